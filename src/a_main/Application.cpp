@@ -1,5 +1,7 @@
 #include "Application.h"
 #include <graphics/d3d12/DX12RenderEngine.h>
+#include <graphics/cpu/CPURenderEngine.h>
+#include <utils/TaskScheduler.h>
 
 #define GLFW_EXPOSE_NATIVE_WIN32
 #include <GLFW/glfw3native.h>
@@ -7,44 +9,26 @@
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_dx12.h>
 
-#include <sstream>
+#include <cstdio>
 #include <filesystem>
 
 namespace neural {
 
 void Application::showFPS(Timer& a_timer, bool a_enableStatistics) {
-    static int maxFPS = 0;
-    static int minFPS = INT_MAX;
-    static int sumFPS = 0;
-    static int countCheckFPS = 0;
-    static constexpr int NEED_CHECK_FPS = 150;
     if (a_timer.tryRecalculateFPS())
     {
-        int fps = a_timer.getLastFPS();
+        char title[256];
         if (a_enableStatistics) {
-            maxFPS = max(maxFPS, fps);
-            minFPS = std::min(minFPS, fps);
-            sumFPS += a_timer.getLastFPS();
-            ++countCheckFPS;
-            if (countCheckFPS >= NEED_CHECK_FPS) {
-                std::stringstream strout;
-                strout << "FPS: AVG = " << sumFPS / countCheckFPS << " MIN = " << minFPS << " MAX = " << maxFPS;
-                glfwSetWindowTitle(m_window, strout.str().c_str());
-                minFPS = INT_MAX;
-                maxFPS = 0;
-                sumFPS = 0;
-                countCheckFPS = 0;
-            }
-        }
-        else {
-            minFPS = INT_MAX;
-            maxFPS = 0;
-            sumFPS = 0;
-            countCheckFPS = 0;
-            std::stringstream strout;
-            strout << "FPS = " << fps;
-            glfwSetWindowTitle(m_window, strout.str().c_str());
+            // Of the whole run, percentiles of the frame times show the hitches an average hides
+            const utils::FrameStatsSummary stats = m_frameStats.getSummary();
+            std::snprintf(title, sizeof(title),
+                          "FPS = %d | p50 %.2f p99 %.2f p99.9 %.2f max %.2f ms | hitches %llu over %.1f ms",
+                          a_timer.getLastFPS(), stats.p50Ms, stats.p99Ms, stats.p999Ms, stats.maxMs,
+                          static_cast<unsigned long long>(stats.hitchCount), stats.budgetMs);
+        } else {
+            std::snprintf(title, sizeof(title), "FPS = %d", a_timer.getLastFPS());
         }
+        glfwSetWindowTitle(m_window, title);
     }
 }
 
@@ -55,9 +39,13 @@ void Application::settingGLFW() {
     glfwSwapInterval(0);
 }
 
-void Application::initialize(std::string_view a_name, int a_width, int a_height)
+void Application::initialize(std::string_view a_name, int a_width, int a_height, RenderBackend a_backend,
+                             const utils::FrameStatsCreateInfo& a_frameStats)
 {
     settingGLFW();
+    m_frameStats.initialize(a_frameStats);
+    // Shared by the CPU inference, asset loading and screenshot writes
+    utils::getTaskScheduler().initialize({ .threadCount = 0, .pinThreads = false });
     m_window = glfwCreateWindow(a_width, a_height, a_name.data(), nullptr, nullptr);
     glfwSetKeyCallback(m_window, onKeyboardPressedBasic);
     glfwSetMouseButtonCallback(m_window, onMouseButtonClickedBasic);
@@ -66,19 +54,19 @@ void Application::initialize(std::string_view a_name, int a_width, int a_height)
     ImGui::CreateContext();
     ImGui_ImplGlfw_InitForOther(m_window, true);
 
-    m_renderer = std::make_shared<graphics::DX12RenderEngine>();
+    if (a_backend == RenderBackend::CPU) {
+        auto softwareRenderer = std::make_shared<graphics::CPURenderEngine>();
+        m_softwareRenderer = softwareRenderer.get();
+        m_renderer = std::move(softwareRenderer);
+    } else {
+        m_renderer = std::make_shared<graphics::DX12RenderEngine>();
+    }
     m_renderer->initialize(glfwGetWin32Window(m_window), a_width, a_height);
 
     m_game = std::make_shared<game::GameEngine>();
     m_game->initialize();
     m_game->setRenderSettingsPtr(m_renderer->getRenderSettingsPtr());
 
-    std::size_t number_of_files = 0u;
-    for (auto const & file : std::filesystem::directory_iterator(MODEL_DATA_ROOT "/colors"))
-    {
-        ++number_of_files;
-    }
-    m_renderer->getRenderSettingsPtr()->screenshotCounter = number_of_files;
 }
 
 void Application::mainLoop()
@@ -96,16 +84,47 @@ void Application::mainLoop()
         showFPS(timer, enableStatisticsFPS);
 
         double dt = timer.calculateDT(glfwGetTime());
+        m_frameStats.addFrame(dt);
 
         m_game->processInputs(g_appInput, dt);
 
         m_renderer->render(timer);
+        if (m_softwareRenderer) {
+            presentSoftwareFrame();
+        }
     }
 }
 
+void Application::presentSoftwareFrame()
+{
+    const graphics::RenderTargets& targets = m_softwareRenderer->getRenderTargets();
+    // Top-down rows with the channel masks of R8G8B8A8
+    struct {
+        BITMAPINFOHEADER header;
+        DWORD masks[3];
+    } bitmapInfo = {
+        .header = {
+            .biSize = sizeof(BITMAPINFOHEADER),
+            .biWidth = static_cast<LONG>(targets.pitch),
+            .biHeight = -static_cast<LONG>(targets.height),
+            .biPlanes = 1,
+            .biBitCount = 32,
+            .biCompression = BI_BITFIELDS
+        },
+        .masks = { 0x000000ff, 0x0000ff00, 0x00ff0000 }
+    };
+    const HWND window = glfwGetWin32Window(m_window);
+    const HDC deviceContext = GetDC(window);
+    SetDIBitsToDevice(deviceContext, 0, 0, targets.width, targets.height, 0, 0, 0, targets.height,
+                      targets.screen.data(), reinterpret_cast<const BITMAPINFO*>(&bitmapInfo), DIB_RGB_COLORS);
+    ReleaseDC(window, deviceContext);
+}
+
 Application::~Application()
 {
+    utils::reportFrameStats(m_frameStats, "frame_times");
     m_renderer->shutdown();
+    utils::getTaskScheduler().shutdown();
     glfwDestroyWindow(m_window);
     glfwTerminate();
 }
@@ -3,6 +3,7 @@
 #include <game/Game.h>
 #include <graphics/IRenderEngine.h>
 #include "Timer.h"
+#include <utils/FrameStats.h>
 #include "AppInput.h"
 
 #include <GLFW/glfw3.h>
@@ -11,18 +12,34 @@
 #include <string_view>
 
 namespace neural {
+namespace graphics {
+class CPURenderEngine;
+}
+
+enum class RenderBackend
+{
+    D3D12,
+    CPU
+};
+
 class Application {
 public:
-    void initialize(std::string_view a_name, int a_width, int a_height);
+    void initialize(std::string_view a_name, int a_width, int a_height, RenderBackend a_backend = RenderBackend::D3D12,
+                    const utils::FrameStatsCreateInfo& a_frameStats = {});
     void mainLoop();
     ~Application();
 private:
     void settingGLFW();
     void showFPS(Timer& a_timer, bool a_enableStatistics);
+    // Copies the screen target of the CPU renderer to the window through GDI
+    void presentSoftwareFrame();
 
     GLFWwindow* m_window{ nullptr };
     std::shared_ptr<game::GameEngine> m_game;
     std::shared_ptr<graphics::IRenderEngine> m_renderer;
+    graphics::CPURenderEngine* m_softwareRenderer = nullptr;  // m_renderer with RenderBackend::CPU
+    // Of the whole run, exported on exit
+    utils::FrameStats m_frameStats;
 
     inline static AppInput g_appInput;
     static void onKeyboardPressedBasic(GLFWwindow* window, int key, int, int action, int);
@@ -1,6 +1,5 @@
 #pragma once
-#include <DirectXMath.h>
-#include <DirectXPackedVector.h>
+#include <utils/VectorMath.h>
 
 namespace neural {
 class Camera {
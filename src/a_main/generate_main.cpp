@@ -0,0 +1,75 @@
+#include <graphics/cpu/DatasetGenerator.h>
+#include <utils/FrameStats.h>
+#include <utils/TaskScheduler.h>
+
+#include <algorithm>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+// <count> [--seed <n>] [--camera orbit|sphere] [--meshes cat,bird] [--size <width> <height>]
+//         [--precision f32|f16|unorm8|unorm16] [--raw]
+static neural::graphics::DatasetSpec parseDatasetSpec(int argc, char** argv) {
+    neural::graphics::DatasetSpec spec;
+    spec.sampleCount = std::stoul(argv[1]);
+    for (int i = 2; i < argc; ++i) {
+        const std::string_view option = argv[i];
+        if (option == "--seed" && i + 1 < argc) {
+            spec.seed = std::stoull(argv[++i]);
+        } else if (option == "--camera" && i + 1 < argc) {
+            spec.cameraDistribution = std::string_view(argv[++i]) == "sphere" ? neural::graphics::CameraDistribution::Sphere
+                                                                              : neural::graphics::CameraDistribution::Orbit;
+        } else if (option == "--meshes" && i + 1 < argc) {
+            spec.meshNames.clear();
+            std::string_view names = argv[++i];
+            while (!names.empty()) {
+                const size_t comma = std::min(names.find(','), names.size());
+                spec.meshNames.emplace_back(names.substr(0, comma));
+                names.remove_prefix(std::min(comma + 1, names.size()));
+            }
+        } else if (option == "--size" && i + 2 < argc) {
+            spec.width = std::stoul(argv[++i]);
+            spec.height = std::stoul(argv[++i]);
+        } else if (option == "--precision" && i + 1 < argc) {
+            const std::string_view precision = argv[++i];
+            spec.precision = precision == "f32"     ? neural::utils::PlanePrecision::Float32
+                           : precision == "unorm8"  ? neural::utils::PlanePrecision::Unorm8
+                           : precision == "unorm16" ? neural::utils::PlanePrecision::Unorm16
+                                                    : neural::utils::PlanePrecision::Float16;
+        } else if (option == "--budget-ms" && i + 1 < argc) {
+            ++i;  // utils::parseFrameStatsArguments
+        } else if (option == "--raw") {
+            spec.compression = neural::utils::PlaneCompression::None;
+        } else {
+            std::cout << "Unknown option " << option << "\n";
+        }
+    }
+    return spec;
+}
+
+// Renders a dataset on the CPU rasterizer, needs neither a window nor a GPU. The sample times are reported like
+// the frame times of the application, --budget-ms <ms> sets the budget of a sample
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cout << "neural_generate <count> [--seed <n>] [--camera orbit|sphere] [--meshes cat,bird] [--size <width> <height>]\n"
+                     "                [--precision f32|f16|unorm8|unorm16] [--raw] [--budget-ms <ms>]\n";
+        return 1;
+    }
+    const neural::graphics::DatasetSpec spec = parseDatasetSpec(argc, argv);
+    neural::utils::TaskScheduler& scheduler = neural::utils::getTaskScheduler();
+    scheduler.initialize({ .threadCount = 0, .pinThreads = true });
+
+    neural::graphics::MeshStorage meshStorage;
+    meshStorage.loadDefaultMeshes();
+    const neural::graphics::DatasetStats stats = neural::graphics::generateDataset(meshStorage, spec);
+    std::cout << "Generated " << stats.sampleCount << " samples in " << stats.seconds << " s, "
+              << stats.samplesPerSecond << " samples/s on " << scheduler.getWorkerCount() + 1 << " threads\n";
+    neural::utils::FrameStats sampleStats;
+    sampleStats.initialize(neural::utils::parseFrameStatsArguments(argc, argv));
+    for (const double seconds : stats.sampleSeconds) {
+        sampleStats.addFrame(seconds);
+    }
+    neural::utils::reportFrameStats(sampleStats, spec.outputDirectory + "/generation_times");
+    scheduler.shutdown();
+    return 0;
+}
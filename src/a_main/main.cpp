@@ -3,6 +3,7 @@
 #include <dxgi1_6.h>
 
 #include <iostream>
+#include <string_view>
 
 #include "Application.h"
 #pragma warning(1:4242)
@@ -12,8 +13,12 @@
 constexpr int32_t WIDTH = 800;
 constexpr int32_t HEIGHT = 600;
 
-int main() {
+// --cpu renders with the software rasterizer instead of D3D12, --budget-ms <ms> sets the frame time budget.
+// Datasets are rendered headlessly by neural_generate
+int main(int argc, char** argv) {
+    const bool useCPU = argc > 1 && std::string_view(argv[1]) == "--cpu";
     neural::Application app;
-    app.initialize("Neural", WIDTH, HEIGHT);
+    app.initialize("Neural", WIDTH, HEIGHT, useCPU ? neural::RenderBackend::CPU : neural::RenderBackend::D3D12,
+                   neural::utils::parseFrameStatsArguments(argc, argv));
     app.mainLoop();
 }
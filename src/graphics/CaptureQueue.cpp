@@ -0,0 +1,112 @@
+#include "CaptureQueue.h"
+
+#include <cassert>
+
+namespace neural::graphics {
+
+void CaptureQueue::initialize(const CaptureQueueCreateInfo& a_createInfo)
+{
+    assert(a_createInfo.device);
+    assert(a_createInfo.slotCount > 0);
+    assert(!m_device);
+
+    m_device = a_createInfo.device;
+    m_overflow = a_createInfo.overflow;
+    m_slots.assign(a_createInfo.slotCount, {});
+    m_copying.clear();
+    m_writes.clear();
+    m_free.clear();
+    // Popped from the back, so slot 0 goes first
+    for (uint32_t slot = a_createInfo.slotCount; slot > 0; --slot) {
+        m_free.push_back(slot - 1);
+    }
+    m_droppedCount = 0;
+    m_writtenCount = 0;
+    m_failedCount = 0;
+}
+
+void CaptureQueue::shutdown()
+{
+    if (!m_device) {
+        return;
+    }
+    flush();
+    m_device = nullptr;
+}
+
+CaptureQueue::~CaptureQueue()
+{
+    shutdown();
+}
+
+uint32_t CaptureQueue::acquireSlot()
+{
+    poll();
+    std::unique_lock lock(m_mutex);
+    if (m_free.empty()) {
+        if (m_overflow == CaptureOverflow::Drop) {
+            ++m_droppedCount;
+            return k_noSlot;
+        }
+        lock.unlock();
+        // Backpressure: the oldest write is the first to free a slot, without one the oldest copy becomes it
+        if (m_writes.empty()) {
+            assert(!m_copying.empty());
+            m_device->waitForFenceValue(m_slots[m_copying.front()].fenceValue);
+            poll();
+        }
+        utils::getTaskScheduler().wait(m_writes.front());
+        lock.lock();
+        assert(!m_free.empty());
+    }
+    const uint32_t slot = m_free.back();
+    m_free.pop_back();
+    return slot;
+}
+
+void CaptureQueue::submitSlot(uint32_t a_slot, uint32_t a_sampleId, uint64_t a_fenceValue)
+{
+    assert(a_slot < m_slots.size());
+    assert(m_copying.empty() || m_slots[m_copying.back()].fenceValue <= a_fenceValue);
+    m_slots[a_slot] = { .sampleId = a_sampleId, .fenceValue = a_fenceValue };
+    m_copying.push_back(a_slot);
+}
+
+void CaptureQueue::poll()
+{
+    utils::TaskScheduler& scheduler = utils::getTaskScheduler();
+    while (!m_writes.empty() && scheduler.isFinished(m_writes.front())) {
+        m_writes.pop_front();
+    }
+    if (m_copying.empty()) {
+        return;
+    }
+    const uint64_t completed = m_device->getCompletedFenceValue();
+    while (!m_copying.empty() && m_slots[m_copying.front()].fenceValue <= completed) {
+        const uint32_t slot = m_copying.front();
+        m_copying.pop_front();
+        m_writes.push_back(scheduler.submit([this, slot]() { writeSlot(slot); }));
+    }
+}
+
+void CaptureQueue::flush()
+{
+    if (!m_copying.empty()) {
+        m_device->waitForFenceValue(m_slots[m_copying.back()].fenceValue);
+        poll();
+    }
+    for (const utils::TaskScheduler::TaskHandle& write : m_writes) {
+        utils::getTaskScheduler().wait(write);
+    }
+    m_writes.clear();
+}
+
+void CaptureQueue::writeSlot(uint32_t a_slot)
+{
+    const bool written = m_device->writeSlot(a_slot, m_slots[a_slot].sampleId);
+    (written ? m_writtenCount : m_failedCount).fetch_add(1, std::memory_order_relaxed);
+
+    std::lock_guard lock(m_mutex);
+    m_free.push_back(a_slot);
+}
+}
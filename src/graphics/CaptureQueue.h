@@ -0,0 +1,89 @@
+#pragma once
+
+#include <utils/TaskScheduler.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <vector>
+
+namespace neural::graphics {
+
+// The device side of captures. A slot is a set of staging buffers the frame targets are copied into,
+// the copies of a slot are complete once the device fence reaches the value the slot was submitted with
+class ICaptureDevice {
+public:
+    virtual ~ICaptureDevice() = default;
+    virtual uint64_t getCompletedFenceValue() = 0;
+    virtual void waitForFenceValue(uint64_t a_value) = 0;
+    // Called on a task of the engine scheduler, no other thread touches the slot meanwhile
+    virtual bool writeSlot(uint32_t a_slot, uint32_t a_sampleId) = 0;
+};
+
+enum class CaptureOverflow : uint32_t
+{
+    Wait,  // the render thread waits for a slot, no capture is lost
+    Drop   // the capture is skipped and counted
+};
+
+struct CaptureQueueCreateInfo {
+    ICaptureDevice* device;
+    uint32_t slotCount = 4;
+    CaptureOverflow overflow = CaptureOverflow::Wait;
+};
+
+// Ring of staging slots between the render thread and the writes:
+//     render thread: acquireSlot, record the copies, submitSlot with the fence value of the frame
+//     poll:          every slot whose fence value is reached becomes a task on the engine scheduler
+//     task:          writeSlot, then the slot is free again
+// No more than slotCount writes are in flight, a full ring stalls or drops on acquireSlot, the frame
+// itself never waits for a readback or a file write. The waits run scheduler tasks meanwhile, so the
+// queue needs no threads of its own and works with any number of workers
+class CaptureQueue {
+public:
+    static constexpr uint32_t k_noSlot = UINT32_MAX;
+
+    void initialize(const CaptureQueueCreateInfo& a_createInfo);
+    // Writes everything submitted
+    void shutdown();
+    ~CaptureQueue();
+
+    // Render thread only. k_noSlot if the ring is full and the overflow policy is Drop
+    uint32_t acquireSlot();
+    void submitSlot(uint32_t a_slot, uint32_t a_sampleId, uint64_t a_fenceValue);
+    // Render thread only, cheap enough to call every frame
+    void poll();
+    // Waits until every submitted capture is written
+    void flush();
+
+    uint32_t getWrittenCount() const {
+        return m_writtenCount.load(std::memory_order_relaxed);
+    }
+    uint32_t getFailedCount() const {
+        return m_failedCount.load(std::memory_order_relaxed);
+    }
+    uint32_t getDroppedCount() const {
+        return m_droppedCount;
+    }
+private:
+    struct Slot {
+        uint32_t sampleId = 0;
+        uint64_t fenceValue = 0;
+    };
+    void writeSlot(uint32_t a_slot);
+
+    ICaptureDevice* m_device = nullptr;
+    CaptureOverflow m_overflow = CaptureOverflow::Wait;
+    std::vector<Slot> m_slots;
+    std::deque<uint32_t> m_copying;  // render thread only, in submission order
+    std::deque<utils::TaskScheduler::TaskHandle> m_writes;  // render thread only, in submission order
+    uint32_t m_droppedCount = 0;
+
+    std::mutex m_mutex;
+    std::vector<uint32_t> m_free;
+
+    std::atomic<uint32_t> m_writtenCount = 0;
+    std::atomic<uint32_t> m_failedCount = 0;
+};
+}
@@ -0,0 +1,83 @@
+#include "CommandStream.h"
+
+namespace neural::graphics {
+
+void CommandChunk::setRootConstants(uint32_t a_slot, std::span<const uint32_t> a_values)
+{
+    const CommandSetRootConstants header = { a_slot, static_cast<uint32_t>(a_values.size()) };
+    const uint32_t headerWords = Command::getWordCount(sizeof(header));
+    uint32_t* payload = beginCommand(CommandType::SetRootConstants,
+                                     headerWords + static_cast<uint32_t>(a_values.size()));
+    std::memcpy(payload, &header, sizeof(header));
+    std::memcpy(payload + headerWords, a_values.data(), a_values.size_bytes());
+}
+
+void CommandChunk::setVertexBuffers(uint32_t a_firstSlot, std::span<const VertexBufferBinding> a_bindings)
+{
+    const CommandSetVertexBuffers header = { a_firstSlot, static_cast<uint32_t>(a_bindings.size()) };
+    const uint32_t headerWords = Command::getWordCount(sizeof(header));
+    uint32_t* payload = beginCommand(CommandType::SetVertexBuffers,
+                                     headerWords + Command::getWordCount(a_bindings.size_bytes()));
+    std::memcpy(payload, &header, sizeof(header));
+    std::memcpy(payload + headerWords, a_bindings.data(), a_bindings.size_bytes());
+}
+
+void CommandChunk::append(const CommandChunk& a_other)
+{
+    m_words.insert(m_words.end(), a_other.m_words.begin(), a_other.m_words.end());
+    m_commandCount += a_other.m_commandCount;
+}
+
+uint32_t* CommandChunk::beginCommand(CommandType a_type, uint32_t a_payloadWords)
+{
+    assert(a_payloadWords <= k_maxPayloadWords);
+    const size_t position = m_words.size();
+    // Padding words of the payload stay zero
+    m_words.resize(position + 1 + a_payloadWords);
+    m_words[position] = static_cast<uint32_t>(a_type) << 24 | a_payloadWords;
+    ++m_commandCount;
+    return m_words.data() + position + 1;
+}
+
+bool CommandReader::next(Command& a_command)
+{
+    if (m_position == m_words.size()) {
+        return false;
+    }
+    const uint32_t header = m_words[m_position];
+    const uint32_t payloadWords = header & 0xFFFFFF;
+    assert(m_position + 1 + payloadWords <= m_words.size());
+    a_command.type = static_cast<CommandType>(header >> 24);
+    a_command.payload = m_words.subspan(m_position + 1, payloadWords);
+    m_position += 1 + payloadWords;
+    return true;
+}
+
+void CommandStream::reset(uint32_t a_chunkCount)
+{
+    if (m_chunks.size() < a_chunkCount) {
+        m_chunks.resize(a_chunkCount);
+    }
+    for (uint32_t i = 0; i < a_chunkCount; ++i) {
+        m_chunks[i].clear();
+    }
+    m_chunkCount = a_chunkCount;
+}
+
+uint32_t CommandStream::getCommandCount() const
+{
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < m_chunkCount; ++i) {
+        count += m_chunks[i].getCommandCount();
+    }
+    return count;
+}
+
+void CommandStream::merge(CommandChunk& a_merged) const
+{
+    a_merged.clear();
+    for (uint32_t i = 0; i < m_chunkCount; ++i) {
+        a_merged.append(m_chunks[i]);
+    }
+}
+}  // namespace neural::graphics
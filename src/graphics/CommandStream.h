@@ -0,0 +1,226 @@
+#pragma once
+#include "RenderGraph.h"
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace neural::graphics {
+
+enum class CommandType : uint8_t {
+    SetPipeline,
+    SetRootConstants,
+    SetConstantBuffer,
+    SetVertexBuffers,
+    SetIndexBuffer,
+    Draw,
+    DrawIndexed,
+    Dispatch,
+    Barrier
+};
+
+enum class CommandBindPoint : uint32_t {
+    Graphics,
+    Compute
+};
+
+// Pipelines, root signatures, resources and GPU addresses are opaque 64-bit handles the backend gives meaning
+// to: on D3D12 pointers to ID3D12PipelineState, ID3D12RootSignature, ID3D12Resource and GPU virtual addresses
+struct CommandSetPipeline {
+    uint64_t pipeline;
+    uint64_t layout;  // root signature, only set again when it changes
+    CommandBindPoint bindPoint;
+};
+// Followed by count 32-bit values
+struct CommandSetRootConstants {
+    uint32_t slot;
+    uint32_t count;
+};
+struct CommandSetConstantBuffer {
+    uint32_t slot;
+    uint64_t address;
+};
+struct VertexBufferBinding {
+    uint64_t address;
+    uint32_t size;
+    uint32_t stride;
+};
+// Followed by count VertexBufferBinding
+struct CommandSetVertexBuffers {
+    uint32_t firstSlot;
+    uint32_t count;
+};
+struct CommandSetIndexBuffer {
+    uint64_t address;
+    uint32_t size;
+    uint32_t indexSize;  // 2 or 4 bytes
+};
+struct CommandDraw {
+    uint32_t vertexCount;
+    uint32_t instanceCount;
+    uint32_t firstVertex;
+    uint32_t firstInstance;
+};
+struct CommandDrawIndexed {
+    uint32_t indexCount;
+    uint32_t instanceCount;
+    uint32_t firstIndex;
+    int32_t baseVertex;
+    uint32_t firstInstance;
+};
+struct CommandDispatch {
+    uint32_t x;
+    uint32_t y;
+    uint32_t z;
+};
+struct CommandBarrier {
+    uint64_t resource;
+    RenderGraphBarrierType type;
+    RenderGraphState before;
+    RenderGraphState after;
+};
+
+// A recorded command: its type and the words of its payload
+struct Command {
+    CommandType type;
+    std::span<const uint32_t> payload;
+
+    template<typename T>
+    T get() const {
+        static_assert(std::is_trivially_copyable_v<T>);
+        assert(payload.size() * sizeof(uint32_t) >= sizeof(T));
+        T value;
+        std::memcpy(&value, payload.data(), sizeof(T));
+        return value;
+    }
+    // The words that follow the fixed part T
+    template<typename T>
+    std::span<const uint32_t> getTail() const {
+        return payload.subspan(getWordCount(sizeof(T)));
+    }
+    // Element a_index of the array that follows the fixed part T, copied out as the words are only 4-byte aligned
+    template<typename T, typename Element>
+    Element getTailElement(uint32_t a_index) const {
+        static_assert(std::is_trivially_copyable_v<Element> && sizeof(Element) % sizeof(uint32_t) == 0);
+        const std::span<const uint32_t> tail = getTail<T>();
+        assert(tail.size() * sizeof(uint32_t) >= (a_index + 1) * sizeof(Element));
+        Element value;
+        std::memcpy(&value, tail.data() + a_index * (sizeof(Element) / sizeof(uint32_t)), sizeof(Element));
+        return value;
+    }
+    static constexpr uint32_t getWordCount(size_t a_bytes) {
+        return static_cast<uint32_t>((a_bytes + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+    }
+};
+
+// Backend-neutral command buffer: every command is a header word, type << 24 | payload words, and the payload
+// packed into 32-bit words. One chunk is recorded by one thread, chunks don't share anything
+class CommandChunk {
+public:
+    void clear() {
+        m_words.clear();
+        m_commandCount = 0;
+    }
+
+    void setPipeline(uint64_t a_pipeline, uint64_t a_layout, CommandBindPoint a_bindPoint) {
+        write(CommandType::SetPipeline, CommandSetPipeline{ a_pipeline, a_layout, a_bindPoint });
+    }
+    void setRootConstants(uint32_t a_slot, std::span<const uint32_t> a_values);
+    template<typename T>
+    void setRootConstants(uint32_t a_slot, const T& a_constants) {
+        static_assert(std::is_trivially_copyable_v<T> && sizeof(T) % sizeof(uint32_t) == 0);
+        setRootConstants(a_slot, { reinterpret_cast<const uint32_t*>(&a_constants), sizeof(T) / sizeof(uint32_t) });
+    }
+    void setConstantBuffer(uint32_t a_slot, uint64_t a_address) {
+        write(CommandType::SetConstantBuffer, CommandSetConstantBuffer{ a_slot, a_address });
+    }
+    void setVertexBuffers(uint32_t a_firstSlot, std::span<const VertexBufferBinding> a_bindings);
+    void setIndexBuffer(uint64_t a_address, uint32_t a_size, uint32_t a_indexSize) {
+        assert(a_indexSize == 2 || a_indexSize == 4);
+        write(CommandType::SetIndexBuffer, CommandSetIndexBuffer{ a_address, a_size, a_indexSize });
+    }
+    void draw(const CommandDraw& a_draw) {
+        write(CommandType::Draw, a_draw);
+    }
+    void drawIndexed(const CommandDrawIndexed& a_draw) {
+        write(CommandType::DrawIndexed, a_draw);
+    }
+    void dispatch(uint32_t a_x, uint32_t a_y, uint32_t a_z) {
+        write(CommandType::Dispatch, CommandDispatch{ a_x, a_y, a_z });
+    }
+    void barrier(const CommandBarrier& a_barrier) {
+        write(CommandType::Barrier, a_barrier);
+    }
+    // Appends the commands of a_other
+    void append(const CommandChunk& a_other);
+
+    std::span<const uint32_t> getWords() const {
+        return m_words;
+    }
+    uint32_t getCommandCount() const {
+        return m_commandCount;
+    }
+private:
+    static constexpr uint32_t k_maxPayloadWords = (1u << 24) - 1;
+
+    // Reserves the header and a_payloadWords, returns the payload
+    uint32_t* beginCommand(CommandType a_type, uint32_t a_payloadWords);
+    template<typename T>
+    void write(CommandType a_type, const T& a_payload) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        std::memcpy(beginCommand(a_type, Command::getWordCount(sizeof(T))), &a_payload, sizeof(T));
+    }
+
+    std::vector<uint32_t> m_words;
+    uint32_t m_commandCount = 0;
+};
+
+// Walks the commands of a chunk in recording order
+class CommandReader {
+public:
+    explicit CommandReader(std::span<const uint32_t> a_words)
+        : m_words(a_words) {}
+
+    bool next(Command& a_command);
+private:
+    std::span<const uint32_t> m_words;
+    size_t m_position = 0;
+};
+
+// Commands of a pass recorded in parallel: worker threads record chunks of their own concurrently, the chunks
+// are consumed in index order, so the order of submission doesn't depend on which thread finished first
+class CommandStream {
+public:
+    // Empties the chunks and keeps their memory for the next frame
+    void reset(uint32_t a_chunkCount);
+    CommandChunk& getChunk(uint32_t a_index) {
+        return m_chunks[a_index];
+    }
+    const CommandChunk& getChunk(uint32_t a_index) const {
+        return m_chunks[a_index];
+    }
+    uint32_t getChunkCount() const {
+        return m_chunkCount;
+    }
+    uint32_t getCommandCount() const;
+    // Concatenates the chunks in index order, for backends that want one buffer
+    void merge(CommandChunk& a_merged) const;
+
+    // Calls a_visitor(const Command&) for every command in submission order
+    template<typename Visitor>
+    void forEach(Visitor&& a_visitor) const {
+        for (uint32_t i = 0; i < m_chunkCount; ++i) {
+            CommandReader reader(m_chunks[i].getWords());
+            for (Command command; reader.next(command);) {
+                a_visitor(command);
+            }
+        }
+    }
+private:
+    std::vector<CommandChunk> m_chunks;  // grows only, the first m_chunkCount are in use
+    uint32_t m_chunkCount = 0;
+};
+}  // namespace neural::graphics
@@ -0,0 +1,45 @@
+#include "InstanceBatcher.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace neural::graphics {
+
+std::span<const InstanceBatch> InstanceBatcher::build(std::span<const SceneInstance> a_instances,
+                                                      const std::function<uint32_t(const SceneInstance&)>& a_selectLod,
+                                                      std::span<InstanceTransform> a_transforms)
+{
+    // 24 bits of instance index, 16 of LOD and 24 of mesh slot
+    assert(a_instances.size() < (1u << 24));
+    m_meshSlots.clear();
+    m_keys.clear();
+    m_batches.clear();
+    for (uint32_t i = 0; i < a_instances.size(); ++i) {
+        const uint32_t lod = a_selectLod(a_instances[i]);
+        if (lod == k_skipInstance) {
+            continue;
+        }
+        const uint32_t slot = m_meshSlots.try_emplace(a_instances[i].meshName, m_meshSlots.size()).first->second;
+        m_keys.push_back(static_cast<uint64_t>(slot) << 40 | static_cast<uint64_t>(lod & 0xffff) << 24 | i);
+    }
+    std::sort(m_keys.begin(), m_keys.end());
+
+    const size_t instanceCount = std::min(m_keys.size(), a_transforms.size());
+    for (uint32_t k = 0; k < instanceCount; ++k) {
+        const SceneInstance& instance = a_instances[m_keys[k] & 0xffffff];
+        const uint32_t lod = static_cast<uint32_t>(m_keys[k] >> 24) & 0xffff;
+        if (m_batches.empty() || (m_keys[k] >> 24) != (m_keys[k - 1] >> 24)) {
+            m_batches.push_back({ .meshName = &instance.meshName, .lod = lod, .firstInstance = k, .instanceCount = 0 });
+        }
+        ++m_batches.back().instanceCount;
+
+        const auto& m = instance.worldMatrix.m;
+        a_transforms[k].columns = { {
+            { m[0][0], m[1][0], m[2][0], m[3][0] },
+            { m[0][1], m[1][1], m[2][1], m[3][1] },
+            { m[0][2], m[1][2], m[2][2], m[3][2] }
+        } };
+    }
+    return m_batches;
+}
+}
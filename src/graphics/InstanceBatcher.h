@@ -0,0 +1,49 @@
+#pragma once
+#include <utils/VectorMath.h>
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace neural::graphics {
+
+struct SceneInstance {
+    std::string meshName;
+    DirectX::XMFLOAT4X4 worldMatrix;  // row-major for row vectors, as in DirectXMath
+};
+
+// The first three columns of the world matrix, the shaders compute world.x = dot(float4(position, 1), columns[0])
+struct InstanceTransform {
+    std::array<DirectX::XMFLOAT4, 3> columns;
+};
+
+struct InstanceBatch {
+    const std::string* meshName;  // of the instances given to InstanceBatcher::build
+    uint32_t lod;
+    uint32_t firstInstance;  // in the transforms written by InstanceBatcher::build
+    uint32_t instanceCount;
+};
+
+// Turns a scene instance list into one instanced draw per mesh and LOD. The instances are sorted by mesh
+// and LOD and their transforms packed in that order, so every batch is a contiguous range of transforms
+class InstanceBatcher {
+public:
+    static constexpr uint32_t k_skipInstance = ~0u;
+
+    // a_selectLod returns the LOD an instance is drawn with, or k_skipInstance. Writes the transforms into
+    // a_transforms, instances that don't fit in it are dropped. The batches are valid until the next call
+    // and while a_instances is alive
+    std::span<const InstanceBatch> build(std::span<const SceneInstance> a_instances,
+                                         const std::function<uint32_t(const SceneInstance&)>& a_selectLod,
+                                         std::span<InstanceTransform> a_transforms);
+private:
+    std::unordered_map<std::string_view, uint32_t> m_meshSlots;
+    std::vector<uint64_t> m_keys;  // mesh slot, LOD, instance index
+    std::vector<InstanceBatch> m_batches;
+};
+}
@@ -0,0 +1,145 @@
+#include "MeshCache.h"
+#include <utils/MappedFile.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace neural::graphics {
+
+namespace {
+constexpr uint32_t k_meshCacheMagic = 0x48534D4E;  // "NMSH"
+constexpr uint32_t k_meshCacheVersion = 4;  // 2: optimized by MeshOptimizer, 3: LODs, 4: all submeshes
+
+struct MeshCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t keySize;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t lodCount;
+};
+
+template<typename T>
+void appendBytes(std::string& a_key, const T& a_value)
+{
+    a_key.append(reinterpret_cast<const char*>(&a_value), sizeof(a_value));
+}
+
+// FNV-1a, names the file of a key
+uint64_t hashKey(const std::string& a_key)
+{
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const char c : a_key) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::string getCachePath(const std::string& a_directory, const std::string& a_key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%016llx.mesh", static_cast<unsigned long long>(hashKey(a_key)));
+    return a_directory + name;
+}
+
+// The vertices start right after the key, which is padded to keep them aligned
+size_t getVertexOffset(size_t a_keySize)
+{
+    return (sizeof(MeshCacheHeader) + a_keySize + 15) / 16 * 16;
+}
+}  // anonymous namespace
+
+std::string getMeshCacheKey(const char* a_sourcePath, const MeshTransform& a_transform)
+{
+    std::error_code error;
+    const std::filesystem::path path = std::filesystem::absolute(a_sourcePath, error);
+    const uint64_t size = std::filesystem::file_size(path, error);
+    if (error) {
+        return {};
+    }
+    const int64_t writeTime = std::filesystem::last_write_time(path, error).time_since_epoch().count();
+    if (error) {
+        return {};
+    }
+    std::string key = path.generic_string();
+    key.push_back('\0');
+    appendBytes(key, size);
+    appendBytes(key, writeTime);
+    appendBytes(key, a_transform);
+    appendBytes(key, static_cast<uint32_t>(sizeof(MeshStorage::Vertex)));
+    return key;
+}
+
+bool readMeshCache(const std::string& a_directory, const std::string& a_key,
+                   std::vector<MeshStorage::Vertex>& a_vertices, std::vector<uint32_t>& a_indices,
+                   std::vector<MeshStorage::MeshLod>& a_lods)
+{
+    utils::MappedFile file;
+    if (a_key.empty() || !file.open(getCachePath(a_directory, a_key)) || file.getSize() < sizeof(MeshCacheHeader)) {
+        return false;
+    }
+    MeshCacheHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+    if (header.magic != k_meshCacheMagic || header.version != k_meshCacheVersion || header.keySize != a_key.size()) {
+        return false;
+    }
+    const size_t vertexOffset = getVertexOffset(a_key.size());
+    const size_t vertexBytes = static_cast<size_t>(header.vertexCount) * sizeof(MeshStorage::Vertex);
+    const size_t indexBytes = static_cast<size_t>(header.indexCount) * sizeof(uint32_t);
+    const size_t lodBytes = static_cast<size_t>(header.lodCount) * sizeof(MeshStorage::MeshLod);
+    if (file.getSize() != vertexOffset + vertexBytes + indexBytes + lodBytes ||
+        std::memcmp(file.getData() + sizeof(header), a_key.data(), a_key.size()) != 0) {
+        return false;
+    }
+    a_vertices.resize(header.vertexCount);
+    a_indices.resize(header.indexCount);
+    a_lods.resize(header.lodCount);
+    std::memcpy(a_vertices.data(), file.getData() + vertexOffset, vertexBytes);
+    std::memcpy(a_indices.data(), file.getData() + vertexOffset + vertexBytes, indexBytes);
+    std::memcpy(a_lods.data(), file.getData() + vertexOffset + vertexBytes + indexBytes, lodBytes);
+    return true;
+}
+
+bool writeMeshCache(const std::string& a_directory, const std::string& a_key,
+                    std::span<const MeshStorage::Vertex> a_vertices, std::span<const uint32_t> a_indices,
+                    std::span<const MeshStorage::MeshLod> a_lods)
+{
+    if (a_key.empty()) {
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(a_directory, error);
+    const std::string path = getCachePath(a_directory, a_key);
+    const std::string temporaryPath = path + ".tmp";
+    std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const MeshCacheHeader header = {
+        .magic = k_meshCacheMagic,
+        .version = k_meshCacheVersion,
+        .keySize = static_cast<uint32_t>(a_key.size()),
+        .vertexCount = static_cast<uint32_t>(a_vertices.size()),
+        .indexCount = static_cast<uint32_t>(a_indices.size()),
+        .lodCount = static_cast<uint32_t>(a_lods.size())
+    };
+    const char padding[16] = {};
+    const size_t paddingSize = getVertexOffset(a_key.size()) - sizeof(header) - a_key.size();
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(a_key.data(), 1, a_key.size(), file) == a_key.size() &&
+                   std::fwrite(padding, 1, paddingSize, file) == paddingSize &&
+                   std::fwrite(a_vertices.data(), sizeof(MeshStorage::Vertex), a_vertices.size(), file) == a_vertices.size() &&
+                   std::fwrite(a_indices.data(), sizeof(uint32_t), a_indices.size(), file) == a_indices.size() &&
+                   std::fwrite(a_lods.data(), sizeof(MeshStorage::MeshLod), a_lods.size(), file) == a_lods.size();
+    written = std::fclose(file) == 0 && written;
+    if (written) {
+        std::filesystem::rename(temporaryPath, path, error);
+        written = !error;
+    }
+    if (!written) {
+        std::filesystem::remove(temporaryPath, error);
+    }
+    return written;
+}
+}
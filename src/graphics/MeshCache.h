@@ -0,0 +1,27 @@
+#pragma once
+#include "MeshStorage.h"
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace neural::graphics {
+
+// Binary cache of imported meshes, one file per source file and transform in the cache directory:
+//     header: magic, version, key size, vertex count, index count, LOD count
+//     key:    source path, source size and last write time, transform, vertex size
+//     vertices, indices and LODs as MeshStorage stores them
+// A file is only used while its source keeps size and write time. Files are written under a temporary
+// name and renamed, so a reader never sees a partial file
+
+// Empty if the source doesn't exist
+std::string getMeshCacheKey(const char* a_sourcePath, const MeshTransform& a_transform);
+// Maps the file and copies the arrays out of it, false on a miss
+bool readMeshCache(const std::string& a_directory, const std::string& a_key,
+                   std::vector<MeshStorage::Vertex>& a_vertices, std::vector<uint32_t>& a_indices,
+                   std::vector<MeshStorage::MeshLod>& a_lods);
+bool writeMeshCache(const std::string& a_directory, const std::string& a_key,
+                    std::span<const MeshStorage::Vertex> a_vertices, std::span<const uint32_t> a_indices,
+                    std::span<const MeshStorage::MeshLod> a_lods);
+}
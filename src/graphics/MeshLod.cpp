@@ -0,0 +1,79 @@
+#include "MeshLod.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace neural::graphics {
+
+std::vector<MeshStorage::MeshLod> buildMeshLods(std::span<const MeshStorage::Vertex> a_vertices,
+                                                std::vector<uint32_t>& a_indices)
+{
+    std::vector<MeshStorage::MeshLod> lods = { { .startIndex = 0, .indexCount = a_indices.size(), .error = 0.0f } };
+    const size_t sourceIndexCount = a_indices.size();
+    while (lods.size() < k_maxMeshLods) {
+        const size_t previousCount = lods.back().indexCount;
+        const size_t targetCount = previousCount / 6 * 3;
+        if (targetCount < k_minLodTriangles * 3) {
+            break;
+        }
+        // From the full mesh every time, so the error is measured against it
+        SimplifyResult lod = simplifyMesh(a_vertices, { a_indices.data(), sourceIndexCount }, targetCount,
+                                          std::numeric_limits<float>::max());
+        // Locked vertices stop the simplifier early, a LOD that saves little isn't worth a draw
+        if (lod.indices.size() > previousCount * 3 / 4) {
+            break;
+        }
+        optimizeVertexCache(lod.indices, a_vertices.size());
+        lods.push_back({
+            .startIndex = a_indices.size(),
+            .indexCount = lod.indices.size(),
+            .error = std::max(lod.error, lods.back().error)
+        });
+        a_indices.insert(a_indices.end(), lod.indices.begin(), lod.indices.end());
+    }
+    return lods;
+}
+
+uint32_t selectMeshLod(const MeshStorage::MeshInfo& a_meshInfo, const DirectX::XMFLOAT4X4& a_worldMatrix,
+                       const Camera& a_camera, uint32_t a_viewportHeight, float a_maxPixelError)
+{
+    if (a_meshInfo.lods.size() <= 1) {
+        return 0;
+    }
+    const auto& m = a_worldMatrix.m;
+    const float center[3] = {
+        (a_meshInfo.boundsMin.x + a_meshInfo.boundsMax.x) * 0.5f,
+        (a_meshInfo.boundsMin.y + a_meshInfo.boundsMax.y) * 0.5f,
+        (a_meshInfo.boundsMin.z + a_meshInfo.boundsMax.z) * 0.5f
+    };
+    const float halfSize[3] = {
+        (a_meshInfo.boundsMax.x - a_meshInfo.boundsMin.x) * 0.5f,
+        (a_meshInfo.boundsMax.y - a_meshInfo.boundsMin.y) * 0.5f,
+        (a_meshInfo.boundsMax.z - a_meshInfo.boundsMin.z) * 0.5f
+    };
+    // The rows are the images of the axes, the longest one bounds how much the matrix stretches the mesh
+    float scale = 0.0f;
+    float centerW[3];
+    for (uint32_t c = 0; c < 3; ++c) {
+        scale = std::max(scale, std::sqrt(m[c][0] * m[c][0] + m[c][1] * m[c][1] + m[c][2] * m[c][2]));
+        centerW[c] = center[0] * m[0][c] + center[1] * m[1][c] + center[2] * m[2][c] + m[3][c];
+    }
+    const float radius = std::sqrt(halfSize[0] * halfSize[0] + halfSize[1] * halfSize[1] + halfSize[2] * halfSize[2]) * scale;
+
+    const DirectX::XMFLOAT3 cameraPosition = a_camera.getPosition3f();
+    const float toCenter[3] = { centerW[0] - cameraPosition.x, centerW[1] - cameraPosition.y, centerW[2] - cameraPosition.z };
+    const float centerDistance = std::sqrt(toCenter[0] * toCenter[0] + toCenter[1] * toCenter[1] + toCenter[2] * toCenter[2]);
+    const float distance = std::max(centerDistance - radius, a_camera.getNearZ());
+    const float pixelsPerUnit = static_cast<float>(a_viewportHeight) / (2.0f * distance * std::tan(a_camera.getFovY() * 0.5f));
+
+    uint32_t lod = 0;
+    while (lod + 1 < a_meshInfo.lods.size() &&
+           a_meshInfo.lods[lod + 1].error * scale * pixelsPerUnit <= a_maxPixelError) {
+        ++lod;
+    }
+    return lod;
+}
+}
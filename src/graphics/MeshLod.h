@@ -0,0 +1,25 @@
+#pragma once
+#include "MeshStorage.h"
+#include <a_main/Camera.h>
+#include <utils/VectorMath.h>
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace neural::graphics {
+
+constexpr uint32_t k_maxMeshLods = 6;
+constexpr uint32_t k_minLodTriangles = 32;
+
+// Simplifies a_indices, the full mesh, into LODs that each have half the triangles of the previous one, until
+// a LOD would be under k_minLodTriangles or the simplifier can't halve it any more. The LODs index the same
+// vertices and are appended to a_indices. Returns all the LODs with startIndex in a_indices, LOD 0 first
+std::vector<MeshStorage::MeshLod> buildMeshLods(std::span<const MeshStorage::Vertex> a_vertices,
+                                                std::vector<uint32_t>& a_indices);
+
+// The coarsest LOD whose error, projected at the point of the bounding sphere nearest to the camera, is at
+// most a_maxPixelError pixels. a_worldMatrix places the mesh, row-major for row vectors as in DirectXMath
+uint32_t selectMeshLod(const MeshStorage::MeshInfo& a_meshInfo, const DirectX::XMFLOAT4X4& a_worldMatrix,
+                       const Camera& a_camera, uint32_t a_viewportHeight, float a_maxPixelError);
+}
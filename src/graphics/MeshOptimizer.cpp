@@ -0,0 +1,328 @@
+#include "MeshOptimizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+namespace neural::graphics {
+
+namespace {
+constexpr uint32_t k_noVertex = ~0u;
+
+// FIFO cache with timestamps instead of a queue: a vertex is cached while fewer than a_cacheSize vertices
+// were inserted after it. Advancing the clock by the cache size empties it
+class VertexCacheModel {
+public:
+    VertexCacheModel(size_t a_vertexCount, uint32_t a_cacheSize)
+        : m_insertedAt(a_vertexCount, 0)
+        , m_cacheSize(a_cacheSize)
+        , m_time(a_cacheSize + 1)
+    {}
+    // True on a miss, the vertex is in the cache afterwards
+    bool access(uint32_t a_vertex) {
+        if (m_time - m_insertedAt[a_vertex] <= m_cacheSize) {
+            return false;
+        }
+        m_insertedAt[a_vertex] = m_time++;
+        return true;
+    }
+    void clear() {
+        m_time += m_cacheSize + 1;
+    }
+private:
+    std::vector<uint64_t> m_insertedAt;
+    uint64_t m_cacheSize;
+    uint64_t m_time;
+};
+
+// Triangles of every vertex, in CSR layout
+struct VertexAdjacency {
+    std::vector<uint32_t> offsets;  // a_vertexCount + 1
+    std::vector<uint32_t> triangles;
+};
+
+VertexAdjacency buildAdjacency(std::span<const uint32_t> a_indices, size_t a_vertexCount)
+{
+    VertexAdjacency adjacency;
+    adjacency.offsets.assign(a_vertexCount + 1, 0);
+    for (const uint32_t index : a_indices) {
+        ++adjacency.offsets[index + 1];
+    }
+    std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+    adjacency.triangles.resize(a_indices.size());
+    std::vector<uint32_t> cursor(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (size_t i = 0; i < a_indices.size(); ++i) {
+        adjacency.triangles[cursor[a_indices[i]]++] = static_cast<uint32_t>(i / 3);
+    }
+    return adjacency;
+}
+
+struct Float3 {
+    float x, y, z;
+};
+
+Float3 operator-(Float3 a_left, Float3 a_right) {
+    return { a_left.x - a_right.x, a_left.y - a_right.y, a_left.z - a_right.z };
+}
+
+Float3 cross(Float3 a_left, Float3 a_right) {
+    return {
+        a_left.y * a_right.z - a_left.z * a_right.y,
+        a_left.z * a_right.x - a_left.x * a_right.z,
+        a_left.x * a_right.y - a_left.y * a_right.x
+    };
+}
+
+float dot(Float3 a_left, Float3 a_right) {
+    return a_left.x * a_right.x + a_left.y * a_right.y + a_left.z * a_right.z;
+}
+
+Float3 getPosition(const MeshStorage::Vertex& a_vertex) {
+    return { a_vertex.position.x, a_vertex.position.y, a_vertex.position.z };
+}
+}  // anonymous namespace
+
+VertexCacheStatistics analyzeVertexCache(std::span<const uint32_t> a_indices, size_t a_vertexCount,
+                                         uint32_t a_cacheSize)
+{
+    assert(a_indices.size() % 3 == 0);
+    if (a_indices.empty()) {
+        return {};
+    }
+    VertexCacheModel cache(a_vertexCount, a_cacheSize);
+    std::vector<bool> referenced(a_vertexCount, false);
+    size_t misses = 0;
+    size_t referencedCount = 0;
+    for (const uint32_t index : a_indices) {
+        misses += cache.access(index);
+        referencedCount += !referenced[index];
+        referenced[index] = true;
+    }
+    return {
+        .acmr = static_cast<float>(misses) / static_cast<float>(a_indices.size() / 3),
+        .atvr = static_cast<float>(misses) / static_cast<float>(referencedCount)
+    };
+}
+
+void optimizeVertexCache(std::span<uint32_t> a_indices, size_t a_vertexCount, uint32_t a_cacheSize)
+{
+    assert(a_indices.size() % 3 == 0);
+    const size_t triangleCount = a_indices.size() / 3;
+    if (triangleCount == 0) {
+        return;
+    }
+    const VertexAdjacency adjacency = buildAdjacency(a_indices, a_vertexCount);
+    std::vector<uint32_t> liveTriangles(a_vertexCount);
+    for (size_t v = 0; v < a_vertexCount; ++v) {
+        liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+    std::vector<uint64_t> cachedAt(a_vertexCount, 0);
+    uint64_t time = a_cacheSize + 1;
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> result;
+    result.reserve(a_indices.size());
+
+    // Restarts from the most recently used vertex that still has triangles, then from the next unused
+    // vertex in input order
+    uint32_t inputCursor = 0;
+    const auto skipDeadEnd = [&]() {
+        while (!deadEnd.empty()) {
+            const uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (liveTriangles[v] > 0) {
+                return v;
+            }
+        }
+        for (; inputCursor < a_vertexCount; ++inputCursor) {
+            if (liveTriangles[inputCursor] > 0) {
+                return inputCursor;
+            }
+        }
+        return k_noVertex;
+    };
+
+    uint32_t fanning = skipDeadEnd();
+    while (fanning != k_noVertex) {
+        candidates.clear();
+        for (uint32_t i = adjacency.offsets[fanning]; i < adjacency.offsets[fanning + 1]; ++i) {
+            const uint32_t triangle = adjacency.triangles[i];
+            if (emitted[triangle]) {
+                continue;
+            }
+            emitted[triangle] = true;
+            for (uint32_t k = 0; k < 3; ++k) {
+                const uint32_t v = a_indices[triangle * 3 + k];
+                result.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --liveTriangles[v];
+                if (time - cachedAt[v] > a_cacheSize) {
+                    cachedAt[v] = time++;
+                }
+            }
+        }
+
+        // The candidate that stays cached while its remaining triangles are fanned and was cached the longest
+        // ago, so its entry is used before it is evicted
+        uint32_t next = k_noVertex;
+        int64_t bestPriority = -1;
+        for (const uint32_t v : candidates) {
+            if (liveTriangles[v] == 0) {
+                continue;
+            }
+            int64_t priority = 0;
+            const uint64_t age = time - cachedAt[v];
+            if (age + 2 * liveTriangles[v] <= a_cacheSize) {
+                priority = static_cast<int64_t>(age);
+            }
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = v;
+            }
+        }
+        fanning = next != k_noVertex ? next : skipDeadEnd();
+    }
+    assert(result.size() == a_indices.size());
+    std::copy(result.begin(), result.end(), a_indices.begin());
+}
+
+void optimizeOverdraw(std::span<uint32_t> a_indices, std::span<const MeshStorage::Vertex> a_vertices,
+                      float a_threshold, uint32_t a_cacheSize)
+{
+    assert(a_indices.size() % 3 == 0);
+    const uint32_t triangleCount = static_cast<uint32_t>(a_indices.size() / 3);
+    if (triangleCount == 0) {
+        return;
+    }
+    VertexCacheModel cache(a_vertices.size(), a_cacheSize);
+    const auto countMisses = [&](uint32_t a_triangle) {
+        return static_cast<uint32_t>(cache.access(a_indices[a_triangle * 3])) +
+               cache.access(a_indices[a_triangle * 3 + 1]) +
+               cache.access(a_indices[a_triangle * 3 + 2]);
+    };
+
+    // Hard boundaries: triangles with three misses, the cache optimizer restarted there
+    std::vector<uint32_t> hardStarts;
+    for (uint32_t t = 0; t < triangleCount; ++t) {
+        if (countMisses(t) == 3) {
+            hardStarts.push_back(t);
+        }
+    }
+    if (hardStarts.empty() || hardStarts.front() != 0) {
+        hardStarts.insert(hardStarts.begin(), 0);
+    }
+    hardStarts.push_back(triangleCount);
+
+    // Soft boundaries: a cluster ends as soon as its own ACMR, starting from an empty cache, is within
+    // the threshold of the run it belongs to
+    std::vector<uint32_t> clusterStarts;
+    for (size_t h = 0; h + 1 < hardStarts.size(); ++h) {
+        const uint32_t begin = hardStarts[h];
+        const uint32_t end = hardStarts[h + 1];
+        cache.clear();
+        uint32_t runMisses = 0;
+        for (uint32_t t = begin; t < end; ++t) {
+            runMisses += countMisses(t);
+        }
+        const float runAcmr = static_cast<float>(runMisses) / static_cast<float>(end - begin);
+
+        cache.clear();
+        clusterStarts.push_back(begin);
+        uint32_t clusterMisses = 0;
+        for (uint32_t t = begin; t < end; ++t) {
+            clusterMisses += countMisses(t);
+            const uint32_t clusterSize = t + 1 - clusterStarts.back();
+            if (t + 1 < end && clusterMisses <= a_threshold * runAcmr * clusterSize) {
+                clusterStarts.push_back(t + 1);
+                clusterMisses = 0;
+                cache.clear();
+            }
+        }
+    }
+    clusterStarts.push_back(triangleCount);
+    const size_t clusterCount = clusterStarts.size() - 1;
+
+    // Area-weighted centroid and normal of every cluster. Clockwise triangles are front faces, so the cross
+    // product of the edges points out of the mesh
+    std::vector<Float3> clusterCentroids(clusterCount, { 0, 0, 0 });
+    std::vector<Float3> clusterNormals(clusterCount, { 0, 0, 0 });
+    std::vector<float> clusterAreas(clusterCount, 0.0f);
+    Float3 meshCentroid = { 0, 0, 0 };
+    float meshArea = 0.0f;
+    for (size_t c = 0; c < clusterCount; ++c) {
+        for (uint32_t t = clusterStarts[c]; t < clusterStarts[c + 1]; ++t) {
+            const Float3 p0 = getPosition(a_vertices[a_indices[t * 3]]);
+            const Float3 p1 = getPosition(a_vertices[a_indices[t * 3 + 1]]);
+            const Float3 p2 = getPosition(a_vertices[a_indices[t * 3 + 2]]);
+            const Float3 normal = cross(p1 - p0, p2 - p0);
+            const float area = std::sqrt(dot(normal, normal));
+            const Float3 center = { (p0.x + p1.x + p2.x) / 3, (p0.y + p1.y + p2.y) / 3, (p0.z + p1.z + p2.z) / 3 };
+            Float3& clusterCentroid = clusterCentroids[c];
+            clusterCentroid = { clusterCentroid.x + center.x * area, clusterCentroid.y + center.y * area,
+                                clusterCentroid.z + center.z * area };
+            Float3& clusterNormal = clusterNormals[c];
+            clusterNormal = { clusterNormal.x + normal.x, clusterNormal.y + normal.y, clusterNormal.z + normal.z };
+            clusterAreas[c] += area;
+        }
+        const Float3& centroid = clusterCentroids[c];
+        meshCentroid = { meshCentroid.x + centroid.x, meshCentroid.y + centroid.y, meshCentroid.z + centroid.z };
+        meshArea += clusterAreas[c];
+    }
+    if (meshArea > 0.0f) {
+        meshCentroid = { meshCentroid.x / meshArea, meshCentroid.y / meshArea, meshCentroid.z / meshArea };
+    }
+
+    std::vector<float> sortKeys(clusterCount, 0.0f);
+    for (size_t c = 0; c < clusterCount; ++c) {
+        const float normalLength = std::sqrt(dot(clusterNormals[c], clusterNormals[c]));
+        if (clusterAreas[c] <= 0.0f || normalLength <= 0.0f) {
+            continue;
+        }
+        const float invArea = 1.0f / clusterAreas[c];
+        const Float3 centroid = { clusterCentroids[c].x * invArea, clusterCentroids[c].y * invArea,
+                                  clusterCentroids[c].z * invArea };
+        sortKeys[c] = dot(centroid - meshCentroid, clusterNormals[c]) / normalLength;
+    }
+    std::vector<uint32_t> order(clusterCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t a_left, uint32_t a_right) {
+        return sortKeys[a_left] > sortKeys[a_right];
+    });
+
+    std::vector<uint32_t> result;
+    result.reserve(a_indices.size());
+    for (const uint32_t c : order) {
+        result.insert(result.end(), a_indices.begin() + clusterStarts[c] * 3, a_indices.begin() + clusterStarts[c + 1] * 3);
+    }
+    std::copy(result.begin(), result.end(), a_indices.begin());
+}
+
+void optimizeVertexFetch(std::vector<MeshStorage::Vertex>& a_vertices, std::span<uint32_t> a_indices)
+{
+    std::vector<uint32_t> remap(a_vertices.size(), k_noVertex);
+    uint32_t vertexCount = 0;
+    for (uint32_t& index : a_indices) {
+        if (remap[index] == k_noVertex) {
+            remap[index] = vertexCount++;
+        }
+        index = remap[index];
+    }
+    std::vector<MeshStorage::Vertex> vertices(vertexCount);
+    for (size_t v = 0; v < a_vertices.size(); ++v) {
+        if (remap[v] != k_noVertex) {
+            vertices[remap[v]] = a_vertices[v];
+        }
+    }
+    a_vertices = std::move(vertices);
+}
+
+void optimizeMesh(std::vector<MeshStorage::Vertex>& a_vertices, std::span<uint32_t> a_indices)
+{
+    optimizeVertexCache(a_indices, a_vertices.size());
+    optimizeOverdraw(a_indices, a_vertices);
+    optimizeVertexFetch(a_vertices, a_indices);
+}
+}
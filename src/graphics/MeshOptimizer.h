@@ -0,0 +1,36 @@
+#pragma once
+#include "MeshStorage.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace neural::graphics {
+
+// Import-time reordering of triangle lists for the post-transform vertex cache, overdraw and vertex fetch.
+// The cache is modelled as a FIFO of k_vertexCacheSize vertices, the usual model for current GPUs
+constexpr uint32_t k_vertexCacheSize = 16;
+
+struct VertexCacheStatistics {
+    float acmr = 0.0f;  // transformed vertices per triangle, 0.5 is the best possible for a regular grid, 3 the worst
+    float atvr = 0.0f;  // transformed vertices per referenced vertex, 1 is the best possible
+};
+// Simulates the FIFO cache over the index buffer
+VertexCacheStatistics analyzeVertexCache(std::span<const uint32_t> a_indices, size_t a_vertexCount,
+                                         uint32_t a_cacheSize = k_vertexCacheSize);
+
+// Tipsify (Sander, Nehab, Barczak 2007): fans around the vertex that is still in the cache and has the most
+// triangles left, jumps to a recently used vertex at dead ends. Linear in the number of triangles
+void optimizeVertexCache(std::span<uint32_t> a_indices, size_t a_vertexCount,
+                         uint32_t a_cacheSize = k_vertexCacheSize);
+// Splits the cache-optimized triangles into clusters at the points where the cache restarts and where the
+// cluster ACMR stays within a_threshold of the ACMR of the whole run, then draws the clusters that face away
+// from the center of the mesh first. Those are the ones that occlude, whatever the view direction is
+void optimizeOverdraw(std::span<uint32_t> a_indices, std::span<const MeshStorage::Vertex> a_vertices,
+                      float a_threshold = 1.05f, uint32_t a_cacheSize = k_vertexCacheSize);
+// Renumbers the vertices in the order the indices first use them and drops the unused ones
+void optimizeVertexFetch(std::vector<MeshStorage::Vertex>& a_vertices, std::span<uint32_t> a_indices);
+
+// All three passes in order: vertex cache, overdraw, vertex fetch
+void optimizeMesh(std::vector<MeshStorage::Vertex>& a_vertices, std::span<uint32_t> a_indices);
+}
@@ -0,0 +1,561 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cmath>
+#include <queue>
+#include <tuple>
+#include <unordered_map>
+
+namespace neural::graphics {
+
+namespace {
+constexpr uint32_t k_dimension = 6;  // position, normal
+constexpr double k_boundaryWeight = 10.0;
+using Point = std::array<double, k_dimension>;
+
+double dot(const Point& a_left, const Point& a_right) {
+    double result = 0.0;
+    for (uint32_t i = 0; i < k_dimension; ++i) {
+        result += a_left[i] * a_right[i];
+    }
+    return result;
+}
+
+std::array<double, 3> cross(const std::array<double, 3>& a_left, const std::array<double, 3>& a_right) {
+    return {
+        a_left[1] * a_right[2] - a_left[2] * a_right[1],
+        a_left[2] * a_right[0] - a_left[0] * a_right[2],
+        a_left[0] * a_right[1] - a_left[1] * a_right[0]
+    };
+}
+
+std::array<double, 3> subtract3(const Point& a_left, const Point& a_right) {
+    return { a_left[0] - a_right[0], a_left[1] - a_right[1], a_left[2] - a_right[2] };
+}
+
+double length3(const std::array<double, 3>& a_vector) {
+    return std::sqrt(a_vector[0] * a_vector[0] + a_vector[1] * a_vector[1] + a_vector[2] * a_vector[2]);
+}
+
+// Error of a point p is p^T A p + 2 b^T p + c, divided by the summed triangle area
+struct Quadric {
+    std::array<double, k_dimension * (k_dimension + 1) / 2> a = {};  // upper triangle, row by row
+    Point b = {};
+    double c = 0.0;
+    double weight = 0.0;
+
+    void add(const Quadric& a_other) {
+        for (size_t i = 0; i < a.size(); ++i) {
+            a[i] += a_other.a[i];
+        }
+        for (uint32_t i = 0; i < k_dimension; ++i) {
+            b[i] += a_other.b[i];
+        }
+        c += a_other.c;
+        weight += a_other.weight;
+    }
+    // The error at a position with the normal that fits the planes best, the one that solves
+    // A_nn n = -(A_np p + b_n)
+    double evaluate(const std::array<double, 3>& a_position) const {
+        std::array<std::array<double, 3>, 3> normalBlock;
+        std::array<double, 3> rhs;
+        for (uint32_t i = 0; i < 3; ++i) {
+            rhs[i] = -b[3 + i];
+            for (uint32_t j = 0; j < 3; ++j) {
+                normalBlock[i][j] = get(3 + i, 3 + j);
+                rhs[i] -= get(j, 3 + i) * a_position[j];
+            }
+        }
+        Point point = { a_position[0], a_position[1], a_position[2], 0.0, 0.0, 0.0 };
+        const auto& m = normalBlock;
+        const double determinant = m[0][0] * (m[1][1] * m[2][2] - m[1][2] * m[2][1]) -
+                                   m[0][1] * (m[1][0] * m[2][2] - m[1][2] * m[2][0]) +
+                                   m[0][2] * (m[1][0] * m[2][1] - m[1][1] * m[2][0]);
+        if (std::abs(determinant) > 1e-12 * weight * weight * weight) {
+            // Cramer's rule
+            for (uint32_t column = 0; column < 3; ++column) {
+                auto replaced = m;
+                for (uint32_t row = 0; row < 3; ++row) {
+                    replaced[row][column] = rhs[row];
+                }
+                point[3 + column] = (replaced[0][0] * (replaced[1][1] * replaced[2][2] - replaced[1][2] * replaced[2][1]) -
+                                     replaced[0][1] * (replaced[1][0] * replaced[2][2] - replaced[1][2] * replaced[2][0]) +
+                                     replaced[0][2] * (replaced[1][0] * replaced[2][1] - replaced[1][1] * replaced[2][0])) /
+                                    determinant;
+            }
+        }
+        return evaluatePoint(point);
+    }
+    double evaluatePoint(const Point& a_point) const {
+        double result = c;
+        uint32_t k = 0;
+        for (uint32_t i = 0; i < k_dimension; ++i) {
+            result += a[k++] * a_point[i] * a_point[i] + 2.0 * b[i] * a_point[i];
+            for (uint32_t j = i + 1; j < k_dimension; ++j) {
+                result += 2.0 * a[k++] * a_point[i] * a_point[j];
+            }
+        }
+        return std::max(result, 0.0) / std::max(weight, 1e-12);
+    }
+    double get(uint32_t a_row, uint32_t a_column) const {
+        const uint32_t i = std::min(a_row, a_column);
+        const uint32_t j = std::max(a_row, a_column);
+        return a[i * k_dimension - i * (i - 1) / 2 + (j - i)];
+    }
+};
+
+// Squared distance to the plane of the triangle in the full space: A = I - e1 e1^T - e2 e2^T for an
+// orthonormal basis e1, e2 of the triangle
+Quadric getTriangleQuadric(const Point& a_p0, const Point& a_p1, const Point& a_p2, double a_weight)
+{
+    Quadric quadric;
+    Point e1, e2;
+    for (uint32_t i = 0; i < k_dimension; ++i) {
+        e1[i] = a_p1[i] - a_p0[i];
+        e2[i] = a_p2[i] - a_p0[i];
+    }
+    const double length1 = std::sqrt(dot(e1, e1));
+    if (length1 <= 0.0) {
+        return quadric;
+    }
+    for (double& value : e1) {
+        value /= length1;
+    }
+    const double projection = dot(e1, e2);
+    for (uint32_t i = 0; i < k_dimension; ++i) {
+        e2[i] -= projection * e1[i];
+    }
+    const double length2 = std::sqrt(dot(e2, e2));
+    if (length2 <= 0.0) {
+        return quadric;
+    }
+    for (double& value : e2) {
+        value /= length2;
+    }
+
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < k_dimension; ++i) {
+        for (uint32_t j = i; j < k_dimension; ++j) {
+            quadric.a[k++] = ((i == j ? 1.0 : 0.0) - e1[i] * e1[j] - e2[i] * e2[j]) * a_weight;
+        }
+    }
+    const double d1 = dot(a_p0, e1);
+    const double d2 = dot(a_p0, e2);
+    for (uint32_t i = 0; i < k_dimension; ++i) {
+        quadric.b[i] = (d1 * e1[i] + d2 * e2[i] - a_p0[i]) * a_weight;
+    }
+    quadric.c = (dot(a_p0, a_p0) - d1 * d1 - d2 * d2) * a_weight;
+    quadric.weight = a_weight;
+    return quadric;
+}
+
+// Squared distance to the plane n.p + d = 0 in the position subspace. Keeps the summed area unchanged
+Quadric getPlaneQuadric(const std::array<double, 3>& a_normal, double a_d, double a_weight)
+{
+    Quadric quadric;
+    uint32_t k = 0;
+    for (uint32_t i = 0; i < k_dimension; ++i) {
+        for (uint32_t j = i; j < k_dimension; ++j) {
+            quadric.a[k++] = i < 3 && j < 3 ? a_normal[i] * a_normal[j] * a_weight : 0.0;
+        }
+    }
+    for (uint32_t i = 0; i < 3; ++i) {
+        quadric.b[i] = a_d * a_normal[i] * a_weight;
+    }
+    quadric.c = a_d * a_d * a_weight;
+    return quadric;
+}
+
+enum class VertexKind : uint8_t {
+    Interior,
+    Border,  // on an open edge, moves along it
+    Locked   // on a non-manifold edge
+};
+
+struct Collapse {
+    float cost;
+    uint32_t from;
+    uint32_t to;
+    uint32_t fromVersion;
+    uint32_t toVersion;
+    bool operator>(const Collapse& a_other) const {
+        return cost > a_other.cost;
+    }
+};
+
+uint64_t getEdgeKey(uint32_t a_v0, uint32_t a_v1) {
+    return static_cast<uint64_t>(std::min(a_v0, a_v1)) << 32 | std::max(a_v0, a_v1);
+}
+
+class Simplifier {
+public:
+    Simplifier(std::span<const MeshStorage::Vertex> a_vertices, std::span<const uint32_t> a_indices,
+               float a_normalWeight);
+    SimplifyResult run(size_t a_targetIndexCount, float a_maxError);
+private:
+    void classifyVertices();
+    void computeQuadrics();
+    void pushCollapse(uint32_t a_from, uint32_t a_to);
+    bool isBorderEdge(uint32_t a_from, uint32_t a_to) const;
+    bool canCollapse(uint32_t a_from, uint32_t a_to);
+    void collapse(uint32_t a_from, uint32_t a_to);
+    void getNeighbours(uint32_t a_vertex, std::vector<uint32_t>& a_neighbours) const;
+
+    std::vector<Point> m_points;  // position relative to the bounds and scaled by 1 / extent, normal * weight
+    double m_extent = 1.0;
+    // Collapses run on the positions: every vertex is welded to the first one with its position, the triangles
+    // index those, and the vertices of the triangle corners pick their attributes when the result is written
+    std::vector<uint32_t> m_welded;
+    std::vector<std::array<uint32_t, 3>> m_corners;
+    std::vector<std::array<uint32_t, 3>> m_triangles;
+    std::vector<bool> m_triangleAlive;
+    size_t m_triangleCount = 0;
+    std::vector<std::vector<uint32_t>> m_vertexTriangles;
+    std::vector<VertexKind> m_kinds;
+    std::vector<Quadric> m_quadrics;
+    std::vector<uint32_t> m_versions;
+    std::vector<bool> m_vertexAlive;
+    std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> m_collapses;
+    std::vector<uint32_t> m_neighbours, m_otherNeighbours;
+};
+
+Simplifier::Simplifier(std::span<const MeshStorage::Vertex> a_vertices, std::span<const uint32_t> a_indices,
+                       float a_normalWeight)
+{
+    assert(a_indices.size() % 3 == 0);
+    std::array<double, 3> boundsMin = { 0, 0, 0 };
+    std::array<double, 3> boundsMax = { 0, 0, 0 };
+    for (size_t i = 0; i < a_vertices.size(); ++i) {
+        const std::array<double, 3> position = { a_vertices[i].position.x, a_vertices[i].position.y,
+                                                 a_vertices[i].position.z };
+        for (uint32_t c = 0; c < 3; ++c) {
+            boundsMin[c] = i == 0 ? position[c] : std::min(boundsMin[c], position[c]);
+            boundsMax[c] = i == 0 ? position[c] : std::max(boundsMax[c], position[c]);
+        }
+    }
+    m_extent = std::max({ boundsMax[0] - boundsMin[0], boundsMax[1] - boundsMin[1], boundsMax[2] - boundsMin[2] });
+    m_extent = m_extent > 0.0 ? m_extent : 1.0;
+
+    m_points.resize(a_vertices.size());
+    for (size_t i = 0; i < a_vertices.size(); ++i) {
+        const MeshStorage::Vertex& vertex = a_vertices[i];
+        const std::array<double, 3> normal = { vertex.normal.x, vertex.normal.y, vertex.normal.z };
+        const double normalLength = length3(normal);
+        const double normalScale = normalLength > 0.0 ? a_normalWeight / normalLength : 0.0;
+        m_points[i] = {
+            (vertex.position.x - boundsMin[0]) / m_extent,
+            (vertex.position.y - boundsMin[1]) / m_extent,
+            (vertex.position.z - boundsMin[2]) / m_extent,
+            normal[0] * normalScale,
+            normal[1] * normalScale,
+            normal[2] * normalScale
+        };
+    }
+
+    std::vector<uint32_t> order(a_vertices.size());
+    for (uint32_t v = 0; v < a_vertices.size(); ++v) {
+        order[v] = v;
+    }
+    const auto position = [this](uint32_t a_vertex) {
+        return std::tie(m_points[a_vertex][0], m_points[a_vertex][1], m_points[a_vertex][2]);
+    };
+    std::sort(order.begin(), order.end(), [&](uint32_t a_left, uint32_t a_right) {
+        return position(a_left) < position(a_right) || (position(a_left) == position(a_right) && a_left < a_right);
+    });
+    m_welded.resize(a_vertices.size());
+    for (size_t i = 0; i < order.size(); ++i) {
+        const bool sameAsPrevious = i > 0 && position(order[i - 1]) == position(order[i]);
+        m_welded[order[i]] = sameAsPrevious ? m_welded[order[i - 1]] : order[i];
+    }
+
+    m_vertexTriangles.resize(a_vertices.size());
+    for (size_t i = 0; i < a_indices.size(); i += 3) {
+        const std::array<uint32_t, 3> corners = { a_indices[i], a_indices[i + 1], a_indices[i + 2] };
+        const std::array<uint32_t, 3> triangle = { m_welded[corners[0]], m_welded[corners[1]], m_welded[corners[2]] };
+        if (triangle[0] == triangle[1] || triangle[1] == triangle[2] || triangle[0] == triangle[2]) {
+            continue;
+        }
+        for (const uint32_t v : triangle) {
+            m_vertexTriangles[v].push_back(static_cast<uint32_t>(m_triangles.size()));
+        }
+        m_triangles.push_back(triangle);
+        m_corners.push_back(corners);
+    }
+    m_triangleAlive.assign(m_triangles.size(), true);
+    m_triangleCount = m_triangles.size();
+    m_versions.assign(a_vertices.size(), 0);
+    m_vertexAlive.assign(a_vertices.size(), true);
+
+    classifyVertices();
+    computeQuadrics();
+}
+
+void Simplifier::classifyVertices()
+{
+    m_kinds.assign(m_points.size(), VertexKind::Interior);
+
+    std::unordered_map<uint64_t, uint32_t> edgeTriangles;
+    for (const auto& triangle : m_triangles) {
+        for (uint32_t k = 0; k < 3; ++k) {
+            ++edgeTriangles[getEdgeKey(triangle[k], triangle[(k + 1) % 3])];
+        }
+    }
+    for (const auto& [key, count] : edgeTriangles) {
+        if (count == 2) {
+            continue;
+        }
+        for (const uint32_t v : { static_cast<uint32_t>(key >> 32), static_cast<uint32_t>(key) }) {
+            if (count > 2) {
+                m_kinds[v] = VertexKind::Locked;
+            } else if (m_kinds[v] == VertexKind::Interior) {
+                m_kinds[v] = VertexKind::Border;
+            }
+        }
+    }
+}
+
+void Simplifier::computeQuadrics()
+{
+    m_quadrics.assign(m_points.size(), {});
+    for (size_t t = 0; t < m_triangles.size(); ++t) {
+        const auto& triangle = m_triangles[t];
+        // The normals of the corners, the quadric of a welded vertex sees all the normals around it
+        const Point& p0 = m_points[m_corners[t][0]];
+        const Point& p1 = m_points[m_corners[t][1]];
+        const Point& p2 = m_points[m_corners[t][2]];
+        const std::array<double, 3> normal = cross(subtract3(p1, p0), subtract3(p2, p0));
+        const double area = 0.5 * length3(normal);
+        const Quadric quadric = getTriangleQuadric(p0, p1, p2, area);
+        for (const uint32_t v : triangle) {
+            m_quadrics[v].add(quadric);
+        }
+
+        // Open edges get the plane through them perpendicular to the triangle
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t v0 = triangle[k];
+            const uint32_t v1 = triangle[(k + 1) % 3];
+            if (!isBorderEdge(v0, v1)) {
+                continue;
+            }
+            const std::array<double, 3> edge = subtract3(m_points[v1], m_points[v0]);
+            std::array<double, 3> planeNormal = cross(edge, normal);
+            const double planeLength = length3(planeNormal);
+            if (planeLength <= 0.0) {
+                continue;
+            }
+            for (double& value : planeNormal) {
+                value /= planeLength;
+            }
+            const Point& origin = m_points[v0];
+            const double d = -(planeNormal[0] * origin[0] + planeNormal[1] * origin[1] + planeNormal[2] * origin[2]);
+            const double edgeLength = length3(edge);
+            const Quadric plane = getPlaneQuadric(planeNormal, d, k_boundaryWeight * edgeLength * edgeLength);
+            m_quadrics[v0].add(plane);
+            m_quadrics[v1].add(plane);
+        }
+    }
+}
+
+bool Simplifier::isBorderEdge(uint32_t a_from, uint32_t a_to) const
+{
+    uint32_t shared = 0;
+    for (const uint32_t t : m_vertexTriangles[a_from]) {
+        const auto& triangle = m_triangles[t];
+        shared += m_triangleAlive[t] && (triangle[0] == a_to || triangle[1] == a_to || triangle[2] == a_to);
+    }
+    return shared == 1;
+}
+
+void Simplifier::pushCollapse(uint32_t a_from, uint32_t a_to)
+{
+    const VertexKind kind = m_kinds[a_from];
+    if (kind == VertexKind::Locked || (kind == VertexKind::Border && !isBorderEdge(a_from, a_to))) {
+        return;
+    }
+    Quadric quadric = m_quadrics[a_from];
+    quadric.add(m_quadrics[a_to]);
+    m_collapses.push({
+        .cost = static_cast<float>(quadric.evaluate({ m_points[a_to][0], m_points[a_to][1], m_points[a_to][2] })),
+        .from = a_from,
+        .to = a_to,
+        .fromVersion = m_versions[a_from],
+        .toVersion = m_versions[a_to]
+    });
+}
+
+void Simplifier::getNeighbours(uint32_t a_vertex, std::vector<uint32_t>& a_neighbours) const
+{
+    a_neighbours.clear();
+    for (const uint32_t t : m_vertexTriangles[a_vertex]) {
+        if (!m_triangleAlive[t]) {
+            continue;
+        }
+        for (const uint32_t v : m_triangles[t]) {
+            if (v != a_vertex) {
+                a_neighbours.push_back(v);
+            }
+        }
+    }
+    std::sort(a_neighbours.begin(), a_neighbours.end());
+    a_neighbours.erase(std::unique(a_neighbours.begin(), a_neighbours.end()), a_neighbours.end());
+}
+
+bool Simplifier::canCollapse(uint32_t a_from, uint32_t a_to)
+{
+    // Link condition: the vertices adjacent to both are the ones opposite to the shared edge, otherwise
+    // the collapse pinches the surface
+    uint32_t sharedTriangles = 0;
+    for (const uint32_t t : m_vertexTriangles[a_from]) {
+        const auto& triangle = m_triangles[t];
+        sharedTriangles += m_triangleAlive[t] && (triangle[0] == a_to || triangle[1] == a_to || triangle[2] == a_to);
+    }
+    getNeighbours(a_from, m_neighbours);
+    getNeighbours(a_to, m_otherNeighbours);
+    uint32_t commonNeighbours = 0;
+    for (const uint32_t v : m_neighbours) {
+        commonNeighbours += std::binary_search(m_otherNeighbours.begin(), m_otherNeighbours.end(), v);
+    }
+    if (commonNeighbours != sharedTriangles) {
+        return false;
+    }
+
+    // No remaining triangle may flip or become degenerate
+    for (const uint32_t t : m_vertexTriangles[a_from]) {
+        const auto& triangle = m_triangles[t];
+        if (!m_triangleAlive[t] || triangle[0] == a_to || triangle[1] == a_to || triangle[2] == a_to) {
+            continue;
+        }
+        std::array<Point, 3> before, after;
+        for (uint32_t k = 0; k < 3; ++k) {
+            before[k] = m_points[triangle[k]];
+            after[k] = m_points[triangle[k] == a_from ? a_to : triangle[k]];
+        }
+        const std::array<double, 3> normalBefore = cross(subtract3(before[1], before[0]), subtract3(before[2], before[0]));
+        const std::array<double, 3> normalAfter = cross(subtract3(after[1], after[0]), subtract3(after[2], after[0]));
+        const double cosine = normalBefore[0] * normalAfter[0] + normalBefore[1] * normalAfter[1] +
+                              normalBefore[2] * normalAfter[2];
+        if (cosine <= 0.25 * length3(normalBefore) * length3(normalAfter) || length3(normalAfter) <= 1e-12) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void Simplifier::collapse(uint32_t a_from, uint32_t a_to)
+{
+    std::vector<uint32_t>& toTriangles = m_vertexTriangles[a_to];
+    for (const uint32_t t : m_vertexTriangles[a_from]) {
+        if (!m_triangleAlive[t]) {
+            continue;
+        }
+        auto& triangle = m_triangles[t];
+        if (triangle[0] == a_to || triangle[1] == a_to || triangle[2] == a_to) {
+            m_triangleAlive[t] = false;
+            --m_triangleCount;
+            continue;
+        }
+        for (uint32_t& v : triangle) {
+            v = v == a_from ? a_to : v;
+        }
+        toTriangles.push_back(t);
+    }
+    std::erase_if(toTriangles, [this](uint32_t a_triangle) { return !m_triangleAlive[a_triangle]; });
+    m_vertexTriangles[a_from].clear();
+    m_vertexAlive[a_from] = false;
+    m_quadrics[a_to].add(m_quadrics[a_from]);
+    ++m_versions[a_to];
+
+    getNeighbours(a_to, m_otherNeighbours);
+    const std::vector<uint32_t> neighbours = m_otherNeighbours;
+    for (const uint32_t v : neighbours) {
+        pushCollapse(a_to, v);
+        pushCollapse(v, a_to);
+    }
+}
+
+SimplifyResult Simplifier::run(size_t a_targetIndexCount, float a_maxError)
+{
+    for (uint32_t v = 0; v < m_points.size(); ++v) {
+        if (m_welded[v] != v) {
+            continue;
+        }
+        getNeighbours(v, m_neighbours);
+        for (const uint32_t neighbour : m_neighbours) {
+            pushCollapse(v, neighbour);
+        }
+    }
+
+    const double relativeMaxError = a_maxError / m_extent;
+    const double maxCost = relativeMaxError * relativeMaxError;
+    double error = 0.0;
+    while (m_triangleCount * 3 > a_targetIndexCount && !m_collapses.empty()) {
+        const Collapse candidate = m_collapses.top();
+        m_collapses.pop();
+        if (!m_vertexAlive[candidate.from] || !m_vertexAlive[candidate.to] ||
+            m_versions[candidate.from] != candidate.fromVersion || m_versions[candidate.to] != candidate.toVersion) {
+            continue;
+        }
+        if (candidate.cost > maxCost) {
+            break;
+        }
+        if (!canCollapse(candidate.from, candidate.to)) {
+            continue;
+        }
+        collapse(candidate.from, candidate.to);
+        error = std::max(error, static_cast<double>(candidate.cost));
+    }
+
+    // A corner keeps its vertex while its position stays, a moved one takes the vertex at the new position
+    // with the closest normal
+    std::vector<uint32_t> groupOffsets(m_points.size() + 1, 0);
+    for (const uint32_t welded : m_welded) {
+        ++groupOffsets[welded + 1];
+    }
+    for (size_t v = 0; v < m_points.size(); ++v) {
+        groupOffsets[v + 1] += groupOffsets[v];
+    }
+    std::vector<uint32_t> groups(m_points.size());
+    std::vector<uint32_t> cursor(groupOffsets.begin(), groupOffsets.end() - 1);
+    for (uint32_t v = 0; v < m_points.size(); ++v) {
+        groups[cursor[m_welded[v]]++] = v;
+    }
+
+    SimplifyResult result;
+    result.indices.reserve(m_triangleCount * 3);
+    for (size_t t = 0; t < m_triangles.size(); ++t) {
+        if (!m_triangleAlive[t]) {
+            continue;
+        }
+        for (uint32_t k = 0; k < 3; ++k) {
+            const uint32_t welded = m_triangles[t][k];
+            const uint32_t corner = m_corners[t][k];
+            uint32_t vertex = corner;
+            if (m_welded[corner] != welded) {
+                const Point& normal = m_points[corner];
+                double bestCosine = -1e30;
+                for (uint32_t i = groupOffsets[welded]; i < groupOffsets[welded + 1]; ++i) {
+                    const Point& candidate = m_points[groups[i]];
+                    const double cosine = normal[3] * candidate[3] + normal[4] * candidate[4] + normal[5] * candidate[5];
+                    if (cosine > bestCosine) {
+                        bestCosine = cosine;
+                        vertex = groups[i];
+                    }
+                }
+            }
+            result.indices.push_back(vertex);
+        }
+    }
+    result.error = static_cast<float>(std::sqrt(error) * m_extent);
+    return result;
+}
+}  // anonymous namespace
+
+SimplifyResult simplifyMesh(std::span<const MeshStorage::Vertex> a_vertices, std::span<const uint32_t> a_indices,
+                            size_t a_targetIndexCount, float a_maxError, float a_normalWeight)
+{
+    Simplifier simplifier(a_vertices, a_indices, a_normalWeight);
+    return simplifier.run(a_targetIndexCount, a_maxError);
+}
+}
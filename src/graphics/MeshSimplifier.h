@@ -0,0 +1,24 @@
+#pragma once
+#include "MeshStorage.h"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace neural::graphics {
+
+struct SimplifyResult {
+    std::vector<uint32_t> indices;  // into the same vertices
+    float error = 0.0f;             // largest collapse error, in the units of the positions
+};
+
+// Quadric error edge collapse (Garland, Heckbert 1998) with the normal as an attribute: every triangle adds
+// the quadric of its plane in (position, normal * a_normalWeight) space, so a collapse costs the squared
+// distance to the planes of the surface it replaces, with normals weighed as a_normalWeight times the mesh
+// extent. Vertices collapse onto a neighbour, so no vertex changes and the result indexes the input vertices.
+// Boundaries are kept: open edges add perpendicular planes and only collapse along themselves, vertices
+// on attribute seams and non-manifold edges don't move. Stops at a_targetIndexCount or when the next
+// collapse would exceed a_maxError
+SimplifyResult simplifyMesh(std::span<const MeshStorage::Vertex> a_vertices, std::span<const uint32_t> a_indices,
+                            size_t a_targetIndexCount, float a_maxError, float a_normalWeight = 0.5f);
+}
@@ -0,0 +1,284 @@
+#include "MeshStorage.h"
+#include "MeshCache.h"
+#include "MeshLod.h"
+#include "MeshOptimizer.h"
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <iostream>
+#include <utils/TaskScheduler.h>
+
+namespace neural::graphics {
+using DirectX::XMMATRIX;
+using DirectX::XMFLOAT3;
+using DirectX::XMMatrixScaling;
+using DirectX::XMMatrixMultiply;
+using DirectX::XMMatrixRotationRollPitchYaw;
+
+namespace {
+XMMATRIX getTransformMatrix(MeshTransform a_transform) {
+    XMMATRIX scalingMatrix = XMMatrixScaling(a_transform.scale, a_transform.scale, a_transform.scale);
+    XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw(DirectX::XMConvertToRadians(a_transform.rotation.y),
+                                                           DirectX::XMConvertToRadians(a_transform.rotation.x),
+                                                           DirectX::XMConvertToRadians(a_transform.rotation.z));
+    return XMMatrixMultiply(scalingMatrix, rotationMatrix);
+}
+
+XMFLOAT3 transformFloat3(XMFLOAT3 a_vector, DirectX::FXMMATRIX a_matrix) {
+    XMFLOAT3 result;
+    DirectX::XMStoreFloat3(&result, DirectX::XMVector3Transform(DirectX::XMLoadFloat3(&a_vector), a_matrix));
+    return result;
+}
+
+void computeBounds(std::span<const MeshStorage::Vertex> a_vertices, MeshStorage::MeshInfo& a_meshInfo) {
+    a_meshInfo.boundsMin = a_vertices.empty() ? XMFLOAT3{ 0, 0, 0 } : a_vertices[0].position;
+    a_meshInfo.boundsMax = a_meshInfo.boundsMin;
+    for (const MeshStorage::Vertex& vertex : a_vertices) {
+        XMFLOAT3& boundsMin = a_meshInfo.boundsMin;
+        XMFLOAT3& boundsMax = a_meshInfo.boundsMax;
+        boundsMin = { std::min(boundsMin.x, vertex.position.x), std::min(boundsMin.y, vertex.position.y),
+                      std::min(boundsMin.z, vertex.position.z) };
+        boundsMax = { std::max(boundsMax.x, vertex.position.x), std::max(boundsMax.y, vertex.position.y),
+                      std::max(boundsMax.z, vertex.position.z) };
+    }
+}
+}  // anonymous namespace
+
+void MeshStorage::loadMesh(const char* a_meshName, const std::vector<Vertex>& a_vertices,
+                           const std::vector<uint32_t>& a_indices, MeshTransform a_transform)
+{
+    const XMMATRIX transformMatrix = getTransformMatrix(a_transform);
+
+    MeshInfo meshInfo;
+    meshInfo.startVertex = m_vertices.size();
+    for (int i = 0; i < a_vertices.size(); ++i) {
+        XMFLOAT3 position =
+            transformFloat3(a_vertices[i].position, transformMatrix);
+        XMFLOAT3 normal =
+            transformFloat3(a_vertices[i].normal, transformMatrix);
+
+        m_vertices.push_back({
+            { position.x, position.y, position.z },
+            { normal.x, normal.y,  normal.z },
+            { 1, 1}
+            });
+    }
+    meshInfo.vertexCount = m_vertices.size() - meshInfo.startVertex;
+
+    meshInfo.startIndex = m_indices.size();
+    for (int i = 0; i < a_indices.size(); ++i) {
+        m_indices.push_back(a_indices[i]);
+    }
+    meshInfo.indexCount = m_indices.size() - meshInfo.startIndex;
+    meshInfo.lods = { { .startIndex = meshInfo.startIndex, .indexCount = meshInfo.indexCount, .error = 0.0f } };
+    computeBounds({ m_vertices.data() + meshInfo.startVertex, meshInfo.vertexCount }, meshInfo);
+    m_meshes[a_meshName] = meshInfo;
+    m_meshStates[a_meshName] = MeshState::Ready;
+}
+void MeshStorage::loadMeshFromFile(const char* a_meshName, const char* a_path, MeshTransform a_transform) {
+    const MeshFile file = { a_meshName, a_path, a_transform };
+    loadMeshesFromFiles({ &file, 1 });
+}
+void MeshStorage::loadMeshesFromFiles(std::span<const MeshFile> a_files) {
+    loadMeshesFromFilesAsync(a_files);
+    waitForMeshes();
+}
+void MeshStorage::loadMeshesFromFilesAsync(std::span<const MeshFile> a_files) {
+    if (m_pendingImports.empty()) {
+        m_loadStart = std::chrono::steady_clock::now();
+        m_loadedCount = 0;
+        m_cachedCount = 0;
+    }
+    for (const MeshFile& file : a_files) {
+        auto mesh = std::make_unique<ImportedMesh>();
+        // The task owns copies of the arguments, a_files may be gone when it runs
+        utils::TaskScheduler::TaskHandle task = utils::getTaskScheduler().submit(
+            [mesh = mesh.get(), path = std::string(file.path), transform = file.transform]() {
+                *mesh = importMesh(path, transform);
+            });
+        m_meshStates[file.meshName] = MeshState::Loading;
+        m_pendingImports.push_back({ .meshName = file.meshName, .task = std::move(task), .mesh = std::move(mesh) });
+    }
+}
+std::vector<std::string> MeshStorage::addFinishedMeshes() {
+    std::vector<std::string> added;
+    // In order, so the arrays don't depend on which import finishes first
+    size_t finished = 0;
+    while (finished < m_pendingImports.size() &&
+           utils::getTaskScheduler().isFinished(m_pendingImports[finished].task)) {
+        PendingImport& pending = m_pendingImports[finished++];
+        if (pending.mesh->lods.empty()) {
+            m_meshStates[pending.meshName] = MeshState::Failed;
+            continue;
+        }
+        addMesh(pending.meshName.c_str(), *pending.mesh);
+        ++m_loadedCount;
+        m_cachedCount += pending.mesh->fromCache;
+        added.push_back(std::move(pending.meshName));
+    }
+    m_pendingImports.erase(m_pendingImports.begin(), m_pendingImports.begin() + finished);
+    if (finished > 0 && m_pendingImports.empty()) {
+        const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_loadStart;
+        std::cout << "Loaded " << m_loadedCount << " meshes, " << m_cachedCount << " from the cache, in "
+                  << elapsed.count() << " ms\n";
+    }
+    return added;
+}
+std::vector<std::string> MeshStorage::waitForMeshes() {
+    for (const PendingImport& pending : m_pendingImports) {
+        utils::getTaskScheduler().wait(pending.task);
+    }
+    return addFinishedMeshes();
+}
+MeshStorage::MeshState MeshStorage::getMeshState(const char* a_meshName) const {
+    const auto it = m_meshStates.find(a_meshName);
+    return it != m_meshStates.end() ? it->second : MeshState::Unknown;
+}
+namespace {
+const MeshStorage::MeshFile k_defaultMeshFiles[] = {
+    { "cat",  RESOURCES"/models/Cat_Sitting.fbx", { .rotation = {90, -90, 0}, .scale = 0.5 } },
+    { "bird", RESOURCES"/models/Bird.obj",        { .rotation = {0, 0, 0},    .scale = 0.2 } }
+};
+}  // anonymous namespace
+void MeshStorage::loadDefaultMeshes() {
+    loadDefaultMeshesAsync();
+    waitForMeshes();
+}
+void MeshStorage::loadDefaultMeshesAsync() {
+    loadMeshesFromFilesAsync(k_defaultMeshFiles);
+    std::vector<Vertex> planeVertices = {
+        {{-1, 0, 1}, {0, 1, 0}, {0,0}},
+        {{1, 0, 1}, {0, 1, 0}, {0,0}},
+        {{-1, 0, -1}, {0, 1, 0}, {0,0}},
+        {{1, 0, -1}, {0, 1, 0}, {0,0}},
+    };
+    std::vector<uint32_t> planeIndices = {
+        0, 1, 2,  1, 3, 2
+    };
+    loadMesh("flat", planeVertices, planeIndices, { .scale = 100 });
+}
+// Runs on worker threads, every call has its own importer and cache file
+MeshStorage::ImportedMesh MeshStorage::importMesh(const std::string& a_path, MeshTransform a_transform) {
+    const std::string cacheDirectory = CACHE_ROOT "/meshes";
+    const std::string cacheKey = getMeshCacheKey(a_path.c_str(), a_transform);
+    ImportedMesh imported;
+    if (readMeshCache(cacheDirectory, cacheKey, imported.vertices, imported.indices, imported.lods)) {
+        imported.fromCache = true;
+        return imported;
+    }
+
+    Assimp::Importer assetImporter;
+    const aiScene* scene = assetImporter.ReadFile(a_path,
+        aiProcess_Triangulate | aiProcess_JoinIdenticalVertices | aiProcess_GenSmoothNormals);
+    if (!scene || !scene->mRootNode) {
+        std::cout << a_path << ": " << assetImporter.GetErrorString() << "\n";
+        return imported;
+    }
+
+    // Every node that references a mesh places one copy of it. The placements are relative to the first one,
+    // so a file with a single mesh keeps its own coordinates, as a_transform expects
+    std::vector<std::pair<const aiNode*, aiMatrix4x4>> nodes = { { scene->mRootNode, scene->mRootNode->mTransformation } };
+    std::vector<std::pair<const aiMesh*, aiMatrix4x4>> placements;
+    while (!nodes.empty()) {
+        const auto [node, nodeTransform] = nodes.back();
+        nodes.pop_back();
+        for (uint32_t i = 0; i < node->mNumMeshes; ++i) {
+            placements.emplace_back(scene->mMeshes[node->mMeshes[i]], nodeTransform);
+        }
+        for (uint32_t i = node->mNumChildren; i-- > 0;) {
+            nodes.emplace_back(node->mChildren[i], nodeTransform * node->mChildren[i]->mTransformation);
+        }
+    }
+    if (placements.empty()) {
+        std::cout << a_path << ": no meshes\n";
+        return imported;
+    }
+    const aiMatrix4x4 toFirstPlacement = aiMatrix4x4(placements[0].second).Inverse();
+
+    const XMMATRIX transformMatrix = getTransformMatrix(a_transform);
+    size_t skippedFaces = 0;
+    for (const auto& [mesh, placement] : placements) {
+        const aiMatrix4x4 positionMatrix = toFirstPlacement * placement;
+        const aiMatrix3x3 normalMatrix = aiMatrix3x3(positionMatrix).Inverse().Transpose();
+        const uint32_t baseVertex = static_cast<uint32_t>(imported.vertices.size());
+        imported.vertices.reserve(imported.vertices.size() + mesh->mNumVertices);
+        for (uint32_t i = 0; i < mesh->mNumVertices; ++i) {
+            const aiVector3D meshPosition = positionMatrix * mesh->mVertices[i];
+            const aiVector3D meshNormal = mesh->HasNormals() ? (normalMatrix * mesh->mNormals[i]).Normalize()
+                                                             : aiVector3D(0, 1, 0);
+            XMFLOAT3 position =
+                transformFloat3({ meshPosition.x, meshPosition.y, meshPosition.z }, transformMatrix);
+            XMFLOAT3 normal =
+                transformFloat3({ meshNormal.x, meshNormal.y, meshNormal.z }, transformMatrix);
+
+            imported.vertices.push_back({
+                { position.x, position.y, position.z },
+                { normal.x, normal.y,  normal.z },
+                { 1, 1}
+                });
+        }
+
+        // Triangulation leaves points and lines as they are
+        imported.indices.reserve(imported.indices.size() + mesh->mNumFaces * 3);
+        for (uint32_t i = 0; i < mesh->mNumFaces; ++i) {
+            const aiFace& face = mesh->mFaces[i];
+            if (face.mNumIndices != 3) {
+                ++skippedFaces;
+                continue;
+            }
+            imported.indices.push_back(baseVertex + face.mIndices[0]);
+            imported.indices.push_back(baseVertex + face.mIndices[1]);
+            imported.indices.push_back(baseVertex + face.mIndices[2]);
+        }
+    }
+    if (skippedFaces > 0) {
+        std::cout << a_path << ": skipped " << skippedFaces << " points and lines\n";
+    }
+    if (imported.indices.empty()) {
+        std::cout << a_path << ": no triangles\n";
+        return imported;
+    }
+    if (placements.size() > 1) {
+        std::cout << a_path << ": merged " << placements.size() << " submeshes\n";
+    }
+    const VertexCacheStatistics before = analyzeVertexCache(imported.indices, imported.vertices.size());
+    optimizeMesh(imported.vertices, imported.indices);
+    const VertexCacheStatistics after = analyzeVertexCache(imported.indices, imported.vertices.size());
+    std::cout << a_path << ": ACMR " << before.acmr << " -> " << after.acmr
+              << ", ATVR " << before.atvr << " -> " << after.atvr << "\n";
+
+    imported.lods = buildMeshLods(imported.vertices, imported.indices);
+    std::cout << a_path << ": LOD triangles";
+    for (const MeshLod& lod : imported.lods) {
+        std::cout << " " << lod.indexCount / 3;
+    }
+    std::cout << "\n";
+
+    if (!writeMeshCache(cacheDirectory, cacheKey, imported.vertices, imported.indices, imported.lods)) {
+        std::cout << a_path << ": can't write the mesh cache\n";
+    }
+    return imported;
+}
+void MeshStorage::addMesh(const char* a_meshName, const ImportedMesh& a_mesh) {
+    MeshInfo meshInfo;
+    meshInfo.startVertex = m_vertices.size();
+    meshInfo.vertexCount = a_mesh.vertices.size();
+    m_vertices.insert(m_vertices.end(), a_mesh.vertices.begin(), a_mesh.vertices.end());
+
+    meshInfo.startIndex = m_indices.size();
+    meshInfo.indexCount = a_mesh.lods[0].indexCount;
+    meshInfo.lods = a_mesh.lods;
+    for (MeshLod& lod : meshInfo.lods) {
+        lod.startIndex += m_indices.size();
+    }
+    m_indices.insert(m_indices.end(), a_mesh.indices.begin(), a_mesh.indices.end());
+    computeBounds(a_mesh.vertices, meshInfo);
+    m_meshes[a_meshName] = meshInfo;
+    m_meshStates[a_meshName] = MeshState::Ready;
+}
+}
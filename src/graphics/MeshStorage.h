@@ -0,0 +1,111 @@
+#pragma once
+#include <utils/VectorMath.h>
+#include <utils/TaskScheduler.h>
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace neural::graphics {
+// Applied to the vertices when a mesh is added. Outside of MeshStorage, GCC can't use the member initializers
+// of a nested struct in default arguments of the enclosing class
+struct MeshTransform {
+    DirectX::XMFLOAT3 rotation = { 0, 0, 0 };  // degrees
+    float scale = 1.0f;
+};
+
+// Meshes of the scene packed into one vertex and one index array. Doesn't depend on the graphics API,
+// SceneManager uploads it for D3D12 and the CPU rasterizer draws from it directly
+class MeshStorage {
+public:
+    struct Vertex {
+        DirectX::XMFLOAT3 position;
+        DirectX::XMFLOAT3 normal;
+        DirectX::XMFLOAT2 textureCoordinates;
+    };
+    struct MeshLod {
+        size_t startIndex;
+        size_t indexCount;
+        float error;  // deviation from the full mesh in the units of the positions, see MeshLod.h
+    };
+    struct MeshInfo {
+        size_t startVertex;
+        size_t vertexCount;
+        size_t startIndex;
+        size_t indexCount;
+        DirectX::XMFLOAT3 boundsMin;  // of the positions
+        DirectX::XMFLOAT3 boundsMax;
+        std::vector<MeshLod> lods;  // lods[0] is the full mesh, startIndex and indexCount
+    };
+    struct MeshFile {
+        const char* meshName;
+        const char* path;
+        MeshTransform transform = {};
+    };
+    enum class MeshState {
+        Unknown,  // never loaded
+        Loading,  // imported on the task scheduler
+        Ready,    // in the vertex and index arrays
+        Failed    // the file couldn't be imported
+    };
+    void loadMesh(const char* a_meshName, const std::vector<Vertex>& a_vertices,
+                  const std::vector<uint32_t>& a_indices,
+                  MeshTransform a_transform = {});
+    void loadMeshFromFile(const char* a_meshName, const char* a_path, MeshTransform a_transform = {});
+    // Files are imported in parallel on the task scheduler, meshes are added in the order of a_files.
+    // Every submesh of a file goes into its mesh. Imports get LOD chains and are cached in
+    // CACHE_ROOT "/meshes", see MeshLod.h and MeshCache.h
+    void loadMeshesFromFiles(std::span<const MeshFile> a_files);
+    // Starts the imports and returns, the meshes stay Loading until addFinishedMeshes takes them
+    void loadMeshesFromFilesAsync(std::span<const MeshFile> a_files);
+    // Adds the imports that finished since the last call, in the order they were started, and returns
+    // their names. Only the thread that owns the storage touches the arrays, so it doesn't lock
+    std::vector<std::string> addFinishedMeshes();
+    // Helps the task scheduler until every import is finished, then adds them
+    std::vector<std::string> waitForMeshes();
+    // "cat", "bird" and the "flat" floor, the scene every render engine shows. The async version adds
+    // the floor at once and imports the files in the background
+    void loadDefaultMeshes();
+    void loadDefaultMeshesAsync();
+
+    MeshState getMeshState(const char* a_meshName) const;
+    const MeshInfo& getMeshInfo(const char* a_meshName) const {
+        return m_meshes.at(a_meshName);
+    }
+    const std::vector<Vertex>& getVertices() const {
+        return m_vertices;
+    }
+    const std::vector<uint32_t>& getIndices() const {
+        return m_indices;
+    }
+protected:
+    std::unordered_map<std::string, MeshInfo> m_meshes;
+    std::vector<Vertex> m_vertices;
+    std::vector<uint32_t> m_indices;
+private:
+    struct ImportedMesh {
+        std::vector<Vertex> vertices;
+        std::vector<uint32_t> indices;  // all the LODs
+        std::vector<MeshLod> lods;      // startIndex in indices, empty if the import failed
+        bool fromCache = false;
+    };
+    struct PendingImport {
+        std::string meshName;
+        utils::TaskScheduler::TaskHandle task;
+        std::unique_ptr<ImportedMesh> mesh;  // written by the task
+    };
+    static ImportedMesh importMesh(const std::string& a_path, MeshTransform a_transform);
+    void addMesh(const char* a_meshName, const ImportedMesh& a_mesh);
+
+    std::vector<PendingImport> m_pendingImports;
+    std::unordered_map<std::string, MeshState> m_meshStates;
+    // For the log line once the imports started together are all added
+    std::chrono::steady_clock::time_point m_loadStart;
+    size_t m_loadedCount = 0;
+    size_t m_cachedCount = 0;
+};
+}
@@ -0,0 +1,33 @@
+#include "NullRenderGraphBackend.h"
+
+namespace neural::graphics {
+
+RenderGraphMemoryRequirements NullRenderGraphBackend::getMemoryRequirements(const RenderGraphResourceDesc& a_desc,
+                                                                            RenderGraphState)
+{
+    const uint64_t size = a_desc.type == RenderGraphResourceType::Buffer ? a_desc.width
+                                                                          : a_desc.width * a_desc.height * 16;
+    return { .size = (size + k_alignment - 1) / k_alignment * k_alignment, .alignment = k_alignment };
+}
+
+void NullRenderGraphBackend::placeTransientResources(const RenderGraph&, uint64_t a_memorySize,
+                                                     std::span<const RenderGraphPlacement> a_placements)
+{
+    m_memorySize = a_memorySize;
+    m_placements.assign(a_placements.begin(), a_placements.end());
+}
+
+void NullRenderGraphBackend::recordBarriers(const RenderGraph& a_graph, std::span<const RenderGraphBarrier> a_barriers)
+{
+    for (const RenderGraphBarrier& barrier : a_barriers) {
+        m_barriers.push_back({ .resourceName = a_graph.getResourceName(barrier.resource), .barrier = barrier });
+    }
+}
+
+void NullRenderGraphBackend::clear()
+{
+    m_memorySize = 0;
+    m_placements.clear();
+    m_barriers.clear();
+}
+}
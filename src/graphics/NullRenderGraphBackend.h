@@ -0,0 +1,42 @@
+#pragma once
+#include "RenderGraph.h"
+
+#include <string>
+#include <vector>
+
+namespace neural::graphics {
+
+// Render graph backend without a GPU: sizes resources like a 16-byte-per-pixel texture in 64 KiB pages and
+// records what the graph asks for, to check the compiled barriers and placements
+class NullRenderGraphBackend : public IRenderGraphBackend {
+public:
+    static constexpr uint64_t k_alignment = 64 * 1024;
+
+    struct RecordedBarrier {
+        std::string resourceName;
+        RenderGraphBarrier barrier;
+    };
+
+    RenderGraphMemoryRequirements getMemoryRequirements(const RenderGraphResourceDesc& a_desc,
+                                                        RenderGraphState a_usage) override;
+    void placeTransientResources(const RenderGraph& a_graph, uint64_t a_memorySize,
+                                 std::span<const RenderGraphPlacement> a_placements) override;
+    void recordBarriers(const RenderGraph& a_graph, std::span<const RenderGraphBarrier> a_barriers) override;
+
+    void clear();
+    uint64_t getMemorySize() const {
+        return m_memorySize;
+    }
+    const std::vector<RenderGraphPlacement>& getPlacements() const {
+        return m_placements;
+    }
+    // In recording order
+    const std::vector<RecordedBarrier>& getBarriers() const {
+        return m_barriers;
+    }
+private:
+    uint64_t m_memorySize = 0;
+    std::vector<RenderGraphPlacement> m_placements;
+    std::vector<RecordedBarrier> m_barriers;
+};
+}
@@ -0,0 +1,225 @@
+#include "PipelineCache.h"
+#include <utils/MappedFile.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+
+namespace neural::graphics {
+
+namespace {
+constexpr uint32_t k_pipelineCacheMagic = 0x4F53504E;  // "NPSO"
+constexpr uint32_t k_pipelineCacheVersion = 1;
+
+struct PipelineCacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t keySize;
+    uint32_t blobSize;
+};
+
+// FNV-1a
+uint64_t hashBytes(const void* a_data, size_t a_size)
+{
+    const uint8_t* bytes = static_cast<const uint8_t*>(a_data);
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (size_t i = 0; i < a_size; ++i) {
+        hash = (hash ^ bytes[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+std::string getCachePath(const std::string& a_directory, const std::string& a_key)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "/%016llx.pso",
+                  static_cast<unsigned long long>(hashBytes(a_key.data(), a_key.size())));
+    return a_directory + name;
+}
+
+bool readShader(const std::string& a_path, std::vector<char>& a_bytecode)
+{
+    utils::MappedFile file;
+    if (!file.open(a_path)) {
+        return false;
+    }
+    a_bytecode.assign(file.getData(), file.getData() + file.getSize());
+    return true;
+}
+}  // anonymous namespace
+
+struct PipelineCache::Job {
+    std::vector<std::string> shaderPaths;
+    std::string state;
+    CompileFunction compile;
+    utils::TaskScheduler::TaskHandle task = nullptr;
+    Pipeline pipeline = nullptr;  // written by the task
+};
+
+PipelineCache::~PipelineCache()
+{
+    // Not under m_mutex, the jobs take it
+    for (const Handle& job : m_jobs) {
+        utils::getTaskScheduler().wait(job->task);
+    }
+}
+
+void PipelineCache::initialize(std::string a_directory)
+{
+    m_directory = std::move(a_directory);
+}
+
+PipelineCache::Handle PipelineCache::request(std::vector<std::string> a_shaderPaths, std::string a_state,
+                                             CompileFunction a_compile)
+{
+    assert(a_compile);
+    ++m_requests;
+    Handle job = std::make_shared<Job>(Job{
+        .shaderPaths = std::move(a_shaderPaths),
+        .state = std::move(a_state),
+        .compile = std::move(a_compile)
+    });
+    utils::TaskScheduler& scheduler = utils::getTaskScheduler();
+    job->task = scheduler.submit([this, rawJob = job.get()]() {
+        run(*rawJob);
+    });
+    // The finished jobs are only kept by their handles
+    std::lock_guard lock(m_mutex);
+    std::erase_if(m_jobs, [&](const Handle& a_job) {
+        return scheduler.isFinished(a_job->task);
+    });
+    m_jobs.push_back(job);
+    return job;
+}
+
+bool PipelineCache::isReady(const Handle& a_handle) const
+{
+    return utils::getTaskScheduler().isFinished(a_handle->task);
+}
+
+PipelineCache::Pipeline PipelineCache::wait(const Handle& a_handle)
+{
+    utils::getTaskScheduler().wait(a_handle->task);
+    return a_handle->pipeline;
+}
+
+PipelineCacheStats PipelineCache::getStats() const
+{
+    return {
+        .requests = m_requests.load(),
+        .memoryHits = m_memoryHits.load(),
+        .diskHits = m_diskHits.load(),
+        .misses = m_misses.load(),
+        .failures = m_failures.load()
+    };
+}
+
+std::string PipelineCache::getKey(std::span<const std::vector<char>> a_shaders, std::string_view a_state)
+{
+    std::string key;
+    appendPipelineState(key, static_cast<uint32_t>(a_shaders.size()));
+    for (const std::vector<char>& shader : a_shaders) {
+        appendPipelineState(key, static_cast<uint64_t>(shader.size()));
+        appendPipelineState(key, hashBytes(shader.data(), shader.size()));
+    }
+    key.append(a_state);
+    return key;
+}
+
+bool PipelineCache::readBlob(const std::string& a_key, std::vector<char>& a_blob) const
+{
+    utils::MappedFile file;
+    if (m_directory.empty() || !file.open(getCachePath(m_directory, a_key)) ||
+        file.getSize() < sizeof(PipelineCacheHeader)) {
+        return false;
+    }
+    PipelineCacheHeader header;
+    std::memcpy(&header, file.getData(), sizeof(header));
+    if (header.magic != k_pipelineCacheMagic || header.version != k_pipelineCacheVersion ||
+        header.keySize != a_key.size() || file.getSize() != sizeof(header) + header.keySize + header.blobSize ||
+        std::memcmp(file.getData() + sizeof(header), a_key.data(), a_key.size()) != 0) {
+        return false;
+    }
+    const uint8_t* blob = file.getData() + sizeof(header) + header.keySize;
+    a_blob.assign(blob, blob + header.blobSize);
+    return true;
+}
+
+bool PipelineCache::writeBlob(const std::string& a_key, std::span<const char> a_blob) const
+{
+    if (m_directory.empty()) {
+        return false;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(m_directory, error);
+    const std::string path = getCachePath(m_directory, a_key);
+    // Jobs of the same key can write at the same time, each writes a file of its own
+    static std::atomic<uint32_t> s_writeCount = 0;
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%u.tmp", s_writeCount.fetch_add(1));
+    const std::string temporaryPath = path + suffix;
+    std::FILE* file = std::fopen(temporaryPath.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    const PipelineCacheHeader header = {
+        .magic = k_pipelineCacheMagic,
+        .version = k_pipelineCacheVersion,
+        .keySize = static_cast<uint32_t>(a_key.size()),
+        .blobSize = static_cast<uint32_t>(a_blob.size())
+    };
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+                   std::fwrite(a_key.data(), 1, a_key.size(), file) == a_key.size() &&
+                   std::fwrite(a_blob.data(), 1, a_blob.size(), file) == a_blob.size();
+    written = std::fclose(file) == 0 && written;
+    if (written) {
+        std::filesystem::rename(temporaryPath, path, error);
+        written = !error;
+    }
+    if (!written) {
+        std::filesystem::remove(temporaryPath, error);
+    }
+    return written;
+}
+
+void PipelineCache::run(Job& a_job)
+{
+    std::vector<std::vector<char>> shaders(a_job.shaderPaths.size());
+    for (size_t i = 0; i < shaders.size(); ++i) {
+        if (!readShader(a_job.shaderPaths[i], shaders[i])) {
+            ++m_failures;
+            return;
+        }
+    }
+    const std::string key = getKey(shaders, a_job.state);
+    {
+        std::lock_guard lock(m_mutex);
+        auto it = m_pipelines.find(key);
+        if (it != m_pipelines.end()) {
+            ++m_memoryHits;
+            a_job.pipeline = it->second;
+            return;
+        }
+    }
+
+    std::vector<char> cachedBlob;
+    const bool isDiskHit = readBlob(key, cachedBlob);
+    CompileResult result = a_job.compile(shaders, cachedBlob);
+    if (!result.pipeline) {
+        ++m_failures;
+        return;
+    }
+    // A compilation that couldn't use the cached blob returns a new one
+    if (result.blob.empty()) {
+        ++(isDiskHit ? m_diskHits : m_misses);
+    } else {
+        ++m_misses;
+        writeBlob(key, result.blob);
+    }
+    std::lock_guard lock(m_mutex);
+    // Another job of the same key may have finished first, its pipeline is shared
+    a_job.pipeline = m_pipelines.try_emplace(key, std::move(result.pipeline)).first->second;
+}
+}  // namespace neural::graphics
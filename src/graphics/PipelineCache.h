@@ -0,0 +1,94 @@
+#pragma once
+#include <utils/TaskScheduler.h>
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace neural::graphics {
+
+struct PipelineCacheStats {
+    uint32_t requests;
+    uint32_t memoryHits;  // shared the pipeline of an earlier request with the same key
+    uint32_t diskHits;    // compiled from a blob of the cache directory
+    uint32_t misses;
+    uint32_t failures;    // missing shaders or failed compilations
+};
+
+// Appends a plain value to a pipeline state description. Values with padding bytes have to be appended
+// field by field, the padding would make equal states differ
+template<typename T>
+void appendPipelineState(std::string& a_state, const T& a_value)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    a_state.append(reinterpret_cast<const char*>(&a_value), sizeof(a_value));
+}
+
+// Content-addressed cache of pipelines. The key of a pipeline is made of the hashes of its shader bytecode and
+// its state description, a rebuilt shader or a changed state gets a key of its own and nothing is invalidated
+// by hand. What the backend compiles a pipeline faster from next time (the cached PSO on D3D12) is kept in one
+// file per key in the cache directory:
+//     header: magic, version, key size, blob size
+//     key, blob
+// Files are written under a temporary name and renamed, like the mesh cache.
+// Pipelines are created by jobs on utils::getTaskScheduler(), request returns at once with a handle that
+// resolves when the job is done
+class PipelineCache {
+public:
+    // The backend pipeline object, ID3D12PipelineState on D3D12
+    using Pipeline = std::shared_ptr<void>;
+    struct CompileResult {
+        Pipeline pipeline;        // null if the compilation failed
+        std::vector<char> blob;   // kept for the next runs, empty if the cached blob was used or to keep nothing
+    };
+    // Called on a worker. a_shaders is the bytecode of the requested shaders in order. a_cachedBlob is the blob
+    // an earlier compilation of the key returned, empty on a miss. It can be stale (a new driver), compilers
+    // compile without it then
+    using CompileFunction = std::function<CompileResult(std::span<const std::vector<char>> a_shaders,
+                                                        std::span<const char> a_cachedBlob)>;
+    struct Job;
+    using Handle = std::shared_ptr<Job>;
+
+    PipelineCache() = default;
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+    // Waits for the jobs in flight
+    ~PipelineCache();
+
+    void initialize(std::string a_directory);
+
+    // a_state describes everything else the pipeline is created from, see appendPipelineState
+    Handle request(std::vector<std::string> a_shaderPaths, std::string a_state, CompileFunction a_compile);
+    bool isReady(const Handle& a_handle) const;
+    // Runs other tasks while the job isn't done. Null if the pipeline failed
+    Pipeline wait(const Handle& a_handle);
+
+    PipelineCacheStats getStats() const;
+
+    static std::string getKey(std::span<const std::vector<char>> a_shaders, std::string_view a_state);
+    // False on a miss
+    bool readBlob(const std::string& a_key, std::vector<char>& a_blob) const;
+    bool writeBlob(const std::string& a_key, std::span<const char> a_blob) const;
+private:
+    void run(Job& a_job);
+
+    std::string m_directory;
+    std::mutex m_mutex;
+    std::unordered_map<std::string, Pipeline> m_pipelines;  // by key
+    std::vector<Handle> m_jobs;                             // in flight, waited by the destructor
+
+    std::atomic<uint32_t> m_requests = 0;
+    std::atomic<uint32_t> m_memoryHits = 0;
+    std::atomic<uint32_t> m_diskHits = 0;
+    std::atomic<uint32_t> m_misses = 0;
+    std::atomic<uint32_t> m_failures = 0;
+};
+}  // namespace neural::graphics
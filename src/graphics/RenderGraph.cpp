@@ -0,0 +1,319 @@
+#include "RenderGraph.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace neural::graphics {
+
+namespace {
+uint64_t alignUp(uint64_t a_value, uint64_t a_alignment)
+{
+    return (a_value + a_alignment - 1) / a_alignment * a_alignment;
+}
+
+// A resource already in a_current can be used in a_required without a barrier
+bool coversState(RenderGraphState a_current, RenderGraphState a_required)
+{
+    if (a_current == a_required) {
+        return true;
+    }
+    return isCombinableReadState(a_current) && isCombinableReadState(a_required) &&
+           (static_cast<uint32_t>(a_current) & static_cast<uint32_t>(a_required)) ==
+               static_cast<uint32_t>(a_required);
+}
+}  // anonymous namespace
+
+void RenderGraph::reset()
+{
+    m_resources.clear();
+    m_passes.clear();
+    m_placements.clear();
+    m_finalBarriers.clear();
+    m_memorySize = 0;
+    m_unaliasedMemorySize = 0;
+    m_compiled = false;
+}
+
+RenderGraphResource RenderGraph::createResource(std::string_view a_name, const RenderGraphResourceDesc& a_desc)
+{
+    assert(a_desc.width > 0 && a_desc.height > 0);
+    m_resources.push_back({ .name = std::string(a_name), .desc = a_desc });
+    m_compiled = false;
+    return { static_cast<uint32_t>(m_resources.size() - 1) };
+}
+
+RenderGraphResource RenderGraph::importResource(std::string_view a_name, void* a_external,
+                                                RenderGraphState a_initialState, RenderGraphState a_finalState)
+{
+    assert(a_external);
+    m_resources.push_back({
+        .name = std::string(a_name),
+        .external = a_external,
+        .initialState = a_initialState,
+        .finalState = a_finalState
+    });
+    m_compiled = false;
+    return { static_cast<uint32_t>(m_resources.size() - 1) };
+}
+
+void RenderGraph::addPass(std::string_view a_name, std::vector<RenderGraphAccess> a_accesses, PassFunction a_execute,
+                          bool a_hasSideEffects)
+{
+    for (size_t i = 0; i < a_accesses.size(); ++i) {
+        assert(a_accesses[i].resource.index < m_resources.size());
+        for (size_t j = 0; j < i; ++j) {
+            assert(a_accesses[j].resource.index != a_accesses[i].resource.index);
+        }
+    }
+    m_passes.push_back({
+        .name = std::string(a_name),
+        .accesses = std::move(a_accesses),
+        .execute = std::move(a_execute),
+        .hasSideEffects = a_hasSideEffects
+    });
+    m_compiled = false;
+}
+
+void RenderGraph::compile(IRenderGraphBackend& a_backend)
+{
+    cullPasses();
+
+    for (Resource& resource : m_resources) {
+        resource.firstPass = ~0u;
+        resource.lastPass = 0;
+        resource.usage = RenderGraphState::Common;
+    }
+    for (uint32_t p = 0; p < m_passes.size(); ++p) {
+        m_passes[p].barriers.clear();
+        if (m_passes[p].culled) {
+            continue;
+        }
+        for (const RenderGraphAccess& access : m_passes[p].accesses) {
+            Resource& resource = m_resources[access.resource.index];
+            resource.firstPass = std::min(resource.firstPass, p);
+            resource.lastPass = std::max(resource.lastPass, p);
+            resource.usage = resource.usage | access.state;
+        }
+    }
+    placeTransientResources(a_backend);
+    computeBarriers();
+    m_compiled = true;
+}
+
+void RenderGraph::cullPasses()
+{
+    // Backwards: a pass is needed if it writes something a later needed pass accesses. The writes of a
+    // needed pass count as accesses, the pass may load what was there before
+    std::vector<bool> needed(m_resources.size(), false);
+    for (size_t p = m_passes.size(); p-- > 0;) {
+        Pass& pass = m_passes[p];
+        bool keep = pass.hasSideEffects;
+        for (const RenderGraphAccess& access : pass.accesses) {
+            if (isWriteState(access.state) &&
+                (needed[access.resource.index] || m_resources[access.resource.index].external)) {
+                keep = true;
+            }
+        }
+        pass.culled = !keep;
+        if (keep) {
+            for (const RenderGraphAccess& access : pass.accesses) {
+                needed[access.resource.index] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::placeTransientResources(IRenderGraphBackend& a_backend)
+{
+    struct Candidate {
+        uint32_t resource;
+        RenderGraphMemoryRequirements requirements;
+    };
+    std::vector<Candidate> candidates;
+    m_unaliasedMemorySize = 0;
+    for (uint32_t r = 0; r < m_resources.size(); ++r) {
+        const Resource& resource = m_resources[r];
+        if (resource.external || resource.firstPass == ~0u) {
+            continue;
+        }
+        const RenderGraphMemoryRequirements requirements = a_backend.getMemoryRequirements(resource.desc,
+                                                                                           resource.usage);
+        assert(requirements.size > 0 && requirements.alignment > 0);
+        candidates.push_back({ r, requirements });
+        m_unaliasedMemorySize = alignUp(m_unaliasedMemorySize, requirements.alignment) + requirements.size;
+    }
+    // Biggest first, the small ones fill the gaps
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a_left, const Candidate& a_right) {
+        return a_left.requirements.size > a_right.requirements.size;
+    });
+
+    m_placements.clear();
+    m_memorySize = 0;
+    struct Range {
+        uint64_t begin;
+        uint64_t end;
+    };
+    std::vector<Range> occupied;
+    for (const Candidate& candidate : candidates) {
+        const Resource& resource = m_resources[candidate.resource];
+        // Memory of the placed resources that are alive at the same time
+        occupied.clear();
+        for (const RenderGraphPlacement& placement : m_placements) {
+            const Resource& other = m_resources[placement.resource.index];
+            if (other.lastPass >= resource.firstPass && resource.lastPass >= other.firstPass) {
+                occupied.push_back({ placement.offset, placement.offset + placement.size });
+            }
+        }
+        std::sort(occupied.begin(), occupied.end(), [](const Range& a_left, const Range& a_right) {
+            return a_left.begin < a_right.begin;
+        });
+        // First gap that fits
+        uint64_t offset = 0;
+        for (const Range& range : occupied) {
+            if (alignUp(offset, candidate.requirements.alignment) + candidate.requirements.size <= range.begin) {
+                break;
+            }
+            offset = std::max(offset, range.end);
+        }
+        offset = alignUp(offset, candidate.requirements.alignment);
+
+        RenderGraphState initialState = RenderGraphState::Common;
+        for (const RenderGraphAccess& access : m_passes[resource.firstPass].accesses) {
+            if (access.resource.index == candidate.resource) {
+                initialState = access.state;
+            }
+        }
+        m_placements.push_back({
+            .resource = { candidate.resource },
+            .offset = offset,
+            .size = candidate.requirements.size,
+            .initialState = initialState,
+            .usage = resource.usage
+        });
+        m_memorySize = std::max(m_memorySize, offset + candidate.requirements.size);
+    }
+    std::sort(m_placements.begin(), m_placements.end(),
+              [](const RenderGraphPlacement& a_left, const RenderGraphPlacement& a_right) {
+                  return a_left.resource.index < a_right.resource.index;
+              });
+}
+
+void RenderGraph::computeBarriers()
+{
+    // Transient resources sharing memory with another one need an aliasing barrier on their first use,
+    // also the one used first in the frame, the other one had the memory in the previous frame
+    std::vector<bool> aliased(m_resources.size(), false);
+    for (size_t i = 0; i < m_placements.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            const RenderGraphPlacement& a = m_placements[i];
+            const RenderGraphPlacement& b = m_placements[j];
+            if (a.offset < b.offset + b.size && b.offset < a.offset + a.size) {
+                aliased[a.resource.index] = true;
+                aliased[b.resource.index] = true;
+            }
+        }
+    }
+    std::vector<RenderGraphState> initialStates(m_resources.size(), RenderGraphState::Common);
+    for (uint32_t r = 0; r < m_resources.size(); ++r) {
+        initialStates[r] = m_resources[r].initialState;
+    }
+    for (const RenderGraphPlacement& placement : m_placements) {
+        initialStates[placement.resource.index] = placement.initialState;
+    }
+
+    struct Use {
+        uint32_t pass;
+        RenderGraphState state;
+    };
+    std::vector<Use> uses;
+    m_finalBarriers.clear();
+    for (uint32_t r = 0; r < m_resources.size(); ++r) {
+        const Resource& resource = m_resources[r];
+        uses.clear();
+        if (resource.firstPass != ~0u) {
+            for (uint32_t p = resource.firstPass; p <= resource.lastPass; ++p) {
+                if (m_passes[p].culled) {
+                    continue;
+                }
+                for (const RenderGraphAccess& access : m_passes[p].accesses) {
+                    if (access.resource.index == r) {
+                        uses.push_back({ p, access.state });
+                    }
+                }
+            }
+        }
+
+        RenderGraphState state = initialStates[r];
+        for (size_t u = 0; u < uses.size(); ++u) {
+            std::vector<RenderGraphBarrier>& barriers = m_passes[uses[u].pass].barriers;
+            const RenderGraphState required = uses[u].state;
+            if (u == 0 && aliased[r]) {
+                barriers.push_back({ .type = RenderGraphBarrierType::Aliasing, .resource = { r }, .after = required });
+            }
+            if (coversState(state, required)) {
+                // The work of the previous frames is finished by the end of their command lists
+                if (required == RenderGraphState::UnorderedAccess && u > 0) {
+                    barriers.push_back({ .type = RenderGraphBarrierType::UnorderedAccess, .resource = { r },
+                                         .before = state, .after = state });
+                }
+                continue;
+            }
+            // Consecutive reads get one transition into all their states
+            RenderGraphState target = required;
+            if (isCombinableReadState(required)) {
+                for (size_t next = u + 1; next < uses.size() && isCombinableReadState(uses[next].state); ++next) {
+                    target = target | uses[next].state;
+                }
+            }
+            barriers.push_back({ .type = RenderGraphBarrierType::Transition, .resource = { r },
+                                 .before = state, .after = target });
+            state = target;
+        }
+        const RenderGraphState finalState = resource.external ? resource.finalState : initialStates[r];
+        if (state != finalState) {
+            m_finalBarriers.push_back({ .type = RenderGraphBarrierType::Transition, .resource = { r },
+                                        .before = state, .after = finalState });
+        }
+    }
+}
+
+void RenderGraph::execute(IRenderGraphBackend& a_backend)
+{
+    assert(m_compiled && "compile the graph after the last change");
+    a_backend.placeTransientResources(*this, m_memorySize, m_placements);
+    for (Pass& pass : m_passes) {
+        if (pass.culled) {
+            continue;
+        }
+        if (!pass.barriers.empty()) {
+            a_backend.recordBarriers(*this, pass.barriers);
+        }
+        if (pass.execute) {
+            pass.execute();
+        }
+    }
+    if (!m_finalBarriers.empty()) {
+        a_backend.recordBarriers(*this, m_finalBarriers);
+    }
+}
+
+bool RenderGraph::isPassCulled(std::string_view a_name) const
+{
+    for (const Pass& pass : m_passes) {
+        if (pass.name == a_name) {
+            return pass.culled;
+        }
+    }
+    assert(false && "no such pass");
+    return true;
+}
+
+size_t RenderGraph::getBarrierCount() const
+{
+    size_t count = m_finalBarriers.size();
+    for (const Pass& pass : m_passes) {
+        count += pass.culled ? 0 : pass.barriers.size();
+    }
+    return count;
+}
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neural::graphics {
+
+// Resource states as bit flags. Only the read states can be combined
+enum class RenderGraphState : uint32_t {
+    Common          = 0,
+    RenderTarget    = 1 << 0,
+    DepthWrite      = 1 << 1,
+    UnorderedAccess = 1 << 2,
+    CopyDest        = 1 << 3,
+    DepthRead       = 1 << 4,
+    ShaderResource  = 1 << 5,
+    CopySource      = 1 << 6,
+    Present         = 1 << 7
+};
+constexpr RenderGraphState operator|(RenderGraphState a_left, RenderGraphState a_right) {
+    return static_cast<RenderGraphState>(static_cast<uint32_t>(a_left) | static_cast<uint32_t>(a_right));
+}
+constexpr bool hasState(RenderGraphState a_states, RenderGraphState a_state) {
+    return (static_cast<uint32_t>(a_states) & static_cast<uint32_t>(a_state)) != 0;
+}
+constexpr bool isWriteState(RenderGraphState a_state) {
+    return hasState(a_state, RenderGraphState::RenderTarget | RenderGraphState::DepthWrite |
+                             RenderGraphState::UnorderedAccess | RenderGraphState::CopyDest);
+}
+constexpr bool isCombinableReadState(RenderGraphState a_state) {
+    return a_state != RenderGraphState::Common &&
+           !hasState(a_state, RenderGraphState::RenderTarget | RenderGraphState::DepthWrite |
+                              RenderGraphState::UnorderedAccess | RenderGraphState::CopyDest |
+                              RenderGraphState::Present);
+}
+
+struct RenderGraphResource {
+    uint32_t index = ~0u;
+    bool isValid() const {
+        return index != ~0u;
+    }
+};
+
+enum class RenderGraphResourceType : uint32_t {
+    Texture,
+    Buffer
+};
+struct RenderGraphResourceDesc {
+    RenderGraphResourceType type = RenderGraphResourceType::Texture;
+    uint64_t width = 0;   // in bytes for buffers
+    uint32_t height = 1;
+    uint32_t format = 0;  // DXGI_FORMAT on D3D12
+    std::array<float, 4> clearColor = { 0, 0, 0, 1 };
+    float clearDepth = 1.0f;
+};
+
+struct RenderGraphAccess {
+    RenderGraphResource resource;
+    RenderGraphState state;
+};
+
+enum class RenderGraphBarrierType : uint32_t {
+    Transition,
+    Aliasing,       // resource starts using memory that other transient resources share
+    UnorderedAccess // between two passes that access resource as UnorderedAccess
+};
+struct RenderGraphBarrier {
+    RenderGraphBarrierType type;
+    RenderGraphResource resource;
+    RenderGraphState before = RenderGraphState::Common;
+    RenderGraphState after = RenderGraphState::Common;
+};
+
+// Where a transient resource lives in the memory shared by the transient resources of a frame
+struct RenderGraphPlacement {
+    RenderGraphResource resource;
+    uint64_t offset;
+    uint64_t size;
+    RenderGraphState initialState;  // of the first pass that uses it, every frame starts in it
+    RenderGraphState usage;         // all the states the passes use it in
+};
+struct RenderGraphMemoryRequirements {
+    uint64_t size;
+    uint64_t alignment;
+};
+
+class RenderGraph;
+
+// The graphics API side of a render graph
+class IRenderGraphBackend {
+public:
+    virtual ~IRenderGraphBackend() = default;
+    virtual RenderGraphMemoryRequirements getMemoryRequirements(const RenderGraphResourceDesc& a_desc,
+                                                                RenderGraphState a_usage) = 0;
+    // Called by every execute before the passes, the placements only change when the graph does
+    virtual void placeTransientResources(const RenderGraph& a_graph, uint64_t a_memorySize,
+                                         std::span<const RenderGraphPlacement> a_placements) = 0;
+    virtual void recordBarriers(const RenderGraph& a_graph, std::span<const RenderGraphBarrier> a_barriers) = 0;
+};
+
+// Frame graph: passes declare the resources they access and in which state, compile derives everything
+// the handwritten code used to do:
+//     culling:  passes whose writes no kept pass or imported resource observes are dropped. Passes with side
+//               effects and writes into imported resources are always kept
+//     barriers: one transition per state change, read states of consecutive reads are merged into one
+//               transition, UnorderedAccess barriers between consecutive UnorderedAccess passes
+//     aliasing: transient resources whose lifetimes don't overlap share memory, first fit by size. An aliased
+//               resource has undefined contents on its first use, its first pass has to clear or overwrite it
+// Transient resources start every frame in the state of their first pass, compile adds the transitions back
+// at the end of the frame. The graph is rebuilt every frame: reset, declare, compile, execute
+class RenderGraph {
+public:
+    using PassFunction = std::function<void()>;
+
+    void reset();
+    RenderGraphResource createResource(std::string_view a_name, const RenderGraphResourceDesc& a_desc);
+    // a_external is the backend resource, ID3D12Resource* on D3D12. It is in a_initialState when the frame
+    // starts and is left in a_finalState
+    RenderGraphResource importResource(std::string_view a_name, void* a_external, RenderGraphState a_initialState,
+                                       RenderGraphState a_finalState);
+    // A resource appears at most once in a_accesses. a_hasSideEffects keeps the pass even if no one reads its writes
+    void addPass(std::string_view a_name, std::vector<RenderGraphAccess> a_accesses, PassFunction a_execute,
+                 bool a_hasSideEffects = false);
+
+    void compile(IRenderGraphBackend& a_backend);
+    void execute(IRenderGraphBackend& a_backend);
+
+    const std::string& getResourceName(RenderGraphResource a_resource) const {
+        return m_resources[a_resource.index].name;
+    }
+    const RenderGraphResourceDesc& getResourceDesc(RenderGraphResource a_resource) const {
+        return m_resources[a_resource.index].desc;
+    }
+    bool isImported(RenderGraphResource a_resource) const {
+        return m_resources[a_resource.index].external != nullptr;
+    }
+    void* getExternal(RenderGraphResource a_resource) const {
+        return m_resources[a_resource.index].external;
+    }
+    // After compile
+    bool isPassCulled(std::string_view a_name) const;
+    uint64_t getTransientMemorySize() const {
+        return m_memorySize;
+    }
+    // What the transient resources would take without aliasing
+    uint64_t getUnaliasedMemorySize() const {
+        return m_unaliasedMemorySize;
+    }
+    size_t getBarrierCount() const;
+private:
+    struct Resource {
+        std::string name;
+        RenderGraphResourceDesc desc = {};
+        void* external = nullptr;
+        RenderGraphState initialState = RenderGraphState::Common;
+        RenderGraphState finalState = RenderGraphState::Common;
+        // Compiled
+        uint32_t firstPass = ~0u;
+        uint32_t lastPass = 0;
+        RenderGraphState usage = RenderGraphState::Common;
+    };
+    struct Pass {
+        std::string name;
+        std::vector<RenderGraphAccess> accesses;
+        PassFunction execute;
+        bool hasSideEffects;
+        // Compiled
+        bool culled = false;
+        std::vector<RenderGraphBarrier> barriers = {};  // before the pass
+    };
+    void cullPasses();
+    void placeTransientResources(IRenderGraphBackend& a_backend);
+    void computeBarriers();
+
+    std::vector<Resource> m_resources;
+    std::vector<Pass> m_passes;
+    std::vector<RenderGraphPlacement> m_placements;
+    std::vector<RenderGraphBarrier> m_finalBarriers;
+    uint64_t m_memorySize = 0;
+    uint64_t m_unaliasedMemorySize = 0;
+    bool m_compiled = false;
+};
+}
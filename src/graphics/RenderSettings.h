@@ -15,5 +15,7 @@ struct RenderSettings {
     bool showGUI = true;
     bool doScreenShot = false;
     bool ml = false;
+    float lodPixelError = 1.0f;  // largest projected error of a mesh LOD, 0 draws the full meshes
+    int instanceCount = 1;       // copies of the mesh on a grid, the gizmo moves the first one (D3D12 only)
 };
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "ShaderSignature.h"
+
+#include <cctype>
+#include <cstring>
+
+namespace neural::graphics {
+
+namespace {
+// The container: "DXBC", a checksum of 16 bytes, version, total size, chunk count and the offsets of the
+// chunks. A chunk is its fourcc and size followed by its data
+constexpr uint32_t k_containerHeaderSize = 32;
+constexpr uint32_t k_chunkHeaderSize = 8;
+// The signature: element count, the offset of the elements and the elements. The names are null-terminated
+// strings in the chunk, their offsets are from the start of the chunk data like the one of the elements
+constexpr uint32_t k_isgnElementSize = 24;
+constexpr uint32_t k_isg1ElementSize = 32;  // stream first and min precision last
+
+uint32_t readUint32(const char* a_data)
+{
+    uint32_t value;
+    std::memcpy(&value, a_data, sizeof(value));
+    return value;
+}
+
+bool readSignatureChunk(std::span<const char> a_chunk, uint32_t a_elementSize,
+                        std::vector<ShaderSignatureElement>& a_elements)
+{
+    if (a_chunk.size() < 8) {
+        return false;
+    }
+    const uint32_t count = readUint32(a_chunk.data());
+    const uint32_t offset = readUint32(a_chunk.data() + 4);
+    if (offset > a_chunk.size() || count > (a_chunk.size() - offset) / a_elementSize) {
+        return false;
+    }
+    a_elements.clear();
+    // ISG1 starts with the stream, the rest is laid out like ISGN
+    const uint32_t skipped = a_elementSize == k_isg1ElementSize ? 4 : 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        const char* element = a_chunk.data() + offset + i * a_elementSize + skipped;
+        const uint32_t nameOffset = readUint32(element);
+        if (nameOffset >= a_chunk.size()) {
+            return false;
+        }
+        const char* name = a_chunk.data() + nameOffset;
+        const void* nameEnd = std::memchr(name, '\0', a_chunk.size() - nameOffset);
+        if (!nameEnd) {
+            return false;
+        }
+        a_elements.push_back({
+            .semanticName = std::string(name, static_cast<const char*>(nameEnd)),
+            .semanticIndex = readUint32(element + 4),
+            .systemValue = readUint32(element + 8),
+            .registerIndex = readUint32(element + 16),
+            .mask = static_cast<uint8_t>(element[20]),
+            .readMask = static_cast<uint8_t>(element[21])
+        });
+    }
+    return true;
+}
+
+bool equalSemanticNames(std::string_view a_left, std::string_view a_right)
+{
+    if (a_left.size() != a_right.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a_left.size(); ++i) {
+        if (std::toupper(static_cast<unsigned char>(a_left[i])) !=
+            std::toupper(static_cast<unsigned char>(a_right[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::string getSemantic(std::string_view a_name, uint32_t a_index)
+{
+    return std::string(a_name) + std::to_string(a_index);
+}
+}  // anonymous namespace
+
+bool readInputSignature(std::span<const char> a_bytecode, std::vector<ShaderSignatureElement>& a_elements)
+{
+    if (a_bytecode.size() < k_containerHeaderSize || std::memcmp(a_bytecode.data(), "DXBC", 4) != 0 ||
+        readUint32(a_bytecode.data() + 24) != a_bytecode.size()) {
+        return false;
+    }
+    const uint32_t chunkCount = readUint32(a_bytecode.data() + 28);
+    if (chunkCount > (a_bytecode.size() - k_containerHeaderSize) / 4) {
+        return false;
+    }
+    for (uint32_t i = 0; i < chunkCount; ++i) {
+        const uint32_t offset = readUint32(a_bytecode.data() + k_containerHeaderSize + i * 4);
+        if (offset > a_bytecode.size() - k_chunkHeaderSize) {
+            return false;
+        }
+        const char* chunk = a_bytecode.data() + offset;
+        const uint32_t size = readUint32(chunk + 4);
+        if (size > a_bytecode.size() - offset - k_chunkHeaderSize) {
+            return false;
+        }
+        const std::span<const char> data(chunk + k_chunkHeaderSize, size);
+        if (std::memcmp(chunk, "ISGN", 4) == 0) {
+            return readSignatureChunk(data, k_isgnElementSize, a_elements);
+        }
+        if (std::memcmp(chunk, "ISG1", 4) == 0) {
+            return readSignatureChunk(data, k_isg1ElementSize, a_elements);
+        }
+    }
+    return false;
+}
+
+std::string checkInputLayout(std::span<const ShaderSignatureElement> a_signature,
+                             std::span<const InputLayoutElement> a_layout)
+{
+    std::string error;
+    for (const ShaderSignatureElement& input : a_signature) {
+        // SV_VertexID and the like come from the input assembler
+        if (input.systemValue != 0) {
+            continue;
+        }
+        bool found = false;
+        for (const InputLayoutElement& element : a_layout) {
+            found = found || (element.semanticIndex == input.semanticIndex &&
+                              equalSemanticNames(element.semanticName, input.semanticName));
+        }
+        if (!found) {
+            error += "the shader takes " + getSemantic(input.semanticName, input.semanticIndex) +
+                     ", the input layout has no such element\n";
+        }
+    }
+    for (const InputLayoutElement& element : a_layout) {
+        if (!element.perInstance) {
+            continue;
+        }
+        bool read = false;
+        for (const ShaderSignatureElement& input : a_signature) {
+            read = read || (input.semanticIndex == element.semanticIndex && input.readMask != 0 &&
+                            equalSemanticNames(input.semanticName, element.semanticName));
+        }
+        if (!read) {
+            error += "the per-instance element " + getSemantic(element.semanticName, element.semanticIndex) +
+                     " isn't read by the shader\n";
+        }
+    }
+    return error;
+}
+}  // namespace neural::graphics
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neural::graphics {
+
+// An input of a shader as the compilers list it in the input signature of the DXBC container
+struct ShaderSignatureElement {
+    std::string semanticName;
+    uint32_t semanticIndex;
+    uint32_t systemValue;    // D3D_NAME, 0 for the inputs the input layout feeds
+    uint32_t registerIndex;
+    uint8_t mask;            // the components declared
+    uint8_t readMask;        // the components the shader reads, 0 if it ignores the input
+};
+
+// Reads the ISGN chunk fxc writes or the ISG1 chunk of dxc and of fxc with min precision. False if a_bytecode
+// isn't a well-formed container or has no input signature
+bool readInputSignature(std::span<const char> a_bytecode, std::vector<ShaderSignatureElement>& a_elements);
+
+// What a D3D12_INPUT_ELEMENT_DESC is checked by, the rest of it doesn't depend on the shader
+struct InputLayoutElement {
+    std::string_view semanticName;
+    uint32_t semanticIndex;
+    bool perInstance;
+};
+
+// Every input of a_signature has to be in a_layout. Pipeline creation only catches that with the debug layer,
+// without it a vertex format change the shader missed draws garbage. The shader also has to read every
+// per-instance element, one that ignores the instance transforms draws every instance at the origin.
+// Semantic names are compared case-insensitively like D3D does. Empty if the layout fits, otherwise a line
+// per problem
+std::string checkInputLayout(std::span<const ShaderSignatureElement> a_signature,
+                             std::span<const InputLayoutElement> a_layout);
+}  // namespace neural::graphics
@@ -0,0 +1,53 @@
+#include "VertexFormat.h"
+#include <utils/GBufferEncoding.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace neural::graphics {
+
+uint32_t getVertexStride(VertexFormat a_format)
+{
+    return a_format == VertexFormat::Compact ? sizeof(CompactVertex) : sizeof(MeshStorage::Vertex);
+}
+
+VertexDecode getVertexDecode(VertexFormat a_format, const MeshStorage::MeshInfo& a_meshInfo)
+{
+    if (a_format == VertexFormat::Float32) {
+        return { .positionOffset = { 0, 0, 0 }, .positionScale = { 1, 1, 1 } };
+    }
+    const DirectX::XMFLOAT3& boundsMin = a_meshInfo.boundsMin;
+    const DirectX::XMFLOAT3& boundsMax = a_meshInfo.boundsMax;
+    return {
+        .positionOffset = { boundsMin.x, boundsMin.y, boundsMin.z },
+        .positionScale = { boundsMax.x - boundsMin.x, boundsMax.y - boundsMin.y, boundsMax.z - boundsMin.z }
+    };
+}
+
+void packVertices(VertexFormat a_format, const VertexDecode& a_decode,
+                  std::span<const MeshStorage::Vertex> a_vertices, void* a_destination)
+{
+    if (a_format == VertexFormat::Float32) {
+        std::memcpy(a_destination, a_vertices.data(), a_vertices.size_bytes());
+        return;
+    }
+    // UNORM inputs are read as value / 65535, so round to nearest. A flat axis has scale 0 and packs to 0
+    std::array<float, 3> invScale;
+    for (uint32_t c = 0; c < 3; ++c) {
+        invScale[c] = a_decode.positionScale[c] > 0.0f ? 65535.0f / a_decode.positionScale[c] : 0.0f;
+    }
+    CompactVertex* destination = static_cast<CompactVertex*>(a_destination);
+    for (size_t i = 0; i < a_vertices.size(); ++i) {
+        const MeshStorage::Vertex& vertex = a_vertices[i];
+        const std::array<float, 3> position = { vertex.position.x, vertex.position.y, vertex.position.z };
+        CompactVertex packed = {};
+        for (uint32_t c = 0; c < 3; ++c) {
+            const float unorm = (position[c] - a_decode.positionOffset[c]) * invScale[c];
+            packed.position[c] = static_cast<uint16_t>(std::clamp(unorm + 0.5f, 0.0f, 65535.0f));
+        }
+        packed.normal = utils::encodeOctahedral(vertex.normal.x, vertex.normal.y, vertex.normal.z);
+        destination[i] = packed;
+    }
+}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include "MeshStorage.h"
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+namespace neural::graphics {
+
+// Vertex streams the GPU draws from, packed from MeshStorage::Vertex at upload:
+//     Float32: MeshStorage::Vertex as is, 32 bytes
+//     Compact: position as R16G16B16A16_UNORM relative to the mesh bounds, normal as R16G16_UNORM octahedral
+//              (utils/GBufferEncoding.h), no texture coordinates as no shader reads them. 12 bytes
+enum class VertexFormat {
+    Float32,
+    Compact
+};
+
+struct CompactVertex {
+    std::array<uint16_t, 4> position;  // w is padding
+    uint32_t normal;
+};
+static_assert(sizeof(CompactVertex) == 12);
+
+// The vertex shader reads positionOffset + position * positionScale, Float32 is the identity
+struct VertexDecode {
+    std::array<float, 3> positionOffset;
+    std::array<float, 3> positionScale;
+};
+
+uint32_t getVertexStride(VertexFormat a_format);
+VertexDecode getVertexDecode(VertexFormat a_format, const MeshStorage::MeshInfo& a_meshInfo);
+// Writes a_vertices.size() * getVertexStride(a_format) bytes
+void packVertices(VertexFormat a_format, const VertexDecode& a_decode,
+                  std::span<const MeshStorage::Vertex> a_vertices, void* a_destination);
+}
@@ -0,0 +1,98 @@
+#include "CPURenderEngine.h"
+#include "CaptureDataset.h"
+#include <graphics/MeshLod.h>
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+
+namespace neural::graphics {
+
+void CPURenderEngine::initialize(void*, int a_width, int a_height)
+{
+    m_windowWidth = a_width;
+    m_windowHeight = a_height;
+
+    m_settings.camera.setFrustum(DirectX::XMConvertToRadians(45), static_cast<float>(m_windowWidth) / m_windowHeight, 1, 1000);
+    DirectX::XMStoreFloat4x4(&m_worldMatrix, DirectX::XMMatrixTranslation(0, 3, 10));
+    // Nothing to render the GUI with
+    m_settings.showGUI = false;
+
+    m_meshStorage.loadDefaultMeshes();
+    m_rasterizer.initialize(m_windowWidth, m_windowHeight);
+}
+
+void CPURenderEngine::render(const Timer&)
+{
+    m_settings.camera.updateViewMatrix();
+    const uint32_t lod = selectMeshLod(m_meshStorage.getMeshInfo(m_settings.meshName.c_str()), m_worldMatrix,
+                                       m_settings.camera, m_windowHeight, m_settings.lodPixelError);
+    m_rasterizer.render(getSceneDrawCalls(m_meshStorage, m_settings.meshName.c_str(), lod),
+                        getFrameConstants(m_worldMatrix, m_settings.camera, { 0, 20, 0 }));
+
+    if (m_settings.doScreenShot) {
+        saveScreenshot();
+        m_settings.doScreenShot = false;
+    }
+}
+
+std::array<DrawCall, 2> CPURenderEngine::getSceneDrawCalls(MeshStorage& a_meshStorage, const char* a_meshName,
+                                                           uint32_t a_lod)
+{
+    const MeshStorage::MeshInfo& meshInfo = a_meshStorage.getMeshInfo(a_meshName);
+    const MeshStorage::MeshLod& lod = meshInfo.lods[std::min<size_t>(a_lod, meshInfo.lods.size() - 1)];
+    const MeshStorage::MeshInfo& meshFlat = a_meshStorage.getMeshInfo("flat");
+    const std::vector<MeshStorage::Vertex>& vertices = a_meshStorage.getVertices();
+    const std::vector<uint32_t>& indices = a_meshStorage.getIndices();
+    return {
+        DrawCall{
+            .vertices = vertices.data() + meshInfo.startVertex,
+            .vertexStride = sizeof(MeshStorage::Vertex),
+            .vertexCount = static_cast<uint32_t>(meshInfo.vertexCount),
+            .indices = indices.data() + lod.startIndex,
+            .indexCount = static_cast<uint32_t>(lod.indexCount),
+            .useWorldMatrix = true
+        },
+        DrawCall{
+            .vertices = vertices.data() + meshFlat.startVertex,
+            .vertexStride = sizeof(MeshStorage::Vertex),
+            .vertexCount = static_cast<uint32_t>(meshFlat.vertexCount),
+            .indices = indices.data() + meshFlat.startIndex,
+            .indexCount = static_cast<uint32_t>(meshFlat.indexCount),
+            .useWorldMatrix = false
+        }
+    };
+}
+
+FrameConstants CPURenderEngine::getFrameConstants(const DirectX::XMFLOAT4X4& a_worldMatrix, const Camera& a_camera,
+                                                  const std::array<float, 3>& a_lightPosition)
+{
+    FrameConstants constants = { .worldMatrix = {}, .viewProjMatrix = {}, .lightPosition = a_lightPosition };
+    DirectX::XMFLOAT4X4 viewProjMatrix;
+    DirectX::XMStoreFloat4x4(&viewProjMatrix, DirectX::XMMatrixMultiply(a_camera.getView(), a_camera.getProj()));
+    std::memcpy(constants.worldMatrix.data(), &a_worldMatrix, sizeof(a_worldMatrix));
+    std::memcpy(constants.viewProjMatrix.data(), &viewProjMatrix, sizeof(viewProjMatrix));
+    return constants;
+}
+
+void CPURenderEngine::saveScreenshot()
+{
+    // Opened on the first screenshot, continues the dataset left by the previous runs
+    if (!m_datasetOpened) {
+        m_datasetOpened = m_dataset.initialize(getCaptureWriterCreateInfo(
+            MODEL_DATA_ROOT "/dataset", m_windowWidth, m_windowHeight, utils::PlanePrecision::Float16,
+            utils::PlaneCompression::Lossless));
+        if (!m_datasetOpened) {
+            return;
+        }
+    }
+    m_settings.screenshotCounter = m_dataset.getSampleCount();
+    appendCapture(m_dataset, m_settings.screenshotCounter, m_rasterizer.getRenderTargets());
+    ++m_settings.screenshotCounter;
+}
+
+void CPURenderEngine::shutdown()
+{
+    m_dataset.shutdown();
+}
+}
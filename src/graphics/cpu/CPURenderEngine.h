@@ -0,0 +1,43 @@
+#pragma once
+#include <graphics/IRenderEngine.h>
+#include <graphics/MeshStorage.h>
+#include <utils/DatasetShards.h>
+#include <utils/VectorMath.h>
+#include "Rasterizer.h"
+
+#include <array>
+
+namespace neural::graphics {
+
+// Renders the final pipeline of DX12RenderEngine (1.vsps.hlsl) on the CPU, so it runs on machines without
+// a D3D12 GPU. Screenshots are appended to the sharded dataset in MODEL_DATA_ROOT/dataset. It needs no window,
+// the application presents getRenderTargets().screen if it has one. The GUI and the DirectML model are D3D12 only
+class CPURenderEngine : public IRenderEngine {
+public:
+    void initialize(void* a_window, int a_width, int a_height) override;
+    void render(const Timer& a_timer) override;
+    void shutdown() override;
+
+    const RenderTargets& getRenderTargets() const {
+        return m_rasterizer.getRenderTargets();
+    }
+
+    // The draws of DX12RenderEngine::render: the mesh with the world matrix (objectId 0) at a_lod, then the floor
+    static std::array<DrawCall, 2> getSceneDrawCalls(MeshStorage& a_meshStorage, const char* a_meshName,
+                                                     uint32_t a_lod = 0);
+    static FrameConstants getFrameConstants(const DirectX::XMFLOAT4X4& a_worldMatrix, const Camera& a_camera,
+                                            const std::array<float, 3>& a_lightPosition);
+private:
+    void saveScreenshot();
+
+    uint32_t m_windowWidth;
+    uint32_t m_windowHeight;
+
+    MeshStorage m_meshStorage;
+    Rasterizer m_rasterizer;
+    DirectX::XMFLOAT4X4 m_worldMatrix;
+
+    utils::DatasetWriter m_dataset;
+    bool m_datasetOpened = false;
+};
+}
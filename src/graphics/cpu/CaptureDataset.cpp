@@ -0,0 +1,61 @@
+#include "CaptureDataset.h"
+
+#include <array>
+
+namespace neural::graphics {
+
+std::vector<utils::DatasetPlane> getCapturePlanes(utils::PlanePrecision a_precision,
+                                                 utils::PlaneCompression a_compression)
+{
+    // Lighting is a clamped dot product plus 0.2 of ambient
+    std::vector<utils::DatasetPlane> planes = {
+        { .name = "color", .precision = a_precision, .compression = a_compression, .minValue = 0.0f, .maxValue = 1.25f }
+    };
+    for (const char* target : { "normal", "toCamera" }) {
+        for (const char* channel : { ".oct.x", ".oct.y" }) {
+            planes.push_back({ .name = std::string(target) + channel, .precision = utils::PlanePrecision::Unorm16,
+                               .compression = a_compression, .minValue = 0.0f, .maxValue = 1.0f });
+        }
+    }
+    return planes;
+}
+
+utils::DatasetWriterCreateInfo getCaptureWriterCreateInfo(const std::string& a_directory, uint32_t a_width,
+                                                          uint32_t a_height, utils::PlanePrecision a_precision,
+                                                          utils::PlaneCompression a_compression)
+{
+    return {
+        .directory = a_directory,
+        .width = a_width,
+        .height = a_height,
+        .planes = getCapturePlanes(a_precision, a_compression)
+    };
+}
+
+bool appendCapture(utils::DatasetWriter& a_writer, uint32_t a_sampleId, const CaptureImages& a_images)
+{
+    using utils::ImageElement;
+    // The unorm16 halves of the packed vectors, x is the low one
+    const auto* normal = reinterpret_cast<const uint16_t*>(a_images.normal);
+    const auto* toCamera = reinterpret_cast<const uint16_t*>(a_images.toCamera);
+    const uint32_t vectorRowStride = 2 * a_images.pitch;
+    const std::array<utils::PlaneSource, 5> planes = {
+        utils::PlaneSource{ a_images.color, 4, 4 * a_images.pitch, ImageElement::Float16 },
+        utils::PlaneSource{ normal,         2, vectorRowStride,    ImageElement::Uint16 },
+        utils::PlaneSource{ normal + 1,     2, vectorRowStride,    ImageElement::Uint16 },
+        utils::PlaneSource{ toCamera,       2, vectorRowStride,    ImageElement::Uint16 },
+        utils::PlaneSource{ toCamera + 1,   2, vectorRowStride,    ImageElement::Uint16 }
+    };
+    return a_writer.append(a_sampleId, planes);
+}
+
+bool appendCapture(utils::DatasetWriter& a_writer, uint32_t a_sampleId, const RenderTargets& a_targets)
+{
+    return appendCapture(a_writer, a_sampleId, CaptureImages{
+        .color = a_targets.color.data(),
+        .normal = a_targets.normal.data(),
+        .toCamera = a_targets.toCamera.data(),
+        .pitch = a_targets.pitch
+    });
+}
+}
@@ -0,0 +1,32 @@
+#pragma once
+#include <utils/DatasetShards.h>
+#include "Rasterizer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neural::graphics {
+
+// The planes of a capture: the color target is gray with alpha 1 so only its red channel is kept in
+// a_precision. normal and toCamera keep the octahedral unorm16 coordinates of their targets as Unorm16
+// planes, an exact copy whatever a_precision is, utils::decodeOctahedral turns them back into vectors
+std::vector<utils::DatasetPlane> getCapturePlanes(utils::PlanePrecision a_precision,
+                                                 utils::PlaneCompression a_compression);
+
+utils::DatasetWriterCreateInfo getCaptureWriterCreateInfo(const std::string& a_directory, uint32_t a_width,
+                                                          uint32_t a_height, utils::PlanePrecision a_precision,
+                                                          utils::PlaneCompression a_compression);
+
+// The G-buffer encodings of utils/GBufferEncoding.h with rows of pitch pixels, e.g. mapped readback buffers
+struct CaptureImages {
+    const uint16_t* color;     // R16G16B16A16_FLOAT
+    const uint32_t* normal;    // R16G16_UNORM, octahedral
+    const uint32_t* toCamera;  // R16G16_UNORM, octahedral
+    uint32_t pitch;
+};
+
+// Appends the color, normal and toCamera targets in the layout of getCapturePlanes
+bool appendCapture(utils::DatasetWriter& a_writer, uint32_t a_sampleId, const CaptureImages& a_images);
+bool appendCapture(utils::DatasetWriter& a_writer, uint32_t a_sampleId, const RenderTargets& a_targets);
+}
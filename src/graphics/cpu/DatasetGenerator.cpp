@@ -0,0 +1,160 @@
+#include "DatasetGenerator.h"
+#include "CPURenderEngine.h"
+#include "CaptureDataset.h"
+#include <a_main/Camera.h>
+#include <graphics/MeshLod.h>
+#include <utils/TaskScheduler.h>
+
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <mutex>
+
+namespace neural::graphics {
+
+namespace {
+constexpr float k_pi = 3.14159265358979f;
+
+// SplitMix64. std distributions are implementation-defined, this gives the same samples on every platform
+class SampleRandom {
+public:
+    SampleRandom(uint64_t a_seed, uint32_t a_sample) : m_state(mix(a_seed ^ mix(a_sample + 1ull))) {}
+
+    uint64_t next() {
+        m_state += 0x9E3779B97F4A7C15ull;
+        return mix(m_state);
+    }
+    float uniform(float a_min, float a_max) {
+        return a_min + (a_max - a_min) * static_cast<float>(next() >> 40) * 0x1.0p-24f;
+    }
+    uint32_t index(uint32_t a_count) {
+        return static_cast<uint32_t>(((next() >> 32) * a_count) >> 32);
+    }
+private:
+    static uint64_t mix(uint64_t a_value) {
+        a_value = (a_value ^ (a_value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        a_value = (a_value ^ (a_value >> 27)) * 0x94D049BB133111EBull;
+        return a_value ^ (a_value >> 31);
+    }
+
+    uint64_t m_state;
+};
+
+// Rasterizers are big, every task takes one for its samples instead of allocating its own
+class RasterizerPool {
+public:
+    RasterizerPool(uint32_t a_width, uint32_t a_height) : m_width(a_width), m_height(a_height) {}
+
+    std::unique_ptr<Rasterizer> acquire() {
+        {
+            std::lock_guard lock(m_mutex);
+            if (!m_free.empty()) {
+                std::unique_ptr<Rasterizer> rasterizer = std::move(m_free.back());
+                m_free.pop_back();
+                return rasterizer;
+            }
+        }
+        auto rasterizer = std::make_unique<Rasterizer>();
+        rasterizer->initialize(m_width, m_height);
+        return rasterizer;
+    }
+    void release(std::unique_ptr<Rasterizer> a_rasterizer) {
+        std::lock_guard lock(m_mutex);
+        m_free.push_back(std::move(a_rasterizer));
+    }
+private:
+    uint32_t m_width;
+    uint32_t m_height;
+    std::mutex m_mutex;
+    std::vector<std::unique_ptr<Rasterizer>> m_free;
+};
+}  // anonymous namespace
+
+DatasetSample getDatasetSample(const DatasetSpec& a_spec, uint32_t a_sample)
+{
+    SampleRandom random(a_spec.seed, a_sample);
+    DatasetSample sample;
+    sample.mesh = random.index(static_cast<uint32_t>(a_spec.meshNames.size()));
+    sample.lightPosition = a_spec.lightPositions[random.index(static_cast<uint32_t>(a_spec.lightPositions.size()))];
+
+    const float distance = random.uniform(a_spec.minCameraDistance, a_spec.maxCameraDistance);
+    const float azimuth = random.uniform(0.0f, 2.0f * k_pi);
+    float horizontal, vertical;
+    if (a_spec.cameraDistribution == CameraDistribution::Sphere) {
+        vertical = random.uniform(-1.0f, 1.0f);
+        horizontal = std::sqrt(1.0f - vertical * vertical);
+    } else {
+        const float elevation = DirectX::XMConvertToRadians(random.uniform(a_spec.minElevation, a_spec.maxElevation));
+        vertical = std::sin(elevation);
+        horizontal = std::cos(elevation);
+    }
+
+    // The mesh is drawn with CPURenderEngine's world matrix, a translation to (0, 3, 10)
+    sample.cameraTarget = { 0.0f, 3.0f, 10.0f };
+    sample.cameraPosition = {
+        sample.cameraTarget.x + distance * horizontal * std::sin(azimuth),
+        sample.cameraTarget.y + distance * vertical,
+        sample.cameraTarget.z + distance * horizontal * std::cos(azimuth)
+    };
+    // Looking straight up or down the Y axis has no defined roll
+    sample.cameraUp = std::abs(vertical) > 0.999f ? DirectX::XMFLOAT3{ 0.0f, 0.0f, 1.0f }
+                                                  : DirectX::XMFLOAT3{ 0.0f, 1.0f, 0.0f };
+    return sample;
+}
+
+DatasetStats generateDataset(MeshStorage& a_meshStorage, const DatasetSpec& a_spec)
+{
+    assert(!a_spec.meshNames.empty() && !a_spec.lightPositions.empty());
+    assert(a_spec.minCameraDistance >= 1.0f);
+    // Looked up before the tasks start, MeshStorage::getMeshInfo isn't safe to call concurrently
+    std::vector<MeshStorage::MeshInfo> meshInfos;
+    std::vector<std::vector<std::array<DrawCall, 2>>> drawCalls;  // per mesh and LOD
+    for (const std::string& meshName : a_spec.meshNames) {
+        meshInfos.push_back(a_meshStorage.getMeshInfo(meshName.c_str()));
+        drawCalls.emplace_back();
+        for (uint32_t lod = 0; lod < meshInfos.back().lods.size(); ++lod) {
+            drawCalls.back().push_back(CPURenderEngine::getSceneDrawCalls(a_meshStorage, meshName.c_str(), lod));
+        }
+    }
+    DirectX::XMFLOAT4X4 worldMatrix;
+    DirectX::XMStoreFloat4x4(&worldMatrix, DirectX::XMMatrixTranslation(0, 3, 10));
+
+    utils::DatasetWriter writer;
+    if (!writer.initialize(getCaptureWriterCreateInfo(a_spec.outputDirectory, a_spec.width, a_spec.height,
+                                                      a_spec.precision, a_spec.compression))) {
+        return {};
+    }
+    const uint32_t firstId = writer.getSampleCount();
+
+    RasterizerPool rasterizers(a_spec.width, a_spec.height);
+    std::vector<double> sampleSeconds(a_spec.sampleCount);
+    const auto start = std::chrono::steady_clock::now();
+    utils::getTaskScheduler().parallelFor(0, a_spec.sampleCount, 1, [&](uint32_t a_begin, uint32_t a_end) {
+        std::unique_ptr<Rasterizer> rasterizer = rasterizers.acquire();
+        for (uint32_t i = a_begin; i < a_end; ++i) {
+            const auto sampleStart = std::chrono::steady_clock::now();
+            const DatasetSample sample = getDatasetSample(a_spec, i);
+            Camera camera;
+            camera.setFrustum(DirectX::XMConvertToRadians(45), static_cast<float>(a_spec.width) / a_spec.height, 1, 1000);
+            camera.lookAt(sample.cameraPosition, sample.cameraTarget, sample.cameraUp);
+            const uint32_t lod = selectMeshLod(meshInfos[sample.mesh], worldMatrix, camera, a_spec.height,
+                                               a_spec.lodPixelError);
+            rasterizer->render(drawCalls[sample.mesh][lod],
+                               CPURenderEngine::getFrameConstants(worldMatrix, camera, sample.lightPosition));
+
+            // Records are stored in completion order, the id keeps the sample number
+            appendCapture(writer, firstId + i, rasterizer->getRenderTargets());
+            sampleSeconds[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - sampleStart).count();
+        }
+        rasterizers.release(std::move(rasterizer));
+    });
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return {
+        .sampleCount = a_spec.sampleCount,
+        .seconds = seconds,
+        .samplesPerSecond = seconds > 0.0 ? a_spec.sampleCount / seconds : 0.0,
+        .sampleSeconds = std::move(sampleSeconds)
+    };
+}
+}
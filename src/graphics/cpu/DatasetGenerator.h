@@ -0,0 +1,60 @@
+#pragma once
+#include <graphics/MeshStorage.h>
+#include <utils/DatasetShards.h>
+#include <utils/VectorMath.h>
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neural::graphics {
+
+enum class CameraDistribution
+{
+    Sphere,  // directions uniform over the whole sphere around the mesh
+    Orbit    // azimuth uniform, elevation uniform between minElevation and maxElevation
+};
+
+struct DatasetSpec {
+    std::vector<std::string> meshNames = { "cat" };
+    CameraDistribution cameraDistribution = CameraDistribution::Orbit;
+    float minCameraDistance = 8.0f;
+    float maxCameraDistance = 20.0f;
+    float minElevation = 5.0f;   // degrees, Orbit only
+    float maxElevation = 60.0f;
+    std::vector<std::array<float, 3>> lightPositions = { { 0, 20, 0 } };
+    uint32_t width = 800;
+    uint32_t height = 600;
+    uint32_t sampleCount = 0;
+    uint64_t seed = 0;
+    float lodPixelError = 1.0f;  // see RenderSettings::lodPixelError
+    utils::PlanePrecision precision = utils::PlanePrecision::Float16;  // of color, see getCapturePlanes
+    utils::PlaneCompression compression = utils::PlaneCompression::Lossless;
+    std::string outputDirectory = MODEL_DATA_ROOT "/dataset";
+};
+
+struct DatasetSample {
+    uint32_t mesh;               // index in DatasetSpec::meshNames
+    DirectX::XMFLOAT3 cameraPosition;
+    DirectX::XMFLOAT3 cameraTarget;
+    DirectX::XMFLOAT3 cameraUp;
+    std::array<float, 3> lightPosition;
+};
+
+struct DatasetStats {
+    uint32_t sampleCount;
+    double seconds;
+    double samplesPerSecond;
+    std::vector<double> sampleSeconds;  // render and write time of every sample, by sample
+};
+
+// Every sample has its own random stream, seeded from the spec seed and the sample index, so a sample
+// is the same whatever thread renders it and however many samples are generated
+DatasetSample getDatasetSample(const DatasetSpec& a_spec, uint32_t a_sample);
+
+// Renders the samples on the CPU rasterizer and appends the color, normal and toCamera targets to the
+// sharded dataset in outputDirectory, numbered after the samples already there. Samples run in parallel on the task scheduler, one whole
+// sample per task, so the throughput grows with the number of workers
+DatasetStats generateDataset(MeshStorage& a_meshStorage, const DatasetSpec& a_spec);
+}
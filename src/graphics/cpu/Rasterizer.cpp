@@ -0,0 +1,288 @@
+#include "RasterizerKernelsImpl.h"
+#include <utils/TaskScheduler.h>
+
+#include <cassert>
+#include <cstring>
+
+namespace neural::graphics {
+
+namespace {
+constexpr uint32_t k_setupChunkSize = 1024;  // triangles
+constexpr uint32_t k_vertexGrain = 1024;
+// {0, 0, 0, 1} in the target formats
+constexpr uint16_t k_clearColor[4] = { 0, 0, 0, 0x3C00 };
+constexpr uint32_t k_clearVector = 0;
+
+RasterizeTriangleFunction getRasterizeTriangle()
+{
+    switch (utils::getIsaTier())
+    {
+#if NEURAL_ARCH_X64
+    case utils::IsaTier::Avx512Fp16:
+    case utils::IsaTier::Avx512:
+        return getRasterizeTriangleAvx512();
+    case utils::IsaTier::Avx2:
+        return getRasterizeTriangleAvx2();
+#endif
+    default:
+        return getRasterizeTriangleBaseline();
+    }
+}
+
+// Row vector times a row-major matrix, as mul(float4(v, w), M) in the shader
+std::array<float, 4> transform(const std::array<float, 3>& a_vector, float a_w, const std::array<float, 16>& a_matrix)
+{
+    std::array<float, 4> result;
+    for (uint32_t j = 0; j < 4; ++j) {
+        result[j] = a_vector[0] * a_matrix[j] + a_vector[1] * a_matrix[4 + j] +
+                    a_vector[2] * a_matrix[8 + j] + a_w * a_matrix[12 + j];
+    }
+    return result;
+}
+
+Rasterizer::ClipVertex lerp(const Rasterizer::ClipVertex& a_v0, const Rasterizer::ClipVertex& a_v1, float a_t)
+{
+    Rasterizer::ClipVertex result;
+    for (uint32_t c = 0; c < 4; ++c) {
+        result.position[c] = a_v0.position[c] + (a_v1.position[c] - a_v0.position[c]) * a_t;
+    }
+    for (uint32_t c = 0; c < 3; ++c) {
+        result.positionW[c] = a_v0.positionW[c] + (a_v1.positionW[c] - a_v0.positionW[c]) * a_t;
+        result.normalW[c] = a_v0.normalW[c] + (a_v1.normalW[c] - a_v0.normalW[c]) * a_t;
+    }
+    return result;
+}
+}  // anonymous namespace
+
+RasterizeTriangleFunction getRasterizeTriangleBaseline()
+{
+    return rasterizeTriangle<8>;
+}
+
+void Rasterizer::initialize(uint32_t a_width, uint32_t a_height)
+{
+    m_tilesX = (a_width + k_tileSize - 1) / k_tileSize;
+    m_tilesY = (a_height + k_tileSize - 1) / k_tileSize;
+    m_targets.width = a_width;
+    m_targets.height = a_height;
+    m_targets.pitch = m_tilesX * k_tileSize;
+    const size_t pixelCount = static_cast<size_t>(m_targets.pitch) * a_height;
+    m_targets.screen.resize(pixelCount);
+    m_targets.color.resize(pixelCount * 4);
+    m_targets.normal.resize(pixelCount);
+    m_targets.toCamera.resize(pixelCount);
+    m_targets.depth.resize(pixelCount);
+}
+
+void Rasterizer::render(std::span<const DrawCall> a_drawCalls, const FrameConstants& a_constants)
+{
+    utils::TaskScheduler& scheduler = utils::getTaskScheduler();
+    m_lightPosition = a_constants.lightPosition;
+
+    // Vertex stage
+    uint32_t vertexCount = 0;
+    m_chunks.clear();
+    for (uint32_t i = 0; i < a_drawCalls.size(); ++i) {
+        const uint32_t triangleCount = a_drawCalls[i].indexCount / 3;
+        for (uint32_t first = 0; first < triangleCount; first += k_setupChunkSize) {
+            m_chunks.push_back({ i, vertexCount, first, std::min(first + k_setupChunkSize, triangleCount) });
+        }
+        vertexCount += a_drawCalls[i].vertexCount;
+    }
+    m_vertices.resize(vertexCount);
+
+    uint32_t firstVertex = 0;
+    for (const DrawCall& drawCall : a_drawCalls) {
+        scheduler.parallelFor(0, drawCall.vertexCount, k_vertexGrain, [&](uint32_t a_begin, uint32_t a_end) {
+            const uint8_t* vertices = static_cast<const uint8_t*>(drawCall.vertices);
+            for (uint32_t i = a_begin; i < a_end; ++i) {
+                std::array<float, 3> position, normal;
+                std::memcpy(position.data(), vertices + static_cast<size_t>(i) * drawCall.vertexStride, sizeof(position));
+                std::memcpy(normal.data(), vertices + static_cast<size_t>(i) * drawCall.vertexStride + sizeof(position),
+                            sizeof(normal));
+
+                ClipVertex& vertex = m_vertices[firstVertex + i];
+                if (drawCall.useWorldMatrix) {
+                    const std::array<float, 4> positionW = transform(position, 1.0f, a_constants.worldMatrix);
+                    const std::array<float, 4> normalW = transform(normal, 0.0f, a_constants.worldMatrix);
+                    vertex.positionW = { positionW[0], positionW[1], positionW[2] };
+                    vertex.normalW = { normalW[0], normalW[1], normalW[2] };
+                } else {
+                    vertex.positionW = position;
+                    vertex.normalW = normal;
+                }
+                vertex.position = transform(vertex.positionW, 1.0f, a_constants.viewProjMatrix);
+            }
+        });
+        firstVertex += drawCall.vertexCount;
+    }
+
+    // Triangle setup and binning, chunks only write their own triangles and bins
+    const uint32_t chunkCount = static_cast<uint32_t>(m_chunks.size());
+    if (m_triangles.size() < chunkCount) {
+        m_triangles.resize(chunkCount);
+        m_bins.resize(chunkCount);
+    }
+    scheduler.parallelFor(0, chunkCount, 1, [&](uint32_t a_begin, uint32_t a_end) {
+        for (uint32_t chunk = a_begin; chunk < a_end; ++chunk) {
+            setupTriangles(chunk, a_drawCalls[m_chunks[chunk].drawCall]);
+        }
+    });
+
+    // Tiles own their pixels, so they are cleared and rasterized without synchronization
+    scheduler.parallelFor(0, m_tilesX * m_tilesY, 1, [&](uint32_t a_begin, uint32_t a_end) {
+        for (uint32_t tile = a_begin; tile < a_end; ++tile) {
+            rasterizeTile(tile);
+        }
+    });
+}
+
+void Rasterizer::setupTriangles(uint32_t a_chunk, const DrawCall& a_drawCall)
+{
+    const SetupChunk& chunk = m_chunks[a_chunk];
+    m_triangles[a_chunk].clear();
+    m_bins[a_chunk].resize(m_tilesX * m_tilesY);
+    for (std::vector<uint32_t>& bin : m_bins[a_chunk]) {
+        bin.clear();
+    }
+
+    const ClipVertex* vertices = m_vertices.data() + chunk.firstVertex;
+    for (uint32_t triangle = chunk.firstTriangle; triangle < chunk.lastTriangle; ++triangle) {
+        const uint32_t* indices = a_drawCall.indices + triangle * 3;
+        assert(indices[0] < a_drawCall.vertexCount && indices[1] < a_drawCall.vertexCount &&
+               indices[2] < a_drawCall.vertexCount);
+        clipTriangle(a_chunk, vertices[indices[0]], vertices[indices[1]], vertices[indices[2]]);
+    }
+}
+
+// Clips against the near plane z >= 0. The other planes need no clipping: after it w >= near, so the
+// screen coordinates stay finite, the bounding box is clamped to the screen and depth > 1 fails the test
+void Rasterizer::clipTriangle(uint32_t a_chunk, const ClipVertex& a_v0, const ClipVertex& a_v1, const ClipVertex& a_v2)
+{
+    const ClipVertex* input[3] = { &a_v0, &a_v1, &a_v2 };
+    uint32_t insideCount = 0;
+    for (const ClipVertex* vertex : input) {
+        insideCount += vertex->position[2] >= 0.0f;
+    }
+    if (insideCount == 3) {
+        addTriangle(a_chunk, a_v0, a_v1, a_v2);
+        return;
+    }
+    if (insideCount == 0) {
+        return;
+    }
+
+    ClipVertex polygon[4];
+    uint32_t polygonSize = 0;
+    for (uint32_t i = 0; i < 3; ++i) {
+        const ClipVertex& current = *input[i];
+        const ClipVertex& next = *input[(i + 1) % 3];
+        const bool currentInside = current.position[2] >= 0.0f;
+        const bool nextInside = next.position[2] >= 0.0f;
+        if (currentInside) {
+            polygon[polygonSize++] = current;
+        }
+        if (currentInside != nextInside) {
+            const float t = current.position[2] / (current.position[2] - next.position[2]);
+            polygon[polygonSize++] = lerp(current, next, t);
+        }
+    }
+    for (uint32_t i = 2; i < polygonSize; ++i) {
+        addTriangle(a_chunk, polygon[0], polygon[i - 1], polygon[i]);
+    }
+}
+
+void Rasterizer::addTriangle(uint32_t a_chunk, const ClipVertex& a_v0, const ClipVertex& a_v1, const ClipVertex& a_v2)
+{
+    const ClipVertex* vertices[3] = { &a_v0, &a_v1, &a_v2 };
+    const float width = static_cast<float>(m_targets.width);
+    const float height = static_cast<float>(m_targets.height);
+
+    Triangle triangle;
+    for (uint32_t i = 0; i < 3; ++i) {
+        const ClipVertex& vertex = *vertices[i];
+        const float invW = 1.0f / vertex.position[3];
+        triangle.x[i] = (vertex.position[0] * invW * 0.5f + 0.5f) * width;
+        triangle.y[i] = (0.5f - vertex.position[1] * invW * 0.5f) * height;
+        triangle.z[i] = vertex.position[2] * invW;
+        triangle.invW[i] = invW;
+        for (uint32_t c = 0; c < 3; ++c) {
+            triangle.positionW[i][c] = vertex.positionW[c] * invW;
+            triangle.normalW[i][c] = vertex.normalW[c] * invW;
+        }
+    }
+
+    // Clockwise triangles on the screen (y goes down) have a positive area and are front faces
+    const float area = (triangle.x[1] - triangle.x[0]) * (triangle.y[2] - triangle.y[0]) -
+                       (triangle.y[1] - triangle.y[0]) * (triangle.x[2] - triangle.x[0]);
+    if (!(area > 0.0f)) {
+        return;
+    }
+    triangle.invArea = 1.0f / area;
+
+    // Pixels whose centers are inside the bounds of the vertices
+    const auto [minX, maxX] = std::minmax({ triangle.x[0], triangle.x[1], triangle.x[2] });
+    const auto [minY, maxY] = std::minmax({ triangle.y[0], triangle.y[1], triangle.y[2] });
+    triangle.minX = static_cast<int32_t>(std::max(std::ceil(minX - 0.5f), 0.0f));
+    triangle.minY = static_cast<int32_t>(std::max(std::ceil(minY - 0.5f), 0.0f));
+    triangle.maxX = static_cast<int32_t>(std::min(std::floor(maxX - 0.5f), width - 1.0f));
+    triangle.maxY = static_cast<int32_t>(std::min(std::floor(maxY - 0.5f), height - 1.0f));
+    if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+        return;
+    }
+
+    // Top-left rule: pixels exactly on an edge belong to the triangle only for top and left edges
+    for (uint32_t i = 0; i < 3; ++i) {
+        const float dx = triangle.x[(i + 2) % 3] - triangle.x[(i + 1) % 3];
+        const float dy = triangle.y[(i + 2) % 3] - triangle.y[(i + 1) % 3];
+        triangle.topLeft[i] = (dy == 0.0f && dx > 0.0f) || dy < 0.0f;
+    }
+
+    std::vector<Triangle>& triangles = m_triangles[a_chunk];
+    const uint32_t index = static_cast<uint32_t>(triangles.size());
+    triangles.push_back(triangle);
+    for (uint32_t tileY = triangle.minY / k_tileSize; tileY <= triangle.maxY / k_tileSize; ++tileY) {
+        for (uint32_t tileX = triangle.minX / k_tileSize; tileX <= triangle.maxX / k_tileSize; ++tileX) {
+            m_bins[a_chunk][tileY * m_tilesX + tileX].push_back(index);
+        }
+    }
+}
+
+void Rasterizer::rasterizeTile(uint32_t a_tile)
+{
+    const TileRect tile = {
+        .minX = static_cast<int32_t>(a_tile % m_tilesX * k_tileSize),
+        .minY = static_cast<int32_t>(a_tile / m_tilesX * k_tileSize),
+        .maxX = static_cast<int32_t>(std::min((a_tile % m_tilesX + 1) * k_tileSize, m_targets.width) - 1),
+        .maxY = static_cast<int32_t>(std::min((a_tile / m_tilesX + 1) * k_tileSize, m_targets.height) - 1),
+    };
+
+    // Includes the padding past the width, the kernels read it
+    for (int32_t y = tile.minY; y <= tile.maxY; ++y) {
+        const size_t begin = static_cast<size_t>(y) * m_targets.pitch + tile.minX;
+        const size_t end = begin + k_tileSize;
+        std::fill(m_targets.screen.begin() + begin, m_targets.screen.begin() + end, 0xFF000000u);
+        std::fill(m_targets.depth.begin() + begin, m_targets.depth.begin() + end, 1.0f);
+        for (size_t pixel = begin; pixel < end; ++pixel) {
+            std::memcpy(&m_targets.color[pixel * 4], k_clearColor, sizeof(k_clearColor));
+        }
+        std::fill(m_targets.normal.begin() + begin, m_targets.normal.begin() + end, k_clearVector);
+        std::fill(m_targets.toCamera.begin() + begin, m_targets.toCamera.begin() + end, k_clearVector);
+    }
+
+    const RasterizeTriangleFunction rasterize = getRasterizeTriangle();
+    const TargetPointers targets = {
+        .pitch = m_targets.pitch,
+        .screen = m_targets.screen.data(),
+        .color = m_targets.color.data(),
+        .normal = m_targets.normal.data(),
+        .toCamera = m_targets.toCamera.data(),
+        .depth = m_targets.depth.data()
+    };
+    for (uint32_t chunk = 0; chunk < m_chunks.size(); ++chunk) {
+        for (const uint32_t index : m_bins[chunk][a_tile]) {
+            rasterize(m_triangles[chunk][index], tile, m_lightPosition.data(), targets);
+        }
+    }
+}
+}  // namespace neural::graphics
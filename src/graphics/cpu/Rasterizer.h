@@ -0,0 +1,98 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace neural::graphics {
+
+// Same outputs as 1.vsps.hlsl, in the encodings of utils/GBufferEncoding.h.
+// Rows are pitch pixels apart, the pitch is the width rounded up to whole tiles
+struct RenderTargets {
+    uint32_t width = 0;
+    uint32_t height = 0;
+    uint32_t pitch = 0;
+    std::vector<uint32_t> screen;    // R8G8B8A8_UNORM
+    std::vector<uint16_t> color;     // R16G16B16A16_FLOAT
+    std::vector<uint32_t> normal;    // R16G16_UNORM, octahedral
+    std::vector<uint32_t> toCamera;  // R16G16_UNORM, octahedral
+    std::vector<float> depth;
+};
+
+// Matrices are row-major and multiply row vectors, as DirectXMath stores them
+struct FrameConstants {
+    std::array<float, 16> worldMatrix;
+    std::array<float, 16> viewProjMatrix;
+    std::array<float, 3> lightPosition;
+};
+
+// Vertices start with float3 position and float3 normal, like MeshStorage::Vertex,
+// indices are relative to a_vertices
+struct DrawCall {
+    const void* vertices;
+    uint32_t vertexStride;
+    uint32_t vertexCount;
+    const uint32_t* indices;
+    uint32_t indexCount;
+    bool useWorldMatrix;  // objectId == 0 in the shader
+};
+
+// Tile-binned rasterizer for the 1.vsps.hlsl pipeline with D3D12 rules: clockwise front faces with
+// back-face culling, top-left fill rule, pixel centers at .5, depth test LESS, near plane clipping.
+// Vertices, triangle setup and tiles run on utils::TaskScheduler, the tile kernel is dispatched on
+// utils::IsaTier
+class Rasterizer {
+public:
+    static constexpr uint32_t k_tileSize = 64;
+
+    void initialize(uint32_t a_width, uint32_t a_height);
+    // Clears the targets to {0, 0, 0, 1} and depth to 1, then draws the calls in order
+    void render(std::span<const DrawCall> a_drawCalls, const FrameConstants& a_constants);
+
+    const RenderTargets& getRenderTargets() const {
+        return m_targets;
+    }
+
+    // Internal, shared with the tile kernels
+    struct ClipVertex {
+        std::array<float, 4> position;  // clip space
+        std::array<float, 3> positionW;
+        std::array<float, 3> normalW;
+    };
+    // C arrays, the tile kernels of the tiers don't call members of std::array
+    struct Triangle {
+        float x[3];
+        float y[3];
+        float z[3];             // depth
+        float invW[3];
+        float positionW[3][3];  // divided by w
+        float normalW[3][3];    // divided by w
+        bool topLeft[3];        // of the edge opposite to the vertex
+        float invArea;
+        int32_t minX, minY, maxX, maxY;
+    };
+private:
+    struct SetupChunk {
+        uint32_t drawCall;
+        uint32_t firstVertex;  // in m_vertices
+        uint32_t firstTriangle;
+        uint32_t lastTriangle;
+    };
+    void setupTriangles(uint32_t a_chunk, const DrawCall& a_drawCall);
+    void clipTriangle(uint32_t a_chunk, const ClipVertex& a_v0, const ClipVertex& a_v1, const ClipVertex& a_v2);
+    void addTriangle(uint32_t a_chunk, const ClipVertex& a_v0, const ClipVertex& a_v1, const ClipVertex& a_v2);
+    void rasterizeTile(uint32_t a_tile);
+
+    RenderTargets m_targets;
+    uint32_t m_tilesX = 0;
+    uint32_t m_tilesY = 0;
+    std::array<float, 3> m_lightPosition;
+    std::vector<ClipVertex> m_vertices;
+    std::vector<SetupChunk> m_chunks;
+    // Setup triangles and per-tile indices of them, one set per setup chunk, so chunks don't share
+    // memory and tiles read the chunks in order, which keeps the draw order
+    std::vector<std::vector<Triangle>> m_triangles;
+    std::vector<std::vector<std::vector<uint32_t>>> m_bins;
+};
+}  // namespace neural::graphics
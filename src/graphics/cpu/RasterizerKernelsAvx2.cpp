@@ -0,0 +1,11 @@
+// Compiled with AVX2 and FMA, see src/CMakeLists.txt
+#include "RasterizerKernelsImpl.h"
+
+namespace neural::graphics {
+#if NEURAL_ARCH_X64
+RasterizeTriangleFunction getRasterizeTriangleAvx2()
+{
+    return rasterizeTriangle<8>;
+}
+#endif
+}  // namespace neural::graphics
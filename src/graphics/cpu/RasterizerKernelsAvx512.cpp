@@ -0,0 +1,11 @@
+// Compiled with AVX-512 F/BW/VL/DQ, 16 pixels fill one ZMM register, see src/CMakeLists.txt
+#include "RasterizerKernelsImpl.h"
+
+namespace neural::graphics {
+#if NEURAL_ARCH_X64
+RasterizeTriangleFunction getRasterizeTriangleAvx512()
+{
+    return rasterizeTriangle<16>;
+}
+#endif
+}  // namespace neural::graphics
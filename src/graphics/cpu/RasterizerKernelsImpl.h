@@ -0,0 +1,154 @@
+#pragma once
+
+#include "Rasterizer.h"
+#include <utils/CpuFeatures.h>
+#include <utils/GBufferEncoding.h>
+
+namespace neural::graphics {
+
+// Inclusive pixel bounds of a tile
+struct TileRect {
+    int32_t minX, minY, maxX, maxY;
+};
+
+// RenderTargets as plain pointers, the kernels don't call members of std::vector
+struct TargetPointers {
+    uint32_t pitch;
+    uint32_t* screen;
+    uint16_t* color;
+    uint32_t* normal;
+    uint32_t* toCamera;
+    float* depth;
+};
+
+// Rasterizes the part of the triangle inside the tile and runs the pixel shader of 1.vsps.hlsl
+using RasterizeTriangleFunction = void (*)(const Rasterizer::Triangle& a_triangle, const TileRect& a_tile,
+                                           const float* a_lightPosition, const TargetPointers& a_targets);
+
+// One per utils::IsaTier, every one is the kernel below compiled with the target flags of the tier
+RasterizeTriangleFunction getRasterizeTriangleBaseline();
+RasterizeTriangleFunction getRasterizeTriangleAvx2();
+RasterizeTriangleFunction getRasterizeTriangleAvx512();
+
+namespace {
+// Walks the rows of the bounding box L pixels at a time. Every step of the lane loops is the same for
+// all lanes, coverage and depth only select which lanes are written, so the compiler maps lanes onto vectors
+template<uint32_t L>
+void rasterizeTriangle(const Rasterizer::Triangle& a_triangle, const TileRect& a_tile, const float* a_lightPosition,
+                       const TargetPointers& a_targets)
+{
+    const Rasterizer::Triangle& t = a_triangle;
+    const int32_t minX = utils::isaMax(t.minX, a_tile.minX);
+    const int32_t minY = utils::isaMax(t.minY, a_tile.minY);
+    const int32_t maxX = utils::isaMin(t.maxX, a_tile.maxX);
+    const int32_t maxY = utils::isaMin(t.maxY, a_tile.maxY);
+    if (minX > maxX || minY > maxY) {
+        return;
+    }
+
+    // Edge i is opposite to vertex i and goes from vertex i + 1 to i + 2. It is evaluated relative to its
+    // start, E_i = dx * (py - y0) - dy * (px - x0), and E_i / area is the barycentric of vertex i
+    float edgeX[3], edgeY[3], edgeDx[3], edgeDy[3];
+    int32_t topLeft[3];
+    for (uint32_t i = 0; i < 3; ++i) {
+        const uint32_t a = (i + 1) % 3;
+        const uint32_t b = (i + 2) % 3;
+        edgeX[i] = t.x[a];
+        edgeY[i] = t.y[a];
+        edgeDx[i] = t.x[b] - t.x[a];
+        edgeDy[i] = t.y[b] - t.y[a];
+        topLeft[i] = t.topLeft[i];
+    }
+
+    // Lanes start at a multiple of L, rows are padded to whole tiles, so the lanes past the triangle are
+    // still inside the tile and every load is a full vector from memory this thread owns
+    const int32_t alignedMinX = minX / static_cast<int32_t>(L) * static_cast<int32_t>(L);
+    for (int32_t y = minY; y <= maxY; ++y) {
+        const float py = static_cast<float>(y) + 0.5f;
+        const size_t rowOffset = static_cast<size_t>(y) * a_targets.pitch;
+        for (int32_t x = alignedMinX; x <= maxX; x += L) {
+            float* depth = &a_targets.depth[rowOffset + x];
+            alignas(64) float l[3][L];
+            alignas(64) float z[L];
+            alignas(64) int32_t written[L];
+            int32_t anyWritten = 0;
+            for (uint32_t k = 0; k < L; ++k) {
+                const int32_t pixel = x + static_cast<int32_t>(k);
+                const float px = static_cast<float>(pixel) + 0.5f;
+                int32_t inside = (pixel >= minX) & (pixel <= maxX);
+                for (uint32_t i = 0; i < 3; ++i) {
+                    const float e = edgeDx[i] * (py - edgeY[i]) - edgeDy[i] * (px - edgeX[i]);
+                    inside &= (e > 0.0f) | ((e == 0.0f) & topLeft[i]);
+                    l[i][k] = e * t.invArea;
+                }
+                z[k] = l[0][k] * t.z[0] + l[1][k] * t.z[1] + l[2][k] * t.z[2];
+                written[k] = inside & (z[k] < depth[k]);
+                anyWritten |= written[k];
+            }
+            if (!anyWritten) {
+                continue;
+            }
+
+            // Perspective-correct attributes: attribute / w and 1 / w are linear in screen space
+            alignas(64) float positionW[3][L];
+            alignas(64) float normalW[3][L];
+            for (uint32_t k = 0; k < L; ++k) {
+                const float w = 1.0f / (l[0][k] * t.invW[0] + l[1][k] * t.invW[1] + l[2][k] * t.invW[2]);
+                for (uint32_t c = 0; c < 3; ++c) {
+                    positionW[c][k] = (l[0][k] * t.positionW[0][c] + l[1][k] * t.positionW[1][c] +
+                                       l[2][k] * t.positionW[2][c]) * w;
+                    normalW[c][k] = (l[0][k] * t.normalW[0][c] + l[1][k] * t.normalW[1][c] +
+                                     l[2][k] * t.normalW[2][c]) * w;
+                }
+            }
+
+            alignas(64) float lightDir[3][L];
+            alignas(64) float normal[3][L];
+            alignas(64) float color[L];
+            for (uint32_t k = 0; k < L; ++k) {
+                float lightLength = 0.0f;
+                float normalLength = 0.0f;
+                for (uint32_t c = 0; c < 3; ++c) {
+                    lightDir[c][k] = a_lightPosition[c] - positionW[c][k];
+                    lightLength += lightDir[c][k] * lightDir[c][k];
+                    normalLength += normalW[c][k] * normalW[c][k];
+                }
+                const float invLightLength = 1.0f / utils::isaSqrt(lightLength);
+                const float invNormalLength = 1.0f / utils::isaSqrt(normalLength);
+                float lambert = 0.0f;
+                for (uint32_t c = 0; c < 3; ++c) {
+                    lightDir[c][k] *= invLightLength;
+                    normal[c][k] = normalW[c][k] * invNormalLength;
+                    lambert += lightDir[c][k] * normal[c][k];
+                }
+                color[k] = utils::isaMax(lambert, 0.0f) + 0.2f;
+            }
+
+            uint32_t* screen = &a_targets.screen[rowOffset + x];
+            uint32_t* normalTexels = &a_targets.normal[rowOffset + x];
+            uint32_t* toCameraTexels = &a_targets.toCamera[rowOffset + x];
+            alignas(64) uint16_t colorHalf[L];
+            for (uint32_t k = 0; k < L; ++k) {
+                // R8G8B8A8_UNORM with round to nearest, as the output merger converts it
+                const uint32_t unorm = static_cast<uint32_t>(utils::isaMin(color[k], 1.0f) * 255.0f + 0.5f);
+                screen[k] = written[k] ? 0xFF000000u | unorm << 16 | unorm << 8 | unorm : screen[k];
+                depth[k] = written[k] ? z[k] : depth[k];
+                const uint32_t packedNormal = utils::encodeOctahedral(normal[0][k], normal[1][k], normal[2][k]);
+                const uint32_t packedToCamera = utils::encodeOctahedral(lightDir[0][k], lightDir[1][k], lightDir[2][k]);
+                normalTexels[k] = written[k] ? packedNormal : normalTexels[k];
+                toCameraTexels[k] = written[k] ? packedToCamera : toCameraTexels[k];
+                colorHalf[k] = utils::encodeFloat16(color[k]);
+            }
+            for (uint32_t k = 0; k < L; ++k) {
+                if (!written[k]) {
+                    continue;
+                }
+                uint16_t* colorTexel = &a_targets.color[(rowOffset + x + k) * 4];
+                colorTexel[0] = colorTexel[1] = colorTexel[2] = colorHalf[k];
+                colorTexel[3] = 0x3C00;  // 1.0
+            }
+        }
+    }
+}
+}  // anonymous namespace
+}  // namespace neural::graphics
@@ -54,6 +54,25 @@ void DX12RenderEngine::renderGUI() {
         ImGui::Begin("Render settings");
         ImGui::Text("Application average %.3f ms/frame (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate);
         ImGui::InputInt("Screenshot Counter", &m_settings.screenshotCounter);
+        ImGui::SliderFloat("LOD pixel error", &m_settings.lodPixelError, 0.0f, 8.0f);
+        ImGui::SliderInt("Instances", &m_settings.instanceCount, 1, 10000);
+        const HeapAllocator::Stats heapStats = m_resourceManager.getHeapAllocator()->getStats();
+        ImGui::Text("Resource heaps %u: %.1f / %.1f MiB, fragmentation %.2f", heapStats.heapCount,
+                    heapStats.memory.usedSize / 1048576.0, heapStats.memory.capacity / 1048576.0,
+                    heapStats.memory.getFragmentation());
+        const PipelineCacheStats pipelineStats = m_pipelineCache.getStats();
+        ImGui::Text("Pipelines %u: %u from the disk cache, %u compiled, %u failed", pipelineStats.requests,
+                    pipelineStats.diskHits, pipelineStats.misses, pipelineStats.failures);
+        switch (m_sceneManager.getMeshState(m_settings.meshName.c_str())) {
+        case MeshStorage::MeshState::Loading:
+            ImGui::Text("Loading %s...", m_settings.meshName.c_str());
+            break;
+        case MeshStorage::MeshState::Failed:
+            ImGui::Text("Couldn't load %s", m_settings.meshName.c_str());
+            break;
+        default:
+            break;
+        }
         // ImGui::SliderFloat("Rotation angle", &m_settings.rotatingTimeY, 0, DirectX::XM_2PI);
         // ImGui::SliderInt("Rotation speed", &m_settings.rotateSpeedY, -10, 10);
         // ImGui::Checkbox("Enable rotating", &m_settings.enableRotating);
@@ -3,13 +3,13 @@
 #include <iostream>
 
 namespace neural::graphics {
-void DX12RenderEngine::initialize(HWND a_window, int a_width, int a_height)
+void DX12RenderEngine::initialize(void* a_window, int a_width, int a_height)
 {
     DEBUG_LINE(ComPtr<ID3D12Debug> debugController);
     DEBUG_LINE(DX_CALL(D3D12GetDebugInterface(IID_PPV_ARGS(&debugController))));
     DEBUG_LINE(debugController->EnableDebugLayer());
 
-    m_window = a_window;
+    m_window = static_cast<HWND>(a_window);
     m_windowWidth = a_width;
     m_windowHeight = a_height;
     m_currentFrame = k_nSwapChainBuffers;
@@ -21,7 +21,9 @@ void DX12RenderEngine::initialize(HWND a_window, int a_width, int a_height)
     createCommandAllocators();
     createFence();
     initializeDirectML();
-    m_resourceManager.initialize(m_mainDevice.Get(), k_nSwapChainBuffers, 64, 64, 64);
+    m_resourceManager.initialize(m_mainDevice.Get(), k_nSwapChainBuffers, 64, 64, 64, 256);
+    m_renderGraphBackend.initialize(&m_resourceManager, k_nSwapChainBuffers);
+    m_uploadRing.initialize(m_mainDevice.Get(), k_uploadRingSize);
     for (uint32_t frameIndex = 0; frameIndex < k_nSwapChainBuffers; ++frameIndex) {
         initializeFrameResources(frameIndex);
     }
@@ -136,6 +138,7 @@ void DX12RenderEngine::createCommandListAndSendInitialCommands()
     NAME_DX_OBJECT(m_commandList, L"CommandList");
     initialCommands();
     m_commandList->Close();
+    m_uploadRing.finishFrame(1);
 
     ID3D12CommandList* cmdLists[] = { m_commandList.Get() };
     m_commandQueue->ExecuteCommandLists(1, cmdLists);
@@ -172,17 +175,16 @@ void DX12RenderEngine::beginFrame()
         DX_CALL(m_framesFence->SetEventOnCompletion(currentFrameBufferFenceValue, m_eventHandle));
         WaitForSingleObject(m_eventHandle, INFINITE);
     }
+    m_captureQueue.poll();
+    m_resourceManager.beginFrame(static_cast<uint32_t>(currentFrameBufferIndex));
+    m_uploadRing.retire(m_framesFence->GetCompletedValue());
 
     // reset command allocator and command list, open command list
     auto& currentCommandAllocator = m_commandAllocators[currentFrameBufferIndex];
     DX_CALL(currentCommandAllocator->Reset());
     DX_CALL(m_commandList->Reset(currentCommandAllocator.Get(), nullptr));
 
-    auto& currentBuffer = m_resourceManager.getTexture("mainRT", currentFrameBufferIndex);
-
-    auto currentBufferBarrier = CD3DX12_RESOURCE_BARRIER::Transition(currentBuffer.getID3D12Resource(),
-        D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
-    m_commandList->ResourceBarrier(1, &currentBufferBarrier);
+    m_renderGraphBackend.beginFrame(m_commandList.Get(), static_cast<uint32_t>(currentFrameBufferIndex));
 
     m_commandList->RSSetViewports(1, &m_screenViewport);
     m_commandList->RSSetScissorRects(1, &m_screenScissor);
@@ -191,52 +193,15 @@ void DX12RenderEngine::beginFrame()
 void DX12RenderEngine::endFrame()
 {
     const uint64_t currentFrameBufferIndex = m_currentFrame % k_nSwapChainBuffers;
-    auto& currentBuffer = m_resourceManager.getTexture("mainRT", currentFrameBufferIndex);
-    auto currentBufferBarrier = CD3DX12_RESOURCE_BARRIER::Transition(currentBuffer.getID3D12Resource(),
-        D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
-    m_commandList->ResourceBarrier(1, &currentBufferBarrier);
     DX_CALL(m_commandList->Close());
     ID3D12CommandList* cmdLists[] = { m_commandList.Get() };
     m_commandQueue->ExecuteCommandLists(1, cmdLists);
 
     m_commandQueue->Signal(m_framesFence.Get(), m_currentFrame);
+    m_uploadRing.finishFrame(m_currentFrame);
 
-    if (m_settings.doScreenShot) {
-        // wait until the gpu draw current buffer
-        const uint64_t currentFrameBufferFenceValue = m_currentFrame;
-        if (m_framesFence->GetCompletedValue() < currentFrameBufferFenceValue) {
-            DX_CALL(m_framesFence->SetEventOnCompletion(currentFrameBufferFenceValue, m_eventHandle));
-            WaitForSingleObject(m_eventHandle, INFINITE);
-        }
-
-
-        auto colorRT =  m_resourceManager.getTexture("colorMap", currentFrameBufferIndex).getID3D12Resource();
-        auto normalRT =  m_resourceManager.getTexture("normalMap", currentFrameBufferIndex).getID3D12Resource();
-        auto toCameraRT =  m_resourceManager.getTexture("toCameraMap", currentFrameBufferIndex).getID3D12Resource();
-
-        std::wstring suffix = std::to_wstring(m_settings.screenshotCounter); suffix += L".dds";
-        ++m_settings.screenshotCounter; 
-        std::wstring colorFileName    = MODEL_DATA_ROOT L"/colors/color"; colorFileName += suffix;
-        std::wstring normalFileName   = MODEL_DATA_ROOT L"/normals/normal"; normalFileName += suffix;
-        std::wstring toCameraFileName = MODEL_DATA_ROOT L"/toCameras/toCamera"; toCameraFileName += suffix;
-
-        DirectX::SaveDDSTextureToFile(
-            m_commandQueue.Get(), 
-            colorRT, colorFileName.c_str(),
-            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-        DirectX::SaveDDSTextureToFile(
-            m_commandQueue.Get(), 
-            normalRT, normalFileName.c_str(),
-            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-        DirectX::SaveDDSTextureToFile(
-            m_commandQueue.Get(), 
-            toCameraRT, toCameraFileName.c_str(),
-            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_RENDER_TARGET);
-
-        m_settings.doScreenShot = false;
-    }
+    // captureFrame recorded the copies, the capture queue writes them once the fence passes
+    m_settings.doScreenShot = false;
     m_frameBufferFenceValue[currentFrameBufferIndex] = m_currentFrame;
     ++m_currentFrame;
     DX_CALL(m_swapChain->Present(0, 0));
@@ -248,6 +213,9 @@ void DX12RenderEngine::shutdown()
     //m_commandList->Close();
     //m_commandList = nullptr;
     flushFrameBuffers();
+    m_captureQueue.shutdown();
+    m_captureReadback.shutdown();
+    m_dataset.shutdown();
     //m_commandQueue = nullptr;
     //m_swapChain->Release();
     //for (int i = 0; i < k_nSwapChainBuffers; ++i) {
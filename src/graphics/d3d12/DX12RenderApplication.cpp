@@ -1,6 +1,10 @@
 #include "DX12RenderEngine.h"
 #include <utils/Macros.h>
+#include <graphics/cpu/CaptureDataset.h>
+#include <graphics/MeshLod.h>
+#include <utils/TaskScheduler.h>
 
+#include <algorithm>
 #include <iostream>
 #include <cmath>
 
@@ -12,63 +16,6 @@ void DX12RenderEngine::initializeFrameResources(uint32_t a_frameIndex)
     DX_CALL(m_swapChain->GetBuffer(a_frameIndex, IID_PPV_ARGS(&swapchainBuffer)));
     m_resourceManager.createTextureInFrame("mainRT", a_frameIndex, swapchainBuffer);
 
-    m_resourceManager.createTextureInFrame("mainDepth", a_frameIndex, {
-            .format = DXGI_FORMAT_D32_FLOAT,
-            .width = m_windowWidth,
-            .height = m_windowHeight,
-            .clearValue = D3D12_CLEAR_VALUE {
-                .Format = DXGI_FORMAT_D32_FLOAT,
-                .DepthStencil = {.Depth = 1.0f, .Stencil = 0}
-            },
-            .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL,
-            .initialState = D3D12_RESOURCE_STATE_DEPTH_WRITE,
-    });
-
-    auto& colorMap = m_resourceManager.createTextureInFrame("colorMap", a_frameIndex, {
-            .format = DXGI_FORMAT_R32G32B32A32_FLOAT,
-            .width = m_windowWidth,
-            .height = m_windowHeight,
-            .clearValue = D3D12_CLEAR_VALUE {
-                .Format = DXGI_FORMAT_R32G32B32A32_FLOAT,
-                .Color = {0, 0, 0, 1}
-            },
-            .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET,
-            .initialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
-    });
-   
-    m_resourceManager.createTextureInFrame("normalMap", a_frameIndex, {
-            .format = DXGI_FORMAT_R32G32B32A32_FLOAT,
-            .width = m_windowWidth,
-            .height = m_windowHeight,
-            .clearValue = D3D12_CLEAR_VALUE {
-                .Format = DXGI_FORMAT_R32G32B32A32_FLOAT,
-                .Color = {0, 0, 0, 1}
-            },
-            .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET,
-            .initialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
-    });
-    
-    m_resourceManager.createTextureInFrame("toCameraMap", a_frameIndex, {
-            .format = DXGI_FORMAT_R32G32B32A32_FLOAT,
-            .width = m_windowWidth,
-            .height = m_windowHeight,
-            .clearValue = D3D12_CLEAR_VALUE {
-                .Format = DXGI_FORMAT_R32G32B32A32_FLOAT,
-                .Color = {0, 0, 0, 1}
-            },
-            .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET,
-            .initialState = D3D12_RESOURCE_STATE_RENDER_TARGET,
-    });
-
-    // createReadbackBufferForTexture(m_resourceManager, "colorMap", a_frameIndex);
-    // createReadbackBufferForTexture(m_resourceManager, "normalMap", a_frameIndex);
-    // createReadbackBufferForTexture(m_resourceManager, "toCameraMap", a_frameIndex);
-
-    m_resourceManager.createConstantBufferInFrame("cb", a_frameIndex, {
-        .size = 1,
-        .elementSize = sizeof(CBCameraParams)
-    });
-
     m_dmlModel[a_frameIndex].initialize(m_mainDevice.Get(), m_dmlDevice.Get(), m_resourceManager.getCBVHeap(),
                           m_windowWidth, m_windowHeight);
     m_dmlModel[a_frameIndex].setInitializationBindings();
@@ -76,21 +23,9 @@ void DX12RenderEngine::initializeFrameResources(uint32_t a_frameIndex)
 
 void DX12RenderEngine::initializeUniqueResources()
 {
-    m_sceneManager.initialize(m_mainDevice.Get());
-    m_sceneManager.loadMeshFromFile("cat", RESOURCES"/models/Cat_Sitting.fbx",
-        { .rotation = {90, -90, 0}, .scale = 0.5 });
-    m_sceneManager.loadMeshFromFile("bird", RESOURCES"/models/Bird.obj",
-        { .rotation = {0, 0, 0}, .scale = 0.2 });
-    std::vector<SceneManager::Vertex> planeVertices = {
-        {{-1, 0, 1}, {0, 1, 0}, {0,0}},
-        {{1, 0, 1}, {0, 1, 0}, {0,0}},
-        {{-1, 0, -1}, {0, 1, 0}, {0,0}},
-        {{1, 0, -1}, {0, 1, 0}, {0,0}},
-    };
-    std::vector<uint32_t> planeIndices = {
-        0, 1, 2,  1, 3, 2
-    };
-    m_sceneManager.loadMesh("flat", planeVertices, planeIndices, { .scale = 100 });
+    m_sceneManager.initialize(m_mainDevice.Get(), m_resourceManager.getHeapAllocator(), &m_uploadRing);
+    // The first frames show the floor while the imports run
+    m_sceneManager.loadDefaultMeshesAsync();
 }
 
 void DX12RenderEngine::initializePipelines()
@@ -99,7 +34,7 @@ void DX12RenderEngine::initializePipelines()
         {
             {
                 .parameterType = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
-                .constants = {.baseShaderRegister = 0, .num32BitValues = 1}
+                .constants = {.baseShaderRegister = 0, .num32BitValues = sizeof(DrawConstants) / 4}
             },
             {
                 .parameterType = D3D12_ROOT_PARAMETER_TYPE_CBV,
@@ -108,41 +43,37 @@ void DX12RenderEngine::initializePipelines()
         });
     NAME_DX_OBJECT(m_rootSignature.getID3D12RootSignature(), L"RootSignature");
 
-    m_finalRenderPipeline.initialize(m_mainDevice.Get(), std::string_view("final_render"),
+    // Compiled on the workers while the rest of the engine initializes, the first frame waits for them
+    m_pipelineCache.initialize(CACHE_ROOT "/pipelines");
+
+    m_finalRenderPipeline.initialize(m_mainDevice.Get(), m_pipelineCache, std::string_view("final_render"),
         GraphicsPipeline::CreateInfo{
             .rootSignature = m_rootSignature,
-            .inputLayout = {
-                { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-                { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-                { "TEXCOORD",   0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-            },
-            .vertexShaderPath = D3D12_ROOT"/shaders/compiled/1.vs.cso",
-            .pixelShaderPath = D3D12_ROOT"/shaders/compiled/1.ps.cso",
-            .RTVFormats = {DXGI_FORMAT_R8G8B8A8_UNORM, DXGI_FORMAT_R32G32B32A32_FLOAT,
-                           DXGI_FORMAT_R32G32B32A32_FLOAT, DXGI_FORMAT_R32G32B32A32_FLOAT},
+            .inputLayout = m_sceneManager.getInputLayout(),
+            .vertexShaderPath = SHADER_ROOT "/1.vs.cso",
+            .pixelShaderPath = SHADER_ROOT "/1.ps.cso",
+            .RTVFormats = {DXGI_FORMAT_R8G8B8A8_UNORM, k_colorMapFormat, k_vectorMapFormat, k_vectorMapFormat},
             .DSVFormat = DXGI_FORMAT_D32_FLOAT
         });
-    NAME_DX_OBJECT(m_finalRenderPipeline.getID3D12Pipeline(), L"FinalRenderPipeline");
 
-    m_basicRenderPipeline.initialize(m_mainDevice.Get(), std::string_view("basic_render"),
+    m_basicRenderPipeline.initialize(m_mainDevice.Get(), m_pipelineCache, std::string_view("basic_render"),
         GraphicsPipeline::CreateInfo{
             .rootSignature = m_rootSignature,
-            .inputLayout = {
-                { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 0, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-                { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, 12, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-                { "TEXCOORD",   0, DXGI_FORMAT_R32G32_FLOAT, 0, 24, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
-            },
-            .vertexShaderPath = D3D12_ROOT"/shaders/compiled/basic.vs.cso",
-            .pixelShaderPath = D3D12_ROOT"/shaders/compiled/basic.ps.cso",
+            .inputLayout = m_sceneManager.getInputLayout(),
+            .vertexShaderPath = SHADER_ROOT "/basic.vs.cso",
+            .pixelShaderPath = SHADER_ROOT "/basic.ps.cso",
             .RTVFormats = {DXGI_FORMAT_R8G8B8A8_UNORM},
             .DSVFormat = DXGI_FORMAT_D32_FLOAT
         });
-    NAME_DX_OBJECT(m_basicRenderPipeline.getID3D12Pipeline(), L"BasicRenderPipeline");
 }
 
 void DX12RenderEngine::initialCommands()
 {
-    m_sceneManager.uploadMeshesOnGPU(m_commandList.Get(), &m_resourceManager);
+    // createCommandListAndSendInitialCommands signals 1 after these
+    m_sceneManager.uploadMeshesOnGPU(m_commandList.Get(), 1, 0);
+    // The binding tables of the models are ranges of the global heap
+    ID3D12DescriptorHeap* descriptorHeaps[] = { m_resourceManager.getCBVHeap()->getID3D12DescriptorHeap() };
+    m_commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
     for (int i = 0; i < k_nSwapChainBuffers; ++i) {
         m_dmlModel[i].dispatchInitialization(m_dmlCommandRecorder.Get(), m_commandList.Get());
     }
@@ -159,96 +90,245 @@ void DX12RenderEngine::render(const Timer& a_timer)
 {
     beginFrame();
     const uint64_t frameIndex = m_currentFrame % k_nSwapChainBuffers;
+    m_sceneManager.uploadMeshesOnGPU(m_commandList.Get(), m_currentFrame, m_framesFence->GetCompletedValue());
     m_settings.camera.updateViewMatrix();
     m_cbCameraParams.LightPosition = { 0, 20, 0 };
 
-    DirectX::XMStoreFloat4x4(&m_cbCameraParams.WorldMatrix,
-        DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&m_worldMatrix)));
     DirectX::XMStoreFloat4x4(&m_cbCameraParams.ViewProjMatrix, 
         DirectX::XMMatrixMultiplyTranspose(m_settings.camera.getView(), m_settings.camera.getProj()));
-    m_resourceManager.getConstantBuffer("cb", frameIndex).uploadData(&m_cbCameraParams);
+    const D3D12_GPU_VIRTUAL_ADDRESS cameraParams =
+        m_uploadRing.uploadConstants(&m_cbCameraParams, sizeof(m_cbCameraParams)).gpu;
 
     ID3D12DescriptorHeap* descriptorHeaps[] = { m_resourceManager.getCBVHeap()->getID3D12DescriptorHeap()};
     m_commandList->SetDescriptorHeaps(_countof(descriptorHeaps), descriptorHeaps);
 
-    auto currentBufferView = m_resourceManager.getTexture("mainRT", frameIndex).getRTV();
-    auto currentDepthBufferView = m_resourceManager.getTexture("mainDepth", frameIndex).getDSV();
-    float color[] = { 0, 0, 0, 1 };
-
-    m_commandList->ClearRenderTargetView(currentBufferView.cpu, color, 0, nullptr);
-    m_commandList->ClearDepthStencilView(currentDepthBufferView.cpu,
-        D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
-    m_commandList->SetGraphicsRootSignature(m_rootSignature.getID3D12RootSignature());
-
+    // The passes declare what they access, the graph puts the barriers between them
     const bool isFinalPipeline = m_settings.ml || m_settings.doScreenShot;
+    const bool meshReady =
+        m_sceneManager.getMeshState(m_settings.meshName.c_str()) == MeshStorage::MeshState::Ready;
+    m_renderGraph.reset();
+    Texture& mainRT = m_resourceManager.getTexture("mainRT", frameIndex);
+    const RenderGraphResource mainRTResource = m_renderGraph.importResource("mainRT", mainRT.getID3D12Resource(),
+        RenderGraphState::Present, RenderGraphState::Present);
+    const RenderGraphResource depthResource = m_renderGraph.createResource("mainDepth", {
+        .width = m_windowWidth,
+        .height = m_windowHeight,
+        .format = DXGI_FORMAT_D32_FLOAT
+    });
+    std::vector<RenderGraphAccess> sceneAccesses = {
+        { mainRTResource, RenderGraphState::RenderTarget },
+        { depthResource, RenderGraphState::DepthWrite }
+    };
+    // Compact encodings of utils/GBufferEncoding.h: colorMap, normalMap, toCameraMap
+    std::array<RenderGraphResource, CaptureReadback::k_targetCount> gBuffer;
     if (isFinalPipeline) {
-        m_commandList->ClearRenderTargetView(m_resourceManager.getTexture("colorMap", frameIndex).getRTV().cpu,
-                                            color, 0, nullptr);
-        m_commandList->ClearRenderTargetView(m_resourceManager.getTexture("normalMap", frameIndex).getRTV().cpu,
-                                            color, 0, nullptr);
-        m_commandList->ClearRenderTargetView(m_resourceManager.getTexture("toCameraMap", frameIndex).getRTV().cpu,
-                                            color, 0, nullptr);
-        m_commandList->SetPipelineState(m_finalRenderPipeline.getID3D12Pipeline());
-    } else {
-        m_commandList->SetPipelineState(m_basicRenderPipeline.getID3D12Pipeline());
+        const std::array<std::pair<const char*, DXGI_FORMAT>, CaptureReadback::k_targetCount> gBufferTargets = { {
+            { "colorMap", k_colorMapFormat }, { "normalMap", k_vectorMapFormat }, { "toCameraMap", k_vectorMapFormat }
+        } };
+        for (uint32_t i = 0; i < gBuffer.size(); ++i) {
+            gBuffer[i] = m_renderGraph.createResource(gBufferTargets[i].first, {
+                .width = m_windowWidth,
+                .height = m_windowHeight,
+                .format = static_cast<uint32_t>(gBufferTargets[i].second)
+            });
+            sceneAccesses.push_back({ gBuffer[i], RenderGraphState::RenderTarget });
+        }
     }
 
-    // m_commandList->SetGraphicsRootDescriptorTable(0, m_constantBuffer[currentFrameBufferIndex].getConstantBufferView().gpu);
-
-    m_commandList->SetGraphicsRoot32BitConstant(0, 0, 0);
-    m_commandList->SetGraphicsRootConstantBufferView(1,
-        m_resourceManager.getConstantBuffer("cb", frameIndex).getID3D12Resource()->GetGPUVirtualAddress());
-
-    const auto& vertexBufferView = m_sceneManager.getVertexBufferView();
-    const auto& indexBufferView = m_sceneManager.getIndexBufferView();
-    m_commandList->IASetVertexBuffers(0, 1, &vertexBufferView);
-    m_commandList->IASetIndexBuffer(&indexBufferView);
-    m_commandList->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+    m_renderGraph.addPass("scene", std::move(sceneAccesses), [&]() {
+        auto currentDepthBufferView = m_renderGraphBackend.getTexture(depthResource).getDSV();
+        float color[] = { 0, 0, 0, 1 };
+
+        m_commandList->ClearRenderTargetView(mainRT.getRTV().cpu, color, 0, nullptr);
+        m_commandList->ClearDepthStencilView(currentDepthBufferView.cpu,
+            D3D12_CLEAR_FLAG_DEPTH, 1.0f, 0, 0, nullptr);
+
+        D3D12_CPU_DESCRIPTOR_HANDLE renderTargets[1 + CaptureReadback::k_targetCount] = { mainRT.getRTV().cpu };
+        if (isFinalPipeline) {
+            for (uint32_t i = 0; i < gBuffer.size(); ++i) {
+                renderTargets[i + 1] = m_renderGraphBackend.getTexture(gBuffer[i]).getRTV().cpu;
+                m_commandList->ClearRenderTargetView(renderTargets[i + 1], color, 0, nullptr);
+            }
+        }
+
+        // One instanced draw per mesh and LOD, the meshes that are still loading are left out.
+        // The transforms are read as the per-instance vertex stream
+        updateSceneInstances();
+        const uint32_t instanceDataSize = static_cast<uint32_t>(m_instances.size() * sizeof(InstanceTransform));
+        const UploadRing::Allocation instanceData = m_uploadRing.allocate(instanceDataSize, 16);
+        assert(instanceData.isValid() && "upload ring is full");
+        const std::span<const InstanceBatch> batches = m_instanceBatcher.build(m_instances,
+            [this](const SceneInstance& a_instance) {
+                const char* meshName = a_instance.meshName.c_str();
+                if (m_sceneManager.getMeshState(meshName) != MeshStorage::MeshState::Ready) {
+                    return InstanceBatcher::k_skipInstance;
+                }
+                return selectMeshLod(m_sceneManager.getMeshInfo(meshName), a_instance.worldMatrix, m_settings.camera,
+                                     m_windowHeight, m_settings.lodPixelError);
+            },
+            { reinterpret_cast<InstanceTransform*>(instanceData.cpu), m_instances.size() });
+
+        m_commandList->IASetPrimitiveTopology(D3D10_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        m_commandList->OMSetRenderTargets(isFinalPipeline ? _countof(renderTargets) : 1, renderTargets, false,
+                                          &currentDepthBufferView.cpu);
+
+        // The draws are recorded by the workers, a contiguous range of batches per chunk. The state every
+        // draw shares goes first into chunk 0
+        const uint32_t chunkCount = std::clamp(static_cast<uint32_t>(batches.size()) / k_batchesPerChunk, 1u,
+                                               utils::getTaskScheduler().getWorkerCount() + 1);
+        m_sceneCommands.reset(chunkCount);
+        CommandChunk& prologue = m_sceneCommands.getChunk(0);
+        GraphicsPipeline& pipeline = isFinalPipeline ? m_finalRenderPipeline : m_basicRenderPipeline;
+        prologue.setPipeline(DX12CommandTranslator::getHandle(pipeline.getID3D12Pipeline()),
+                             DX12CommandTranslator::getHandle(m_rootSignature.getID3D12RootSignature()),
+                             CommandBindPoint::Graphics);
+        prologue.setConstantBuffer(1, cameraParams);
+        const D3D12_VERTEX_BUFFER_VIEW meshVertices = m_sceneManager.getVertexBufferView();
+        const VertexBufferBinding vertexBuffers[] = {
+            { meshVertices.BufferLocation, meshVertices.SizeInBytes, meshVertices.StrideInBytes },
+            { instanceData.gpu, instanceDataSize, sizeof(InstanceTransform) }
+        };
+        static_assert(SceneManager::k_instanceSlot == 1);
+        prologue.setVertexBuffers(0, vertexBuffers);
+
+        const uint32_t batchCount = static_cast<uint32_t>(batches.size());
+        utils::getTaskScheduler().parallelFor(0, chunkCount, 1, [&](uint32_t a_begin, uint32_t a_end) {
+            for (uint32_t chunk = a_begin; chunk < a_end; ++chunk) {
+                const uint32_t first = static_cast<uint64_t>(batchCount) * chunk / chunkCount;
+                const uint32_t last = static_cast<uint64_t>(batchCount) * (chunk + 1) / chunkCount;
+                for (uint32_t i = first; i < last; ++i) {
+                    recordBatch(m_sceneCommands.getChunk(chunk), batches[i]);
+                }
+            }
+        });
+        m_commandTranslator.translate(m_commandList.Get(), m_sceneCommands);
+    });
 
-    auto& mainRT =  m_resourceManager.getTexture("mainRT", frameIndex);
+    // A dataset sample without the mesh is useless
+    if (m_settings.doScreenShot && meshReady) {
+        m_renderGraph.addPass("capture", {
+            { gBuffer[0], RenderGraphState::CopySource },
+            { gBuffer[1], RenderGraphState::CopySource },
+            { gBuffer[2], RenderGraphState::CopySource }
+        }, [&]() {
+            captureFrame({
+                m_renderGraphBackend.getTexture(gBuffer[0]).getID3D12Resource(),
+                m_renderGraphBackend.getTexture(gBuffer[1]).getID3D12Resource(),
+                m_renderGraphBackend.getTexture(gBuffer[2]).getID3D12Resource()
+            });
+        }, true);
+    }
 
-    auto& colorMap =  m_resourceManager.getTexture("colorMap", frameIndex);
-    // auto& colorMapReadback =  m_resourceManager.getBuffer("colorMapReadback", frameIndex);
+    if (m_settings.showGUI && !m_settings.doScreenShot) {
+        m_renderGraph.addPass("gui", { { mainRTResource, RenderGraphState::RenderTarget } }, [&]() {
+            const D3D12_CPU_DESCRIPTOR_HANDLE renderTarget = mainRT.getRTV().cpu;
+            m_commandList->OMSetRenderTargets(1, &renderTarget, false, nullptr);
+            renderGUI();
+        });
+    }
+    if (m_settings.ml) {
+        // A pass per layer, the graph puts UAV barriers between the writes of a layer and the reads of the next
+        Model& model = m_dmlModel[frameIndex];
+        std::vector<RenderGraphResource> layerBuffers = {
+            m_renderGraph.importResource("mlInput", model.getLayerInput(0).getID3D12Resource(),
+                                         RenderGraphState::Common, RenderGraphState::Common)
+        };
+        for (uint32_t layer = 0; layer < model.getLayerCount(); ++layer) {
+            layerBuffers.push_back(m_renderGraph.importResource("mlOutput",
+                model.getLayerOutput(layer).getID3D12Resource(), RenderGraphState::Common, RenderGraphState::Common));
+            m_renderGraph.addPass("ml", {
+                { layerBuffers[layer], RenderGraphState::UnorderedAccess },
+                { layerBuffers[layer + 1], RenderGraphState::UnorderedAccess }
+            }, [this, &model, layer]() {
+                model.dispatchLayer(m_dmlCommandRecorder.Get(), m_commandList.Get(), layer);
+            });
+        }
+    }
+    m_renderGraph.compile(m_renderGraphBackend);
+    m_renderGraph.execute(m_renderGraphBackend);
+    endFrame();
+}
 
-    auto& normalMap =  m_resourceManager.getTexture("normalMap", frameIndex);
-    // auto& normalMapReadback =  m_resourceManager.getBuffer("normalMapReadback", frameIndex);
+void DX12RenderEngine::updateSceneInstances()
+{
+    const size_t instanceCount = std::clamp(m_settings.instanceCount, 1, static_cast<int>(k_maxInstances) - 1);
+    m_instances.resize(instanceCount + 1);
+    m_instances[0] = { .meshName = m_settings.meshName, .worldMatrix = m_worldMatrix };
+
+    // The copies go on a square grid behind the first one, a bounding box apart
+    float spacing = 1.0f;
+    const char* meshName = m_settings.meshName.c_str();
+    if (m_sceneManager.getMeshState(meshName) == MeshStorage::MeshState::Ready) {
+        const MeshStorage::MeshInfo& meshInfo = m_sceneManager.getMeshInfo(meshName);
+        spacing = 1.5f * std::max({ meshInfo.boundsMax.x - meshInfo.boundsMin.x, meshInfo.boundsMax.z - meshInfo.boundsMin.z,
+                                    spacing });
+    }
+    const uint32_t side = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(instanceCount))));
+    const DirectX::XMMATRIX worldMatrix = DirectX::XMLoadFloat4x4(&m_worldMatrix);
+    for (uint32_t i = 1; i < instanceCount; ++i) {
+        const float x = (static_cast<float>(i % side) - 0.5f * static_cast<float>(side - 1)) * spacing;
+        const float z = static_cast<float>(i / side) * spacing;
+        m_instances[i].meshName = m_settings.meshName;
+        DirectX::XMStoreFloat4x4(&m_instances[i].worldMatrix,
+            DirectX::XMMatrixMultiply(worldMatrix, DirectX::XMMatrixTranslation(x, 0, z)));
+    }
 
-    auto& toCameraMap =  m_resourceManager.getTexture("toCameraMap", frameIndex);
-    // auto& toCameraMapReadback =  m_resourceManager.getBuffer("toCameraMapReadback", frameIndex);
+    SceneInstance& floor = m_instances[instanceCount];
+    floor.meshName = "flat";
+    DirectX::XMStoreFloat4x4(&floor.worldMatrix, DirectX::XMMatrixIdentity());
+}
 
-    D3D12_CPU_DESCRIPTOR_HANDLE renderTargets[] = {
-        mainRT.getRTV().cpu,
-        colorMap.getRTV().cpu,
-        normalMap.getRTV().cpu,
-        toCameraMap.getRTV().cpu
+void DX12RenderEngine::recordBatch(CommandChunk& a_chunk, const InstanceBatch& a_batch) const
+{
+    const SceneManager::DrawArguments& mesh = m_sceneManager.getDrawArguments(a_batch.meshName->c_str());
+    const SceneManager::DrawLod& lod = mesh.lods[std::min<size_t>(a_batch.lod, mesh.lods.size() - 1)];
+    const VertexDecode& decode = mesh.vertexDecode;
+    const DrawConstants constants = {
+        .octahedralNormals = m_sceneManager.getVertexFormat() == VertexFormat::Compact,
+        .positionOffset = { decode.positionOffset[0], decode.positionOffset[1], decode.positionOffset[2] },
+        .positionScale = { decode.positionScale[0], decode.positionScale[1], decode.positionScale[2] }
     };
-    m_commandList->OMSetRenderTargets(isFinalPipeline ? _countof(renderTargets) : 1, renderTargets, true, &currentDepthBufferView.cpu);
-
-    const auto& meshInfo = m_sceneManager.getMeshInfo(m_settings.meshName.c_str());
-    m_commandList->DrawIndexedInstanced(meshInfo.indexCount, 1, meshInfo.startIndex, meshInfo.startVertex, 0);
-
-    m_commandList->SetGraphicsRoot32BitConstant(0, 1, 0);
-    const auto& meshFlat = m_sceneManager.getMeshInfo("flat");
-    m_commandList->DrawIndexedInstanced(meshFlat.indexCount, 1, meshFlat.startIndex, meshFlat.startVertex, 0);
-
-    // if (m_settings.doScreenShot)
-    // {
-    //     copyTextureToReadbackBuffer(m_commandList.Get(), colorMap, colorMapReadback);
-    //     copyTextureToReadbackBuffer(m_commandList.Get(), normalMap, normalMapReadback);
-    //     copyTextureToReadbackBuffer(m_commandList.Get(), toCameraMap, toCameraMapReadback);
-
-    //     m_settings.doScreenShot = false;
-    //     m_screenshotWaitFences.push(m_currentFrame);
-    // }
+    a_chunk.setRootConstants(0, constants);
+    a_chunk.setIndexBuffer(lod.indexBufferView.BufferLocation, lod.indexBufferView.SizeInBytes,
+                           lod.indexBufferView.Format == DXGI_FORMAT_R16_UINT ? 2 : 4);
+    // The start instance offsets the instance stream to the transforms of the batch
+    a_chunk.drawIndexed({ .indexCount = lod.indexCount, .instanceCount = a_batch.instanceCount, .firstIndex = 0,
+                          .baseVertex = mesh.baseVertex, .firstInstance = a_batch.firstInstance });
+}
 
-    if (m_settings.showGUI && !m_settings.doScreenShot) {
-        renderGUI();
+void DX12RenderEngine::captureFrame(const CaptureReadback::Targets& a_targets)
+{
+    // Continues the dataset left by the previous runs, like the CPU renderer
+    if (!m_capturesOpened) {
+        m_capturesOpened = m_dataset.initialize(getCaptureWriterCreateInfo(
+            MODEL_DATA_ROOT "/dataset", m_windowWidth, m_windowHeight, utils::PlanePrecision::Float16,
+            utils::PlaneCompression::Lossless));
+        if (!m_capturesOpened) {
+            return;
+        }
+        // One slot per frame in flight and one more, so capturing every frame only waits if the
+        // writes fall behind
+        const uint32_t slotCount = k_nSwapChainBuffers + 1;
+        m_captureReadback.initialize(m_mainDevice.Get(), {
+            .width = m_windowWidth,
+            .height = m_windowHeight,
+            .colorFormat = k_colorMapFormat,
+            .vectorFormat = k_vectorMapFormat,
+            .slotCount = slotCount,
+            .fence = m_framesFence.Get(),
+            .writer = &m_dataset
+        });
+        m_captureQueue.initialize({ .device = &m_captureReadback, .slotCount = slotCount });
+        m_settings.screenshotCounter = m_dataset.getSampleCount();
     }
-    if (m_settings.ml) {
-        ID3D12DescriptorHeap* descriptorHeapsDml[] = { m_dmlModel[frameIndex].getID3D12DescriptorHeap() };
-        m_commandList->SetDescriptorHeaps(_countof(descriptorHeapsDml), descriptorHeapsDml);
-        m_dmlModel[frameIndex].dispatch(m_dmlCommandRecorder.Get(), m_commandList.Get());
+
+    const uint32_t slot = m_captureQueue.acquireSlot();
+    if (slot == CaptureQueue::k_noSlot) {
+        return;
     }
-    endFrame();
+    m_captureReadback.recordCopy(m_commandList.Get(), slot, a_targets);
+    // endFrame signals m_currentFrame after this command list
+    m_captureQueue.submitSlot(slot, m_settings.screenshotCounter, m_currentFrame);
+    ++m_settings.screenshotCounter;
 }
 }
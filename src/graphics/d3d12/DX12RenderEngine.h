@@ -11,6 +11,16 @@
 #include "classes/resource/ConstantBuffer.h"
 #include "CommonGraphicsHeaders.h"
 #include "classes/ml/Model.h"
+#include "classes/CaptureReadback.h"
+#include "classes/DX12RenderGraphBackend.h"
+#include "classes/UploadRing.h"
+#include "classes/DX12CommandTranslator.h"
+#include <graphics/CaptureQueue.h>
+#include <graphics/CommandStream.h>
+#include <graphics/InstanceBatcher.h>
+#include <graphics/PipelineCache.h>
+#include <graphics/RenderGraph.h>
+#include <utils/DatasetShards.h>
 
 #include <DirectXMath.h>
 #include <DirectXColors.h>
@@ -18,7 +28,6 @@
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_dx12.h>
 #include <ImGuizmo.h>
-#include <directx_tool_kit/Inc/ScreenGrab.h>
 #include <directx_tool_kit/Inc/DirectXHelpers.h>
 #include <wincodec.h>
 #include <DirectML.h>
@@ -31,7 +40,7 @@ namespace neural::graphics {
 
 class DX12RenderEngine : public IRenderEngine {
 public:
-    void initialize(HWND a_window, int a_width, int a_height) override;
+    void initialize(void* a_window, int a_width, int a_height) override;
     void render(const Timer& a_timer) override;
     void shutdown() override;
 private:
@@ -53,11 +62,19 @@ private:
     void initializeFrameResources(uint32_t a_frameIndex);
     void initializeUniqueResources();
     void renderGUI();
+    void captureFrame(const CaptureReadback::Targets& a_targets);
+    void updateSceneInstances();
+    void recordBatch(CommandChunk& a_chunk, const InstanceBatch& a_batch) const;
  
     static constexpr uint32_t k_nSwapChainBuffers = 3;
     static_assert(k_nSwapChainBuffers >= 2);
 
     static constexpr DXGI_FORMAT k_swapChainFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+    static constexpr DXGI_FORMAT k_colorMapFormat = DXGI_FORMAT_R16G16B16A16_FLOAT;
+    static constexpr DXGI_FORMAT k_vectorMapFormat = DXGI_FORMAT_R16G16_UNORM;  // octahedral
+    static constexpr uint32_t k_maxInstances = 1 << 16;  // per frame, their transforms take 3 MiB of the upload ring
+    static constexpr uint64_t k_uploadRingSize = 32 << 20;
+    static constexpr uint32_t k_batchesPerChunk = 64;  // fewer batches are not worth a worker
 
     HWND m_window;
     uint32_t m_windowWidth;
@@ -71,11 +88,18 @@ private:
     ComPtr<IDXGISwapChain> m_swapChain;
 
     struct CBCameraParams {
-        DirectX::XMFLOAT4X4 WorldMatrix;
         DirectX::XMFLOAT4X4 ViewProjMatrix;
         DirectX::XMFLOAT3 LightPosition;
     } m_cbCameraParams;
-
+    // rootConstant in the shaders, set per draw
+    struct DrawConstants {
+        int32_t octahedralNormals;
+        DirectX::XMFLOAT3 positionOffset;
+        DirectX::XMFLOAT3 positionScale;
+    };
+
+    // Before the pipelines, its destructor waits for their jobs
+    PipelineCache m_pipelineCache;
     GraphicsPipeline m_finalRenderPipeline;
     GraphicsPipeline m_basicRenderPipeline;
     RootSignature m_rootSignature;
@@ -90,17 +114,32 @@ private:
 
     SceneManager m_sceneManager;
     ResourceManager m_resourceManager;
+    // Camera constants, instance transforms and mesh uploads of the frames in flight
+    UploadRing m_uploadRing;
+    // Rebuilt every frame, the depth buffer and the G-buffer are its transient resources
+    RenderGraph m_renderGraph;
+    DX12RenderGraphBackend m_renderGraphBackend;
 
     ImGuizmo::OPERATION m_currentGizmoOperation;
     ImGuizmo::MODE m_currentGizmoMode;
     DirectX::XMFLOAT4X4* m_selectedMatrix;
 
     DirectX::XMFLOAT4X4 m_worldMatrix;
+    // The mesh at m_worldMatrix, its copies for RenderSettings::instanceCount and the floor
+    std::vector<SceneInstance> m_instances;
+    InstanceBatcher m_instanceBatcher;
+    // The draws of the scene pass, recorded in parallel
+    CommandStream m_sceneCommands;
+    DX12CommandTranslator m_commandTranslator;
 
     ComPtr<IDMLDevice> m_dmlDevice;
     ComPtr<IDMLCommandRecorder> m_dmlCommandRecorder;
     Model m_dmlModel[k_nSwapChainBuffers];
 
-    // std::queue<uint64_t> m_screenshotWaitFences; 
+    // Opened on the first screenshot, the readback slots take 16 bytes per pixel each
+    utils::DatasetWriter m_dataset;
+    CaptureReadback m_captureReadback;
+    CaptureQueue m_captureQueue;
+    bool m_capturesOpened = false;
 };
 }
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "CaptureReadback.h"
+#include <graphics/cpu/CaptureDataset.h>
+
+namespace neural::graphics {
+
+void CaptureReadback::initialize(ID3D12Device* a_device, const CreateInfo& a_createInfo)
+{
+    assert(a_device);
+    assert(a_createInfo.fence);
+    assert(a_createInfo.writer);
+    assert(a_createInfo.slotCount > 0);
+
+    m_slotCount = a_createInfo.slotCount;
+    m_fence = a_createInfo.fence;
+    m_writer = a_createInfo.writer;
+    m_eventHandle = CreateEventEx(nullptr, nullptr, false, EVENT_ALL_ACCESS);
+
+    // Rows are padded to a pitch that satisfies D3D12_TEXTURE_DATA_PITCH_ALIGNMENT in both formats, so the
+    // images share it like the targets of the CPU rasterizer
+    m_pitch = (a_createInfo.width + 63) / 64 * 64;
+    const std::array<std::pair<DXGI_FORMAT, uint32_t>, k_targetCount> formats = {
+        std::pair{ a_createInfo.colorFormat, 8u },
+        std::pair{ a_createInfo.vectorFormat, 4u },
+        std::pair{ a_createInfo.vectorFormat, 4u }
+    };
+    for (uint32_t i = 0; i < k_targetCount; ++i) {
+        m_footprints[i] = {
+            .Offset = 0,
+            .Footprint = {
+                .Format = formats[i].first,
+                .Width = a_createInfo.width,
+                .Height = a_createInfo.height,
+                .Depth = 1,
+                .RowPitch = m_pitch * formats[i].second
+            }
+        };
+    }
+
+    m_buffers = std::make_unique<Buffer[]>(m_slotCount * k_targetCount);
+    for (uint32_t i = 0; i < m_slotCount * k_targetCount; ++i) {
+        const auto& footprint = m_footprints[i % k_targetCount].Footprint;
+        m_buffers[i].initialize(a_device, nullptr, {
+            .size = static_cast<uint64_t>(footprint.RowPitch) * footprint.Height,
+            .elementSize = 1,
+            .initialState = D3D12_RESOURCE_STATE_COPY_DEST,
+            .heapType = D3D12_HEAP_TYPE_READBACK
+        });
+        NAME_DX_OBJECT(m_buffers[i].getID3D12Resource(), L"CaptureReadback");
+        // Readback heaps stay mapped, the workers only read a slot after its fence value is reached
+        m_buffers[i].mapData();
+    }
+}
+
+void CaptureReadback::shutdown()
+{
+    m_buffers.reset();
+    if (m_eventHandle) {
+        CloseHandle(m_eventHandle);
+        m_eventHandle = nullptr;
+    }
+}
+
+void CaptureReadback::recordCopy(ID3D12GraphicsCommandList* a_commandList, uint32_t a_slot, const Targets& a_targets)
+{
+    assert(a_slot < m_slotCount);
+    for (uint32_t i = 0; i < k_targetCount; ++i) {
+        const CD3DX12_TEXTURE_COPY_LOCATION source(a_targets[i], 0);
+        const CD3DX12_TEXTURE_COPY_LOCATION destination(
+            m_buffers[a_slot * k_targetCount + i].getID3D12Resource(), m_footprints[i]);
+        a_commandList->CopyTextureRegion(&destination, 0, 0, 0, &source, nullptr);
+    }
+}
+
+uint64_t CaptureReadback::getCompletedFenceValue()
+{
+    return m_fence->GetCompletedValue();
+}
+
+void CaptureReadback::waitForFenceValue(uint64_t a_value)
+{
+    if (m_fence->GetCompletedValue() < a_value) {
+        DX_CALL(m_fence->SetEventOnCompletion(a_value, m_eventHandle));
+        WaitForSingleObject(m_eventHandle, INFINITE);
+    }
+}
+
+bool CaptureReadback::writeSlot(uint32_t a_slot, uint32_t a_sampleId)
+{
+    const auto image = [this, a_slot](uint32_t a_target) {
+        return m_buffers[a_slot * k_targetCount + a_target].getMappedData();
+    };
+    return appendCapture(*m_writer, a_sampleId, CaptureImages{
+        .color = static_cast<const uint16_t*>(image(0)),
+        .normal = static_cast<const uint32_t*>(image(1)),
+        .toCamera = static_cast<const uint32_t*>(image(2)),
+        .pitch = m_pitch
+    });
+}
+}
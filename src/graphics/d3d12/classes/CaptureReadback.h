@@ -0,0 +1,50 @@
+#pragma once
+
+#include <utils/Macros.h>
+#include <utils/DatasetShards.h>
+#include <graphics/CaptureQueue.h>
+#include "resource/BufferAndTexture.h"
+
+#include <graphics/d3d12/CommonGraphicsHeaders.h>
+
+#include <array>
+#include <memory>
+
+using Microsoft::WRL::ComPtr;
+namespace neural::graphics {
+
+// Readback slots for CaptureQueue: every slot has a persistently mapped buffer per capture target,
+// the write tasks append the mapped images to a dataset
+class CaptureReadback : public ICaptureDevice {
+public:
+    static constexpr uint32_t k_targetCount = 3;  // color, normal, toCamera
+    using Targets = std::array<ID3D12Resource*, k_targetCount>;
+
+    struct CreateInfo {
+        uint32_t width;
+        uint32_t height;
+        DXGI_FORMAT colorFormat;   // R16G16B16A16_FLOAT
+        DXGI_FORMAT vectorFormat;  // R16G16_UNORM, octahedral
+        uint32_t slotCount;
+        ID3D12Fence* fence;
+        utils::DatasetWriter* writer;
+    };
+
+    void initialize(ID3D12Device* a_device, const CreateInfo& a_createInfo);
+    void shutdown();
+    // The targets are in the formats of CreateInfo and in the copy source state
+    void recordCopy(ID3D12GraphicsCommandList* a_commandList, uint32_t a_slot, const Targets& a_targets);
+
+    uint64_t getCompletedFenceValue() override;
+    void waitForFenceValue(uint64_t a_value) override;
+    bool writeSlot(uint32_t a_slot, uint32_t a_sampleId) override;
+private:
+    std::array<D3D12_PLACED_SUBRESOURCE_FOOTPRINT, k_targetCount> m_footprints;
+    uint32_t m_pitch = 0;  // in pixels, the same for all targets
+    std::unique_ptr<Buffer[]> m_buffers;  // k_targetCount per slot
+    uint32_t m_slotCount = 0;
+    ID3D12Fence* m_fence = nullptr;
+    HANDLE m_eventHandle = nullptr;
+    utils::DatasetWriter* m_writer = nullptr;
+};
+}
@@ -1,15 +1,41 @@
 #include "ComputePipeline.h"
+#include "DX12PipelineCompiler.h"
 #include <utils/Utils.h>
 
 namespace neural::graphics {
 
-void ComputePipeline::initialize(ID3D12Device* a_device, std::string_view a_debugName, CreateInfo a_info) {
-    D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
-    desc.pRootSignature = a_info.rootSignature.getID3D12RootSignature();
-    std::vector<char> csByteCode = utils::loadBinary(a_info.computeShaderPath);
-    desc.CS = {csByteCode.data(), csByteCode.size()};
-    desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+void ComputePipeline::initialize(ID3D12Device* a_device, PipelineCache& a_cache, std::string_view a_debugName,
+                                 CreateInfo a_info) {
+    std::string state;
+    const std::span<const char> rootSignature = a_info.rootSignature.getSerialized();
+    appendPipelineState(state, static_cast<uint32_t>(rootSignature.size()));
+    state.append(rootSignature.begin(), rootSignature.end());
 
-    a_device->CreateComputePipelineState(&desc, IID_PPV_ARGS(&m_pipeline));
+    m_cache = &a_cache;
+    m_pipeline = nullptr;
+    std::vector<std::string> shaderPaths = { a_info.computeShaderPath };
+    m_job = a_cache.request(std::move(shaderPaths), std::move(state),
+        [a_device, debugName = std::string(a_debugName), info = std::move(a_info)](
+            std::span<const std::vector<char>> a_shaders, std::span<const char> a_cachedBlob) mutable {
+            D3D12_COMPUTE_PIPELINE_STATE_DESC desc = {};
+            desc.pRootSignature = info.rootSignature.getID3D12RootSignature();
+            desc.CS = { a_shaders[0].data(), a_shaders[0].size() };
+            desc.Flags = D3D12_PIPELINE_STATE_FLAG_NONE;
+
+            return createPipelineState(a_cachedBlob, debugName,
+                [&](const D3D12_CACHED_PIPELINE_STATE& a_cachedState, ID3D12PipelineState** a_pipeline) {
+                    desc.CachedPSO = a_cachedState;
+                    return a_device->CreateComputePipelineState(&desc, IID_PPV_ARGS(a_pipeline));
+                });
+        });
+}
+
+ID3D12PipelineState* ComputePipeline::getID3D12Pipeline() {
+    if (!m_pipeline) {
+        assert(m_cache && "not initialized");
+        m_pipeline = m_cache->wait(m_job);
+        assert(m_pipeline && "the pipeline failed to compile, see the debug output");
+    }
+    return static_cast<ID3D12PipelineState*>(m_pipeline.get());
+}
 }
-}
\ No newline at end of file
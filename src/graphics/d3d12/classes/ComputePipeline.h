@@ -3,6 +3,7 @@
 #include <utils/Macros.h>
 #include <utils/Utils.h>
 #include "RootSignature.h"
+#include <graphics/PipelineCache.h>
 
 #include <graphics/d3d12/CommonGraphicsHeaders.h>
 
@@ -19,13 +20,16 @@ public:
         std::string computeShaderPath;
     };
 
-    void initialize(ID3D12Device* a_device, std::string_view a_debugName, CreateInfo a_info);
-
-    ID3D12PipelineState* getID3D12Pipeline() {
-        return m_pipeline.Get();
+    // Compiled by a job of a_cache, the first getID3D12Pipeline waits for it
+    void initialize(ID3D12Device* a_device, PipelineCache& a_cache, std::string_view a_debugName, CreateInfo a_info);
+    bool isReady() const {
+        return m_pipeline || m_cache->isReady(m_job);
     }
+    ID3D12PipelineState* getID3D12Pipeline();
 
 private:
-    ComPtr<ID3D12PipelineState> m_pipeline;
+    PipelineCache* m_cache = nullptr;
+    PipelineCache::Handle m_job;
+    PipelineCache::Pipeline m_pipeline;
 };
 }
\ No newline at end of file
@@ -0,0 +1,132 @@
+#include "DX12CommandTranslator.h"
+#include "DX12RenderGraphBackend.h"
+
+namespace neural::graphics {
+
+namespace {
+template<typename T>
+T* fromHandle(uint64_t a_handle)
+{
+    return reinterpret_cast<T*>(static_cast<uintptr_t>(a_handle));
+}
+}  // anonymous namespace
+
+void DX12CommandTranslator::translate(ID3D12GraphicsCommandList* a_commandList, const CommandStream& a_stream)
+{
+    assert(a_commandList);
+    m_bindPoint = CommandBindPoint::Graphics;
+    m_layouts[0] = m_layouts[1] = 0;
+    a_stream.forEach([&](const Command& a_command) {
+        if (a_command.type != CommandType::Barrier) {
+            flushBarriers(a_commandList);
+        }
+        translate(a_commandList, a_command);
+    });
+    flushBarriers(a_commandList);
+}
+
+void DX12CommandTranslator::translate(ID3D12GraphicsCommandList* a_commandList, const Command& a_command)
+{
+    const bool isCompute = m_bindPoint == CommandBindPoint::Compute;
+    switch (a_command.type) {
+    case CommandType::SetPipeline: {
+        const auto command = a_command.get<CommandSetPipeline>();
+        m_bindPoint = command.bindPoint;
+        uint64_t& layout = m_layouts[static_cast<uint32_t>(command.bindPoint)];
+        if (command.layout != layout) {
+            layout = command.layout;
+            if (command.bindPoint == CommandBindPoint::Compute) {
+                a_commandList->SetComputeRootSignature(fromHandle<ID3D12RootSignature>(layout));
+            } else {
+                a_commandList->SetGraphicsRootSignature(fromHandle<ID3D12RootSignature>(layout));
+            }
+        }
+        a_commandList->SetPipelineState(fromHandle<ID3D12PipelineState>(command.pipeline));
+        break;
+    }
+    case CommandType::SetRootConstants: {
+        const auto command = a_command.get<CommandSetRootConstants>();
+        const uint32_t* values = a_command.getTail<CommandSetRootConstants>().data();
+        if (isCompute) {
+            a_commandList->SetComputeRoot32BitConstants(command.slot, command.count, values, 0);
+        } else {
+            a_commandList->SetGraphicsRoot32BitConstants(command.slot, command.count, values, 0);
+        }
+        break;
+    }
+    case CommandType::SetConstantBuffer: {
+        const auto command = a_command.get<CommandSetConstantBuffer>();
+        if (isCompute) {
+            a_commandList->SetComputeRootConstantBufferView(command.slot, command.address);
+        } else {
+            a_commandList->SetGraphicsRootConstantBufferView(command.slot, command.address);
+        }
+        break;
+    }
+    case CommandType::SetVertexBuffers: {
+        const auto command = a_command.get<CommandSetVertexBuffers>();
+        D3D12_VERTEX_BUFFER_VIEW views[D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT];
+        assert(command.count <= _countof(views));
+        for (uint32_t i = 0; i < command.count; ++i) {
+            const auto binding = a_command.getTailElement<CommandSetVertexBuffers, VertexBufferBinding>(i);
+            views[i] = { .BufferLocation = binding.address, .SizeInBytes = binding.size,
+                         .StrideInBytes = binding.stride };
+        }
+        a_commandList->IASetVertexBuffers(command.firstSlot, command.count, views);
+        break;
+    }
+    case CommandType::SetIndexBuffer: {
+        const auto command = a_command.get<CommandSetIndexBuffer>();
+        const D3D12_INDEX_BUFFER_VIEW view = {
+            .BufferLocation = command.address,
+            .SizeInBytes = command.size,
+            .Format = command.indexSize == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT
+        };
+        a_commandList->IASetIndexBuffer(&view);
+        break;
+    }
+    case CommandType::Draw: {
+        const auto command = a_command.get<CommandDraw>();
+        a_commandList->DrawInstanced(command.vertexCount, command.instanceCount, command.firstVertex,
+                                     command.firstInstance);
+        break;
+    }
+    case CommandType::DrawIndexed: {
+        const auto command = a_command.get<CommandDrawIndexed>();
+        a_commandList->DrawIndexedInstanced(command.indexCount, command.instanceCount, command.firstIndex,
+                                            command.baseVertex, command.firstInstance);
+        break;
+    }
+    case CommandType::Dispatch: {
+        const auto command = a_command.get<CommandDispatch>();
+        a_commandList->Dispatch(command.x, command.y, command.z);
+        break;
+    }
+    case CommandType::Barrier: {
+        const auto command = a_command.get<CommandBarrier>();
+        ID3D12Resource* resource = fromHandle<ID3D12Resource>(command.resource);
+        switch (command.type) {
+        case RenderGraphBarrierType::Transition:
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, getD3D12States(command.before),
+                                                                      getD3D12States(command.after)));
+            break;
+        case RenderGraphBarrierType::Aliasing:
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, resource));
+            break;
+        case RenderGraphBarrierType::UnorderedAccess:
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(resource));
+            break;
+        }
+        break;
+    }
+    }
+}
+
+void DX12CommandTranslator::flushBarriers(ID3D12GraphicsCommandList* a_commandList)
+{
+    if (!m_barriers.empty()) {
+        a_commandList->ResourceBarrier(static_cast<uint32_t>(m_barriers.size()), m_barriers.data());
+        m_barriers.clear();
+    }
+}
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <graphics/CommandStream.h>
+
+#include <graphics/d3d12/CommonGraphicsHeaders.h>
+
+#include <vector>
+
+namespace neural::graphics {
+
+// Records a CommandStream into a D3D12 command list, on the thread that owns the list. The handles of the
+// stream are ID3D12PipelineState*, ID3D12RootSignature*, ID3D12Resource* and GPU virtual addresses
+class DX12CommandTranslator {
+public:
+    static uint64_t getHandle(const void* a_object) {
+        return reinterpret_cast<uintptr_t>(a_object);
+    }
+
+    // Root bindings go to the bind point of the last SetPipeline. The root signature set before the call is
+    // unknown to the translator, the first SetPipeline sets it again
+    void translate(ID3D12GraphicsCommandList* a_commandList, const CommandStream& a_stream);
+private:
+    void translate(ID3D12GraphicsCommandList* a_commandList, const Command& a_command);
+    void flushBarriers(ID3D12GraphicsCommandList* a_commandList);
+
+    CommandBindPoint m_bindPoint = CommandBindPoint::Graphics;
+    uint64_t m_layouts[2] = {};  // by bind point
+    // Consecutive barriers go into one ResourceBarrier call
+    std::vector<D3D12_RESOURCE_BARRIER> m_barriers;
+};
+}
@@ -0,0 +1,92 @@
+#include "DX12PipelineCompiler.h"
+#include <utils/Macros.h>
+
+namespace neural::graphics {
+
+namespace {
+void appendStencilOp(std::string& a_state, const D3D12_DEPTH_STENCILOP_DESC& a_stencilOp)
+{
+    appendPipelineState(a_state, a_stencilOp.StencilFailOp);
+    appendPipelineState(a_state, a_stencilOp.StencilDepthFailOp);
+    appendPipelineState(a_state, a_stencilOp.StencilPassOp);
+    appendPipelineState(a_state, a_stencilOp.StencilFunc);
+}
+
+PipelineCache::Pipeline toPipeline(ComPtr<ID3D12PipelineState>& a_pipeline)
+{
+    return PipelineCache::Pipeline(a_pipeline.Detach(), [](void* a_object) {
+        static_cast<ID3D12PipelineState*>(a_object)->Release();
+    });
+}
+}  // anonymous namespace
+
+void appendInputLayout(std::string& a_state, std::span<const D3D12_INPUT_ELEMENT_DESC> a_inputLayout)
+{
+    appendPipelineState(a_state, static_cast<uint32_t>(a_inputLayout.size()));
+    for (const D3D12_INPUT_ELEMENT_DESC& element : a_inputLayout) {
+        a_state.append(element.SemanticName);
+        a_state.push_back('\0');
+        appendPipelineState(a_state, element.SemanticIndex);
+        appendPipelineState(a_state, element.Format);
+        appendPipelineState(a_state, element.InputSlot);
+        appendPipelineState(a_state, element.AlignedByteOffset);
+        appendPipelineState(a_state, element.InputSlotClass);
+        appendPipelineState(a_state, element.InstanceDataStepRate);
+    }
+}
+
+void appendBlendState(std::string& a_state, const D3D12_BLEND_DESC& a_blendState)
+{
+    appendPipelineState(a_state, a_blendState.AlphaToCoverageEnable);
+    appendPipelineState(a_state, a_blendState.IndependentBlendEnable);
+    for (const D3D12_RENDER_TARGET_BLEND_DESC& target : a_blendState.RenderTarget) {
+        appendPipelineState(a_state, target.BlendEnable);
+        appendPipelineState(a_state, target.LogicOpEnable);
+        appendPipelineState(a_state, target.SrcBlend);
+        appendPipelineState(a_state, target.DestBlend);
+        appendPipelineState(a_state, target.BlendOp);
+        appendPipelineState(a_state, target.SrcBlendAlpha);
+        appendPipelineState(a_state, target.DestBlendAlpha);
+        appendPipelineState(a_state, target.BlendOpAlpha);
+        appendPipelineState(a_state, target.LogicOp);
+        appendPipelineState(a_state, target.RenderTargetWriteMask);
+    }
+}
+
+void appendDepthStencilState(std::string& a_state, const D3D12_DEPTH_STENCIL_DESC& a_depthStencilState)
+{
+    appendPipelineState(a_state, a_depthStencilState.DepthEnable);
+    appendPipelineState(a_state, a_depthStencilState.DepthWriteMask);
+    appendPipelineState(a_state, a_depthStencilState.DepthFunc);
+    appendPipelineState(a_state, a_depthStencilState.StencilEnable);
+    appendPipelineState(a_state, a_depthStencilState.StencilReadMask);
+    appendPipelineState(a_state, a_depthStencilState.StencilWriteMask);
+    appendStencilOp(a_state, a_depthStencilState.FrontFace);
+    appendStencilOp(a_state, a_depthStencilState.BackFace);
+}
+
+PipelineCache::CompileResult createPipelineState(std::span<const char> a_cachedBlob, std::string_view a_debugName,
+                                                 const CreatePipelineFunction& a_create)
+{
+    PipelineCache::CompileResult result;
+    ComPtr<ID3D12PipelineState> pipeline;
+    // A blob of another driver or adapter is rejected, the pipeline is compiled again then
+    if (a_cachedBlob.empty() ||
+        FAILED(a_create({ .pCachedBlob = a_cachedBlob.data(), .CachedBlobSizeInBytes = a_cachedBlob.size() },
+                        pipeline.ReleaseAndGetAddressOf()))) {
+        const HRESULT createResult = a_create({}, pipeline.ReleaseAndGetAddressOf());
+        DX_CALL(createResult);
+        if (FAILED(createResult)) {
+            return {};
+        }
+        ComPtr<ID3DBlob> blob;
+        if (SUCCEEDED(pipeline->GetCachedBlob(&blob))) {
+            const char* data = static_cast<const char*>(blob->GetBufferPointer());
+            result.blob.assign(data, data + blob->GetBufferSize());
+        }
+    }
+    NAME_DX_OBJECT(pipeline, std::wstring(a_debugName.begin(), a_debugName.end()));
+    result.pipeline = toPipeline(pipeline);
+    return result;
+}
+}
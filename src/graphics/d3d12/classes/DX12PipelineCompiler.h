@@ -0,0 +1,26 @@
+#pragma once
+
+#include <graphics/PipelineCache.h>
+
+#include <graphics/d3d12/CommonGraphicsHeaders.h>
+
+#include <functional>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace neural::graphics {
+
+// Pipeline cache keys of the D3D12 state descriptions. The blend and depth-stencil descriptions have padding
+// and are appended field by field, the semantic names of the input layout by value
+void appendInputLayout(std::string& a_state, std::span<const D3D12_INPUT_ELEMENT_DESC> a_inputLayout);
+void appendBlendState(std::string& a_state, const D3D12_BLEND_DESC& a_blendState);
+void appendDepthStencilState(std::string& a_state, const D3D12_DEPTH_STENCIL_DESC& a_depthStencilState);
+
+using CreatePipelineFunction = std::function<HRESULT(const D3D12_CACHED_PIPELINE_STATE& a_cachedState,
+                                                     ID3D12PipelineState** a_pipeline)>;
+// Creates a pipeline state from a_cachedBlob if the driver still accepts it, otherwise from scratch and returns
+// the blob the driver gives back for it
+PipelineCache::CompileResult createPipelineState(std::span<const char> a_cachedBlob, std::string_view a_debugName,
+                                                 const CreatePipelineFunction& a_create);
+}
@@ -0,0 +1,240 @@
+#include "DX12RenderGraphBackend.h"
+
+#include <algorithm>
+#include <bit>
+#include <string>
+
+namespace neural::graphics {
+
+D3D12_RESOURCE_STATES getD3D12States(RenderGraphState a_state)
+{
+    D3D12_RESOURCE_STATES states = D3D12_RESOURCE_STATE_COMMON;
+    if (hasState(a_state, RenderGraphState::RenderTarget))    states |= D3D12_RESOURCE_STATE_RENDER_TARGET;
+    if (hasState(a_state, RenderGraphState::DepthWrite))      states |= D3D12_RESOURCE_STATE_DEPTH_WRITE;
+    if (hasState(a_state, RenderGraphState::UnorderedAccess)) states |= D3D12_RESOURCE_STATE_UNORDERED_ACCESS;
+    if (hasState(a_state, RenderGraphState::CopyDest))        states |= D3D12_RESOURCE_STATE_COPY_DEST;
+    if (hasState(a_state, RenderGraphState::DepthRead))       states |= D3D12_RESOURCE_STATE_DEPTH_READ;
+    if (hasState(a_state, RenderGraphState::ShaderResource)) {
+        states |= D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE;
+    }
+    if (hasState(a_state, RenderGraphState::CopySource))      states |= D3D12_RESOURCE_STATE_COPY_SOURCE;
+    if (hasState(a_state, RenderGraphState::Present))         states |= D3D12_RESOURCE_STATE_PRESENT;
+    return states;
+}
+
+namespace {
+bool isTarget(RenderGraphState a_usage)
+{
+    return hasState(a_usage, RenderGraphState::RenderTarget | RenderGraphState::DepthWrite |
+                             RenderGraphState::DepthRead);
+}
+
+D3D12_RESOURCE_FLAGS getResourceFlags(RenderGraphState a_usage)
+{
+    D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE;
+    if (hasState(a_usage, RenderGraphState::RenderTarget)) {
+        flags |= D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+    }
+    if (hasState(a_usage, RenderGraphState::DepthWrite | RenderGraphState::DepthRead)) {
+        flags |= D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL;
+        if (!hasState(a_usage, RenderGraphState::ShaderResource)) {
+            flags |= D3D12_RESOURCE_FLAG_DENY_SHADER_RESOURCE;
+        }
+    }
+    if (hasState(a_usage, RenderGraphState::UnorderedAccess)) {
+        flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
+    }
+    return flags;
+}
+
+D3D12_RESOURCE_DESC getResourceDesc(const RenderGraphResourceDesc& a_desc, RenderGraphState a_usage)
+{
+    if (a_desc.type == RenderGraphResourceType::Buffer) {
+        assert(!isTarget(a_usage));
+        return CD3DX12_RESOURCE_DESC::Buffer(a_desc.width, getResourceFlags(a_usage));
+    }
+    return CD3DX12_RESOURCE_DESC::Tex2D(static_cast<DXGI_FORMAT>(a_desc.format), a_desc.width, a_desc.height,
+                                        1, 1, 1, 0, getResourceFlags(a_usage));
+}
+}  // anonymous namespace
+
+void DX12RenderGraphBackend::initialize(ResourceManager* a_resourceManager, uint32_t a_nFrames)
+{
+    assert(a_resourceManager);
+    assert(a_nFrames > 0);
+    m_resourceManager = a_resourceManager;
+    m_device = a_resourceManager->getDevice();
+    m_nFrames = a_nFrames;
+    m_frameSets = std::make_unique<std::map<TransientKey, TransientSet>[]>(a_nFrames);
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+    DX_CALL(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)));
+    m_heapTier = options.ResourceHeapTier;
+}
+
+void DX12RenderGraphBackend::beginFrame(ID3D12GraphicsCommandList* a_commandList, uint32_t a_frameIndex)
+{
+    assert(a_frameIndex < m_nFrames);
+    m_commandList = a_commandList;
+    m_frameIndex = a_frameIndex;
+    m_currentSet = nullptr;
+}
+
+RenderGraphMemoryRequirements DX12RenderGraphBackend::getMemoryRequirements(const RenderGraphResourceDesc& a_desc,
+                                                                            RenderGraphState a_usage)
+{
+    const D3D12_RESOURCE_DESC desc = getResourceDesc(a_desc, a_usage);
+    const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &desc);
+    return { .size = info.SizeInBytes, .alignment = info.Alignment };
+}
+
+void DX12RenderGraphBackend::placeTransientResources(const RenderGraph& a_graph, uint64_t a_memorySize,
+                                                     std::span<const RenderGraphPlacement> a_placements)
+{
+    TransientKey key = { a_memorySize };
+    for (const RenderGraphPlacement& placement : a_placements) {
+        const RenderGraphResourceDesc& desc = a_graph.getResourceDesc(placement.resource);
+        key.insert(key.end(), {
+            placement.resource.index, placement.offset, static_cast<uint64_t>(placement.initialState),
+            static_cast<uint64_t>(placement.usage), static_cast<uint64_t>(desc.type), desc.width, desc.height,
+            desc.format, std::bit_cast<uint32_t>(desc.clearColor[0]), std::bit_cast<uint32_t>(desc.clearColor[1]),
+            std::bit_cast<uint32_t>(desc.clearColor[2]), std::bit_cast<uint32_t>(desc.clearColor[3]),
+            std::bit_cast<uint32_t>(desc.clearDepth)
+        });
+    }
+    auto [it, inserted] = m_frameSets[m_frameIndex].try_emplace(std::move(key));
+    m_currentSet = &it->second;
+    if (inserted) {
+        createTransientSet(it->second, a_graph, a_memorySize, a_placements);
+    }
+}
+
+void DX12RenderGraphBackend::createTransientSet(TransientSet& a_set, const RenderGraph& a_graph, uint64_t a_memorySize,
+                                                std::span<const RenderGraphPlacement> a_placements)
+{
+    if (a_placements.empty()) {
+        return;
+    }
+    // Tier 1 heaps hold one kind of resources only
+    bool onlyTargets = true;
+    bool onlyBuffers = true;
+    bool onlyOtherTextures = true;
+    uint32_t resourceCount = 0;
+    for (const RenderGraphPlacement& placement : a_placements) {
+        const bool isBuffer = a_graph.getResourceDesc(placement.resource).type == RenderGraphResourceType::Buffer;
+        onlyTargets &= !isBuffer && isTarget(placement.usage);
+        onlyBuffers &= isBuffer;
+        onlyOtherTextures &= !isBuffer && !isTarget(placement.usage);
+        resourceCount = std::max(resourceCount, placement.resource.index + 1);
+    }
+    D3D12_HEAP_FLAGS heapFlags = D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES;
+    if (m_heapTier == D3D12_RESOURCE_HEAP_TIER_1) {
+        assert((onlyTargets || onlyBuffers || onlyOtherTextures) && "resource heap tier 1 can't mix resource kinds");
+        heapFlags = onlyTargets ? D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES
+                  : onlyBuffers ? D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS
+                                : D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+    }
+    const CD3DX12_HEAP_DESC heapDesc(a_memorySize, D3D12_HEAP_TYPE_DEFAULT, 0, heapFlags);
+    DX_CALL(m_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&a_set.heap)));
+    NAME_DX_OBJECT_INDEXED(a_set.heap, L"RenderGraphHeap", m_frameIndex);
+
+    a_set.textures.resize(resourceCount);
+    a_set.buffers.resize(resourceCount);
+    for (const RenderGraphPlacement& placement : a_placements) {
+        const RenderGraphResourceDesc& desc = a_graph.getResourceDesc(placement.resource);
+        const HeapInfo heapInfo = { .heap = a_set.heap.Get(), .offset = placement.offset };
+        ID3D12Resource* resource;
+        if (desc.type == RenderGraphResourceType::Buffer) {
+            auto& buffer = a_set.buffers[placement.resource.index] = std::make_unique<Buffer>();
+            buffer->initialize(m_device, m_resourceManager->getCBVHeap(), {
+                .size = desc.width,
+                .elementSize = 1,
+                .usageFlags = getResourceFlags(placement.usage),
+                .initialState = getD3D12States(placement.initialState),
+                .heapInfo = heapInfo
+            });
+            resource = buffer->getID3D12Resource();
+        } else {
+            const DXGI_FORMAT format = static_cast<DXGI_FORMAT>(desc.format);
+            std::optional<D3D12_CLEAR_VALUE> clearValue;
+            if (hasState(placement.usage, RenderGraphState::RenderTarget)) {
+                clearValue = D3D12_CLEAR_VALUE{ .Format = format,
+                                                .Color = { desc.clearColor[0], desc.clearColor[1],
+                                                           desc.clearColor[2], desc.clearColor[3] } };
+            } else if (isTarget(placement.usage)) {
+                clearValue = D3D12_CLEAR_VALUE{ .Format = format,
+                                                .DepthStencil = { .Depth = desc.clearDepth, .Stencil = 0 } };
+            }
+            auto& texture = a_set.textures[placement.resource.index] = std::make_unique<Texture>();
+            texture->initialize(m_device, {
+                .format = format,
+                .width = desc.width,
+                .height = desc.height,
+                .clearValue = clearValue,
+                .usageFlags = getResourceFlags(placement.usage),
+                .initialState = getD3D12States(placement.initialState),
+                .placementHeap = heapInfo
+            }, m_resourceManager->getRTVHeap(), m_resourceManager->getDSVHeap(), m_resourceManager->getCBVHeap());
+            resource = texture->getID3D12Resource();
+        }
+        const std::string& name = a_graph.getResourceName(placement.resource);
+        NAME_DX_OBJECT(resource, std::wstring(name.begin(), name.end()));
+    }
+}
+
+void DX12RenderGraphBackend::recordBarriers(const RenderGraph& a_graph, std::span<const RenderGraphBarrier> a_barriers)
+{
+    assert(m_commandList);
+    m_barriers.clear();
+    for (const RenderGraphBarrier& barrier : a_barriers) {
+        ID3D12Resource* resource = getID3D12Resource(a_graph, barrier.resource);
+        switch (barrier.type) {
+        case RenderGraphBarrierType::Transition:
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::Transition(resource, getD3D12States(barrier.before),
+                                                                      getD3D12States(barrier.after)));
+            break;
+        case RenderGraphBarrierType::Aliasing:
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::Aliasing(nullptr, resource));
+            break;
+        case RenderGraphBarrierType::UnorderedAccess:
+            m_barriers.push_back(CD3DX12_RESOURCE_BARRIER::UAV(resource));
+            break;
+        }
+    }
+    m_commandList->ResourceBarrier(static_cast<uint32_t>(m_barriers.size()), m_barriers.data());
+
+    // Render targets and depth buffers that take over aliased memory have to be initialized before their
+    // first draw, the discard does it without writing memory. A clear in the pass stays correct
+    for (const RenderGraphBarrier& barrier : a_barriers) {
+        if (barrier.type == RenderGraphBarrierType::Aliasing &&
+            (barrier.after == RenderGraphState::RenderTarget || barrier.after == RenderGraphState::DepthWrite)) {
+            m_commandList->DiscardResource(getID3D12Resource(a_graph, barrier.resource), nullptr);
+        }
+    }
+}
+
+Texture& DX12RenderGraphBackend::getTexture(RenderGraphResource a_resource)
+{
+    assert(m_currentSet && a_resource.index < m_currentSet->textures.size());
+    assert(m_currentSet->textures[a_resource.index] && "not a transient texture used by a pass");
+    return *m_currentSet->textures[a_resource.index];
+}
+
+Buffer& DX12RenderGraphBackend::getBuffer(RenderGraphResource a_resource)
+{
+    assert(m_currentSet && a_resource.index < m_currentSet->buffers.size());
+    assert(m_currentSet->buffers[a_resource.index] && "not a transient buffer used by a pass");
+    return *m_currentSet->buffers[a_resource.index];
+}
+
+ID3D12Resource* DX12RenderGraphBackend::getID3D12Resource(const RenderGraph& a_graph, RenderGraphResource a_resource)
+{
+    if (a_graph.isImported(a_resource)) {
+        return static_cast<ID3D12Resource*>(a_graph.getExternal(a_resource));
+    }
+    if (a_graph.getResourceDesc(a_resource).type == RenderGraphResourceType::Buffer) {
+        return getBuffer(a_resource).getID3D12Resource();
+    }
+    return getTexture(a_resource).getID3D12Resource();
+}
+}
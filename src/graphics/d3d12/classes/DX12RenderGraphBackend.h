@@ -0,0 +1,59 @@
+#pragma once
+
+#include <utils/Macros.h>
+#include <graphics/RenderGraph.h>
+#include "ResourceManager.h"
+#include "resource/BufferAndTexture.h"
+
+#include <graphics/d3d12/CommonGraphicsHeaders.h>
+
+#include <map>
+#include <memory>
+#include <vector>
+
+using Microsoft::WRL::ComPtr;
+namespace neural::graphics {
+
+D3D12_RESOURCE_STATES getD3D12States(RenderGraphState a_state);
+
+// Render graph on D3D12: imported resources are ID3D12Resource*, the transient ones are placed resources in
+// one heap per frame in flight. A frame reuses the heap and resources of the last frame with the same
+// placements, every distinct graph keeps its own set (the engine has one per pipeline)
+class DX12RenderGraphBackend : public IRenderGraphBackend {
+public:
+    void initialize(ResourceManager* a_resourceManager, uint32_t a_nFrames);
+    // The frame whose transient resources the next execute uses, after the GPU finished its previous use
+    void beginFrame(ID3D12GraphicsCommandList* a_commandList, uint32_t a_frameIndex);
+
+    RenderGraphMemoryRequirements getMemoryRequirements(const RenderGraphResourceDesc& a_desc,
+                                                        RenderGraphState a_usage) override;
+    void placeTransientResources(const RenderGraph& a_graph, uint64_t a_memorySize,
+                                 std::span<const RenderGraphPlacement> a_placements) override;
+    void recordBarriers(const RenderGraph& a_graph, std::span<const RenderGraphBarrier> a_barriers) override;
+
+    // Transient resources of the current frame, valid in the passes
+    Texture& getTexture(RenderGraphResource a_resource);
+    Buffer& getBuffer(RenderGraphResource a_resource);
+private:
+    struct TransientSet {
+        ComPtr<ID3D12Heap> heap;
+        std::vector<std::unique_ptr<Texture>> textures;  // by resource index
+        std::vector<std::unique_ptr<Buffer>> buffers;
+    };
+    using TransientKey = std::vector<uint64_t>;  // everything the set is created from
+
+    void createTransientSet(TransientSet& a_set, const RenderGraph& a_graph, uint64_t a_memorySize,
+                            std::span<const RenderGraphPlacement> a_placements);
+    ID3D12Resource* getID3D12Resource(const RenderGraph& a_graph, RenderGraphResource a_resource);
+
+    ResourceManager* m_resourceManager = nullptr;
+    ID3D12Device* m_device = nullptr;
+    D3D12_RESOURCE_HEAP_TIER m_heapTier = D3D12_RESOURCE_HEAP_TIER_1;
+    std::unique_ptr<std::map<TransientKey, TransientSet>[]> m_frameSets;
+    uint32_t m_nFrames = 0;
+    uint32_t m_frameIndex = 0;
+    TransientSet* m_currentSet = nullptr;
+    ID3D12GraphicsCommandList* m_commandList = nullptr;
+    std::vector<D3D12_RESOURCE_BARRIER> m_barriers;
+};
+}
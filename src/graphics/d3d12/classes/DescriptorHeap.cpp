@@ -4,13 +4,13 @@
 namespace neural::graphics {
 
 void DescriptorHeap::initialize(ID3D12Device* a_device, uint32_t a_nFrames,
-    D3D12_DESCRIPTOR_HEAP_TYPE a_type, uint32_t a_capacity, bool isShaderVisiable)
+    D3D12_DESCRIPTOR_HEAP_TYPE a_type, uint32_t a_capacity, bool isShaderVisiable, uint32_t a_rangeCapacity)
 {
     assert(!m_heap);
 
     D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc = {
     .Type = a_type,
-    .NumDescriptors = a_capacity,
+    .NumDescriptors = a_capacity + a_rangeCapacity,
     .Flags = isShaderVisiable ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE
                               : D3D12_DESCRIPTOR_HEAP_FLAG_NONE,
     .NodeMask = 0,
@@ -22,37 +22,78 @@ void DescriptorHeap::initialize(ID3D12Device* a_device, uint32_t a_nFrames,
     m_startHeapAddress.gpu = isShaderVisiable ? m_heap->GetGPUDescriptorHandleForHeapStart()
         : D3D12_GPU_DESCRIPTOR_HANDLE(0);
 
-    m_freeIndices = std::move(std::make_unique<uint32_t[]>(a_capacity));
-    DEBUG_LINE(m_heapCapacity = a_capacity);
-    m_heapSize = 0;
-
-    for (uint32_t i = 0; i < a_capacity; ++i)
-    {
-        m_freeIndices[i] = i;
+    m_indices.initialize(a_capacity, a_nFrames);
+    if (a_rangeCapacity > 0) {
+        m_ranges.initialize(a_rangeCapacity, 1);
     }
-
-    m_indicesToDeferredDeallocate = std::move(std::make_unique<std::vector<uint32_t>[]>(a_nFrames));
-    DEBUG_LINE(m_nDeferredVectors = a_nFrames);
+    m_rangesToDeferredDeallocate = std::make_unique<std::vector<utils::OffsetAllocator::Allocation>[]>(a_nFrames);
+    m_nFrames = a_nFrames;
 }
 
 DescriptorHeap::Handle DescriptorHeap::allocate()
 {
-    assert(m_heapSize < m_heapCapacity);
-    uint32_t freeIndex = m_freeIndices[m_heapSize];
-    ++m_heapSize;
+    const uint32_t freeIndex = m_indices.allocate();
+    assert(freeIndex != utils::ConcurrentIndexAllocator::k_invalidIndex && "descriptor heap is full");
     SIZE_T addressOffset = freeIndex * m_descriptorSize;
     return { m_startHeapAddress.cpu.ptr + addressOffset,
              m_startHeapAddress.gpu.ptr + addressOffset };
 }
 
+DescriptorHeap::Range DescriptorHeap::allocateRange(uint32_t a_size)
+{
+    assert(a_size > 0);
+    std::lock_guard lock(m_rangeMutex);
+    assert(m_ranges.getCapacity() > 0 && "the heap was initialized without a range section");
+    const utils::OffsetAllocator::Allocation allocation = m_ranges.allocate(a_size, 1);
+    assert(allocation.isValid() && "descriptor heap range section is full");
+    const SIZE_T addressOffset = (m_indices.getCapacity() + allocation.offset) * m_descriptorSize;
+    return {
+        .start = { m_startHeapAddress.cpu.ptr + addressOffset,
+                   m_startHeapAddress.gpu.ptr + (m_startHeapAddress.gpu.ptr != 0 ? addressOffset : 0) },
+        .size = a_size,
+        .allocation = allocation
+    };
+}
+
+DescriptorHeap::Handle DescriptorHeap::getHandle(const Range& a_range, uint32_t a_index) const
+{
+    assert(a_index < a_range.size);
+    const SIZE_T addressOffset = a_index * m_descriptorSize;
+    return { a_range.start.cpu.ptr + addressOffset,
+             a_range.start.gpu.ptr + (a_range.start.gpu.ptr != 0 ? addressOffset : 0) };
+}
+
+void DescriptorHeap::deferredDeallocate(Range& a_range)
+{
+    assert(a_range.allocation.isValid());
+    const uint32_t currentFrame = m_currentFrame.load(std::memory_order_relaxed);
+    assert(currentFrame != k_noFrame && "if failed need set current frame for deferred deallocations, to do this call resetDeferred");
+    {
+        std::lock_guard lock(m_rangeMutex);
+        m_rangesToDeferredDeallocate[currentFrame].push_back(a_range.allocation);
+    }
+    a_range = {};
+}
+
+void DescriptorHeap::immediatelyDeallocate(Range& a_range)
+{
+    assert(a_range.allocation.isValid());
+    {
+        std::lock_guard lock(m_rangeMutex);
+        m_ranges.free(a_range.allocation);
+    }
+    a_range = {};
+}
+
 void DescriptorHeap::deferredDeallocate(Handle& a_handle)
 {
     uint32_t index = getIndex(a_handle);
 
     clearHandle(a_handle);
 
-    assert(m_currentFrame.has_value() && "if failed need set current frame for deferred deallocations, to do this call resetDeferred");
-    m_indicesToDeferredDeallocate[m_currentFrame.value()].push_back(index);
+    const uint32_t currentFrame = m_currentFrame.load(std::memory_order_relaxed);
+    assert(currentFrame != k_noFrame && "if failed need set current frame for deferred deallocations, to do this call resetDeferred");
+    m_indices.deferredFree(index, currentFrame);
 }
 
 void DescriptorHeap::immediatelyDeallocate(Handle& a_handle)
@@ -61,40 +102,30 @@ void DescriptorHeap::immediatelyDeallocate(Handle& a_handle)
 
     clearHandle(a_handle);
 
-    deallocate(index);
+    m_indices.free(index);
 }
 
 void DescriptorHeap::resetDeferred(uint32_t a_newFrameIndex)
 {
-    assert(a_newFrameIndex < m_nDeferredVectors);
-    m_currentFrame = a_newFrameIndex;
-    std::vector<uint32_t>& currentDeferredIndices = m_indicesToDeferredDeallocate[a_newFrameIndex];
+    assert(a_newFrameIndex < m_nFrames);
+    m_currentFrame.store(a_newFrameIndex, std::memory_order_relaxed);
+    m_indices.releaseDeferred(a_newFrameIndex);
 
-    if (!currentDeferredIndices.empty())
-    {
-        for (auto index : currentDeferredIndices)
-        {
-            deallocate(index);
-        }
-        currentDeferredIndices.clear();
+    std::lock_guard lock(m_rangeMutex);
+    for (const utils::OffsetAllocator::Allocation& allocation : m_rangesToDeferredDeallocate[a_newFrameIndex]) {
+        m_ranges.free(allocation);
     }
-}
-
-void DescriptorHeap::deallocate(uint32_t a_index)
-{
-    --m_heapSize;
-    m_freeIndices[m_heapSize] = a_index;
+    m_rangesToDeferredDeallocate[a_newFrameIndex].clear();
 }
 
 uint32_t DescriptorHeap::getIndex(const Handle& a_handle) const
 {
-    assert(m_heapSize > 0);
     assert(a_handle.cpu.ptr != 0);
-    assert(a_handle.cpu.ptr > m_startHeapAddress.cpu.ptr);
+    assert(a_handle.cpu.ptr >= m_startHeapAddress.cpu.ptr);
     SIZE_T addressOffset = a_handle.cpu.ptr - m_startHeapAddress.cpu.ptr;
 
     uint32_t index = static_cast<uint32_t>(addressOffset) / m_descriptorSize;
-    assert(index < m_heapCapacity);
+    assert(index < m_indices.getCapacity());
     return index;
 }
 
@@ -1,15 +1,22 @@
 #pragma once
 
 #include <utils/Macros.h>
+#include <utils/ConcurrentIndexAllocator.h>
+#include <utils/OffsetAllocator.h>
 
 #include <graphics/d3d12/CommonGraphicsHeaders.h>
 
-#include <vector>
+#include <atomic>
 #include <memory>
-#include <optional>
+#include <mutex>
+#include <vector>
 
 namespace neural::graphics {
 
+// Thread-safe: views can be created while command lists are recorded or assets stream in on other threads.
+// Deferred deallocations are freed when resetDeferred is called with the same frame index again.
+// Contiguous ranges for descriptor tables and DirectML binding tables come from a section of their own after
+// the single descriptors, placed by an OffsetAllocator that merges freed ranges
 class DescriptorHeap
 {
 public:
@@ -21,23 +28,35 @@ public:
             return gpu.ptr != 0;
         }
     };
+    struct Range
+    {
+        Handle start;
+        uint32_t size = 0;
+        utils::OffsetAllocator::Allocation allocation;
+    };
     void initialize(ID3D12Device* a_device, uint32_t a_nFrames,
-        D3D12_DESCRIPTOR_HEAP_TYPE a_type, uint32_t a_capacity, bool isShaderVisiable);
+        D3D12_DESCRIPTOR_HEAP_TYPE a_type, uint32_t a_capacity, bool isShaderVisiable, uint32_t a_rangeCapacity = 0);
 
     Handle allocate();
+    Range allocateRange(uint32_t a_size);
+    Handle getHandle(const Range& a_range, uint32_t a_index) const;
 
+    // Once the gpu finished the frame that last used a_newFrame
     void resetDeferred(uint32_t a_newFrame);
     void deferredDeallocate(Handle& a_handle);
 
     // Be careful, when multiple command allocators access a handle, deallocate it immediatly can lead to errors
     void immediatelyDeallocate(Handle& a_handle);
+    void deferredDeallocate(Range& a_range);
+    void immediatelyDeallocate(Range& a_range);
 
     ID3D12DescriptorHeap* getID3D12DescriptorHeap()
     {
         return m_heap.Get();
     }
 private:
-    void deallocate(uint32_t a_index);
+    static constexpr uint32_t k_noFrame = ~0u;
+
     uint32_t getIndex(const Handle& a_handle) const;
     void clearHandle(Handle& a_handle);
 
@@ -45,12 +64,13 @@ private:
     Handle m_startHeapAddress;
     uint32_t m_descriptorSize;
 
-    std::unique_ptr<uint32_t[]> m_freeIndices;
-    std::uint32_t m_heapSize;
-    DEBUG_LINE(std::uint32_t m_heapCapacity);
+    utils::ConcurrentIndexAllocator m_indices;
+    std::atomic<uint32_t> m_currentFrame = k_noFrame;
 
-    std::unique_ptr<std::vector<uint32_t>[]> m_indicesToDeferredDeallocate;
-    std::optional<std::uint32_t> m_currentFrame;
-    DEBUG_LINE(std::uint32_t m_nDeferredVectors);
+    // Ranges are rare, a lock is enough for them
+    std::mutex m_rangeMutex;
+    utils::OffsetAllocator m_ranges;  // offsets from the end of the single descriptors
+    std::unique_ptr<std::vector<utils::OffsetAllocator::Allocation>[]> m_rangesToDeferredDeallocate;
+    uint32_t m_nFrames = 0;
 };
 }
\ No newline at end of file
@@ -1,30 +1,86 @@
 #include "GraphicsPipeline.h"
+#include "DX12PipelineCompiler.h"
+#include <graphics/ShaderSignature.h>
 
 namespace neural::graphics {
 
-void GraphicsPipeline::initialize(ID3D12Device* a_device, std::string_view a_debugName, CreateInfo a_info) {
-    D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineDesc;
-    ZeroMemory(&pipelineDesc, sizeof(D3D12_GRAPHICS_PIPELINE_STATE_DESC));
-    if (a_info.inputLayout.size() > 0) {
-        pipelineDesc.InputLayout = { a_info.inputLayout.data(), static_cast<uint32_t>(a_info.inputLayout.size()) };
+void GraphicsPipeline::initialize(ID3D12Device* a_device, PipelineCache& a_cache, std::string_view a_debugName,
+                                  CreateInfo a_info) {
+    assert(a_info.RTVFormats.size() <= D3D12_SIMULTANEOUS_RENDER_TARGET_COUNT);
+    std::string state;
+    const std::span<const char> rootSignature = a_info.rootSignature.getSerialized();
+    appendPipelineState(state, static_cast<uint32_t>(rootSignature.size()));
+    state.append(rootSignature.begin(), rootSignature.end());
+    appendInputLayout(state, a_info.inputLayout);
+    appendPipelineState(state, a_info.rasterizerState);
+    appendBlendState(state, a_info.blendState);
+    appendDepthStencilState(state, a_info.depthStencilState);
+    appendPipelineState(state, a_info.sampleMask);
+    appendPipelineState(state, a_info.primitiveTopologyType);
+    appendPipelineState(state, static_cast<uint32_t>(a_info.RTVFormats.size()));
+    for (const DXGI_FORMAT format : a_info.RTVFormats) {
+        appendPipelineState(state, format);
     }
-    pipelineDesc.pRootSignature = a_info.rootSignature.getID3D12RootSignature();
-    std::vector<char> vsByteCode = utils::loadBinary(a_info.vertexShaderPath);
-    pipelineDesc.VS = { vsByteCode.data(), vsByteCode.size() };
-    std::vector<char> psByteCode = utils::loadBinary(a_info.pixelShaderPath);
-    pipelineDesc.PS = { psByteCode.data(), psByteCode.size() };
-    pipelineDesc.RasterizerState = a_info.rasterizerState;
-    pipelineDesc.BlendState = a_info.blendState;
-    pipelineDesc.DepthStencilState = a_info.depthStencilState;
-    pipelineDesc.SampleMask = a_info.sampleMask;
-    pipelineDesc.PrimitiveTopologyType = a_info.primitiveTopologyType;
-    pipelineDesc.NumRenderTargets = a_info.RTVFormats.size();
-    for (int i = 0; i < a_info.RTVFormats.size(); ++i) {
-        pipelineDesc.RTVFormats[i] = a_info.RTVFormats[i];
-    }
-    pipelineDesc.SampleDesc = a_info.sampleDesc;
-    pipelineDesc.DSVFormat = a_info.DSVFormat;
+    appendPipelineState(state, a_info.DSVFormat);
+    appendPipelineState(state, a_info.sampleDesc);
+
+    m_cache = &a_cache;
+    m_pipeline = nullptr;
+    std::vector<std::string> shaderPaths = { a_info.vertexShaderPath, a_info.pixelShaderPath };
+    m_job = a_cache.request(std::move(shaderPaths), std::move(state),
+        [a_device, debugName = std::string(a_debugName), info = std::move(a_info)](
+            std::span<const std::vector<char>> a_shaders, std::span<const char> a_cachedBlob) mutable {
+            // A layout the vertex shader doesn't fit fails here with the reason instead of drawing garbage
+            std::vector<ShaderSignatureElement> signature;
+            std::vector<InputLayoutElement> layout;
+            for (const D3D12_INPUT_ELEMENT_DESC& element : info.inputLayout) {
+                layout.push_back({
+                    .semanticName = element.SemanticName,
+                    .semanticIndex = element.SemanticIndex,
+                    .perInstance = element.InputSlotClass == D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA
+                });
+            }
+            const std::string layoutError = readInputSignature(a_shaders[0], signature) ?
+                checkInputLayout(signature, layout) : "the vertex shader has no input signature\n";
+            if (!layoutError.empty()) {
+                OutputDebugStringA(("-------Input layout of " + debugName + ":\n" + layoutError).c_str());
+                return PipelineCache::CompileResult{};
+            }
 
-    DX_CALL(a_device->CreateGraphicsPipelineState(&pipelineDesc, IID_PPV_ARGS(m_pipeline.GetAddressOf())));
+            D3D12_GRAPHICS_PIPELINE_STATE_DESC pipelineDesc;
+            ZeroMemory(&pipelineDesc, sizeof(D3D12_GRAPHICS_PIPELINE_STATE_DESC));
+            if (info.inputLayout.size() > 0) {
+                pipelineDesc.InputLayout = { info.inputLayout.data(), static_cast<uint32_t>(info.inputLayout.size()) };
+            }
+            pipelineDesc.pRootSignature = info.rootSignature.getID3D12RootSignature();
+            pipelineDesc.VS = { a_shaders[0].data(), a_shaders[0].size() };
+            pipelineDesc.PS = { a_shaders[1].data(), a_shaders[1].size() };
+            pipelineDesc.RasterizerState = info.rasterizerState;
+            pipelineDesc.BlendState = info.blendState;
+            pipelineDesc.DepthStencilState = info.depthStencilState;
+            pipelineDesc.SampleMask = info.sampleMask;
+            pipelineDesc.PrimitiveTopologyType = info.primitiveTopologyType;
+            pipelineDesc.NumRenderTargets = info.RTVFormats.size();
+            for (int i = 0; i < info.RTVFormats.size(); ++i) {
+                pipelineDesc.RTVFormats[i] = info.RTVFormats[i];
+            }
+            pipelineDesc.SampleDesc = info.sampleDesc;
+            pipelineDesc.DSVFormat = info.DSVFormat;
+
+            return createPipelineState(a_cachedBlob, debugName,
+                [&](const D3D12_CACHED_PIPELINE_STATE& a_cachedState, ID3D12PipelineState** a_pipeline) {
+                    pipelineDesc.CachedPSO = a_cachedState;
+                    return a_device->CreateGraphicsPipelineState(&pipelineDesc, IID_PPV_ARGS(a_pipeline));
+                });
+        });
+}
+
+ID3D12PipelineState* GraphicsPipeline::getID3D12Pipeline() {
+    if (!m_pipeline) {
+        assert(m_cache && "not initialized");
+        m_pipeline = m_cache->wait(m_job);
+        assert(m_pipeline && "the pipeline failed to compile, see the debug output");
+    }
+    return static_cast<ID3D12PipelineState*>(m_pipeline.get());
+}
 }
-}
\ No newline at end of file
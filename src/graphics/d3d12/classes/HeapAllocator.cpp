@@ -0,0 +1,100 @@
+#include "HeapAllocator.h"
+
+#include <algorithm>
+
+namespace neural::graphics {
+
+void HeapAllocator::initialize(ID3D12Device* a_device, const CreateInfo& a_createInfo)
+{
+    assert(a_device);
+    assert(a_createInfo.heapSize % D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT == 0);
+    m_device = a_device;
+    m_heapSize = a_createInfo.heapSize;
+    m_heaps.clear();
+
+    D3D12_FEATURE_DATA_D3D12_OPTIONS options = {};
+    DX_CALL(m_device->CheckFeatureSupport(D3D12_FEATURE_D3D12_OPTIONS, &options, sizeof(options)));
+    m_heapTier = options.ResourceHeapTier;
+}
+
+HeapAllocator::Allocation HeapAllocator::allocate(const D3D12_RESOURCE_DESC& a_desc)
+{
+    assert(m_device);
+    const D3D12_RESOURCE_ALLOCATION_INFO info = m_device->GetResourceAllocationInfo(0, 1, &a_desc);
+    if (info.SizeInBytes == UINT64_MAX || info.SizeInBytes > m_heapSize / 2 ||
+        info.Alignment > D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT) {
+        return {};
+    }
+    const HeapKind kind = getHeapKind(a_desc);
+    for (uint32_t i = 0; i < m_heaps.size(); ++i) {
+        Heap& heap = *m_heaps[i];
+        if (heap.kind != kind) {
+            continue;
+        }
+        const utils::OffsetAllocator::Allocation range = heap.allocator.allocate(info.SizeInBytes, info.Alignment);
+        if (range.isValid()) {
+            return { .heapInfo = { .heap = heap.heap.Get(), .offset = range.offset }, .heapIndex = i, .range = range };
+        }
+    }
+
+    static constexpr D3D12_HEAP_FLAGS k_heapFlags[] = {
+        D3D12_HEAP_FLAG_ALLOW_ALL_BUFFERS_AND_TEXTURES,
+        D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+        D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES
+    };
+    auto heap = std::make_unique<Heap>();
+    heap->kind = kind;
+    const CD3DX12_HEAP_DESC heapDesc(m_heapSize, D3D12_HEAP_TYPE_DEFAULT, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+                                     k_heapFlags[static_cast<uint32_t>(kind)]);
+    DX_CALL(m_device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap->heap)));
+    NAME_DX_OBJECT_INDEXED(heap->heap, L"ResourceHeap", m_heaps.size());
+    heap->allocator.initialize(m_heapSize, D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT);
+    const utils::OffsetAllocator::Allocation range = heap->allocator.allocate(info.SizeInBytes, info.Alignment);
+    assert(range.isValid());
+    m_heaps.push_back(std::move(heap));
+    return {
+        .heapInfo = { .heap = m_heaps.back()->heap.Get(), .offset = range.offset },
+        .heapIndex = static_cast<uint32_t>(m_heaps.size() - 1),
+        .range = range
+    };
+}
+
+void HeapAllocator::free(const Allocation& a_allocation)
+{
+    if (a_allocation.heapInfo.heap == nullptr) {
+        return;
+    }
+    assert(a_allocation.heapIndex < m_heaps.size());
+    m_heaps[a_allocation.heapIndex]->allocator.free(a_allocation.range);
+}
+
+HeapAllocator::Stats HeapAllocator::getStats() const
+{
+    Stats stats = { .heapCount = static_cast<uint32_t>(m_heaps.size()), .memory = {} };
+    for (const auto& heap : m_heaps) {
+        const utils::OffsetAllocatorStats heapStats = heap->allocator.getStats();
+        stats.memory.capacity += heapStats.capacity;
+        stats.memory.usedSize += heapStats.usedSize;
+        stats.memory.freeSize += heapStats.freeSize;
+        stats.memory.largestFreeBlock = std::max(stats.memory.largestFreeBlock, heapStats.largestFreeBlock);
+        stats.memory.allocationCount += heapStats.allocationCount;
+        stats.memory.freeBlockCount += heapStats.freeBlockCount;
+    }
+    return stats;
+}
+
+HeapAllocator::HeapKind HeapAllocator::getHeapKind(const D3D12_RESOURCE_DESC& a_desc) const
+{
+    if (m_heapTier != D3D12_RESOURCE_HEAP_TIER_1) {
+        return HeapKind::All;
+    }
+    if (a_desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER) {
+        return HeapKind::Buffers;
+    }
+    if (a_desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL)) {
+        return HeapKind::Targets;
+    }
+    return HeapKind::OtherTextures;
+}
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <utils/Macros.h>
+#include <utils/OffsetAllocator.h>
+#include "resource/BufferAndTexture.h"
+
+#include <graphics/d3d12/CommonGraphicsHeaders.h>
+
+#include <memory>
+#include <vector>
+
+using Microsoft::WRL::ComPtr;
+namespace neural::graphics {
+
+// Places default heap resources in large ID3D12Heaps, offsets are handed out by a TLSF allocator per heap.
+// Resources bigger than half a heap or with the 4 MiB MSAA alignment stay committed. On resource heap
+// tier 1 buffers, render/depth targets and other textures get heaps of their own
+class HeapAllocator {
+public:
+    static constexpr uint64_t k_defaultHeapSize = 64ull << 20;
+
+    struct CreateInfo {
+        uint64_t heapSize = k_defaultHeapSize;
+    };
+    struct Allocation {
+        HeapInfo heapInfo;  // heap is null when the resource has to be committed
+        uint32_t heapIndex = ~0u;
+        utils::OffsetAllocator::Allocation range;
+    };
+    struct Stats {
+        uint32_t heapCount;
+        utils::OffsetAllocatorStats memory;  // of all heaps, largestFreeBlock is the largest of one heap
+    };
+
+    void initialize(ID3D12Device* a_device, const CreateInfo& a_createInfo);
+    Allocation allocate(const D3D12_RESOURCE_DESC& a_desc);
+    // After the GPU finished with the resource placed there
+    void free(const Allocation& a_allocation);
+    Stats getStats() const;
+private:
+    enum class HeapKind : uint32_t {
+        All,
+        Buffers,
+        Targets,
+        OtherTextures
+    };
+    struct Heap {
+        ComPtr<ID3D12Heap> heap;
+        HeapKind kind;
+        utils::OffsetAllocator allocator;
+    };
+    HeapKind getHeapKind(const D3D12_RESOURCE_DESC& a_desc) const;
+
+    ID3D12Device* m_device = nullptr;
+    uint64_t m_heapSize = 0;
+    D3D12_RESOURCE_HEAP_TIER m_heapTier = D3D12_RESOURCE_HEAP_TIER_1;
+    std::vector<std::unique_ptr<Heap>> m_heaps;
+};
+}
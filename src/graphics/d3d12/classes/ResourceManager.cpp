@@ -4,7 +4,7 @@
 
 namespace neural::graphics {
 void ResourceManager::initialize(ID3D12Device* a_device, uint32_t a_nFrames,
-    uint32_t a_rtvHeapSize, uint32_t a_dsvHeapSize, uint32_t a_cbvHeapSize)
+    uint32_t a_rtvHeapSize, uint32_t a_dsvHeapSize, uint32_t a_cbvHeapSize, uint32_t a_cbvRangeHeapSize)
 {
     assert(a_device);
     assert(a_rtvHeapSize > 0);
@@ -14,13 +14,39 @@ void ResourceManager::initialize(ID3D12Device* a_device, uint32_t a_nFrames,
 
     m_rtvHeap.initialize(a_device, a_nFrames, D3D12_DESCRIPTOR_HEAP_TYPE_RTV, a_rtvHeapSize, false);
     m_dsvHeap.initialize(a_device, a_nFrames, D3D12_DESCRIPTOR_HEAP_TYPE_DSV, a_dsvHeapSize, false);
-    m_cbvHeap.initialize(a_device, a_nFrames, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, a_cbvHeapSize, true);
+    m_cbvHeap.initialize(a_device, a_nFrames, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, a_cbvHeapSize, true,
+                         a_cbvRangeHeapSize);
     m_device = a_device;
+    m_heapAllocator.initialize(a_device, {});
 
     m_frameResources = std::move(std::make_unique<Resources[]>(a_nFrames));
     NAME_DX_OBJECT(m_cbvHeap.getID3D12DescriptorHeap(), L"mainSrvHeap");
 }
 
+void ResourceManager::beginFrame(uint32_t a_frame)
+{
+    m_rtvHeap.resetDeferred(a_frame);
+    m_dsvHeap.resetDeferred(a_frame);
+    m_cbvHeap.resetDeferred(a_frame);
+}
+
+BufferCreateInfo ResourceManager::placeBuffer(const BufferCreateInfo& a_createInfo)
+{
+    BufferCreateInfo createInfo = a_createInfo;
+    if (createInfo.heapType == D3D12_HEAP_TYPE_DEFAULT && createInfo.heapInfo.heap == nullptr) {
+        createInfo.heapInfo = m_heapAllocator.allocate(Buffer::getResourceDesc(createInfo)).heapInfo;
+    }
+    return createInfo;
+}
+TextureCreateInfo ResourceManager::placeTexture(const TextureCreateInfo& a_createInfo)
+{
+    TextureCreateInfo createInfo = a_createInfo;
+    if (createInfo.heapType == D3D12_HEAP_TYPE_DEFAULT && createInfo.placementHeap.heap == nullptr) {
+        createInfo.placementHeap = m_heapAllocator.allocate(Texture::getResourceDesc(createInfo)).heapInfo;
+    }
+    return createInfo;
+}
+
 ConstantBuffer& ResourceManager::createConstantBufferInFrame(std::string a_name, uint32_t a_frame, const ConstantBufferCreateInfo& a_createInfo)
 {
     assert(!m_frameResources[a_frame].m_constantBuffers.contains(a_name)); // name is already taken
@@ -39,7 +65,7 @@ Buffer& ResourceManager::createBufferInUnique(std::string a_name, const BufferCr
 
     m_uniqueResources.m_buffers[a_name] = {};
     Buffer& buffer = m_uniqueResources.m_buffers[a_name];
-    buffer.initialize(m_device, &m_cbvHeap, a_createInfo);
+    buffer.initialize(m_device, &m_cbvHeap, placeBuffer(a_createInfo));
 
     std::wstring wName(a_name.begin(), a_name.end());
     NAME_DX_OBJECT(buffer.m_resource, wName);
@@ -52,7 +78,7 @@ Buffer& ResourceManager::createBufferInFrame(std::string a_name, uint32_t a_fram
 
     m_frameResources[a_frame].m_buffers[a_name] = {};
     Buffer& buffer = m_frameResources[a_frame].m_buffers[a_name];
-    buffer.initialize(m_device, &m_cbvHeap, a_createInfo);
+    buffer.initialize(m_device, &m_cbvHeap, placeBuffer(a_createInfo));
 
     std::wstring wName(a_name.begin(), a_name.end());
     NAME_DX_OBJECT(buffer.m_resource, wName);
@@ -65,7 +91,7 @@ Texture& ResourceManager::createTextureInFrame(std::string a_name, uint32_t a_fr
 
     m_frameResources[a_frame].m_textures[a_name] = {};
     Texture& texture = m_frameResources[a_frame].m_textures[a_name];
-    texture.initialize(m_device, a_createInfo, &m_rtvHeap, &m_dsvHeap, &m_cbvHeap);
+    texture.initialize(m_device, placeTexture(a_createInfo), &m_rtvHeap, &m_dsvHeap, &m_cbvHeap);
 
     std::wstring wName(a_name.begin(), a_name.end());
     NAME_DX_OBJECT_INDEXED(texture.m_resource, wName, a_frame);
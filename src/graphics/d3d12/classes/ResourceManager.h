@@ -1,5 +1,6 @@
 #pragma once
 #include "DescriptorHeap.h"
+#include "HeapAllocator.h"
 #include "resource/BufferAndTexture.h"
 #include "resource/ConstantBuffer.h"
 #include <graphics/d3d12/CommonGraphicsHeaders.h>
@@ -10,14 +11,20 @@ namespace neural::graphics {
 
 class ResourceManager {
 public:
+    // a_cbvRangeHeapSize descriptors of the CBV/SRV/UAV heap are kept for contiguous ranges
     void initialize(ID3D12Device* a_device, uint32_t a_nFrames,
-        uint32_t a_rtvHeapSize, uint32_t a_dsvHeapSize, uint32_t a_cbvHeapSize);
+        uint32_t a_rtvHeapSize, uint32_t a_dsvHeapSize, uint32_t a_cbvHeapSize, uint32_t a_cbvRangeHeapSize);
+
+    // After the gpu finished the last frame that used a_frame, frees the views deferred on it
+    void beginFrame(uint32_t a_frame);
 
     ConstantBuffer& createConstantBufferInFrame(std::string a_name, uint32_t a_frame, 
                                                 const ConstantBufferCreateInfo& a_createInfo);
     ConstantBuffer& getConstantBuffer(std::string a_name, uint32_t a_frame) {
         return m_frameResources[a_frame].m_constantBuffers[a_name];
     }
+    // Default heap buffers and textures without a heap of their own are placed by the heap allocator.
+    // Placed render and depth targets have to be cleared or discarded before their first use
     Buffer& createBufferInUnique(std::string a_name, const BufferCreateInfo& a_createInfo);
     Buffer& createBufferInFrame(std::string a_name, uint32_t a_frame, const BufferCreateInfo& a_createInfo);
     Buffer& getBuffer(std::string a_name, uint32_t a_frame) {
@@ -46,11 +53,19 @@ public:
     ID3D12Device* getDevice() {
         return m_device;
     }
+    HeapAllocator* getHeapAllocator() {
+        return &m_heapAllocator;
+    }
 private:
+    // The create info placed in a heap of the allocator, if the resource can be
+    BufferCreateInfo placeBuffer(const BufferCreateInfo& a_createInfo);
+    TextureCreateInfo placeTexture(const TextureCreateInfo& a_createInfo);
+
     DescriptorHeap m_rtvHeap;
     DescriptorHeap m_dsvHeap;
     DescriptorHeap m_cbvHeap;
     ID3D12Device* m_device;
+    HeapAllocator m_heapAllocator;
 
     struct Resources {
         std::unordered_map<std::string, ConstantBuffer> m_constantBuffers;
@@ -70,6 +70,8 @@ void RootSignature::initialize(ID3D12Device* a_device, const std::vector<RootPar
         ::OutputDebugStringA((char*)errorBlob->GetBufferPointer());
     }
     DX_CALL(hr);
+    const char* serialized = static_cast<const char*>(serializedRootSig->GetBufferPointer());
+    m_serialized.assign(serialized, serialized + serializedRootSig->GetBufferSize());
     DX_CALL(a_device->CreateRootSignature(
         0,
         serializedRootSig->GetBufferPointer(),
@@ -8,6 +8,7 @@
 #include <wrl.h>
 #include <d3dx12.h>
 
+#include <span>
 #include <vector>
 
 using Microsoft::WRL::ComPtr;
@@ -50,7 +51,12 @@ public:
 
     void initialize(ID3D12Device* a_device, const std::vector<RootParameter>& slots);
     ID3D12RootSignature* getID3D12RootSignature();
+    // The description D3D12 creates the root signature from, part of the pipeline cache keys
+    std::span<const char> getSerialized() const {
+        return m_serialized;
+    }
 private:
     ComPtr<ID3D12RootSignature> m_rootSignature;
+    std::vector<char> m_serialized;
 };
 }
\ No newline at end of file
@@ -1,148 +1,204 @@
 #include "SceneManager.h"
-#include "ResourceManager.h"
+#include <utils/Macros.h>
 
-#include <iostream>
-#include <utils/Utils.h>
+#include <algorithm>
+#include <cassert>
+#include <cstring>
 
 namespace neural::graphics {
-using utils::transformFloat3;
-using DirectX::XMMATRIX;
-using DirectX::XMFLOAT3;
-using DirectX::XMMatrixScaling;
-using DirectX::XMMatrixMultiply;
-using DirectX::XMMatrixRotationRollPitchYaw;
-
-void SceneManager::initialize(ID3D12Device* a_device) {
+namespace {
+constexpr uint64_t k_minMeshBufferSize = 1 << 20;
+}  // anonymous namespace
+
+void SceneManager::initialize(ID3D12Device* a_device, HeapAllocator* a_heapAllocator, UploadRing* a_uploadRing,
+                              VertexFormat a_vertexFormat) {
+    assert(a_heapAllocator);
+    assert(a_uploadRing);
     m_device = a_device;
+    m_heapAllocator = a_heapAllocator;
+    m_uploadRing = a_uploadRing;
+    m_vertexFormat = a_vertexFormat;
 }
-void SceneManager::loadMesh(const char* a_meshName, const std::vector<Vertex>& a_vertices,
-                            const std::vector<uint32_t>& a_indices, MeshTransform a_transform)
-{
-    XMMATRIX scalingMatrix = XMMatrixScaling(a_transform.scale, a_transform.scale, a_transform.scale);
-    XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw(DirectX::XMConvertToRadians(a_transform.rotation.y),
-        DirectX::XMConvertToRadians(a_transform.rotation.x),
-        DirectX::XMConvertToRadians(a_transform.rotation.z));
-    XMMATRIX transformMatrix = XMMatrixMultiply(scalingMatrix, rotationMatrix);
-
-    MeshInfo meshInfo;
-    meshInfo.startVertex = m_vertices.size();
-    for (int i = 0; i < a_vertices.size(); ++i) {
-        XMFLOAT3 position =
-            transformFloat3(a_vertices[i].position, transformMatrix);
-        XMFLOAT3 normal =
-            transformFloat3(a_vertices[i].normal, transformMatrix);
-
-        m_vertices.push_back({
-            { position.x, position.y, position.z },
-            { normal.x, normal.y,  normal.z },
-            { 1, 1}
-            });
+std::vector<D3D12_INPUT_ELEMENT_DESC> SceneManager::getInputLayout() const {
+    std::vector<D3D12_INPUT_ELEMENT_DESC> layout;
+    if (m_vertexFormat == VertexFormat::Compact) {
+        layout = {
+            { "POSITION", 0, DXGI_FORMAT_R16G16B16A16_UNORM, 0, offsetof(CompactVertex, position),
+              D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "NORMAL",   0, DXGI_FORMAT_R16G16_UNORM, 0, offsetof(CompactVertex, normal),
+              D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
+    } else {
+        layout = {
+            { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, offsetof(Vertex, position),
+              D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "NORMAL",   0, DXGI_FORMAT_R32G32B32_FLOAT, 0, offsetof(Vertex, normal),
+              D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
+            { "TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, offsetof(Vertex, textureCoordinates),
+              D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 }
+        };
     }
-    meshInfo.vertexCount = m_vertices.size() - meshInfo.startVertex;
-
-    meshInfo.startIndex = m_indices.size();
-    for (int i = 0; i < a_indices.size(); ++i) {
-        m_indices.push_back(a_indices[i]);
+    for (uint32_t column = 0; column < 3; ++column) {
+        layout.push_back({ "WORLD", column, DXGI_FORMAT_R32G32B32A32_FLOAT, k_instanceSlot,
+                           static_cast<uint32_t>(offsetof(InstanceTransform, columns) + column * sizeof(DirectX::XMFLOAT4)),
+                           D3D12_INPUT_CLASSIFICATION_PER_INSTANCE_DATA, 1 });
     }
-    meshInfo.indexCount = m_indices.size() - meshInfo.startIndex;
-    m_meshes[a_meshName] = meshInfo;
+    return layout;
 }
-void SceneManager::loadMeshFromFile(const char* a_meshName, const char* a_path, MeshTransform a_transform) {
-    Assimp::Importer assetImporter;
-    const aiScene* scene = assetImporter.ReadFile(a_path,
-        aiProcess_Triangulate | aiProcess_JoinIdenticalVertices);
-    assert(scene);
-    const aiMesh* mesh = scene->mMeshes[0];
-
-    XMMATRIX scalingMatrix = XMMatrixScaling(a_transform.scale, a_transform.scale, a_transform.scale);
-    XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw(DirectX::XMConvertToRadians(a_transform.rotation.y),
-                                                           DirectX::XMConvertToRadians(a_transform.rotation.x),
-                                                           DirectX::XMConvertToRadians(a_transform.rotation.z));
-    XMMATRIX transformMatrix = XMMatrixMultiply(scalingMatrix, rotationMatrix);
-
-    MeshInfo meshInfo;
-    meshInfo.startVertex = m_vertices.size();
-    for (int i = 0; i < mesh->mNumVertices; ++i) {
-        XMFLOAT3 position = 
-            transformFloat3({ mesh->mVertices[i].x, mesh->mVertices[i].y, mesh->mVertices[i].z }, transformMatrix);
-        XMFLOAT3 normal =
-            transformFloat3({ mesh->mNormals[i].x, mesh->mNormals[i].y, mesh->mNormals[i].z }, transformMatrix);
-
-        m_vertices.push_back({
-            { position.x, position.y, position.z },
-            { normal.x, normal.y,  normal.z },
-            { 1, 1}
-            });
+void SceneManager::reserveBuffer(ID3D12GraphicsCommandList* a_commandList, std::unique_ptr<Buffer>& a_buffer,
+                                 HeapAllocator::Allocation& a_allocation, const wchar_t* a_name, uint64_t a_usedSize, uint64_t a_size,
+                                 uint32_t a_elementSize, uint64_t a_frame) {
+    if (a_buffer && a_buffer->getTotalSize() >= a_size) {
+        return;
     }
-    meshInfo.vertexCount = m_vertices.size() - meshInfo.startVertex;
-
-    meshInfo.startIndex = m_indices.size();
-    for (int i = 0; i < mesh->mNumFaces; ++i) {
-        const auto face = mesh->mFaces[i];
-#ifdef _DEBUG 
-        if (face.mNumIndices == 3) {
-            m_indices.push_back(face.mIndices[0]);
-            m_indices.push_back(face.mIndices[1]);
-            m_indices.push_back(face.mIndices[2]);
-        }
-#else
-        m_indices.push_back(face.mIndices[0]);
-        m_indices.push_back(face.mIndices[1]);
-        m_indices.push_back(face.mIndices[2]);
-#endif
+    // Doubles, so streaming many meshes copies every byte a constant number of times on average
+    const uint64_t oldSize = a_buffer ? a_buffer->getTotalSize() : 0;
+    const uint64_t size = std::max({ a_size, oldSize * 2, k_minMeshBufferSize });
+    BufferCreateInfo createInfo = {
+        .size = (size + a_elementSize - 1) / a_elementSize,
+        .elementSize = a_elementSize,
+    };
+    const HeapAllocator::Allocation allocation = m_heapAllocator->allocate(Buffer::getResourceDesc(createInfo));
+    createInfo.heapInfo = allocation.heapInfo;
+    auto buffer = std::make_unique<Buffer>();
+    buffer->initialize(m_device, nullptr, createInfo);
+    NAME_DX_OBJECT(buffer->getID3D12Resource(), a_name);
+    if (a_usedSize > 0) {
+        a_commandList->CopyBufferRegion(buffer->getID3D12Resource(), 0, a_buffer->getID3D12Resource(), 0, a_usedSize);
     }
-    meshInfo.indexCount = m_indices.size() - meshInfo.startIndex;
-#ifdef _DEBUG 
-    if (meshInfo.indexCount != mesh->mNumFaces * 3) {
-        std::cout << a_path << ": not just triangles\n";
+    if (a_buffer) {
+        m_retiredBuffers.push_back({ .frame = a_frame, .buffer = std::move(a_buffer), .allocation = a_allocation });
     }
-#endif
-    m_meshes[a_meshName] = meshInfo;
+    a_buffer = std::move(buffer);
+    a_allocation = allocation;
 }
-void SceneManager::uploadMeshesOnGPU(ID3D12GraphicsCommandList* a_commandList, 
-                                     ResourceManager* a_pResourceManager) {
-    m_vertexBuffer = a_pResourceManager->createBufferInUnique("VertexBuffer", {
-        .size = m_vertices.size(),
-        .elementSize = sizeof(m_vertices[0]),
-        });
-
-    m_indexBuffer = a_pResourceManager->createBufferInUnique("IndexBuffer", {
-        .size = m_indices.size(),
-        .elementSize = sizeof(m_indices[0]),
-        });
-
-    Buffer& uploadVertex = a_pResourceManager->createBufferInUnique("VertexBufferUpload", {
-        .size = m_vertices.size(),
-        .elementSize = sizeof(m_vertices[0]),
-        .initialState = D3D12_RESOURCE_STATE_GENERIC_READ,
-        .heapType = D3D12_HEAP_TYPE_UPLOAD
-        });
-
-    Buffer& uploadIndex = a_pResourceManager->createBufferInUnique("IndexBufferUpload", {
-        .size = m_indices.size(),
-        .elementSize = sizeof(m_indices[0]),
-        .initialState = D3D12_RESOURCE_STATE_GENERIC_READ,
-        .heapType = D3D12_HEAP_TYPE_UPLOAD
-        });
+void SceneManager::uploadMeshesOnGPU(ID3D12GraphicsCommandList* a_commandList, uint64_t a_frame,
+                                     uint64_t a_completedFrame) {
+    std::erase_if(m_retiredBuffers, [this, a_completedFrame](const RetiredBuffer& a_retired) {
+        if (a_retired.frame > a_completedFrame) {
+            return false;
+        }
+        m_heapAllocator->free(a_retired.allocation);
+        return true;
+    });
+    addFinishedMeshes();
+
+    // MeshStorage only appends, so the meshes that aren't on the GPU yet are the last ones
+    std::vector<std::pair<const std::string*, const MeshInfo*>> meshes;
+    for (const auto& [name, meshInfo] : m_meshes) {
+        if (!m_drawArguments.contains(name)) {
+            meshes.emplace_back(&name, &meshInfo);
+        }
+    }
+    if (meshes.empty()) {
+        return;
+    }
+    std::sort(meshes.begin(), meshes.end(), [](const auto& a_left, const auto& a_right) {
+        return a_left.second->startIndex < a_right.second->startIndex;
+    });
+    assert(meshes.front().second->startVertex == m_uploadedVertexCount);
+
+    // Every mesh packs its own vertices and indices, in the order they are stored in MeshStorage
+    const uint32_t vertexStride = getVertexStride(m_vertexFormat);
+    std::vector<uint8_t> vertices((m_vertices.size() - m_uploadedVertexCount) * vertexStride);
+    std::vector<uint8_t> indices;
+    struct IndexRange {
+        DrawLod* lod;
+        uint32_t offset;  // in the index buffer
+        uint32_t size;
+        DXGI_FORMAT format;
+    };
+    std::vector<IndexRange> indexRanges;
+    for (const auto& [name, meshInfo] : meshes) {
+        const VertexDecode decode = getVertexDecode(m_vertexFormat, *meshInfo);
+        packVertices(m_vertexFormat, decode, { m_vertices.data() + meshInfo->startVertex, meshInfo->vertexCount },
+                     vertices.data() + (meshInfo->startVertex - m_uploadedVertexCount) * vertexStride);
+
+        // Indices are relative to the base vertex. Ranges start 4-byte aligned, as a view of either format can
+        const bool shortIndices = meshInfo->vertexCount <= 0x10000;
+        const uint32_t indexSize = shortIndices ? sizeof(uint16_t) : sizeof(uint32_t);
+        DrawArguments& drawArguments = m_drawArguments[*name];
+        drawArguments = { .baseVertex = static_cast<int32_t>(meshInfo->startVertex), .vertexDecode = decode };
+        drawArguments.lods.resize(meshInfo->lods.size());
+        for (size_t l = 0; l < meshInfo->lods.size(); ++l) {
+            const MeshLod& lod = meshInfo->lods[l];
+            const size_t offset = (indices.size() + 3) / 4 * 4;
+            indices.resize(offset + lod.indexCount * indexSize);
+            for (size_t i = 0; i < lod.indexCount; ++i) {
+                const uint32_t index = m_indices[lod.startIndex + i];
+                if (shortIndices) {
+                    const uint16_t shortIndex = static_cast<uint16_t>(index);
+                    std::memcpy(&indices[offset + i * indexSize], &shortIndex, indexSize);
+                } else {
+                    std::memcpy(&indices[offset + i * indexSize], &index, indexSize);
+                }
+            }
+            drawArguments.lods[l].indexCount = static_cast<uint32_t>(lod.indexCount);
+            indexRanges.push_back({
+                .lod = &drawArguments.lods[l],
+                .offset = static_cast<uint32_t>(m_uploadedIndexSize + offset),
+                .size = static_cast<uint32_t>(lod.indexCount * indexSize),
+                .format = shortIndices ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT
+            });
+        }
+    }
+    indices.resize((indices.size() + 3) / 4 * 4);
+
+    // Buffers decay to COMMON after every ExecuteCommandLists and the copies promote them implicitly,
+    // only the draws after them in this command list need a barrier
+    const uint64_t vertexOffset = m_uploadedVertexCount * vertexStride;
+    const D3D12_GPU_VIRTUAL_ADDRESS oldIndexAddress =
+        m_indexBuffer ? m_indexBuffer->getID3D12Resource()->GetGPUVirtualAddress() : 0;
+    reserveBuffer(a_commandList, m_vertexBuffer, m_vertexAllocation, L"VertexBuffer", vertexOffset, vertexOffset + vertices.size(),
+                  vertexStride, a_frame);
+    reserveBuffer(a_commandList, m_indexBuffer, m_indexAllocation, L"IndexBuffer", m_uploadedIndexSize,
+                  m_uploadedIndexSize + indices.size(), 1, a_frame);
+
+    UploadRing::Allocation staging = m_uploadRing->allocate(vertices.size() + indices.size(), 16);
+    if (!staging.isValid()) {
+        auto buffer = std::make_unique<Buffer>();
+        buffer->initialize(m_device, nullptr, {
+            .size = vertices.size() + indices.size(),
+            .elementSize = 1,
+            .initialState = D3D12_RESOURCE_STATE_GENERIC_READ,
+            .heapType = D3D12_HEAP_TYPE_UPLOAD
+            });
+        buffer->mapData();
+        staging = { .cpu = static_cast<uint8_t*>(buffer->getMappedData()), .resource = buffer->getID3D12Resource() };
+        m_retiredBuffers.push_back({ .frame = a_frame, .buffer = std::move(buffer) });
+    }
+    std::memcpy(staging.cpu, vertices.data(), vertices.size());
+    std::memcpy(staging.cpu + vertices.size(), indices.data(), indices.size());
+    a_commandList->CopyBufferRegion(m_vertexBuffer->getID3D12Resource(), vertexOffset,
+                                    staging.resource, staging.offset, vertices.size());
+    a_commandList->CopyBufferRegion(m_indexBuffer->getID3D12Resource(), m_uploadedIndexSize,
+                                    staging.resource, staging.offset + vertices.size(), indices.size());
 
     D3D12_RESOURCE_BARRIER barriers[] = {
-    CD3DX12_RESOURCE_BARRIER::Transition(m_vertexBuffer.getID3D12Resource(),
-    D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON),
-    CD3DX12_RESOURCE_BARRIER::Transition(m_indexBuffer.getID3D12Resource(),
-    D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON)
+        CD3DX12_RESOURCE_BARRIER::Transition(m_vertexBuffer->getID3D12Resource(),
+            D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_VERTEX_AND_CONSTANT_BUFFER),
+        CD3DX12_RESOURCE_BARRIER::Transition(m_indexBuffer->getID3D12Resource(),
+            D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_INDEX_BUFFER)
     };
     a_commandList->ResourceBarrier(_countof(barriers), barriers);
 
-    uploadVertex.mapData(); // mb do when create
-    uploadIndex.mapData();
-
-    uploadVertex.uploadData(m_vertices.data());
-    uploadIndex.uploadData(m_indices.data());
-
-    a_commandList->CopyResource(m_vertexBuffer.getID3D12Resource(), uploadVertex.getID3D12Resource());
-    a_commandList->CopyResource(m_indexBuffer.getID3D12Resource(), uploadIndex.getID3D12Resource());
-
-    m_vertexBufferView = m_vertexBuffer.getVertexBufferView();
-    m_indexBufferView = m_indexBuffer.getIndexBufferView();
+    m_uploadedVertexCount = m_vertices.size();
+    m_uploadedIndexSize += indices.size();
+    m_vertexBufferView = m_vertexBuffer->getVertexBufferView();
+
+    // The views of the meshes uploaded before move with the index buffer
+    const D3D12_GPU_VIRTUAL_ADDRESS indexAddress = m_indexBuffer->getID3D12Resource()->GetGPUVirtualAddress();
+    if (oldIndexAddress != 0 && oldIndexAddress != indexAddress) {
+        for (auto& [name, drawArguments] : m_drawArguments) {
+            for (DrawLod& lod : drawArguments.lods) {
+                if (lod.indexBufferView.BufferLocation != 0) {
+                    lod.indexBufferView.BufferLocation = indexAddress + (lod.indexBufferView.BufferLocation - oldIndexAddress);
+                }
+            }
+        }
+    }
+    for (const IndexRange& range : indexRanges) {
+        range.lod->indexBufferView = m_indexBuffer->getIndexBufferView(range.format, range.offset, range.size);
+    }
+}
 }
-}
\ No newline at end of file
@@ -1,65 +1,88 @@
 #pragma once
-#include <DirectXMath.h>
 #include <utils/Macros.h>
 #include <graphics/d3d12/CommonGraphicsHeaders.h>
-#include "ResourceManager.h"
-
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
+#include <graphics/MeshStorage.h>
+#include <graphics/VertexFormat.h>
+#include <graphics/InstanceBatcher.h>
+#include "HeapAllocator.h"
+#include "UploadRing.h"
+#include "resource/BufferAndTexture.h"
 
+#include <memory>
+#include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace neural::graphics {
-class SceneManager {
+// MeshStorage with its arrays uploaded into D3D12 vertex and index buffers. Vertices are packed in the
+// VertexFormat given to initialize, meshes with up to 65536 vertices get 16-bit indices. Meshes stream in
+// as their imports finish, the buffers grow by copying on the GPU. They are placed by the heap allocator,
+// the copies come from the upload ring unless a batch of meshes is too big for it
+class SceneManager : public MeshStorage {
 public:
-    struct Vertex {
-        DirectX::XMFLOAT3 position;
-        DirectX::XMFLOAT3 normal;
-        DirectX::XMFLOAT2 textureCoordinates;
-    };
-    struct MeshInfo {
-        size_t startVertex;
-        size_t vertexCount;
-        size_t startIndex;
-        size_t indexCount;
+    struct DrawLod {
+        D3D12_INDEX_BUFFER_VIEW indexBufferView;  // only the indices of the LOD, R16_UINT or R32_UINT
+        uint32_t indexCount;
     };
-    struct MeshTransform {
-        DirectX::XMFLOAT3 rotation = { 0, 0, 0 };
-        float scale = 1.0f;
+    struct DrawArguments {
+        std::vector<DrawLod> lods;  // as in MeshInfo::lods
+        int32_t baseVertex;
+        VertexDecode vertexDecode;
     };
-    void initialize(ID3D12Device* a_device);
-    void loadMesh(const char* a_meshName, const std::vector<Vertex>& a_vertices,
-                  const std::vector<uint32_t>& a_indices,
-                  MeshTransform a_transform = {});
-    void loadMeshFromFile(const char* a_meshName, const char* a_path, MeshTransform a_transform = {});
-    void uploadMeshesOnGPU(ID3D12GraphicsCommandList* a_commandList, ResourceManager* a_pResourceManager);
 
+    void initialize(ID3D12Device* a_device, HeapAllocator* a_heapAllocator, UploadRing* a_uploadRing,
+                    VertexFormat a_vertexFormat = VertexFormat::Compact);
+    // Adds the imports finished since the last call and records the copies of every mesh that isn't on the GPU
+    // yet, before the draws of a_commandList. Call it once per command list: a_frame is the fence value it
+    // signals, the buffers it no longer needs are released once the fence reaches a_completedFrame.
+    // A mesh can be drawn after the call that makes it Ready
+    void uploadMeshesOnGPU(ID3D12GraphicsCommandList* a_commandList, uint64_t a_frame, uint64_t a_completedFrame);
+
+    // Input slot of the InstanceTransform stream, stepped once per instance
+    static constexpr uint32_t k_instanceSlot = 1;
+
+    // Matches the vertex buffer in slot 0 and the instance transforms, the shaders take any of the formats
+    std::vector<D3D12_INPUT_ELEMENT_DESC> getInputLayout() const;
+    VertexFormat getVertexFormat() const {
+        return m_vertexFormat;
+    }
     ID3D12Resource* getVertexBuffer() {
-        return m_vertexBuffer.getID3D12Resource();
+        return m_vertexBuffer->getID3D12Resource();
     }
     ID3D12Resource* getIndexBuffer() {
-        return m_indexBuffer.getID3D12Resource();
+        return m_indexBuffer->getID3D12Resource();
     }
+    // Empty until the first mesh is uploaded
     const D3D12_VERTEX_BUFFER_VIEW& getVertexBufferView() const {
         return m_vertexBufferView;
     }
-    const D3D12_INDEX_BUFFER_VIEW& getIndexBufferView() const {
-        return m_indexBufferView;
-    }
-    const MeshInfo& getMeshInfo(const char* a_meshName) {
-        return m_meshes[a_meshName];
+    const DrawArguments& getDrawArguments(const char* a_meshName) const {
+        return m_drawArguments.at(a_meshName);
     }
 private:
-    ID3D12Device* m_device;
+    struct RetiredBuffer {
+        uint64_t frame;
+        std::unique_ptr<Buffer> buffer;
+        HeapAllocator::Allocation allocation;
+    };
+    // Makes a_buffer hold at least a_size bytes, the first a_usedSize are copied into a new buffer
+    void reserveBuffer(ID3D12GraphicsCommandList* a_commandList, std::unique_ptr<Buffer>& a_buffer,
+                       HeapAllocator::Allocation& a_allocation, const wchar_t* a_name, uint64_t a_usedSize, uint64_t a_size, uint32_t a_elementSize,
+                       uint64_t a_frame);
 
-    std::unordered_map<std::string, MeshInfo> m_meshes;
-    std::vector<Vertex> m_vertices;
-    std::vector<uint32_t> m_indices;
+    ID3D12Device* m_device;
+    HeapAllocator* m_heapAllocator;
+    UploadRing* m_uploadRing;
+    VertexFormat m_vertexFormat = VertexFormat::Compact;
 
-    Buffer m_vertexBuffer;
-    Buffer m_indexBuffer;
-    D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView;
-    D3D12_INDEX_BUFFER_VIEW m_indexBufferView;
+    std::unique_ptr<Buffer> m_vertexBuffer;
+    std::unique_ptr<Buffer> m_indexBuffer;
+    HeapAllocator::Allocation m_vertexAllocation;
+    HeapAllocator::Allocation m_indexAllocation;
+    size_t m_uploadedVertexCount = 0;
+    uint64_t m_uploadedIndexSize = 0;  // bytes, a multiple of 4
+    std::vector<RetiredBuffer> m_retiredBuffers;  // oversized staging and outgrown buffers the GPU may still read
+    D3D12_VERTEX_BUFFER_VIEW m_vertexBufferView = {};
+    std::unordered_map<std::string, DrawArguments> m_drawArguments;
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,44 @@
+#include "UploadRing.h"
+#include <utils/Macros.h>
+
+#include <cstring>
+
+namespace neural::graphics {
+
+void UploadRing::initialize(ID3D12Device* a_device, uint64_t a_capacity)
+{
+    m_buffer.initialize(a_device, nullptr, {
+        .size = a_capacity,
+        .elementSize = 1,
+        .initialState = D3D12_RESOURCE_STATE_GENERIC_READ,
+        .heapType = D3D12_HEAP_TYPE_UPLOAD
+    });
+    NAME_DX_OBJECT(m_buffer.getID3D12Resource(), L"UploadRing");
+    m_buffer.mapData();
+    m_mappedData = static_cast<uint8_t*>(m_buffer.getMappedData());
+    m_gpuAddress = m_buffer.getID3D12Resource()->GetGPUVirtualAddress();
+    m_ring.initialize(a_capacity);
+}
+
+UploadRing::Allocation UploadRing::allocate(uint64_t a_size, uint64_t a_alignment)
+{
+    const uint64_t offset = m_ring.allocate(a_size, a_alignment);
+    if (offset == utils::LinearRingAllocator::k_invalidOffset) {
+        return {};
+    }
+    return {
+        .cpu = m_mappedData + offset,
+        .gpu = m_gpuAddress + offset,
+        .resource = m_buffer.getID3D12Resource(),
+        .offset = offset
+    };
+}
+
+UploadRing::Allocation UploadRing::uploadConstants(const void* a_data, uint64_t a_size)
+{
+    const Allocation allocation = allocate(a_size, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+    assert(allocation.isValid() && "upload ring is full");
+    std::memcpy(allocation.cpu, a_data, a_size);
+    return allocation;
+}
+}
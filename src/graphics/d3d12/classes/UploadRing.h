@@ -0,0 +1,46 @@
+#pragma once
+
+#include <utils/LinearRingAllocator.h>
+#include "resource/BufferAndTexture.h"
+
+#include <graphics/d3d12/CommonGraphicsHeaders.h>
+
+namespace neural::graphics {
+
+// One persistently mapped upload buffer for constants, instance data and streaming copies. Space is
+// bumped per frame and reused once the fence value the frame was finished with completes.
+// Used from the thread that records the command list only
+class UploadRing {
+public:
+    struct Allocation {
+        uint8_t* cpu = nullptr;
+        D3D12_GPU_VIRTUAL_ADDRESS gpu = 0;
+        ID3D12Resource* resource = nullptr;
+        uint64_t offset = 0;  // in resource
+        bool isValid() const {
+            return cpu != nullptr;
+        }
+    };
+
+    void initialize(ID3D12Device* a_device, uint64_t a_capacity);
+    // Invalid if the frames in flight leave no room
+    Allocation allocate(uint64_t a_size, uint64_t a_alignment);
+    // 256-byte aligned, for a root CBV
+    Allocation uploadConstants(const void* a_data, uint64_t a_size);
+    // The allocations since the last call are read by the commands that signal a_fenceValue
+    void finishFrame(uint64_t a_fenceValue) {
+        m_ring.finishFrame(a_fenceValue);
+    }
+    void retire(uint64_t a_completedFenceValue) {
+        m_ring.retire(a_completedFenceValue);
+    }
+    uint64_t getUsedSize() const {
+        return m_ring.getUsedSize();
+    }
+private:
+    Buffer m_buffer;
+    uint8_t* m_mappedData = nullptr;
+    D3D12_GPU_VIRTUAL_ADDRESS m_gpuAddress = 0;
+    utils::LinearRingAllocator m_ring;
+};
+}
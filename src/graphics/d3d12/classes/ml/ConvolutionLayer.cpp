@@ -1,8 +1,28 @@
 #include "ConvolutionLayer.h"
-#include <utils/Float16Compressor.h>
+#include <utils/Float16Conversion.h>
+
+#include <algorithm>
 
 namespace neural::graphics {
 
+namespace {
+// DML_CONVOLUTION_OPERATOR_DESC::FusedActivation takes only parameterless or scalar activations.
+// PRelu with one slope for all channels is a LeakyRelu
+bool isFusedActivation(const ml::ActivationDesc& a_activation)
+{
+    switch (a_activation.type)
+    {
+    case ml::ActivationType::Silu:
+        return false;
+    case ml::ActivationType::PRelu:
+        return std::all_of(a_activation.slopes.begin(), a_activation.slopes.end(),
+                           [&](float a_slope) { return a_slope == a_activation.slopes[0]; });
+    default:
+        return true;
+    }
+}
+}  // anonymous namespace
+
 void ConvolutionLayer::initialize(ID3D12Device* a_device,
                                     IDMLDevice* a_dmlDevice,
                                     const ConvolutionLayerCreateInfo& a_createInfo) 
@@ -62,34 +82,106 @@ void ConvolutionLayer::initialize(ID3D12Device* a_device,
     UINT endPadding[] = { paddingHeightBottom, paddingWidthRight };
     UINT outputPadding[] = { 0, 0 };
 
-    DML_ACTIVATION_RELU_OPERATOR_DESC fusedReluDesc = { 0 };
-    DML_OPERATOR_DESC activationDesc = { DML_OPERATOR_ACTIVATION_RELU, &fusedReluDesc };
-
-    DML_CONVOLUTION_OPERATOR_DESC convolutionDesc = {
-        .InputTensor = &inputTensorDesc,
-        .FilterTensor = &filterTensorDesc,
-        .BiasTensor = a_createInfo.useBiasAndActivation ? &biasTensorDesc : nullptr,
-        .OutputTensor = &outputTensorDesc,
-        .Mode = DML_CONVOLUTION_MODE_CROSS_CORRELATION,  // TODO: what is it?
-        .Direction = DML_CONVOLUTION_DIRECTION_FORWARD,
-        .DimensionCount = 2,
-        .Strides = strides,
-        .Dilations = dilations,
-        .StartPadding = startPadding,
-        .EndPadding = endPadding,
-        .OutputPadding = outputPadding,
-        .GroupCount = 1,  // TODO: what is it?
-        .FusedActivation = a_createInfo.useBiasAndActivation ? &activationDesc : nullptr
-    };
-    DML_OPERATOR_DESC operatorDesc = { DML_OPERATOR_CONVOLUTION, &convolutionDesc };
-    ComPtr<IDMLOperator> op;
-    DX_CALL(a_dmlDevice->CreateOperator(&operatorDesc, IID_PPV_ARGS(op.ReleaseAndGetAddressOf())));
-
     DML_EXECUTION_FLAGS flag = DML_EXECUTION_FLAG_NONE;
     if (a_createInfo.dataType == DML_TENSOR_DATA_TYPE_FLOAT16) { 
         flag = DML_EXECUTION_FLAG_ALLOW_HALF_PRECISION_COMPUTATION;
-    }                 
-    DX_CALL(a_dmlDevice->CompileOperator(op.Get(), flag, IID_PPV_ARGS(&m_compiledOperator)));
+    }
+
+    const ml::ActivationDesc& activation = a_createInfo.activation;
+    const std::array<uint32_t, 4> slopeSizes = { 1, filterSizes[0], 1, 1 };
+    std::array<uint32_t, 4> slopeStrides;
+    DML_BUFFER_TENSOR_DESC slopeBufferTensorDesc = getBufferTensorDesc(a_createInfo.dataType, slopeSizes, slopeStrides);
+#if DML_MANAGED_WEIGHTS
+    slopeBufferTensorDesc.Flags = DML_TENSOR_FLAG_OWNED_BY_DML;
+#endif
+
+    if (isFusedActivation(activation))
+    {
+        DML_ACTIVATION_RELU_OPERATOR_DESC fusedReluDesc = { 0 };
+        DML_ACTIVATION_LEAKY_RELU_OPERATOR_DESC fusedLeakyReluDesc = {
+            .Alpha = activation.type == ml::ActivationType::PRelu ? activation.slopes[0] : activation.alpha
+        };
+        DML_ACTIVATION_SIGMOID_OPERATOR_DESC fusedSigmoidDesc = { 0 };
+        DML_ACTIVATION_TANH_OPERATOR_DESC fusedTanhDesc = { 0 };
+
+        DML_OPERATOR_DESC activationDesc = {};
+        switch (activation.type)
+        {
+        case ml::ActivationType::Relu:
+            activationDesc = { DML_OPERATOR_ACTIVATION_RELU, &fusedReluDesc };
+            break;
+        case ml::ActivationType::LeakyRelu:
+        case ml::ActivationType::PRelu:
+            activationDesc = { DML_OPERATOR_ACTIVATION_LEAKY_RELU, &fusedLeakyReluDesc };
+            break;
+        case ml::ActivationType::Sigmoid:
+            activationDesc = { DML_OPERATOR_ACTIVATION_SIGMOID, &fusedSigmoidDesc };
+            break;
+        case ml::ActivationType::Tanh:
+            activationDesc = { DML_OPERATOR_ACTIVATION_TANH, &fusedTanhDesc };
+            break;
+        default:
+            break;
+        }
+
+        DML_CONVOLUTION_OPERATOR_DESC convolutionDesc = {
+            .InputTensor = &inputTensorDesc,
+            .FilterTensor = &filterTensorDesc,
+            .BiasTensor = a_createInfo.useBias ? &biasTensorDesc : nullptr,
+            .OutputTensor = &outputTensorDesc,
+            .Mode = DML_CONVOLUTION_MODE_CROSS_CORRELATION,  // TODO: what is it?
+            .Direction = DML_CONVOLUTION_DIRECTION_FORWARD,
+            .DimensionCount = 2,
+            .Strides = strides,
+            .Dilations = dilations,
+            .StartPadding = startPadding,
+            .EndPadding = endPadding,
+            .OutputPadding = outputPadding,
+            .GroupCount = 1,  // TODO: what is it?
+            .FusedActivation = activation.type != ml::ActivationType::None ? &activationDesc : nullptr
+        };
+        DML_OPERATOR_DESC operatorDesc = { DML_OPERATOR_CONVOLUTION, &convolutionDesc };
+        ComPtr<IDMLOperator> op;
+        DX_CALL(a_dmlDevice->CreateOperator(&operatorDesc, IID_PPV_ARGS(op.ReleaseAndGetAddressOf())));
+        DX_CALL(a_dmlDevice->CompileOperator(op.Get(), flag, IID_PPV_ARGS(&m_compiledOperator)));
+        m_slopes.clear();
+        m_inputCount = 3;
+    }
+    else
+    {
+        // SiLU and per-channel PRelu can't be fused into DML_CONVOLUTION_OPERATOR_DESC, so the epilogue is
+        // built as a DirectMLX graph. It is still compiled into one operator and the convolution output
+        // doesn't leave the operator between the two steps
+        dml::Graph graph(a_dmlDevice, m_tensorLayout == TensorLayout::NHWC ? dml::TensorPolicy::InterleavedChannel()
+                                                                            : dml::TensorPolicy::Default());
+        dml::Expression input = dml::InputTensor(graph, 0, inputBufferTensorDesc);
+        dml::Expression filter = dml::InputTensor(graph, 1, filterBufferTensorDesc);
+        dml::Optional<dml::Expression> bias = dml::NullOpt;
+        if (a_createInfo.useBias) {
+            bias = dml::InputTensor(graph, 2, biasBufferTensorDesc);
+        }
+        dml::Expression convolution = dml::ConvolutionBuilder(input, filter, bias)
+            .StartPadding(startPadding)
+            .EndPadding(endPadding)
+            .Build();
+
+        dml::Expression output;
+        if (activation.type == ml::ActivationType::Silu) {
+            output = convolution * dml::ActivationSigmoid(convolution);
+            m_inputCount = 3;
+        }
+        else {
+            assert(activation.type == ml::ActivationType::PRelu && activation.slopes.size() == filterSizes[0]);
+            // The slope is broadcast over N, H and W with zero strides
+            dml::Expression slope = dml::InputTensor(graph, 3, slopeBufferTensorDesc);
+            slope = dml::Reinterpret(slope, { outputSizes[0], outputSizes[1], outputSizes[2], outputSizes[3] },
+                                     dml::TensorStrides{ 0, 1, 0, 0 });
+            output = dml::ActivationParameterizedRelu(convolution, slope);
+            m_slopes = activation.slopes;
+            m_inputCount = 4;
+        }
+        m_compiledOperator = graph.Compile(flag, { output }, m_inputCount);
+    }
     
 
     /////////////////////////////////  Create Resources for Layer  ///////////////////////////////
@@ -101,7 +193,17 @@ void ConvolutionLayer::initialize(ID3D12Device* a_device,
         .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
     });
 
-    if (a_createInfo.useBiasAndActivation)
+    if (!m_slopes.empty())
+    {
+        m_slopeWeights = std::make_unique<Buffer>();
+        m_slopeWeights->initialize(a_device, nullptr, {
+            .size = slopeBufferTensorDesc.TotalTensorSizeInBytes,
+            .elementSize = 1,
+            .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
+        });
+    }
+
+    if (a_createInfo.useBias)
     {
         m_biasWeights = std::make_unique<Buffer>();
         m_biasWeights->initialize(a_device, nullptr, {
@@ -167,6 +269,11 @@ void ConvolutionLayer::getStrides(const std::array<uint32_t, 4>& a_sizes, Tensor
         a_strides[3] = a_sizes[1];
         break;
 
+    case TensorLayout::NCHWc8:
+    case TensorLayout::NCHWc16:
+        assert(false); // a channel-blocked tensor can't be described with 4 strides
+        break;
+
     default:
         a_strides[0] = a_sizes[1] * a_sizes[2] * a_sizes[3];
         a_strides[1] = a_sizes[2] * a_sizes[3];
@@ -177,56 +284,18 @@ void ConvolutionLayer::getStrides(const std::array<uint32_t, 4>& a_sizes, Tensor
 
 void ConvolutionLayer::uploadWeightsFloat16(DirectX::ResourceUploadBatch& a_uploadBatch, 
                                           const std::vector<float>* a_filterWeights, 
-                                          const std::vector<float>* a_scaleWeights,
-                                          const std::vector<float>* a_shiftWeights)
+                                          const std::vector<float>* a_biasWeights)
 {
-    const bool useBias = (m_biasWeights->getID3D12Resource() != nullptr);
-    assert(!useBias || (a_scaleWeights && a_shiftWeights));
+    const bool useBias = (m_biasWeights != nullptr);
+    assert(!useBias || a_biasWeights);
 
-    std::vector<uint16_t> filterWeights;
-    std::vector<uint16_t> biasWeights;
+    std::vector<float> filterWeights32 = ml::reorderWeights(a_filterWeights->data(), m_filterSizes, m_tensorLayout);
 
-    const uint32_t N = m_filterSizes[0];
-    const uint32_t C = m_filterSizes[1];
-    const uint32_t H = m_filterSizes[2];
-    const uint32_t W = m_filterSizes[3];
-    
-    // From https://github.com/microsoft/DirectML/tree/master/Samples/DirectMLSuperResolution
-    for (uint32_t n = 0; n < N; n++)
-    {
-        switch (m_tensorLayout)
-        {
-        case TensorLayout::NHWC:
-            // We need to convert the weights from NCHW to NHWC.
-            for (uint32_t h = 0; h < H; h++)
-                for (uint32_t w = 0; w < W; w++)
-                    for (uint32_t c = 0; c < C; c++)
-                    {
-                        // Apply the scale weight now so we don't need a normalization layer
-                        uint32_t idx = w + h * W + c * H*W + n * C*H*W;
-                        float scaledWeight = useBias ? (*a_filterWeights)[idx] * (*a_scaleWeights)[n] 
-                                                     : (*a_filterWeights)[idx];
-                        filterWeights.push_back(Float16Compressor::compress(scaledWeight));
-                    }
-            break;
-
-        default:
-            // Weights are already in the right order
-            for (uint32_t i = 0; i < C*H*W; i++)
-            {
-                // Apply the scale weight now so we don't need a normalization layer
-                uint32_t idx = n * C*H*W + i;
-                float scaledWeight = useBias ? (*a_filterWeights)[idx] * (*a_scaleWeights)[n] 
-                                             : (*a_filterWeights)[idx];
-                filterWeights.push_back(Float16Compressor::compress(scaledWeight));
-            }
-        }
-
-        if (useBias)
-        {
-            // Technically this is initialBias*scale+shift, but the initial bias is 0
-            biasWeights.push_back(Float16Compressor::compress((*a_shiftWeights)[n]));
-        }
+    std::vector<uint16_t> filterWeights(filterWeights32.size());
+    std::vector<uint16_t> biasWeights(useBias ? a_biasWeights->size() : 0);
+    utils::compressFloat16(filterWeights32.data(), filterWeights.data(), filterWeights.size());
+    if (useBias) {
+        utils::compressFloat16(a_biasWeights->data(), biasWeights.data(), biasWeights.size());
     }
 
     // Upload to the GPU
@@ -239,6 +308,14 @@ void ConvolutionLayer::uploadWeightsFloat16(DirectX::ResourceUploadBatch& a_uplo
         weightsData.pData = biasWeights.data();
         a_uploadBatch.Upload(m_biasWeights->getID3D12Resource(), 0, &weightsData, 1);
     }
+
+    if (m_slopeWeights)
+    {
+        std::vector<uint16_t> slopes(m_slopes.size());
+        utils::compressFloat16(m_slopes.data(), slopes.data(), slopes.size());
+        weightsData.pData = slopes.data();
+        a_uploadBatch.Upload(m_slopeWeights->getID3D12Resource(), 0, &weightsData, 1);
+    }
 }
 
 void ConvolutionLayer::createBinding(const DescriptorHeap::Handle& handle) {
@@ -262,7 +339,7 @@ void ConvolutionLayer::bindResources(const BindResourcesDesc& a_bindDesc) {
     
 #if DML_MANAGED_WEIGHTS
     // The weights are stored in the persistent resource and shouldn't be bound separately.
-    DML_BINDING_DESC inputBindings[] = { inputBinding, emptyBindingDesc, emptyBindingDesc };
+    DML_BINDING_DESC inputBindings[] = { inputBinding, emptyBindingDesc, emptyBindingDesc, emptyBindingDesc };
 #else
     // Bind the weight resources
     DML_BUFFER_BINDING filterBufferBinding = { m_filterWeights->getID3D12Resource(),
@@ -281,9 +358,17 @@ void ConvolutionLayer::bindResources(const BindResourcesDesc& a_bindDesc) {
         biasBinding = emptyBindingDesc;
     }
 
-    DML_BINDING_DESC inputBindings[] = { inputBinding, filterBinding, biasBinding };
+    DML_BUFFER_BINDING slopeBufferBinding;
+    DML_BINDING_DESC slopeBinding = emptyBindingDesc;
+    if (m_slopeWeights.get()) {
+        slopeBufferBinding = { m_slopeWeights->getID3D12Resource(),
+                               0, m_slopeWeights->getID3D12Resource()->GetDesc().Width };
+        slopeBinding = { DML_BINDING_TYPE_BUFFER, &slopeBufferBinding };
+    }
+
+    DML_BINDING_DESC inputBindings[] = { inputBinding, filterBinding, biasBinding, slopeBinding };
 #endif
-    m_bindingTable->BindInputs(3, inputBindings);
+    m_bindingTable->BindInputs(m_inputCount, inputBindings);
 
     DML_BUFFER_BINDING outputBufferBinding = { a_bindDesc.output, 0, a_bindDesc.output->GetDesc().Width };
     DML_BINDING_DESC outputBinding = { DML_BINDING_TYPE_BUFFER, &outputBufferBinding };
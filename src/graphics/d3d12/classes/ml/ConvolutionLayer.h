@@ -1,11 +1,12 @@
 #pragma once
 #include <graphics/d3d12/CommonGraphicsHeaders.h>
 #include <graphics/d3d12/classes/resource/BufferAndTexture.h>
+#include <ml/TensorLayout.h>
+#include <ml/NetworkGraph.h>
 
 #include <DirectML.h>
 #include <DirectMLX.h>
 #include <directx_tool_kit/Inc/ResourceUploadBatch.h>
-#include <directx_tool_kit/Inc/DescriptorHeap.h>
 
 #include <cstdint>
 #include <vector>
@@ -18,15 +19,14 @@ struct ConvolutionLayerCreateInfo {
     DML_TENSOR_DATA_TYPE dataType;
     std::array<uint32_t, 4> inputSizes;
     std::array<uint32_t, 4> filterSizes;
-    bool useBiasAndActivation;
+    bool useBias;
+    ml::ActivationDesc activation;
 };
 class ConvolutionLayer {
 public:
-    enum class TensorLayout
-    {
-        Default,
-        NHWC
-    };
+    // DirectML describes tensors with per-dimension strides, so only NCHW and NHWC are expressible here.
+    // The blocked layouts are used by the CPU backend
+    using TensorLayout = ml::TensorLayout;
 
     void initialize(ID3D12Device* a_device,
                     IDMLDevice* a_dmlDevice,
@@ -39,65 +39,20 @@ public:
         ID3D12Resource* output;
     };
     void bindResources(const BindResourcesDesc& a_bindDesc);
+    // Normalization is folded into the weights by ml::optimizeGraph, so they are uploaded as is
     void uploadWeightsFloat16(DirectX::ResourceUploadBatch& a_uploadBatch, 
                             const std::vector<float>* a_filterWeights, 
-                            const std::vector<float>* a_scaleWeights,
-                            const std::vector<float>* a_shiftWeights);
+                            const std::vector<float>* a_biasWeights);
 
     template<typename T>
     void uploadWeights(DirectX::ResourceUploadBatch& a_uploadBatch, 
                      const std::vector<T>* a_filterWeights, 
-                     const std::vector<T>* a_scaleWeights,
-                     const std::vector<T>* a_shiftWeights) 
+                     const std::vector<T>* a_biasWeights) 
     {
-        bool useBias = (m_biasWeights->getID3D12Resource() != nullptr);
-        assert(!useBias || (a_scaleWeights && a_shiftWeights));
-
-        std::vector<T> filterWeights;
-        std::vector<T> biasWeights;
-
-        const uint32_t N = m_filterSizes[0];
-        const uint32_t C = m_filterSizes[1];
-        const uint32_t H = m_filterSizes[2];
-        const uint32_t W = m_filterSizes[3];
-        
-        // From https://github.com/microsoft/DirectML/tree/master/Samples/DirectMLSuperResolution
-        for (uint32_t n = 0; n < N; n++)
-        {
-            switch (m_tensorLayout)
-            {
-            case TensorLayout::NHWC:
-                // We need to convert the weights from NCHW to NHWC.
-                for (uint32_t h = 0; h < H; h++)
-                    for (uint32_t w = 0; w < W; w++)
-                        for (uint32_t c = 0; c < C; c++)
-                        {
-                            // Apply the scale weight now so we don't need a normalization layer
-                            uint32_t idx = w + h * W + c * H*W + n * C*H*W;
-                            T scaledWeight = useBias ? (*a_filterWeights)[idx] * (*a_scaleWeights)[n]
-                                                     : (*a_filterWeights)[idx];
-                            filterWeights.push_back(scaledWeight);
-                        }
-                break;
-
-            default:
-                // Weights are already in the right order
-                for (uint32_t i = 0; i < C*H*W; i++)
-                {
-                    // Apply the scale weight now so we don't need a normalization layer
-                    uint32_t idx = n * C*H*W + i;
-                    T scaledWeight = useBias ? (*a_filterWeights)[idx] * (*a_scaleWeights)[n]
-                                             : (*a_filterWeights)[idx];
-                    filterWeights.push_back(scaledWeight);
-                }
-            }
-
-            if (useBias)
-            {
-                // Technically this is initialBias*scale+shift, but the initial bias is 0
-                biasWeights.push_back((*a_shiftWeights)[n]);
-            }
-        }
+        const bool useBias = (m_biasWeights != nullptr);
+        assert(!useBias || a_biasWeights);
+
+        std::vector<T> filterWeights = ml::reorderWeights(a_filterWeights->data(), m_filterSizes, m_tensorLayout);
 
         // Upload to the GPU
         D3D12_SUBRESOURCE_DATA weightsData = {};
@@ -106,9 +61,16 @@ public:
 
         if (useBias)
         {
-            weightsData.pData = biasWeights.data();
+            weightsData.pData = a_biasWeights->data();
             a_uploadBatch.Upload(m_biasWeights->getID3D12Resource(), 0, &weightsData, 1);
         }
+
+        if (m_slopeWeights)
+        {
+            std::vector<T> slopes(m_slopes.begin(), m_slopes.end());
+            weightsData.pData = slopes.data();
+            a_uploadBatch.Upload(m_slopeWeights->getID3D12Resource(), 0, &weightsData, 1);
+        }
     }
 
     uint64_t getInputTotalSize() {
@@ -126,6 +88,10 @@ public:
         return m_biasWeights.get();
     }
 
+    Buffer* getSlopeWeights() {
+        return m_slopeWeights.get();
+    }
+
     Buffer* getPersistentBuffer() {
         return m_persistentResource.get();
     }
@@ -147,9 +113,12 @@ private:
     IDMLDevice* m_dmlDevice;
     ComPtr<IDMLCompiledOperator> m_compiledOperator;
     ComPtr<IDMLBindingTable>     m_bindingTable;
-    TensorLayout m_tensorLayout = TensorLayout::Default;
+    TensorLayout m_tensorLayout = TensorLayout::NCHW;
     std::unique_ptr<Buffer> m_filterWeights = nullptr;
     std::unique_ptr<Buffer> m_biasWeights = nullptr;
+    std::unique_ptr<Buffer> m_slopeWeights = nullptr;  // per-channel PRelu slopes, input 3 of the operator
+    std::vector<float> m_slopes;
+    uint32_t m_inputCount = 3;
     std::unique_ptr<Buffer> m_persistentResource = nullptr;
     std::unique_ptr<Buffer> m_temporaryResource = nullptr;
     std::array<uint32_t, 4> m_filterSizes;
@@ -167,17 +136,8 @@ public:
 
     void createOperatorInitializer();
     uint32_t getDescriptorCount();
-    void createOperatorInitializerBinding(DirectX::DescriptorHeap* a_descriptorHeap, uint32_t a_startIndex);
-
-    void getInitializerBindings() {
-
-    }
-
-    void getInitializerBindings(std::shared_ptr<DirectX::DescriptorHeap>  a_descriptorHeap, uint32_t a_startIndex) 
-    {
-        m_descriptorHeapStartIndex = a_startIndex;
-        m_descriptorHeap = a_descriptorHeap;
-    }
+    // a_handle starts getDescriptorCount() * size() descriptors of a shader visible heap
+    void createOperatorInitializerBinding(const DescriptorHeap::Handle& a_handle);
 
     ConvolutionLayer& operator [](int idx) {
         return m_layers[idx];
@@ -204,8 +164,6 @@ private:
     std::unique_ptr<Buffer>                   m_operatorInitializerTemporaryResource;
     ComPtr<IDMLBindingTable>                  m_initBindingTable;
 
-    int32_t                                   m_descriptorHeapStartIndex = -1;
-    std::shared_ptr<DirectX::DescriptorHeap>  m_descriptorHeap;
     uint32_t                                  m_descriptorCount = 0;
 };
 }
\ No newline at end of file
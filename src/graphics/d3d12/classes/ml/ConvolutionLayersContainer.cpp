@@ -1,15 +1,14 @@
 #include "ConvolutionLayer.h"
 
 namespace neural::graphics {
-void ConvolutionLayersContainer::createOperatorInitializerBinding(DirectX::DescriptorHeap* a_descriptorHeap,
-                                                                   uint32_t a_startIndex) {
+void ConvolutionLayersContainer::createOperatorInitializerBinding(const DescriptorHeap::Handle& a_handle) {
     auto bindingProps = m_operatorInitializer->GetBindingProperties();
     assert(bindingProps.PersistentResourceSize == 0);
 
     DML_BINDING_TABLE_DESC tableDesc = {
         m_operatorInitializer.Get(),
-        a_descriptorHeap->GetCpuHandle(a_startIndex),
-        a_descriptorHeap->GetGpuHandle(a_startIndex),
+        a_handle.cpu,
+        a_handle.gpu,
         bindingProps.RequiredDescriptorCount
     };
     DX_CALL(m_dmlDevice->CreateBindingTable(&tableDesc, IID_PPV_ARGS(&m_initBindingTable)));
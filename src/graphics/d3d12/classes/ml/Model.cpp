@@ -1,66 +1,95 @@
 #include "Model.h"
+#include <ml/GraphPasses.h>
+
 #include <iostream>
 
 namespace neural::graphics {
+// The trained network before optimization. The scale/shift pair is the normalization
+// that ml::foldNormalization turns into the bias of the first convolution
+ml::NetworkGraph Model::buildGraph(uint32_t a_inputWidth, uint32_t a_inputHeight)
+{
+    ml::NetworkGraph graph;
+    uint32_t tensor = graph.addInput({1, 3, a_inputHeight, a_inputWidth});
+    tensor = graph.addConvolution(tensor, { .filterSizes = {6, 3, 2, 2} });
+    tensor = graph.addScaleShift(tensor, {});
+    tensor = graph.addActivation(tensor, { .type = ml::ActivationType::Relu });
+    tensor = graph.addConvolution(tensor, { .filterSizes = {3, 6, 2, 2} });
+    graph.setOutput(tensor);
+    return graph;
+}
+
 void Model::initialize(ID3D12Device* a_device, IDMLDevice* a_dmlDevice, DescriptorHeap* a_srvUavHeap,
                        uint32_t a_inputWidth, uint32_t a_inputHeight) {
     m_device = a_device;
     m_dmlDevice = a_dmlDevice;
+    m_srvUavHeap = a_srvUavHeap;
 
-    m_convolutionLayers.initialize(m_device, m_dmlDevice, 2);
-
-    DML_TENSOR_DATA_TYPE dataType = DML_TENSOR_DATA_TYPE_FLOAT16;
-    m_convolutionLayers[0].initialize(m_device, m_dmlDevice, {
-        .dataType = dataType,
-        .inputSizes = {1, 3, a_inputHeight, a_inputWidth},
-        .filterSizes = {6, 3, 2, 2},
-        .useBiasAndActivation = true
-    });
+    ml::NetworkGraph graph = buildGraph(a_inputWidth, a_inputHeight);
+    for (const auto& report : ml::optimizeGraph(graph)) {
+        if (report.layersRemoved > 0) {
+            std::cout << "Model: " << report.name << " removed " << report.layersRemoved << " layers, saved "
+                      << report.flopsSaved << " FLOPs and " << report.bytesSaved << " bytes of memory traffic\n";
+        }
+    }
 
-    m_convolutionLayers[1].initialize(m_device, m_dmlDevice, {
-        .dataType = dataType,
-        .inputSizes = {1, 6, a_inputHeight, a_inputWidth},
-        .filterSizes = {3, 6, 2, 2},
-        .useBiasAndActivation = false
-    });
+    // DirectML gets one convolution operator per layer, everything else has to be fused by now
+    const auto& layers = graph.getLayers();
+    m_convolutionLayers.initialize(m_device, m_dmlDevice, static_cast<uint32_t>(layers.size()));
 
+    DML_TENSOR_DATA_TYPE dataType = DML_TENSOR_DATA_TYPE_FLOAT16;
+    for (size_t i = 0; i < layers.size(); ++i) {
+        assert(layers[i].type == ml::LayerType::Convolution);
+        assert(!layers[i].convolution.fuseAdd);
+        assert(i == 0 || layers[i].inputs[0] == layers[i - 1].output);
+        m_convolutionLayers[i].initialize(m_device, m_dmlDevice, {
+            .dataType = dataType,
+            .inputSizes = graph.getTensor(layers[i].inputs[0]).sizes,
+            .filterSizes = layers[i].convolution.filterSizes,
+            .useBias = !layers[i].convolution.biasWeights.empty(),
+            .activation = layers[i].convolution.activation
+        });
+    }
 
+    const size_t lastLayer = m_convolutionLayers.size() - 1;
     m_input.initialize(a_device, nullptr, {
         .size = m_convolutionLayers[0].getInputTotalSize(),
         .elementSize = 1,
         .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
     });
     m_output.initialize(a_device, nullptr, {
-        .size = m_convolutionLayers[1].getOutputTotalSize(),
-        .elementSize = 1,
-        .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
-    });
-    m_intermediate.initialize(a_device, nullptr, {
-        .size = m_convolutionLayers[0].getOutputTotalSize(),
+        .size = m_convolutionLayers[lastLayer].getOutputTotalSize(),
         .elementSize = 1,
         .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
     });
+    m_intermediates.clear();
+    for (size_t i = 0; i < lastLayer; ++i) {
+        m_intermediates.push_back(std::make_unique<Buffer>());
+        m_intermediates.back()->initialize(a_device, nullptr, {
+            .size = m_convolutionLayers[i].getOutputTotalSize(),
+            .elementSize = 1,
+            .usageFlags = D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS
+        });
+    }
 }
 
 void Model::setInitializationBindings() {
     m_convolutionLayers.createOperatorInitializer();
-    m_descriptorHeap = std::make_unique<DirectX::DescriptorHeap>(m_device,
-                        D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV,
-                        D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE,
-                        m_convolutionLayers.getDescriptorCount() * m_convolutionLayers.size());
-    m_convolutionLayers.createOperatorInitializerBinding(m_descriptorHeap.get(), 0);
+    m_descriptors = m_srvUavHeap->allocateRange(
+        m_convolutionLayers.getDescriptorCount() * static_cast<uint32_t>(m_convolutionLayers.size()));
+    m_convolutionLayers.createOperatorInitializerBinding(m_descriptors.start);
 }
 
 void Model::setExecutionBindings() {
     for (int i = 0; i < m_convolutionLayers.size(); ++i) {
-        m_convolutionLayers[i].createBinding({
-            .cpu = m_descriptorHeap->GetCpuHandle(i * m_convolutionLayers.getDescriptorCount()),
-            .gpu = m_descriptorHeap->GetGpuHandle(i * m_convolutionLayers.getDescriptorCount())});
+        m_convolutionLayers[i].createBinding(
+            m_srvUavHeap->getHandle(m_descriptors, i * m_convolutionLayers.getDescriptorCount()));
+    }
+    const size_t lastLayer = m_convolutionLayers.size() - 1;
+    for (size_t i = 0; i < m_convolutionLayers.size(); ++i) {
+        m_convolutionLayers[i].bindResources({
+            .input = (i == 0) ? m_input.getID3D12Resource() : m_intermediates[i - 1]->getID3D12Resource(),
+            .output = (i == lastLayer) ? m_output.getID3D12Resource() : m_intermediates[i]->getID3D12Resource()});
     }
-    m_convolutionLayers[0].bindResources({.input = m_input.getID3D12Resource(),
-                                          .output = m_intermediate.getID3D12Resource()});
-    m_convolutionLayers[1].bindResources({.input = m_intermediate.getID3D12Resource(),
-                                          .output = m_output.getID3D12Resource()});
 }
     
 void Model::dispatchInitialization(IDMLCommandRecorder* a_dmlCommandRecorder, 
@@ -70,12 +99,10 @@ void Model::dispatchInitialization(IDMLCommandRecorder* a_dmlCommandRecorder,
                                          m_convolutionLayers.getInitializerBinding());
 }
 
-void Model::dispatch(IDMLCommandRecorder* a_dmlCommandRecorder, 
-                                   ID3D12GraphicsCommandList* a_commandList)
+void Model::dispatchLayer(IDMLCommandRecorder* a_dmlCommandRecorder, ID3D12GraphicsCommandList* a_commandList,
+                          uint32_t a_layer)
 {
-    a_dmlCommandRecorder->RecordDispatch(a_commandList, m_convolutionLayers[0].getCompiledOperator(),
-                                         m_convolutionLayers[0].getBinding());
-    a_dmlCommandRecorder->RecordDispatch(a_commandList, m_convolutionLayers[1].getCompiledOperator(),
-                                         m_convolutionLayers[1].getBinding());
+    a_dmlCommandRecorder->RecordDispatch(a_commandList, m_convolutionLayers[a_layer].getCompiledOperator(),
+                                         m_convolutionLayers[a_layer].getBinding());
 }
 }
\ No newline at end of file
@@ -4,14 +4,15 @@
 #include <graphics/d3d12/CommonGraphicsHeaders.h>
 #include <graphics/d3d12/classes/resource/BufferAndTexture.h>
 #include <graphics/d3d12/classes/DescriptorHeap.h>
+#include <ml/NetworkGraph.h>
 
 #include <DirectML.h>
 #include <DirectMLX.h>
 #include <directx_tool_kit/Inc/ResourceUploadBatch.h>
-#include <directx_tool_kit/Inc/DescriptorHeap.h>
 
 #include <array>
 #include <memory>
+#include <vector>
 
 namespace neural::graphics {
 class Model {
@@ -24,7 +25,18 @@ public:
     void setExecutionBindings();
 
     void dispatchInitialization(IDMLCommandRecorder* a_dmlCommandRecorder, ID3D12GraphicsCommandList* a_commandList);
-    void dispatch(IDMLCommandRecorder* a_dmlCommandRecorder, ID3D12GraphicsCommandList* a_commandList);
+    // Layer by layer, so the render graph puts the barriers between the layers
+    void dispatchLayer(IDMLCommandRecorder* a_dmlCommandRecorder, ID3D12GraphicsCommandList* a_commandList,
+                       uint32_t a_layer);
+    uint32_t getLayerCount() {
+        return static_cast<uint32_t>(m_convolutionLayers.size());
+    }
+    Buffer& getLayerInput(uint32_t a_layer) {
+        return a_layer == 0 ? m_input : *m_intermediates[a_layer - 1];
+    }
+    Buffer& getLayerOutput(uint32_t a_layer) {
+        return a_layer + 1 == getLayerCount() ? m_output : *m_intermediates[a_layer];
+    }
 
     Buffer& getInputBuffer() {
         return m_input;
@@ -32,16 +44,16 @@ public:
     Buffer& getOutputBuffer() {
         return m_output;
     }
-    ID3D12DescriptorHeap* getID3D12DescriptorHeap() {
-        return m_descriptorHeap->Heap();
-    }
 private:
+    static ml::NetworkGraph buildGraph(uint32_t a_inputWidth, uint32_t a_inputHeight);
+
     ID3D12Device* m_device;
     IDMLDevice*   m_dmlDevice;
     ConvolutionLayersContainer m_convolutionLayers;
-    std::unique_ptr<DirectX::DescriptorHeap> m_descriptorHeap;
+    DescriptorHeap* m_srvUavHeap;
+    DescriptorHeap::Range m_descriptors;  // the binding tables of the initializer, then of every layer
     Buffer m_input;
     Buffer m_output;
-    Buffer m_intermediate;
+    std::vector<std::unique_ptr<Buffer>> m_intermediates;  // output of every layer except the last
 };
 }
\ No newline at end of file
@@ -43,8 +43,7 @@ void Buffer::initialize(ID3D12Device* a_device, DescriptorHeap* a_srvUavHeap, co
     m_elementSize = a_createInfo.elementSize;
     m_srvUavHeap = a_srvUavHeap;
     
-    auto desc = CD3DX12_RESOURCE_DESC::Buffer(a_createInfo.size * a_createInfo.elementSize,
-        a_createInfo.usageFlags);
+    const D3D12_RESOURCE_DESC desc = getResourceDesc(a_createInfo);
     createResource(a_device, &m_resource, {
         .resourceDesc = &desc,
         .initialState = a_createInfo.initialState,
@@ -53,6 +52,10 @@ void Buffer::initialize(ID3D12Device* a_device, DescriptorHeap* a_srvUavHeap, co
         .heapType = a_createInfo.heapType,
         });
 }
+D3D12_RESOURCE_DESC Buffer::getResourceDesc(const BufferCreateInfo& a_createInfo)
+{
+    return CD3DX12_RESOURCE_DESC::Buffer(a_createInfo.size * a_createInfo.elementSize, a_createInfo.usageFlags);
+}
 DescriptorHeap::Handle& Buffer::getShaderResourceView() {
     ViewParams viewParams = { SHADER_RESOURCE_VIEW };
     auto it = m_views.find(viewParams);
@@ -87,11 +90,19 @@ D3D12_VERTEX_BUFFER_VIEW Buffer::getVertexBufferView() const {
     return vertexInputBufferView;
 }
 D3D12_INDEX_BUFFER_VIEW Buffer::getIndexBufferView() const {
-    assert(sizeof(uint32_t) == m_elementSize);
+    assert(m_elementSize == sizeof(uint16_t) || m_elementSize == sizeof(uint32_t));
+    return getIndexBufferView(m_elementSize == sizeof(uint16_t) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT,
+                              0, m_size * m_elementSize);
+}
+D3D12_INDEX_BUFFER_VIEW Buffer::getIndexBufferView(DXGI_FORMAT a_format, uint32_t a_byteOffset,
+                                                   uint32_t a_byteSize) const {
+    assert(a_format == DXGI_FORMAT_R16_UINT || a_format == DXGI_FORMAT_R32_UINT);
+    assert(a_byteOffset % 4 == 0);
+    assert(a_byteOffset + a_byteSize <= m_size * m_elementSize);
     D3D12_INDEX_BUFFER_VIEW indexBufferView;
-    indexBufferView.BufferLocation = m_resource.Get()->GetGPUVirtualAddress();
-    indexBufferView.SizeInBytes = m_size * sizeof(uint32_t);
-    indexBufferView.Format = DXGI_FORMAT_R32_UINT;
+    indexBufferView.BufferLocation = m_resource.Get()->GetGPUVirtualAddress() + a_byteOffset;
+    indexBufferView.SizeInBytes = a_byteSize;
+    indexBufferView.Format = a_format;
     return indexBufferView;
 }
 #pragma endregion
@@ -124,18 +135,7 @@ void Texture::initialize(ID3D12Device* a_device, const TextureCreateInfo& a_crea
     m_format = a_createInfo.format;
     m_dimension = static_cast<D3D12_RESOURCE_DIMENSION>(a_createInfo.dimension);
 
-    D3D12_RESOURCE_DESC desc = {
-                .Dimension = static_cast<D3D12_RESOURCE_DIMENSION>(a_createInfo.dimension),
-                .Alignment = a_createInfo.alignment,
-                .Width = a_createInfo.width,
-                .Height = a_createInfo.height,
-                .DepthOrArraySize = a_createInfo.depthOrArraySize,
-                .MipLevels = a_createInfo.mipLevels,
-                .Format = a_createInfo.format,
-                .SampleDesc = a_createInfo.multisampleDesc,
-                .Layout = a_createInfo.textureLayout,
-                .Flags = a_createInfo.usageFlags
-    };
+    const D3D12_RESOURCE_DESC desc = getResourceDesc(a_createInfo);
     createResource(m_device, &m_resource, {
         .resourceDesc = &desc,
         .initialState = a_createInfo.initialState,
@@ -144,6 +144,21 @@ void Texture::initialize(ID3D12Device* a_device, const TextureCreateInfo& a_crea
         .heapType = a_createInfo.heapType,
         });
 }
+D3D12_RESOURCE_DESC Texture::getResourceDesc(const TextureCreateInfo& a_createInfo)
+{
+    return {
+        .Dimension = static_cast<D3D12_RESOURCE_DIMENSION>(a_createInfo.dimension),
+        .Alignment = a_createInfo.alignment,
+        .Width = a_createInfo.width,
+        .Height = a_createInfo.height,
+        .DepthOrArraySize = a_createInfo.depthOrArraySize,
+        .MipLevels = a_createInfo.mipLevels,
+        .Format = a_createInfo.format,
+        .SampleDesc = a_createInfo.multisampleDesc,
+        .Layout = a_createInfo.textureLayout,
+        .Flags = a_createInfo.usageFlags
+    };
+}
 DescriptorHeap::Handle Texture::getRTV() {
     assert(m_device);
     assert(m_rtvHeap);
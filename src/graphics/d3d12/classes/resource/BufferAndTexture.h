@@ -63,6 +63,7 @@ public:
     //}
     public:
     void initialize(ID3D12Device* a_device, DescriptorHeap* a_srvUavHeap, const BufferCreateInfo& a_createInfo);
+    static D3D12_RESOURCE_DESC getResourceDesc(const BufferCreateInfo& a_createInfo);
     void setSrvUavHeap(DescriptorHeap* a_srvUavHeap) {
         m_srvUavHeap = a_srvUavHeap;
     }
@@ -109,7 +110,10 @@ public:
     static uint32_t CalcConstantBufferByteSize(uint32_t a_byteSize) {
         return (a_byteSize + 255) & ~255;
     }
+    // The whole buffer, 2- or 4-byte elements are R16_UINT or R32_UINT
     D3D12_INDEX_BUFFER_VIEW getIndexBufferView() const;
+    // A range of the buffer, a_byteOffset is 4-byte aligned
+    D3D12_INDEX_BUFFER_VIEW getIndexBufferView(DXGI_FORMAT a_format, uint32_t a_byteOffset, uint32_t a_byteSize) const;
     ~Buffer() {
         if (m_resource != nullptr) {
             m_resource->Unmap(0, nullptr);
@@ -160,6 +164,7 @@ class Texture {
 public:
     void initialize(ID3D12Device* a_device, const TextureCreateInfo& a_createInfo,
      DescriptorHeap* a_rtvHeap, DescriptorHeap* a_dsvHeap, DescriptorHeap* a_srvUavHeap);
+    static D3D12_RESOURCE_DESC getResourceDesc(const TextureCreateInfo& a_createInfo);
     ID3D12Resource* getID3D12Resource() const {
         assert(m_resource);
         return m_resource.Get();
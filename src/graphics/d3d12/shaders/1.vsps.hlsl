@@ -1,11 +1,15 @@
+#include "GBufferEncoding.hlsli"
+
+// DX12RenderEngine::DrawConstants. Vertices are in one of the formats of src/graphics/VertexFormat.h
 cbuffer rootConstant : register(b0)
 {
-    int objectId;
+    int octahedralNormals;
+    float3 positionOffset;
+    float3 positionScale;
 };
 
 cbuffer cbPerObject : register(b1)
 {
-    float4x4 WorldMatrix;
     float4x4 ViewProjMatrix;
     float3 LightPosition;
 };
@@ -13,21 +17,25 @@ struct Surface
 {
     float3 posW : POSITION;
     float3 normalW : NORMAL;
-    float2 texCoord : TEXCOORD;
 };
-void VS(float3 iPos : POSITION,
+// The world matrix of the instance is InstanceTransform of src/graphics/InstanceBatcher.h, its first three columns
+void VS(float3 iPosition : POSITION,
         float3 iNormal : NORMAL,
-        float2 iTexCoord : TEXCOORD,
+        float4 iWorld0 : WORLD0,
+        float4 iWorld1 : WORLD1,
+        float4 iWorld2 : WORLD2,
         out float4 oPos : SV_POSITION,
         out Surface oSurface)
 {
-    
-    float3 posW = objectId == 0 ? mul(float4(iPos, 1), WorldMatrix).xyz : iPos;
-    float3 normalW = objectId == 0 ? mul(float4(iNormal, 0), WorldMatrix).xyz : iNormal;
+    float3 iPos = positionOffset + iPosition * positionScale;
+    if (octahedralNormals) {
+        iNormal = decodeOctahedral(iNormal.xy);
+    }
+    float3 posW = float3(dot(float4(iPos, 1), iWorld0), dot(float4(iPos, 1), iWorld1), dot(float4(iPos, 1), iWorld2));
+    float3 normalW = float3(dot(iNormal, iWorld0.xyz), dot(iNormal, iWorld1.xyz), dot(iNormal, iWorld2.xyz));
     
     oSurface.posW = posW;
     oSurface.normalW = normalW;
-    oSurface.texCoord = iTexCoord;
     
     oPos = mul(float4(posW, 1), ViewProjMatrix);
     //oPos.w = -oPos.w;
@@ -38,8 +46,8 @@ struct PS_OUTPUT
 {
     float4 Screen: SV_Target0;
     float4 Color: SV_Target1;
-    float4 Normal: SV_Target2;
-    float4 ToCamera: SV_Target3;
+    float2 Normal: SV_Target2;
+    float2 ToCamera: SV_Target3;
 };
 
 PS_OUTPUT PS(float4 oPos : SV_POSITION, Surface oSurface)
@@ -51,8 +59,8 @@ PS_OUTPUT PS(float4 oPos : SV_POSITION, Surface oSurface)
     PS_OUTPUT output;
     output.Screen = float4(color * (max(dot(lightDir, normal), 0)) + 0.2f, 1);
     output.Color = float4(color * (max(dot(lightDir, normal), 0)) + 0.2f, 1);
-    output.Normal = float4(normal, 1);
-    output.ToCamera = float4(lightDir, 1);
+    output.Normal = encodeOctahedral(normal);
+    output.ToCamera = encodeOctahedral(lightDir);
 
     return output;
     // return float4(lightDir, 1);
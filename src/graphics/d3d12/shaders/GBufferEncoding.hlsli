@@ -0,0 +1,19 @@
+// Same encodings as src/utils/GBufferEncoding.h, unit vectors go to R16G16_UNORM targets
+// as octahedral coordinates in [0, 1]
+
+float2 encodeOctahedral(float3 n)
+{
+    n /= abs(n.x) + abs(n.y) + abs(n.z);
+    float2 folded = (1.0f - abs(n.yx)) * (n.xy >= 0.0f ? 1.0f : -1.0f);
+    float2 oct = n.z >= 0.0f ? n.xy : folded;
+    return oct * 0.5f + 0.5f;
+}
+
+float3 decodeOctahedral(float2 uv)
+{
+    float3 n = float3(uv * 2.0f - 1.0f, 0.0f);
+    n.z = 1.0f - abs(n.x) - abs(n.y);
+    float fold = max(-n.z, 0.0f);
+    n.xy += n.xy >= 0.0f ? -fold : fold;
+    return normalize(n);
+}
@@ -1,25 +1,64 @@
-from distutils import extension
+import argparse
+import hashlib
 import os
 import subprocess
-import pathlib
 
+# The pipeline cache is keyed by the bytecode, recompiled shaders get new pipelines without clearing it.
+# Next to every output is a stamp, the hash of what went into it: the source, every .hlsli and the command.
+# An output is up to date if its stamp matches, so checkouts, branch switches and copied trees that only
+# change modification times don't recompile, and edits are never missed because of an older mtime
 if __name__ == '__main__':
-    fxc_cmd = "C:\\Program Files (x86)\\Windows Kits\\10\\bin\\10.0.22621.0\\x86\\fxc.exe"
+    shader_dir = os.path.dirname(os.path.abspath(__file__))
+    parser = argparse.ArgumentParser()
+    parser.add_argument("--debug", action="store_true", help="without optimizations and with debug info")
+    parser.add_argument("--force", action="store_true", help="compile the shaders that are up to date too")
+    # The build passes its own shaders directory, compiled/ is for runs by hand and is not tracked
+    parser.add_argument("--output-dir", default=os.path.join(shader_dir, "compiled"),
+                        help="where the .cso files and their stamps go")
+    args = parser.parse_args()
+
+    fxc_cmd = os.environ.get("FXC", "C:\\Program Files (x86)\\Windows Kits\\10\\bin\\10.0.22621.0\\x86\\fxc.exe")
     version_vs = "vs_5_0"
     version_ps = "ps_5_0"
-    
+    flags = ["/Od", "/Zi"] if args.debug else ["/O3"]
+
+    output_dir = os.path.abspath(args.output_dir)
+    os.makedirs(output_dir, exist_ok=True)
     shader_list = ["1.vsps.hlsl", "basic.vsps.hlsl"]
-    
+
+    def read(name):
+        with open(os.path.join(shader_dir, name), "rb") as file:
+            return file.read()
+
+    # Every shader includes them
+    include_hash = hashlib.sha256()
+    for name in sorted(name for name in os.listdir(shader_dir) if name.endswith(".hlsli")):
+        include_hash.update(name.encode() + b"\0" + read(name) + b"\0")
+
+    def compile_stage(shader, version, entry, output):
+        source = os.path.join(shader_dir, shader)
+        output = os.path.join(output_dir, output)
+        stamp_path = output + ".stamp"
+        stamp = hashlib.sha256(read(shader) + b"\0" + include_hash.digest() +
+                               " ".join([fxc_cmd, *flags, version, entry]).encode()).hexdigest()
+        if not args.force and os.path.exists(output) and os.path.exists(stamp_path):
+            with open(stamp_path) as file:
+                if file.read().strip() == stamp:
+                    return
+        subprocess.run([fxc_cmd, source, *flags, "/T", version, "/E", entry, "/Fo", output], check=True)
+        with open(stamp_path, "w") as file:
+            file.write(stamp + "\n")
+
     for shader in shader_list:
         words = shader.split('.')
         name = words[0]
         extension = words[1]
-        if extension == "vs": 
-            subprocess.run([fxc_cmd, shader, "/Od", "/Zi", "/T", version_vs, "/E", "VS", "/Fo", "compiled\{}vs.cso".format(name)])
+        if extension == "vs":
+            compile_stage(shader, version_vs, "VS", "{}.vs.cso".format(name))
         elif extension == "ps":
-            subprocess.run([fxc_cmd, shader, "/Od", "/Zi", "/T", version_ps, "/E", "PS", "/Fo", "compiled\{}.ps.cso".format(name)])
+            compile_stage(shader, version_ps, "PS", "{}.ps.cso".format(name))
         elif extension == "vsps":
-            subprocess.run([fxc_cmd, shader, "/Od", "/Zi", "/T", version_vs, "/E", "VS", "/Fo", "compiled\{}.vs.cso".format(name)])
-            subprocess.run([fxc_cmd, shader, "/Od", "/Zi", "/T", version_ps, "/E", "PS", "/Fo", "compiled\{}.ps.cso".format(name)])
+            compile_stage(shader, version_vs, "VS", "{}.vs.cso".format(name))
+            compile_stage(shader, version_ps, "PS", "{}.ps.cso".format(name))
         else:
-            print("Wrong extension:", extension, "-----", shader)
\ No newline at end of file
+            print("Wrong extension:", extension, "-----", shader)
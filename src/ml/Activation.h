@@ -0,0 +1,23 @@
+#pragma once
+
+#include <vector>
+
+namespace neural::ml {
+
+enum class ActivationType
+{
+    None,
+    Relu,
+    LeakyRelu,
+    PRelu,
+    Sigmoid,
+    Tanh,
+    Silu
+};
+
+struct ActivationDesc {
+    ActivationType type = ActivationType::None;
+    float alpha = 0.01f;        // LeakyRelu negative slope
+    std::vector<float> slopes;  // PRelu negative slope, one per channel
+};
+}  // namespace neural::ml
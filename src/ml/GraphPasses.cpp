@@ -0,0 +1,300 @@
+#include "GraphPasses.h"
+
+#include <cmath>
+
+namespace neural::ml {
+
+namespace {
+uint64_t getElementCount(const NetworkGraph& a_graph, uint32_t a_tensor) {
+    const auto& sizes = a_graph.getTensor(a_tensor).sizes;
+    return static_cast<uint64_t>(sizes[0]) * sizes[1] * sizes[2] * sizes[3];
+}
+
+// Epilogue work can still be added to a convolution only if nothing was fused into it yet
+bool isPlainConvolution(const Layer& a_layer) {
+    return a_layer.type == LayerType::Convolution &&
+           a_layer.convolution.activation.type == ActivationType::None &&
+           !a_layer.convolution.fuseAdd;
+}
+
+// Returns the index of the convolution producing a_tensor if the tensor is used only once
+int32_t findFusableProducer(const NetworkGraph& a_graph, uint32_t a_tensor) {
+    const int32_t producer = a_graph.findProducer(a_tensor);
+    if (producer < 0 || a_graph.getConsumerCount(a_tensor) != 1 || a_tensor == a_graph.getOutput()) {
+        return -1;
+    }
+    return isPlainConvolution(a_graph.getLayers()[producer]) ? producer : -1;
+}
+
+void addSavings(PassReport& a_report, const NetworkGraph& a_graph, const Layer& a_layer) {
+    ++a_report.layersRemoved;
+    a_report.flopsSaved += getLayerFlops(a_graph, a_layer);
+    a_report.bytesSaved += getLayerMemoryTraffic(a_graph, a_layer);
+}
+
+// Removes a layer and forwards its output to a_replacement
+void bypassLayer(NetworkGraph& a_graph, size_t a_layerIndex, uint32_t a_replacement) {
+    const uint32_t output = a_graph.getLayers()[a_layerIndex].output;
+    a_graph.removeLayer(a_layerIndex);
+    a_graph.replaceTensorUses(output, a_replacement);
+}
+
+// output = conv * scale + shift, applied per output channel
+void applyScaleShift(ConvolutionDesc& a_convolution, const std::vector<float>& a_scale, const std::vector<float>& a_shift) {
+    const uint32_t O = a_convolution.filterSizes[0];
+    if (a_convolution.biasWeights.empty()) {
+        a_convolution.biasWeights.assign(O, 0.0f);
+    }
+    if (!a_scale.empty()) {
+        const uint64_t filterSize = static_cast<uint64_t>(a_convolution.filterSizes[1]) *
+                                    a_convolution.filterSizes[2] * a_convolution.filterSizes[3];
+        for (uint32_t o = 0; o < O; ++o) {
+            if (!a_convolution.filterWeights.empty()) {
+                for (uint64_t i = 0; i < filterSize; ++i) {
+                    a_convolution.filterWeights[o * filterSize + i] *= a_scale[o];
+                }
+            }
+            a_convolution.biasWeights[o] *= a_scale[o];
+        }
+    }
+    if (!a_shift.empty()) {
+        for (uint32_t o = 0; o < O; ++o) {
+            a_convolution.biasWeights[o] += a_shift[o];
+        }
+    }
+}
+}  // anonymous namespace
+
+uint64_t getLayerFlops(const NetworkGraph& a_graph, const Layer& a_layer)
+{
+    const uint64_t outputElements = getElementCount(a_graph, a_layer.output);
+    switch (a_layer.type)
+    {
+    case LayerType::Convolution:
+    {
+        const auto& f = a_layer.convolution.filterSizes;
+        return 2 * outputElements * f[1] * f[2] * f[3];
+    }
+    case LayerType::BatchNormalization:
+    case LayerType::ScaleShift:
+        return 2 * outputElements;
+    case LayerType::Activation:
+    case LayerType::Add:
+        return outputElements;
+    default:
+        return 0;
+    }
+}
+
+uint64_t getLayerMemoryTraffic(const NetworkGraph& a_graph, const Layer& a_layer)
+{
+    uint64_t elements = getElementCount(a_graph, a_layer.output);
+    for (auto input : a_layer.inputs) {
+        elements += getElementCount(a_graph, input);
+    }
+    if (a_layer.type == LayerType::Convolution) {
+        const auto& f = a_layer.convolution.filterSizes;
+        elements += static_cast<uint64_t>(f[0]) * f[1] * f[2] * f[3] + a_layer.convolution.biasWeights.size();
+    }
+    return elements * sizeof(float);
+}
+
+PassReport foldNormalization(NetworkGraph& a_graph)
+{
+    PassReport report = { .name = "fold normalization" };
+    for (size_t i = 0; i < a_graph.getLayers().size(); ++i) {
+        const Layer& layer = a_graph.getLayers()[i];
+        if (layer.type != LayerType::BatchNormalization && layer.type != LayerType::ScaleShift) {
+            continue;
+        }
+        const int32_t producer = findFusableProducer(a_graph, layer.inputs[0]);
+        if (producer < 0) {
+            continue;
+        }
+
+        std::vector<float> scale = layer.scaleShift.scale;
+        std::vector<float> shift = layer.scaleShift.shift;
+        if (layer.type == LayerType::BatchNormalization) {
+            // y = (x - mean) / sqrt(variance + eps) * gamma + beta
+            const auto& bn = layer.batchNormalization;
+            scale.resize(bn.mean.size());
+            shift.resize(bn.mean.size());
+            for (size_t c = 0; c < bn.mean.size(); ++c) {
+                scale[c] = bn.scale[c] / std::sqrt(bn.variance[c] + bn.epsilon);
+                shift[c] = bn.bias[c] - bn.mean[c] * scale[c];
+            }
+        }
+
+        addSavings(report, a_graph, layer);
+        applyScaleShift(a_graph.getLayer(producer).convolution, scale, shift);
+        bypassLayer(a_graph, i, a_graph.getLayers()[producer].output);
+        --i;
+    }
+    return report;
+}
+
+PassReport fuseActivations(NetworkGraph& a_graph)
+{
+    PassReport report = { .name = "fuse activations" };
+    for (size_t i = 0; i < a_graph.getLayers().size(); ++i) {
+        const Layer& layer = a_graph.getLayers()[i];
+        if (layer.type != LayerType::Activation) {
+            continue;
+        }
+        // an already fused residual add is fine here, the epilogue applies the activation last
+        const int32_t producer = a_graph.findProducer(layer.inputs[0]);
+        if (producer < 0 || a_graph.getConsumerCount(layer.inputs[0]) != 1 || layer.inputs[0] == a_graph.getOutput()) {
+            continue;
+        }
+        Layer& convolution = a_graph.getLayer(producer);
+        if (convolution.type != LayerType::Convolution ||
+            convolution.convolution.activation.type != ActivationType::None) {
+            continue;
+        }
+
+        addSavings(report, a_graph, layer);
+        convolution.convolution.activation = layer.activation;
+        bypassLayer(a_graph, i, convolution.output);
+        --i;
+    }
+    return report;
+}
+
+PassReport fuseElementwiseAdds(NetworkGraph& a_graph)
+{
+    PassReport report = { .name = "fuse elementwise adds" };
+    for (size_t i = 0; i < a_graph.getLayers().size(); ++i) {
+        const Layer& layer = a_graph.getLayers()[i];
+        if (layer.type != LayerType::Add) {
+            continue;
+        }
+        for (uint32_t side = 0; side < 2; ++side) {
+            const uint32_t convolutionOutput = layer.inputs[side];
+            const uint32_t residual = layer.inputs[1 - side];
+            const int32_t producer = findFusableProducer(a_graph, convolutionOutput);
+            // the residual has to be computed before the convolution runs
+            const int32_t residualProducer = a_graph.findProducer(residual);
+            if (producer < 0 || residualProducer > producer) {
+                continue;
+            }
+
+            addSavings(report, a_graph, layer);
+            Layer& convolution = a_graph.getLayer(producer);
+            convolution.convolution.fuseAdd = true;
+            convolution.inputs.push_back(residual);
+            bypassLayer(a_graph, i, convolutionOutput);
+            --i;
+            break;
+        }
+    }
+    return report;
+}
+
+PassReport mergePointwiseConvolutions(NetworkGraph& a_graph)
+{
+    PassReport report = { .name = "merge pointwise convolutions" };
+    for (size_t i = 0; i < a_graph.getLayers().size(); ++i) {
+        const Layer& second = a_graph.getLayers()[i];
+        if (second.type != LayerType::Convolution || second.convolution.fuseAdd ||
+            second.convolution.filterSizes[2] != 1 || second.convolution.filterSizes[3] != 1) {
+            continue;
+        }
+        const int32_t producer = findFusableProducer(a_graph, second.inputs[0]);
+        if (producer < 0) {
+            continue;
+        }
+        const Layer& first = a_graph.getLayers()[producer];
+        // W2 * W1 can't be formed when only one side is loaded, the merged layer would lose the other
+        if (first.convolution.filterWeights.empty() != second.convolution.filterWeights.empty()) {
+            continue;
+        }
+        const auto& f1 = first.convolution.filterSizes;
+        const uint32_t O2 = second.convolution.filterSizes[0];
+        const uint32_t O1 = f1[0];
+        const uint64_t filterSize = static_cast<uint64_t>(f1[1]) * f1[2] * f1[3];
+
+        ConvolutionDesc merged = {
+            .filterSizes = { O2, f1[1], f1[2], f1[3] },
+            .activation = second.convolution.activation
+        };
+        // pointwise after any kernel: W[o2] = sum W2[o2][o1] * W1[o1], b = W2 * b1 + b2
+        const bool hasWeights = !first.convolution.filterWeights.empty();
+        if (hasWeights) {
+            merged.filterWeights.assign(O2 * filterSize, 0.0f);
+            for (uint32_t o2 = 0; o2 < O2; ++o2)
+                for (uint32_t o1 = 0; o1 < O1; ++o1)
+                {
+                    const float w2 = second.convolution.filterWeights[o2 * O1 + o1];
+                    for (uint64_t k = 0; k < filterSize; ++k) {
+                        merged.filterWeights[o2 * filterSize + k] += w2 * first.convolution.filterWeights[o1 * filterSize + k];
+                    }
+                }
+        }
+        if (!first.convolution.biasWeights.empty() || !second.convolution.biasWeights.empty()) {
+            merged.biasWeights = second.convolution.biasWeights;
+            merged.biasWeights.resize(O2, 0.0f);
+            if (hasWeights && !first.convolution.biasWeights.empty()) {
+                for (uint32_t o2 = 0; o2 < O2; ++o2)
+                    for (uint32_t o1 = 0; o1 < O1; ++o1)
+                        merged.biasWeights[o2] += second.convolution.filterWeights[o2 * O1 + o1] * first.convolution.biasWeights[o1];
+            }
+        }
+
+        Layer mergedLayer = { .type = LayerType::Convolution, .inputs = first.inputs, .output = second.output,
+                              .convolution = std::move(merged) };
+        const uint64_t flopsBefore = getLayerFlops(a_graph, first) + getLayerFlops(a_graph, second);
+        const uint64_t bytesBefore = getLayerMemoryTraffic(a_graph, first) + getLayerMemoryTraffic(a_graph, second);
+        const uint64_t flopsAfter = getLayerFlops(a_graph, mergedLayer);
+        const uint64_t bytesAfter = getLayerMemoryTraffic(a_graph, mergedLayer);
+        if (flopsAfter > flopsBefore) {
+            continue;  // expanding channels, the two layers are cheaper
+        }
+
+        ++report.layersRemoved;
+        report.flopsSaved += flopsBefore - flopsAfter;
+        report.bytesSaved += bytesBefore > bytesAfter ? bytesBefore - bytesAfter : 0;
+        a_graph.getLayer(i) = std::move(mergedLayer);
+        a_graph.removeLayer(producer);
+        --i;
+    }
+    return report;
+}
+
+PassReport eliminateDeadLayers(NetworkGraph& a_graph)
+{
+    PassReport report = { .name = "eliminate dead layers" };
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = a_graph.getLayers().size(); i-- > 0; ) {
+            const Layer& layer = a_graph.getLayers()[i];
+            const bool isIdentity = layer.type == LayerType::Identity ||
+                                   (layer.type == LayerType::Activation && layer.activation.type == ActivationType::None) ||
+                                   (layer.type == LayerType::Reorder &&
+                                    a_graph.getTensor(layer.inputs[0]).layout == a_graph.getTensor(layer.output).layout);
+            if (isIdentity && layer.output != a_graph.getOutput()) {
+                addSavings(report, a_graph, layer);
+                bypassLayer(a_graph, i, layer.inputs[0]);
+                changed = true;
+            }
+            else if (a_graph.getConsumerCount(layer.output) == 0) {
+                addSavings(report, a_graph, layer);
+                a_graph.removeLayer(i);
+                changed = true;
+            }
+        }
+    }
+    return report;
+}
+
+std::vector<PassReport> optimizeGraph(NetworkGraph& a_graph)
+{
+    std::vector<PassReport> reports;
+    reports.push_back(eliminateDeadLayers(a_graph));
+    reports.push_back(foldNormalization(a_graph));
+    reports.push_back(mergePointwiseConvolutions(a_graph));
+    reports.push_back(fuseElementwiseAdds(a_graph));
+    reports.push_back(fuseActivations(a_graph));
+    return reports;
+}
+}  // namespace neural::ml
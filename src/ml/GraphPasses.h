@@ -0,0 +1,36 @@
+#pragma once
+
+#include "NetworkGraph.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace neural::ml {
+
+// Savings are computed for float32 activations, memory traffic counts every tensor
+// read and written by the removed work
+struct PassReport {
+    const char* name;
+    uint32_t layersRemoved = 0;
+    uint64_t flopsSaved = 0;
+    uint64_t bytesSaved = 0;
+};
+
+uint64_t getLayerFlops(const NetworkGraph& a_graph, const Layer& a_layer);
+uint64_t getLayerMemoryTraffic(const NetworkGraph& a_graph, const Layer& a_layer);
+
+// Folds BatchNormalization and ScaleShift layers into the preceding convolution weights and bias
+PassReport foldNormalization(NetworkGraph& a_graph);
+// Moves Activation layers into the convolution epilogue
+PassReport fuseActivations(NetworkGraph& a_graph);
+// Moves Add layers into the convolution epilogue as a residual input
+PassReport fuseElementwiseAdds(NetworkGraph& a_graph);
+// Replaces a convolution followed by a 1x1 convolution with one convolution when it is cheaper. Both need
+// their weights loaded, or neither
+PassReport mergePointwiseConvolutions(NetworkGraph& a_graph);
+// Removes Identity layers and layers whose output is never used
+PassReport eliminateDeadLayers(NetworkGraph& a_graph);
+
+// Runs all passes in an order where each one exposes work for the next
+std::vector<PassReport> optimizeGraph(NetworkGraph& a_graph);
+}  // namespace neural::ml
@@ -0,0 +1,167 @@
+#include "NetworkGraph.h"
+
+namespace neural::ml {
+
+uint32_t NetworkGraph::addTensor(const TensorDesc& a_desc)
+{
+    m_tensors.push_back(a_desc);
+    return static_cast<uint32_t>(m_tensors.size() - 1);
+}
+
+uint32_t NetworkGraph::addInput(const std::array<uint32_t, 4>& a_sizes)
+{
+    assert(m_input == k_noTensor);  // only one input is supported
+    m_input = addTensor({ .sizes = a_sizes });
+    return m_input;
+}
+
+uint32_t NetworkGraph::addConvolution(uint32_t a_input, ConvolutionDesc a_desc)
+{
+    const TensorDesc& input = getTensor(a_input);
+    assert(a_desc.filterSizes[1] == input.sizes[1]);
+    assert(a_desc.filterWeights.empty() ||
+           a_desc.filterWeights.size() == getFilterElementCount(a_desc.filterSizes, TensorLayout::NCHW));
+    assert(a_desc.biasWeights.empty() || a_desc.biasWeights.size() == a_desc.filterSizes[0]);
+
+    const uint32_t output = addTensor({
+        .sizes = { input.sizes[0], a_desc.filterSizes[0], input.sizes[2], input.sizes[3] },
+        .layout = input.layout
+    });
+    m_layers.push_back({
+        .type = LayerType::Convolution,
+        .inputs = { a_input },
+        .output = output,
+        .convolution = std::move(a_desc)
+    });
+    return output;
+}
+
+uint32_t NetworkGraph::addElementwiseLayer(LayerType a_type, std::vector<uint32_t> a_inputs, Layer a_layer)
+{
+    const TensorDesc input = getTensor(a_inputs[0]);
+    for (auto tensor : a_inputs) {
+        assert(getTensor(tensor).sizes == input.sizes);
+    }
+    a_layer.type = a_type;
+    a_layer.inputs = std::move(a_inputs);
+    a_layer.output = addTensor(input);
+    m_layers.push_back(std::move(a_layer));
+    return m_layers.back().output;
+}
+
+uint32_t NetworkGraph::addBatchNormalization(uint32_t a_input, BatchNormalizationDesc a_desc)
+{
+    const uint32_t channels = getTensor(a_input).sizes[1];
+    assert(a_desc.mean.size() == channels && a_desc.variance.size() == channels);
+    assert(a_desc.scale.size() == channels && a_desc.bias.size() == channels);
+    return addElementwiseLayer(LayerType::BatchNormalization, { a_input },
+                               { .batchNormalization = std::move(a_desc) });
+}
+
+uint32_t NetworkGraph::addScaleShift(uint32_t a_input, ScaleShiftDesc a_desc)
+{
+    const uint32_t channels = getTensor(a_input).sizes[1];
+    assert(a_desc.scale.empty() || a_desc.scale.size() == channels);
+    assert(a_desc.shift.empty() || a_desc.shift.size() == channels);
+    return addElementwiseLayer(LayerType::ScaleShift, { a_input }, { .scaleShift = std::move(a_desc) });
+}
+
+uint32_t NetworkGraph::addActivation(uint32_t a_input, ActivationDesc a_activation)
+{
+    assert(a_activation.type != ActivationType::PRelu || a_activation.slopes.size() == getTensor(a_input).sizes[1]);
+    return addElementwiseLayer(LayerType::Activation, { a_input }, { .activation = std::move(a_activation) });
+}
+
+uint32_t NetworkGraph::addAdd(uint32_t a_inputA, uint32_t a_inputB)
+{
+    return addElementwiseLayer(LayerType::Add, { a_inputA, a_inputB }, {});
+}
+
+uint32_t NetworkGraph::addIdentity(uint32_t a_input)
+{
+    return addElementwiseLayer(LayerType::Identity, { a_input }, {});
+}
+
+void NetworkGraph::setOutput(uint32_t a_tensor)
+{
+    assert(a_tensor < m_tensors.size());
+    m_output = a_tensor;
+}
+
+uint32_t NetworkGraph::getConsumerCount(uint32_t a_tensor) const
+{
+    uint32_t count = (a_tensor == m_output) ? 1 : 0;
+    for (const auto& layer : m_layers) {
+        for (auto input : layer.inputs) {
+            count += (input == a_tensor) ? 1 : 0;
+        }
+    }
+    return count;
+}
+
+int32_t NetworkGraph::findProducer(uint32_t a_tensor) const
+{
+    for (size_t i = 0; i < m_layers.size(); ++i) {
+        if (m_layers[i].output == a_tensor) {
+            return static_cast<int32_t>(i);
+        }
+    }
+    return -1;
+}
+
+void NetworkGraph::replaceTensorUses(uint32_t a_oldTensor, uint32_t a_newTensor)
+{
+    for (auto& layer : m_layers) {
+        for (auto& input : layer.inputs) {
+            if (input == a_oldTensor) {
+                input = a_newTensor;
+            }
+        }
+    }
+    if (m_output == a_oldTensor) {
+        m_output = a_newTensor;
+    }
+}
+
+void NetworkGraph::removeLayer(size_t a_layerIndex)
+{
+    assert(a_layerIndex < m_layers.size());
+    m_layers.erase(m_layers.begin() + a_layerIndex);
+}
+
+NetworkGraph NetworkGraph::build(TensorLayout a_internalLayout) const
+{
+    assert(m_input != k_noTensor && m_output != k_noTensor);
+
+    NetworkGraph graph;
+    graph.m_tensors = m_tensors;
+    for (auto& tensor : graph.m_tensors) {
+        tensor.layout = a_internalLayout;
+    }
+
+    // The boundary tensors keep NCHW, the layers inside the model never reformat
+    graph.m_input = m_input;
+    graph.m_tensors[m_input].layout = TensorLayout::NCHW;
+    uint32_t internalInput = m_input;
+    if (a_internalLayout != TensorLayout::NCHW) {
+        internalInput = graph.addTensor({ .sizes = m_tensors[m_input].sizes, .layout = a_internalLayout });
+        graph.m_layers.push_back({ .type = LayerType::Reorder, .inputs = { m_input }, .output = internalInput });
+    }
+
+    for (const auto& layer : m_layers) {
+        Layer& newLayer = graph.m_layers.emplace_back(layer);
+        for (auto& input : newLayer.inputs) {
+            if (input == m_input) {
+                input = internalInput;
+            }
+        }
+    }
+
+    graph.m_output = m_output;
+    if (a_internalLayout != TensorLayout::NCHW) {
+        graph.m_output = graph.addTensor({ .sizes = m_tensors[m_output].sizes, .layout = TensorLayout::NCHW });
+        graph.m_layers.push_back({ .type = LayerType::Reorder, .inputs = { m_output }, .output = graph.m_output });
+    }
+    return graph;
+}
+}  // namespace neural::ml
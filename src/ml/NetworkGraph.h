@@ -0,0 +1,114 @@
+#pragma once
+
+#include "Activation.h"
+#include "TensorLayout.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace neural::ml {
+
+enum class LayerType
+{
+    Reorder,
+    Convolution,
+    BatchNormalization,
+    ScaleShift,
+    Activation,
+    Add,
+    Identity
+};
+
+struct TensorDesc {
+    std::array<uint32_t, 4> sizes;  // {N, C, H, W}
+    TensorLayout layout = TensorLayout::NCHW;
+};
+
+// The convolution epilogue is applied in registers: output = activation(conv + bias + residual),
+// where the residual is inputs[1] of the layer when fuseAdd is set
+struct ConvolutionDesc {
+    std::array<uint32_t, 4> filterSizes = {};  // {O, I, H, W}, stride 1 and "same" padding as in ConvolutionLayer
+    std::vector<float> filterWeights = {};     // OIHW, empty if the weights are not loaded yet
+    std::vector<float> biasWeights = {};       // O values, empty if the convolution has no bias
+    ActivationDesc activation = {};
+    bool fuseAdd = false;
+};
+
+struct BatchNormalizationDesc {
+    std::vector<float> mean;
+    std::vector<float> variance;
+    std::vector<float> scale;
+    std::vector<float> bias;
+    float epsilon = 1e-5f;
+};
+
+// Per-channel output = input * scale + shift
+struct ScaleShiftDesc {
+    std::vector<float> scale;
+    std::vector<float> shift;
+};
+
+struct Layer {
+    LayerType type = LayerType::Identity;
+    std::vector<uint32_t> inputs = {};
+    uint32_t output = 0;
+    ConvolutionDesc convolution = {};                // LayerType::Convolution
+    BatchNormalizationDesc batchNormalization = {};  // LayerType::BatchNormalization
+    ScaleShiftDesc scaleShift = {};                  // LayerType::ScaleShift
+    ActivationDesc activation = {};                  // LayerType::Activation
+};
+
+// Backend-neutral description of the network. Layers are stored in execution order
+class NetworkGraph {
+public:
+    uint32_t addInput(const std::array<uint32_t, 4>& a_sizes);
+    uint32_t addConvolution(uint32_t a_input, ConvolutionDesc a_desc);
+    uint32_t addBatchNormalization(uint32_t a_input, BatchNormalizationDesc a_desc);
+    uint32_t addScaleShift(uint32_t a_input, ScaleShiftDesc a_desc);
+    uint32_t addActivation(uint32_t a_input, ActivationDesc a_activation);
+    uint32_t addAdd(uint32_t a_inputA, uint32_t a_inputB);
+    uint32_t addIdentity(uint32_t a_input);
+    void setOutput(uint32_t a_tensor);
+
+    // Returns the graph where all internal tensors use a_internalLayout. Reorders are inserted only
+    // after the model input and before the model output, which both stay in NCHW
+    NetworkGraph build(TensorLayout a_internalLayout) const;
+
+    // Graph editing for the optimization passes
+    uint32_t getConsumerCount(uint32_t a_tensor) const;
+    int32_t findProducer(uint32_t a_tensor) const;
+    void replaceTensorUses(uint32_t a_oldTensor, uint32_t a_newTensor);
+    void removeLayer(size_t a_layerIndex);
+    Layer& getLayer(size_t a_layerIndex) {
+        assert(a_layerIndex < m_layers.size());
+        return m_layers[a_layerIndex];
+    }
+
+    const std::vector<Layer>& getLayers() const {
+        return m_layers;
+    }
+    const TensorDesc& getTensor(uint32_t a_tensor) const {
+        assert(a_tensor < m_tensors.size());
+        return m_tensors[a_tensor];
+    }
+    uint32_t getTensorCount() const {
+        return static_cast<uint32_t>(m_tensors.size());
+    }
+    uint32_t getInput() const {
+        return m_input;
+    }
+    uint32_t getOutput() const {
+        return m_output;
+    }
+    static constexpr uint32_t k_noTensor = UINT32_MAX;
+private:
+    uint32_t addTensor(const TensorDesc& a_desc);
+    uint32_t addElementwiseLayer(LayerType a_type, std::vector<uint32_t> a_inputs, Layer a_layer);
+
+    std::vector<TensorDesc> m_tensors;
+    std::vector<Layer> m_layers;
+    uint32_t m_input = k_noTensor;
+    uint32_t m_output = k_noTensor;
+};
+}  // namespace neural::ml
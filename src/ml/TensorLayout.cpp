@@ -0,0 +1,105 @@
+#include "TensorLayout.h"
+
+#include <cstring>
+
+namespace neural::ml {
+
+namespace {
+uint32_t getWidthStride(const std::array<uint32_t, 4>& a_sizes, TensorLayout a_layout) {
+    switch (a_layout)
+    {
+    case TensorLayout::NHWC:
+        return a_sizes[1];
+    case TensorLayout::NCHWc8:
+    case TensorLayout::NCHWc16:
+        return getChannelBlock(a_layout);
+    default:
+        return 1;
+    }
+}
+}  // anonymous namespace
+
+uint64_t getActivationElementCount(const std::array<uint32_t, 4>& a_sizes, TensorLayout a_layout)
+{
+    return static_cast<uint64_t>(a_sizes[0]) * getPaddedChannels(a_sizes[1], a_layout) * a_sizes[2] * a_sizes[3];
+}
+
+uint64_t getFilterElementCount(const std::array<uint32_t, 4>& a_filterSizes, TensorLayout a_layout)
+{
+    return static_cast<uint64_t>(getPaddedChannels(a_filterSizes[0], a_layout)) *
+           getPaddedChannels(a_filterSizes[1], a_layout) * a_filterSizes[2] * a_filterSizes[3];
+}
+
+uint64_t getActivationOffset(const std::array<uint32_t, 4>& a_sizes, TensorLayout a_layout,
+                             uint32_t n, uint32_t c, uint32_t h, uint32_t w)
+{
+    const uint64_t C = a_sizes[1];
+    const uint64_t H = a_sizes[2];
+    const uint64_t W = a_sizes[3];
+    switch (a_layout)
+    {
+    case TensorLayout::NHWC:
+        return ((n * H + h) * W + w) * C + c;
+    case TensorLayout::NCHWc8:
+    case TensorLayout::NCHWc16:
+    {
+        const uint64_t block = getChannelBlock(a_layout);
+        const uint64_t nBlocks = getPaddedChannels(a_sizes[1], a_layout) / block;
+        return (((n * nBlocks + c / block) * H + h) * W + w) * block + c % block;
+    }
+    default:
+        return ((n * C + c) * H + h) * W + w;
+    }
+}
+
+uint64_t getFilterOffset(const std::array<uint32_t, 4>& a_filterSizes, TensorLayout a_layout,
+                         uint32_t o, uint32_t i, uint32_t h, uint32_t w)
+{
+    const uint64_t I = a_filterSizes[1];
+    const uint64_t H = a_filterSizes[2];
+    const uint64_t W = a_filterSizes[3];
+    switch (a_layout)
+    {
+    case TensorLayout::NHWC:
+        return ((o * H + h) * W + w) * I + i;
+    case TensorLayout::NCHWc8:
+    case TensorLayout::NCHWc16:
+    {
+        const uint64_t block = getChannelBlock(a_layout);
+        const uint64_t nInputBlocks = getPaddedChannels(a_filterSizes[1], a_layout) / block;
+        return ((((o / block) * nInputBlocks + i / block) * H + h) * W + w) * block * block
+               + (i % block) * block + o % block;
+    }
+    default:
+        return ((o * I + i) * H + h) * W + w;
+    }
+}
+
+void reorderActivations(const float* a_src, TensorLayout a_srcLayout,
+                        float* a_dst, TensorLayout a_dstLayout,
+                        const std::array<uint32_t, 4>& a_sizes)
+{
+    assert(a_src && a_dst && a_src != a_dst);
+    if (a_srcLayout == a_dstLayout) {
+        memcpy(a_dst, a_src, getActivationElementCount(a_sizes, a_srcLayout) * sizeof(float));
+        return;
+    }
+    if (isBlocked(a_dstLayout)) {
+        // padded channels must stay zero, the next layers rely on it
+        memset(a_dst, 0, getActivationElementCount(a_sizes, a_dstLayout) * sizeof(float));
+    }
+
+    const uint32_t srcStride = getWidthStride(a_sizes, a_srcLayout);
+    const uint32_t dstStride = getWidthStride(a_sizes, a_dstLayout);
+    for (uint32_t n = 0; n < a_sizes[0]; ++n)
+        for (uint32_t c = 0; c < a_sizes[1]; ++c)
+            for (uint32_t h = 0; h < a_sizes[2]; ++h)
+            {
+                const float* src = a_src + getActivationOffset(a_sizes, a_srcLayout, n, c, h, 0);
+                float* dst = a_dst + getActivationOffset(a_sizes, a_dstLayout, n, c, h, 0);
+                for (uint32_t w = 0; w < a_sizes[3]; ++w) {
+                    dst[w * dstStride] = src[w * srcStride];
+                }
+            }
+}
+}  // namespace neural::ml
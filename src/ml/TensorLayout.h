@@ -0,0 +1,82 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace neural::ml {
+
+// Sizes of activation tensors are always given as {N, C, H, W} and sizes of filters as {O, I, H, W},
+// the layout only defines how elements are placed in memory.
+enum class TensorLayout
+{
+    NCHW,
+    NHWC,
+    NCHWc8,   // nChw8c: channels split into blocks of 8, the block is the innermost dimension
+    NCHWc16   // nChw16c
+};
+
+constexpr uint32_t getChannelBlock(TensorLayout a_layout) {
+    switch (a_layout)
+    {
+    case TensorLayout::NCHWc8:
+        return 8;
+    case TensorLayout::NCHWc16:
+        return 16;
+    default:
+        return 1;
+    }
+}
+
+constexpr bool isBlocked(TensorLayout a_layout) {
+    return getChannelBlock(a_layout) > 1;
+}
+
+// Blocked layouts pad channels up to the block size, padded channels are kept zero
+constexpr uint32_t getPaddedChannels(uint32_t a_channels, TensorLayout a_layout) {
+    const uint32_t block = getChannelBlock(a_layout);
+    return (a_channels + block - 1) / block * block;
+}
+
+uint64_t getActivationElementCount(const std::array<uint32_t, 4>& a_sizes, TensorLayout a_layout);
+uint64_t getFilterElementCount(const std::array<uint32_t, 4>& a_filterSizes, TensorLayout a_layout);
+
+uint64_t getActivationOffset(const std::array<uint32_t, 4>& a_sizes, TensorLayout a_layout,
+                             uint32_t n, uint32_t c, uint32_t h, uint32_t w);
+
+// Filters in blocked layouts are stored as OIhw<B>i<B>o, so the kernel reads B output channels at once
+uint64_t getFilterOffset(const std::array<uint32_t, 4>& a_filterSizes, TensorLayout a_layout,
+                         uint32_t o, uint32_t i, uint32_t h, uint32_t w);
+
+void reorderActivations(const float* a_src, TensorLayout a_srcLayout,
+                        float* a_dst, TensorLayout a_dstLayout,
+                        const std::array<uint32_t, 4>& a_sizes);
+
+// Source weights are always OIHW, as they come from the training side
+template<typename T>
+std::vector<T> reorderWeights(const T* a_src, const std::array<uint32_t, 4>& a_filterSizes, TensorLayout a_layout)
+{
+    const uint32_t O = a_filterSizes[0];
+    const uint32_t I = a_filterSizes[1];
+    const uint32_t H = a_filterSizes[2];
+    const uint32_t W = a_filterSizes[3];
+
+    std::vector<T> weights(getFilterElementCount(a_filterSizes, a_layout), T(0));
+    if (a_layout == TensorLayout::NCHW) {
+        std::copy(a_src, a_src + static_cast<size_t>(O) * I * H * W, weights.begin());
+        return weights;
+    }
+
+    for (uint32_t o = 0; o < O; ++o)
+        for (uint32_t i = 0; i < I; ++i)
+            for (uint32_t h = 0; h < H; ++h)
+                for (uint32_t w = 0; w < W; ++w)
+                {
+                    const uint64_t srcIdx = w + h * W + i * H * W + static_cast<uint64_t>(o) * I * H * W;
+                    weights[getFilterOffset(a_filterSizes, a_layout, o, i, h, w)] = a_src[srcIdx];
+                }
+    return weights;
+}
+}  // namespace neural::ml
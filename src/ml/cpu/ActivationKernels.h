@@ -0,0 +1,120 @@
+#pragma once
+
+#include <ml/Activation.h>
+#include <utils/CpuFeatures.h>
+
+#include <cstdint>
+
+namespace neural::ml::cpu {
+inline namespace NEURAL_ISA_NAMESPACE {
+
+// The approximations below are branch-free, so inside a fixed-width lane loop the compiler turns them
+// into vector code and a fused activation costs a few instructions per output instead of a memory pass.
+// Max errors are measured against the double precision functions on every 7th float bit pattern in range.
+// Tier translation units include this file, so it uses the helpers of utils/CpuFeatures.h, not std::
+
+// exp(x) = 2^n * exp(r), n = round(x / ln2), |r| <= ln2 / 2, exp(r) is the Cephes degree 6 polynomial.
+// Input is clamped to [-87, 88]. Max relative error 8.2e-8
+inline float fastExp(float a_x)
+{
+    const float x = utils::isaMin(utils::isaMax(a_x, -87.0f), 88.0f);
+    const float n = utils::isaFloor(x * 1.44269504088896341f + 0.5f);
+    // Cody-Waite reduction, ln2 split into an exact high part and a low correction
+    const float r = (x - n * 0.693359375f) + n * 2.12194440e-4f;
+
+    float p = 1.9875691500e-4f;
+    p = p * r + 1.3981999507e-3f;
+    p = p * r + 8.3334519073e-3f;
+    p = p * r + 4.1665795894e-2f;
+    p = p * r + 1.6666665459e-1f;
+    p = p * r + 5.0000001201e-1f;
+    p = p * r * r + r + 1.0f;
+
+    const float scale = utils::isaBitCast<float>((static_cast<int32_t>(n) + 127) << 23);
+    return p * scale;
+}
+
+// Odd rational approximation p(x) / q(x) of degree 13/6, input clamped to +-7.9 where tanh rounds to 1.
+// Max absolute error 4.0e-7
+inline float fastTanh(float a_x)
+{
+    const float x = utils::isaMin(utils::isaMax(a_x, -7.90531110763549805f), 7.90531110763549805f);
+    const float x2 = x * x;
+
+    float p = -2.76076847742355e-16f;
+    p = p * x2 + 2.00018790482477e-13f;
+    p = p * x2 - 8.60467152213735e-11f;
+    p = p * x2 + 5.12229709037114e-08f;
+    p = p * x2 + 1.48572235717979e-05f;
+    p = p * x2 + 6.37261928875436e-04f;
+    p = p * x2 + 4.89352455891786e-03f;
+    p = p * x;
+
+    float q = 1.19825839466702e-06f;
+    q = q * x2 + 1.18534705686654e-04f;
+    q = q * x2 + 2.26843463243900e-03f;
+    q = q * x2 + 4.89352518554385e-03f;
+    return p / q;
+}
+
+// 1 / (1 + exp(-x)), keeps the relative accuracy of fastExp for large negative inputs.
+// Max absolute error 9.0e-8
+inline float fastSigmoid(float a_x)
+{
+    return 1.0f / (1.0f + fastExp(-a_x));
+}
+
+inline float applyActivation(float a_value, const ActivationDesc& a_activation, uint32_t a_channel)
+{
+    switch (a_activation.type)
+    {
+    case ActivationType::Relu:
+        return utils::isaMax(a_value, 0.0f);
+    case ActivationType::LeakyRelu:
+        return a_value > 0.0f ? a_value : a_value * a_activation.alpha;
+    case ActivationType::PRelu:
+        return a_value > 0.0f ? a_value : a_value * a_activation.slopes[a_channel];
+    case ActivationType::Sigmoid:
+        return fastSigmoid(a_value);
+    case ActivationType::Tanh:
+        return fastTanh(a_value);
+    case ActivationType::Silu:
+        return a_value * fastSigmoid(a_value);
+    default:
+        return a_value;
+    }
+}
+
+// Applies the activation to a block of B channels, a_slopes are the PRelu slopes of the block. The switch
+// is outside the lane loops, so every case is a straight vectorizable loop
+template<uint32_t B>
+inline void applyActivationBlock(float* a_values, ActivationType a_type, float a_alpha, const float* a_slopes)
+{
+    switch (a_type)
+    {
+    case ActivationType::Relu:
+        for (uint32_t i = 0; i < B; ++i) a_values[i] = utils::isaMax(a_values[i], 0.0f);
+        break;
+    case ActivationType::LeakyRelu:
+        for (uint32_t i = 0; i < B; ++i) a_values[i] = a_values[i] > 0.0f ? a_values[i] : a_values[i] * a_alpha;
+        break;
+    case ActivationType::PRelu:
+        for (uint32_t i = 0; i < B; ++i) {
+            a_values[i] = a_values[i] > 0.0f ? a_values[i] : a_values[i] * a_slopes[i];
+        }
+        break;
+    case ActivationType::Sigmoid:
+        for (uint32_t i = 0; i < B; ++i) a_values[i] = fastSigmoid(a_values[i]);
+        break;
+    case ActivationType::Tanh:
+        for (uint32_t i = 0; i < B; ++i) a_values[i] = fastTanh(a_values[i]);
+        break;
+    case ActivationType::Silu:
+        for (uint32_t i = 0; i < B; ++i) a_values[i] = a_values[i] * fastSigmoid(a_values[i]);
+        break;
+    default:
+        break;
+    }
+}
+}  // namespace NEURAL_ISA_NAMESPACE
+}  // namespace neural::ml::cpu
@@ -0,0 +1,153 @@
+#include "CPUNetwork.h"
+#include "ActivationKernels.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace neural::ml::cpu {
+
+void CPUNetwork::initialize(const NetworkGraph& a_graph, TensorLayout a_internalLayout, bool a_optimize)
+{
+    NetworkGraph graph = a_graph;
+    m_passReports.clear();
+    if (a_optimize) {
+        m_passReports = optimizeGraph(graph);
+    }
+    m_graph = graph.build(a_internalLayout);
+    m_internalLayout = a_internalLayout;
+
+    const auto& layers = m_graph.getLayers();
+    m_tensorData.clear();
+    m_tensorData.resize(m_graph.getTensorCount());
+    for (const auto& layer : layers) {
+        if (layer.output != m_graph.getOutput()) {
+            const TensorDesc& tensor = m_graph.getTensor(layer.output);
+            m_tensorData[layer.output].resize(getActivationElementCount(tensor.sizes, tensor.layout), 0.0f);
+        }
+    }
+
+    m_convolutions.clear();
+    m_convolutions.resize(layers.size());
+    for (size_t i = 0; i < layers.size(); ++i) {
+        if (layers[i].type != LayerType::Convolution) {
+            continue;
+        }
+        const ConvolutionDesc& desc = layers[i].convolution;
+        const TensorDesc& input = m_graph.getTensor(layers[i].inputs[0]);
+        const std::array<uint32_t, 4>& filterSizes = desc.filterSizes;
+        PreparedConvolution& convolution = m_convolutions[i];
+
+        if (desc.filterWeights.empty()) {
+            // weights were not loaded yet, keep the buffer so the network still runs
+            convolution.weights.resize(getFilterElementCount(filterSizes, a_internalLayout), 0.0f);
+        }
+        else {
+            convolution.weights = reorderWeights(desc.filterWeights.data(), filterSizes, a_internalLayout);
+        }
+        if (!desc.biasWeights.empty()) {
+            convolution.bias = desc.biasWeights;
+            convolution.bias.resize(getPaddedChannels(filterSizes[0], a_internalLayout), 0.0f);
+        }
+
+        // Same padding as in ConvolutionLayer
+        convolution.params = {
+            .batch = input.sizes[0],
+            .inputChannels = getPaddedChannels(filterSizes[1], a_internalLayout),
+            .outputChannels = getPaddedChannels(filterSizes[0], a_internalLayout),
+            .height = input.sizes[2],
+            .width = input.sizes[3],
+            .kernelHeight = filterSizes[2],
+            .kernelWidth = filterSizes[3],
+            .padTop = filterSizes[2] / 2,
+            .padLeft = filterSizes[3] / 2,
+            .activation = desc.activation
+        };
+        if (desc.activation.type == ActivationType::PRelu) {
+            convolution.params.activation.slopes.resize(convolution.params.outputChannels, 0.0f);
+        }
+    }
+}
+
+float* CPUNetwork::getTensorData(uint32_t a_tensor, const float* a_input, float* a_output)
+{
+    if (a_tensor == m_graph.getInput()) {
+        return const_cast<float*>(a_input);
+    }
+    if (a_tensor == m_graph.getOutput()) {
+        return a_output;
+    }
+    return m_tensorData[a_tensor].data();
+}
+
+// Layers the passes could not fuse. They are rare, so they go through the generic offsets
+void CPUNetwork::executeElementwise(const Layer& a_layer, const float* a_input, const float* a_input2, float* a_output)
+{
+    const TensorDesc& tensor = m_graph.getTensor(a_layer.output);
+    const auto& sizes = tensor.sizes;
+    for (uint32_t n = 0; n < sizes[0]; ++n)
+        for (uint32_t c = 0; c < sizes[1]; ++c)
+            for (uint32_t h = 0; h < sizes[2]; ++h)
+                for (uint32_t w = 0; w < sizes[3]; ++w)
+                {
+                    const uint64_t offset = getActivationOffset(sizes, tensor.layout, n, c, h, w);
+                    const float x = a_input[offset];
+                    float y = x;
+                    switch (a_layer.type)
+                    {
+                    case LayerType::BatchNormalization:
+                    {
+                        const auto& bn = a_layer.batchNormalization;
+                        y = (x - bn.mean[c]) / std::sqrt(bn.variance[c] + bn.epsilon) * bn.scale[c] + bn.bias[c];
+                    }
+                    break;
+                    case LayerType::ScaleShift:
+                        y = a_layer.scaleShift.scale.empty() ? x : x * a_layer.scaleShift.scale[c];
+                        y += a_layer.scaleShift.shift.empty() ? 0.0f : a_layer.scaleShift.shift[c];
+                        break;
+                    case LayerType::Activation:
+                        y = applyActivation(x, a_layer.activation, c);
+                        break;
+                    case LayerType::Add:
+                        y = x + a_input2[offset];
+                        break;
+                    default:
+                        break;
+                    }
+                    a_output[offset] = y;
+                }
+}
+
+void CPUNetwork::execute(const float* a_input, float* a_output)
+{
+    const auto& layers = m_graph.getLayers();
+    for (size_t i = 0; i < layers.size(); ++i) {
+        const Layer& layer = layers[i];
+        const float* input = getTensorData(layer.inputs[0], a_input, a_output);
+        const float* input2 = layer.inputs.size() > 1 ? getTensorData(layer.inputs[1], a_input, a_output) : nullptr;
+        float* output = getTensorData(layer.output, a_input, a_output);
+
+        switch (layer.type)
+        {
+        case LayerType::Reorder:
+        {
+            const TensorDesc& src = m_graph.getTensor(layer.inputs[0]);
+            const TensorDesc& dst = m_graph.getTensor(layer.output);
+            reorderActivations(input, src.layout, output, dst.layout, src.sizes);
+        }
+        break;
+        case LayerType::Convolution:
+        {
+            const PreparedConvolution& prepared = m_convolutions[i];
+            convolution(input, prepared.weights.data(),
+                        prepared.bias.empty() ? nullptr : prepared.bias.data(),
+                        layer.convolution.fuseAdd ? input2 : nullptr,
+                        output, prepared.params, m_internalLayout);
+        }
+        break;
+        default:
+            executeElementwise(layer, input, input2, output);
+            break;
+        }
+    }
+}
+}  // namespace neural::ml::cpu
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <ml/NetworkGraph.h>
+#include <ml/GraphPasses.h>
+#include "ConvolutionKernels.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace neural::ml::cpu {
+
+// Runs a NetworkGraph on the CPU. The graph is optimized with optimizeGraph, weights are reordered
+// once here and activations are reordered only at the model boundaries, see NetworkGraph::build
+class CPUNetwork {
+public:
+    // a_optimize = false runs the graph as given, to compare the passes against it
+    void initialize(const NetworkGraph& a_graph, TensorLayout a_internalLayout, bool a_optimize = true);
+
+    // a_input and a_output are NCHW float tensors of the model input/output sizes
+    void execute(const float* a_input, float* a_output);
+
+    uint64_t getInputElementCount() const {
+        return getActivationElementCount(m_graph.getTensor(m_graph.getInput()).sizes, TensorLayout::NCHW);
+    }
+    uint64_t getOutputElementCount() const {
+        return getActivationElementCount(m_graph.getTensor(m_graph.getOutput()).sizes, TensorLayout::NCHW);
+    }
+    const std::vector<PassReport>& getPassReports() const {
+        return m_passReports;
+    }
+private:
+    struct PreparedConvolution {
+        std::vector<float> weights;  // reordered to the internal layout
+        std::vector<float> bias;     // padded, empty if there is no bias
+        ConvolutionParams params;
+    };
+
+    float* getTensorData(uint32_t a_tensor, const float* a_input, float* a_output);
+    void executeElementwise(const Layer& a_layer, const float* a_input, const float* a_input2, float* a_output);
+
+    NetworkGraph m_graph;
+    TensorLayout m_internalLayout;
+    std::vector<PassReport> m_passReports;
+    std::vector<PreparedConvolution> m_convolutions;  // one per layer, empty for other layers
+    std::vector<std::vector<float>> m_tensorData;     // model input and output are not stored
+};
+}  // namespace neural::ml::cpu
@@ -0,0 +1,99 @@
+#include "ConvolutionKernelsImpl.h"
+#include <utils/TaskScheduler.h>
+
+#include <algorithm>
+
+namespace neural::ml::cpu {
+
+namespace {
+BlockedConvolutionKernels getBlockedConvolutionKernels()
+{
+    switch (utils::getIsaTier())
+    {
+#if NEURAL_ARCH_X64
+    case utils::IsaTier::Avx512Fp16:
+    case utils::IsaTier::Avx512:
+        return getBlockedConvolutionKernelsAvx512();
+    case utils::IsaTier::Avx2:
+        return getBlockedConvolutionKernelsAvx2();
+#endif
+    default:
+        return getBlockedConvolutionKernelsBaseline();
+    }
+}
+
+// Layout-agnostic version through offsets, used for NCHW/NHWC and as a reference for the blocked kernels
+void convolutionGeneric(const float* a_input, const float* a_weights, const float* a_bias, const float* a_residual,
+                        float* a_output, const ConvolutionParams& a_params, TensorLayout a_layout,
+                        uint32_t a_rowBegin, uint32_t a_rowEnd)
+{
+    const std::array<uint32_t, 4> inputSizes  = { a_params.batch, a_params.inputChannels, a_params.height, a_params.width };
+    const std::array<uint32_t, 4> outputSizes = { a_params.batch, a_params.outputChannels, a_params.height, a_params.width };
+    const std::array<uint32_t, 4> filterSizes = { a_params.outputChannels, a_params.inputChannels,
+                                                  a_params.kernelHeight, a_params.kernelWidth };
+
+    for (uint32_t row = a_rowBegin; row < a_rowEnd; ++row) {
+        const uint32_t h = row % a_params.height;
+        const uint32_t o = (row / a_params.height) % a_params.outputChannels;
+        const uint32_t n = row / (a_params.height * a_params.outputChannels);
+        for (uint32_t w = 0; w < a_params.width; ++w)
+        {
+            float acc = a_bias ? a_bias[o] : 0.0f;
+            for (uint32_t i = 0; i < a_params.inputChannels; ++i)
+                for (uint32_t kh = 0; kh < a_params.kernelHeight; ++kh)
+                    for (uint32_t kw = 0; kw < a_params.kernelWidth; ++kw)
+                    {
+                        const int32_t ih = static_cast<int32_t>(h + kh) - static_cast<int32_t>(a_params.padTop);
+                        const int32_t iw = static_cast<int32_t>(w + kw) - static_cast<int32_t>(a_params.padLeft);
+                        if (ih < 0 || iw < 0 || ih >= static_cast<int32_t>(a_params.height) ||
+                            iw >= static_cast<int32_t>(a_params.width)) {
+                            continue;
+                        }
+                        acc += a_input[getActivationOffset(inputSizes, a_layout, n, i, ih, iw)] *
+                               a_weights[getFilterOffset(filterSizes, a_layout, o, i, kh, kw)];
+                    }
+            const uint64_t outputOffset = getActivationOffset(outputSizes, a_layout, n, o, h, w);
+            if (a_residual) {
+                acc += a_residual[outputOffset];
+            }
+            a_output[outputOffset] = applyActivation(acc, a_params.activation, o);
+        }
+    }
+}
+}  // anonymous namespace
+
+BlockedConvolutionKernels getBlockedConvolutionKernelsBaseline()
+{
+    return { convolutionBlocked<8>, convolutionBlocked<16> };
+}
+
+void convolution(const float* a_input, const float* a_weights, const float* a_bias, const float* a_residual,
+                 float* a_output, const ConvolutionParams& a_params, TensorLayout a_layout)
+{
+    assert(a_params.inputChannels % getChannelBlock(a_layout) == 0);
+    assert(a_params.outputChannels % getChannelBlock(a_layout) == 0);
+    const BlockedConvolutionKernels kernels = getBlockedConvolutionKernels();
+    const uint32_t block = getChannelBlock(a_layout);
+    const uint32_t rows = a_params.batch * (a_params.outputChannels / block) * a_params.height;
+    const std::vector<float>& slopes = a_params.activation.slopes;
+    const float* slopesData = slopes.empty() ? nullptr : slopes.data();
+
+    // Output rows are independent, every task computes a tile of whole rows
+    utils::getTaskScheduler().parallelFor(0, rows, 1, [&](uint32_t a_rowBegin, uint32_t a_rowEnd) {
+        switch (a_layout)
+        {
+        case TensorLayout::NCHWc8:
+            kernels.blocked8(a_input, a_weights, a_bias, a_residual, slopesData, a_output, a_params, a_rowBegin,
+                             a_rowEnd);
+            break;
+        case TensorLayout::NCHWc16:
+            kernels.blocked16(a_input, a_weights, a_bias, a_residual, slopesData, a_output, a_params, a_rowBegin,
+                              a_rowEnd);
+            break;
+        default:
+            convolutionGeneric(a_input, a_weights, a_bias, a_residual, a_output, a_params, a_layout,
+                               a_rowBegin, a_rowEnd);
+        }
+    });
+}
+}  // namespace neural::ml::cpu
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ml/TensorLayout.h>
+#include <ml/Activation.h>
+
+#include <cstdint>
+
+namespace neural::ml::cpu {
+
+struct ConvolutionParams {
+    uint32_t batch;
+    uint32_t inputChannels;   // padded to the channel block
+    uint32_t outputChannels;  // padded to the channel block
+    uint32_t height;
+    uint32_t width;
+    uint32_t kernelHeight;
+    uint32_t kernelWidth;
+    uint32_t padTop;
+    uint32_t padLeft;
+    ActivationDesc activation;  // PRelu slopes are padded to outputChannels
+};
+
+// Input and output are in a_layout, weights are reordered with reorderWeights(.., a_layout) and
+// bias is padded to outputChannels. Output spatial size equals input size (stride 1, "same" padding).
+// a_bias and a_residual are optional, output = activation(conv + bias + residual)
+void convolution(const float* a_input, const float* a_weights, const float* a_bias, const float* a_residual,
+                 float* a_output, const ConvolutionParams& a_params, TensorLayout a_layout);
+}  // namespace neural::ml::cpu
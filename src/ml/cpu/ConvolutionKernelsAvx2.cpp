@@ -0,0 +1,11 @@
+// Compiled with AVX2 and FMA, see src/CMakeLists.txt
+#include "ConvolutionKernelsImpl.h"
+
+namespace neural::ml::cpu {
+#if NEURAL_ARCH_X64
+BlockedConvolutionKernels getBlockedConvolutionKernelsAvx2()
+{
+    return { convolutionBlocked<8>, convolutionBlocked<16> };
+}
+#endif
+}  // namespace neural::ml::cpu
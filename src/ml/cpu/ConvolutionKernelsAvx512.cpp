@@ -0,0 +1,11 @@
+// Compiled with AVX-512 F/BW/VL/DQ, 16-channel blocks fill one ZMM register, see src/CMakeLists.txt
+#include "ConvolutionKernelsImpl.h"
+
+namespace neural::ml::cpu {
+#if NEURAL_ARCH_X64
+BlockedConvolutionKernels getBlockedConvolutionKernelsAvx512()
+{
+    return { convolutionBlocked<8>, convolutionBlocked<16> };
+}
+#endif
+}  // namespace neural::ml::cpu
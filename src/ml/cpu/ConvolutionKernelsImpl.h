@@ -0,0 +1,94 @@
+#pragma once
+
+#include "ConvolutionKernels.h"
+#include "ActivationKernels.h"
+
+namespace neural::ml::cpu {
+
+// Computes the output rows [a_rowBegin, a_rowEnd), rows are counted over batch * outputBlocks * height.
+// a_slopes are the PRelu slopes of a_params.activation, the kernels don't touch its std::vector
+using BlockedConvolutionFunction = void (*)(const float* a_input, const float* a_weights, const float* a_bias,
+                                            const float* a_residual, const float* a_slopes, float* a_output,
+                                            const ConvolutionParams& a_params, uint32_t a_rowBegin,
+                                            uint32_t a_rowEnd);
+
+struct BlockedConvolutionKernels {
+    BlockedConvolutionFunction blocked8;
+    BlockedConvolutionFunction blocked16;
+};
+
+// One per utils::IsaTier, every one is the kernel below compiled with the target flags of the tier
+BlockedConvolutionKernels getBlockedConvolutionKernelsBaseline();
+BlockedConvolutionKernels getBlockedConvolutionKernelsAvx2();
+BlockedConvolutionKernels getBlockedConvolutionKernelsAvx512();
+
+namespace {
+// Direct convolution over nChw<B>c tensors. Every output pixel keeps B accumulators, one per output
+// channel of the block, so the innermost loop is a B-wide multiply-add the compiler maps onto vectors
+template<uint32_t B>
+void convolutionBlocked(const float* a_input, const float* a_weights, const float* a_bias, const float* a_residual,
+                        const float* a_slopes, float* a_output, const ConvolutionParams& a_params,
+                        uint32_t a_rowBegin, uint32_t a_rowEnd)
+{
+    const uint32_t inputBlocks  = a_params.inputChannels / B;
+    const uint32_t outputBlocks = a_params.outputChannels / B;
+    const uint32_t H  = a_params.height;
+    const uint32_t W  = a_params.width;
+    const uint32_t KH = a_params.kernelHeight;
+    const uint32_t KW = a_params.kernelWidth;
+    const uint64_t imageSize = static_cast<uint64_t>(H) * W * B;
+    const uint64_t filterBlockSize = static_cast<uint64_t>(KH) * KW * B * B;
+
+    for (uint32_t row = a_rowBegin; row < a_rowEnd; ++row) {
+        const uint32_t h  = row % H;
+        const uint32_t ob = (row / H) % outputBlocks;
+        const uint32_t n  = row / (H * outputBlocks);
+        const float* input = a_input + n * inputBlocks * imageSize;
+        const float* weights = a_weights + ob * inputBlocks * filterBlockSize;
+        float* output = a_output + (n * outputBlocks + ob) * imageSize;
+        const float* residual = a_residual ? a_residual + (n * outputBlocks + ob) * imageSize : nullptr;
+
+        for (uint32_t w = 0; w < W; ++w)
+        {
+            alignas(64) float acc[B];
+            for (uint32_t o = 0; o < B; ++o) {
+                acc[o] = a_bias ? a_bias[ob * B + o] : 0.0f;
+            }
+
+            const int32_t kh0 = utils::isaMax(0, static_cast<int32_t>(a_params.padTop) - static_cast<int32_t>(h));
+            const int32_t kh1 = utils::isaMin<int32_t>(KH, H + a_params.padTop - h);
+            const int32_t kw0 = utils::isaMax(0, static_cast<int32_t>(a_params.padLeft) - static_cast<int32_t>(w));
+            const int32_t kw1 = utils::isaMin<int32_t>(KW, W + a_params.padLeft - w);
+
+            for (uint32_t ib = 0; ib < inputBlocks; ++ib)
+                for (int32_t kh = kh0; kh < kh1; ++kh)
+                    for (int32_t kw = kw0; kw < kw1; ++kw)
+                    {
+                        const uint32_t ih = h + kh - a_params.padTop;
+                        const uint32_t iw = w + kw - a_params.padLeft;
+                        const float* src = input + ib * imageSize + (static_cast<uint64_t>(ih) * W + iw) * B;
+                        const float* wt = weights + ib * filterBlockSize + (kh * KW + kw) * B * B;
+                        for (uint32_t i = 0; i < B; ++i) {
+                            const float x = src[i];
+                            for (uint32_t o = 0; o < B; ++o) {
+                                acc[o] += x * wt[i * B + o];
+                            }
+                        }
+                    }
+
+            const uint64_t pixel = (static_cast<uint64_t>(h) * W + w) * B;
+            if (residual) {
+                for (uint32_t o = 0; o < B; ++o) {
+                    acc[o] += residual[pixel + o];
+                }
+            }
+            applyActivationBlock<B>(acc, a_params.activation.type, a_params.activation.alpha,
+                                    a_slopes ? a_slopes + ob * B : nullptr);
+            for (uint32_t o = 0; o < B; ++o) {
+                output[pixel + o] = acc[o];
+            }
+        }
+    }
+}
+}  // anonymous namespace
+}  // namespace neural::ml::cpu
@@ -0,0 +1,70 @@
+#include "Test.h"
+
+#include <ml/cpu/ActivationKernels.h>
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+using namespace neural::ml::cpu;
+using namespace neural::tests;
+
+namespace {
+
+// Every a_stride-th float bit pattern of [a_begin, a_end], the sign bit swept separately so both halves
+// start at zero. Returns the largest error of a_approximation against the double precision a_reference,
+// relative or absolute
+template<typename Approximation, typename Reference>
+double sweepMaxError(float a_begin, float a_end, uint32_t a_stride, bool a_relative,
+                     Approximation a_approximation, Reference a_reference)
+{
+    double maxError = 0.0;
+    for (const float sign : { 1.0f, -1.0f }) {
+        const float limit = sign > 0.0f ? a_end : -a_begin;
+        if (limit < 0.0f) {
+            continue;
+        }
+        const uint32_t lastBits = std::bit_cast<uint32_t>(limit);
+        for (uint64_t bits = 0; bits <= lastBits; bits += a_stride) {
+            const float x = sign * std::bit_cast<float>(static_cast<uint32_t>(bits));
+            const double expected = a_reference(static_cast<double>(x));
+            double error = std::abs(static_cast<double>(a_approximation(x)) - expected);
+            if (a_relative) {
+                error /= expected;
+            }
+            maxError = std::max(maxError, error);
+        }
+    }
+    return maxError;
+}
+
+// A prime stride keeps the sweep to a few million values and still hits every exponent and mantissa pattern
+constexpr uint32_t k_stride = 701;
+}  // anonymous namespace
+
+NEURAL_TEST(ActivationKernels, FastExpMaxError)
+{
+    const double maxError = sweepMaxError(-87.0f, 88.0f, k_stride, true, fastExp,
+                                          [](double a_x) { return std::exp(a_x); });
+    NEURAL_CHECK(maxError <= 8.2e-8);
+    // Clamped outside the range, but never infinite or zero
+    NEURAL_CHECK(std::isfinite(fastExp(1000.0f)) && fastExp(1000.0f) == fastExp(88.0f));
+    NEURAL_CHECK(fastExp(-1000.0f) > 0.0f && fastExp(-1000.0f) == fastExp(-87.0f));
+    NEURAL_CHECK(fastExp(0.0f) == 1.0f);
+}
+
+NEURAL_TEST(ActivationKernels, FastTanhMaxError)
+{
+    const double maxError = sweepMaxError(-10.0f, 10.0f, k_stride, false, fastTanh,
+                                          [](double a_x) { return std::tanh(a_x); });
+    NEURAL_CHECK(maxError <= 4.0e-7);
+    NEURAL_CHECK(fastTanh(0.0f) == 0.0f && fastTanh(-3.0f) == -fastTanh(3.0f));
+    NEURAL_CHECK(std::abs(fastTanh(1000.0f)) <= 1.0f);
+}
+
+NEURAL_TEST(ActivationKernels, FastSigmoidMaxError)
+{
+    const double maxError = sweepMaxError(-87.0f, 87.0f, k_stride, false, fastSigmoid,
+                                          [](double a_x) { return 1.0 / (1.0 + std::exp(-a_x)); });
+    NEURAL_CHECK(maxError <= 9.0e-8);
+}
@@ -0,0 +1,192 @@
+#include "Test.h"
+
+#include <graphics/CaptureQueue.h>
+#include <utils/TaskScheduler.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+using namespace neural::graphics;
+using namespace neural::tests;
+
+namespace {
+
+// The GPU is a fence value the test completes by hand, and catches up at once when waited for. Writes of
+// sample ids ending in 4 or 9 fail
+class FakeCaptureDevice : public ICaptureDevice {
+public:
+    explicit FakeCaptureDevice(uint32_t a_slotCount)
+        : m_writing(std::make_unique<std::atomic<bool>[]>(a_slotCount)) {}
+
+    uint64_t getCompletedFenceValue() override {
+        return m_completedFenceValue.load();
+    }
+    void waitForFenceValue(uint64_t a_value) override {
+        ++m_waitCount;
+        complete(a_value);
+    }
+    bool writeSlot(uint32_t a_slot, uint32_t a_sampleId) override {
+        if (m_writing[a_slot].exchange(true)) {
+            m_slotReused = true;
+        }
+        {
+            std::lock_guard lock(m_mutex);
+            m_writtenIds.push_back(a_sampleId);
+        }
+        m_writing[a_slot] = false;
+        return a_sampleId % 5 != 4;
+    }
+
+    void complete(uint64_t a_value) {
+        uint64_t completed = m_completedFenceValue.load();
+        while (completed < a_value && !m_completedFenceValue.compare_exchange_weak(completed, a_value)) {
+        }
+    }
+    uint32_t getWaitCount() const {
+        return m_waitCount;
+    }
+    // A slot written by two workers at once
+    bool isSlotReused() const {
+        return m_slotReused;
+    }
+    // Sorted
+    std::vector<uint32_t> getWrittenIds() {
+        std::lock_guard lock(m_mutex);
+        std::vector<uint32_t> ids = m_writtenIds;
+        std::sort(ids.begin(), ids.end());
+        return ids;
+    }
+private:
+    std::atomic<uint64_t> m_completedFenceValue = 0;
+    std::atomic<uint32_t> m_waitCount = 0;
+    std::unique_ptr<std::atomic<bool>[]> m_writing;
+    std::atomic<bool> m_slotReused = false;
+    std::mutex m_mutex;
+    std::vector<uint32_t> m_writtenIds;
+};
+
+std::vector<uint32_t> getIds(uint32_t a_first, uint32_t a_count)
+{
+    std::vector<uint32_t> ids(a_count);
+    for (uint32_t i = 0; i < a_count; ++i) {
+        ids[i] = a_first + i;
+    }
+    return ids;
+}
+}  // namespace
+
+// Nothing is written before the fence of its frame, and everything is once flushed
+NEURAL_TEST(CaptureQueue, WritesAfterFence)
+{
+    neural::utils::getTaskScheduler().initialize({ .threadCount = 3 });
+    FakeCaptureDevice device(4);
+    CaptureQueue queue;
+    queue.initialize({ .device = &device, .slotCount = 4 });
+    for (uint32_t i = 0; i < 3; ++i) {
+        queue.submitSlot(queue.acquireSlot(), i, i + 1);
+    }
+    queue.poll();
+    NEURAL_CHECK(device.getWrittenIds().empty());
+
+    device.complete(2);
+    queue.flush();
+    NEURAL_CHECK(device.getWrittenIds() == getIds(0, 3));
+    NEURAL_CHECK(queue.getWrittenCount() == 3 && queue.getFailedCount() == 0);
+    // Only flush waited for the last frame
+    NEURAL_CHECK(device.getWaitCount() == 1);
+    queue.shutdown();
+    neural::utils::getTaskScheduler().shutdown();
+}
+
+// A full ring makes the render thread wait for the oldest copy, no capture is lost
+NEURAL_TEST(CaptureQueue, WaitBackpressure)
+{
+    neural::utils::getTaskScheduler().initialize({ .threadCount = 3 });
+    FakeCaptureDevice device(2);
+    CaptureQueue queue;
+    queue.initialize({ .device = &device, .slotCount = 2, .overflow = CaptureOverflow::Wait });
+    queue.submitSlot(queue.acquireSlot(), 0, 1);
+    queue.submitSlot(queue.acquireSlot(), 1, 2);
+    NEURAL_CHECK(device.getWaitCount() == 0);
+
+    const uint32_t slot = queue.acquireSlot();
+    NEURAL_CHECK(slot != CaptureQueue::k_noSlot);
+    NEURAL_CHECK(device.getWaitCount() == 1);
+    NEURAL_CHECK(device.getCompletedFenceValue() == 1);
+    queue.submitSlot(slot, 2, 3);
+    queue.shutdown();
+    NEURAL_CHECK(device.getWrittenIds() == getIds(0, 3));
+    NEURAL_CHECK(queue.getDroppedCount() == 0);
+    neural::utils::getTaskScheduler().shutdown();
+}
+
+// A full ring skips captures without waiting, the ring takes captures again once written
+NEURAL_TEST(CaptureQueue, DropPolicy)
+{
+    neural::utils::getTaskScheduler().initialize({ .threadCount = 3 });
+    FakeCaptureDevice device(2);
+    CaptureQueue queue;
+    queue.initialize({ .device = &device, .slotCount = 2, .overflow = CaptureOverflow::Drop });
+    queue.submitSlot(queue.acquireSlot(), 0, 1);
+    queue.submitSlot(queue.acquireSlot(), 1, 2);
+    for (int i = 0; i < 3; ++i) {
+        NEURAL_CHECK(queue.acquireSlot() == CaptureQueue::k_noSlot);
+    }
+    NEURAL_CHECK(queue.getDroppedCount() == 3);
+    NEURAL_CHECK(device.getWaitCount() == 0);
+
+    queue.flush();
+    NEURAL_CHECK(device.getWrittenIds() == getIds(0, 2));
+    const uint32_t slot = queue.acquireSlot();
+    if (NEURAL_CHECK(slot != CaptureQueue::k_noSlot)) {
+        queue.submitSlot(slot, 2, 3);
+    }
+    queue.shutdown();
+    NEURAL_CHECK(queue.getWrittenCount() + queue.getFailedCount() == 3);
+    NEURAL_CHECK(queue.getDroppedCount() == 3);
+    neural::utils::getTaskScheduler().shutdown();
+}
+
+// A capture every frame with the GPU two frames behind: every capture is written once by one task at a time,
+// failed writes are counted. Once with scheduler workers and once without, where writes only run while the
+// render thread waits
+NEURAL_TEST(CaptureQueue, EveryFrame)
+{
+    constexpr uint32_t frameCount = 1000;
+    neural::utils::getTaskScheduler().initialize({ .threadCount = 3 });
+    for (const bool workers : { true, false })
+    for (const CaptureOverflow overflow : { CaptureOverflow::Wait, CaptureOverflow::Drop }) {
+        if (!workers) {
+            neural::utils::getTaskScheduler().shutdown();
+        }
+        FakeCaptureDevice device(3);
+        CaptureQueue queue;
+        queue.initialize({ .device = &device, .slotCount = 3, .overflow = overflow });
+        uint32_t submittedCount = 0;
+        for (uint32_t frame = 1; frame <= frameCount; ++frame) {
+            device.complete(frame > 2 ? frame - 2 : 0);
+            const uint32_t slot = queue.acquireSlot();
+            if (slot != CaptureQueue::k_noSlot) {
+                queue.submitSlot(slot, frame, frame);
+                ++submittedCount;
+            }
+        }
+        queue.shutdown();
+
+        NEURAL_CHECK(!device.isSlotReused());
+        const std::vector<uint32_t> ids = device.getWrittenIds();
+        NEURAL_CHECK(ids.size() == submittedCount);
+        NEURAL_CHECK(std::adjacent_find(ids.begin(), ids.end()) == ids.end());
+        const uint32_t failedCount = static_cast<uint32_t>(std::count_if(ids.begin(), ids.end(), [](uint32_t a_id) {
+            return a_id % 5 == 4;
+        }));
+        NEURAL_CHECK(queue.getFailedCount() == failedCount);
+        NEURAL_CHECK(queue.getWrittenCount() + failedCount == submittedCount);
+        NEURAL_CHECK(submittedCount + queue.getDroppedCount() == frameCount);
+        if (overflow == CaptureOverflow::Wait) {
+            NEURAL_CHECK(submittedCount == frameCount);
+        }
+    }
+}
@@ -0,0 +1,25 @@
+# Fails if an object of a tier (NEURAL_AVX2_SRC, NEURAL_AVX512_SRC) defines a weak symbol outside the tier
+# namespace. The linker may pick such a copy for baseline callers, see NEURAL_ISA_NAMESPACE in
+# src/utils/CpuFeatures.h
+#     cmake -DNM=<nm> -DOBJECTS=<objects separated by |> -P CheckIsaSymbols.cmake
+string(REPLACE "|" ";" objects "${OBJECTS}")
+set(leaks "")
+foreach(object ${objects})
+  if(NOT object MATCHES "(Avx2|Avx512)\\.cpp\\.(o|obj)$")
+    continue()
+  endif()
+  execute_process(COMMAND ${NM} -C --defined-only ${object} OUTPUT_VARIABLE symbols RESULT_VARIABLE result)
+  if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${NM} failed on ${object}")
+  endif()
+  string(REPLACE "\n" ";" symbols "${symbols}")
+  foreach(symbol ${symbols})
+    # Weak functions and objects, the personality routine reference is data the compiler emits everywhere
+    if(symbol MATCHES " [WwVvu] " AND NOT symbol MATCHES "(avx2|avx512)::" AND NOT symbol MATCHES "DW\\.ref\\.")
+      string(APPEND leaks "\n  ${object}: ${symbol}")
+    endif()
+  endforeach()
+endforeach()
+if(leaks)
+  message(FATAL_ERROR "Weak symbols outside the tier namespace:${leaks}")
+endif()
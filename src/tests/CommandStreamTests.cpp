@@ -0,0 +1,150 @@
+#include "Test.h"
+
+#include <graphics/CommandStream.h>
+#include <utils/TaskScheduler.h>
+
+#include <algorithm>
+
+using namespace neural::graphics;
+using namespace neural::tests;
+using namespace neural::utils;
+
+namespace {
+
+struct DrawConstants {
+    int32_t object;
+    float position[3];
+    float color[3];
+};
+
+// The commands of a_drawCount draws split evenly over the chunks of a_stream, each chunk recorded by a task
+void recordDraws(TaskScheduler& a_scheduler, CommandStream& a_stream, uint32_t a_drawCount)
+{
+    const uint32_t chunkCount = a_stream.getChunkCount();
+    a_scheduler.parallelFor(0, chunkCount, 1, [&a_stream, a_drawCount, chunkCount](uint32_t a_begin, uint32_t a_end) {
+        for (uint32_t chunkIndex = a_begin; chunkIndex < a_end; ++chunkIndex) {
+            CommandChunk& chunk = a_stream.getChunk(chunkIndex);
+            const uint32_t first = static_cast<uint32_t>(uint64_t{ a_drawCount } * chunkIndex / chunkCount);
+            const uint32_t last = static_cast<uint32_t>(uint64_t{ a_drawCount } * (chunkIndex + 1) / chunkCount);
+            for (uint32_t i = first; i < last; ++i) {
+                chunk.setRootConstants(0, DrawConstants{ static_cast<int32_t>(i), { 1, 2, 3 }, { 4, 5, 6 } });
+                chunk.setIndexBuffer(i * 100ull, i, (i & 1) ? 2 : 4);
+                chunk.drawIndexed({ .indexCount = i, .instanceCount = 1, .firstIndex = 0,
+                                    .baseVertex = -static_cast<int32_t>(i), .firstInstance = i });
+            }
+        }
+    });
+}
+}  // namespace
+
+NEURAL_TEST(CommandStream, Payloads)
+{
+    CommandChunk chunk;
+    const VertexBufferBinding bindings[2] = { { 10, 20, 32 }, { 40, 50, 48 } };
+    chunk.setPipeline(1, 2, CommandBindPoint::Compute);
+    chunk.setVertexBuffers(3, bindings);
+    chunk.setConstantBuffer(5, 0x123456789abcull);
+    chunk.dispatch(4, 5, 6);
+    chunk.barrier({ .resource = 7, .type = RenderGraphBarrierType::Transition,
+                    .before = RenderGraphState::UnorderedAccess, .after = RenderGraphState::ShaderResource });
+    NEURAL_CHECK(chunk.getCommandCount() == 5);
+
+    CommandReader reader(chunk.getWords());
+    Command command;
+    if (!NEURAL_CHECK(reader.next(command) && command.type == CommandType::SetPipeline)) {
+        return;
+    }
+    const CommandSetPipeline pipeline = command.get<CommandSetPipeline>();
+    NEURAL_CHECK(pipeline.pipeline == 1 && pipeline.layout == 2 && pipeline.bindPoint == CommandBindPoint::Compute);
+    if (!NEURAL_CHECK(reader.next(command) && command.type == CommandType::SetVertexBuffers)) {
+        return;
+    }
+    NEURAL_CHECK(command.get<CommandSetVertexBuffers>().firstSlot == 3);
+    NEURAL_CHECK(command.get<CommandSetVertexBuffers>().count == 2);
+    const VertexBufferBinding second = command.getTailElement<CommandSetVertexBuffers, VertexBufferBinding>(1);
+    NEURAL_CHECK(second.address == 40 && second.size == 50 && second.stride == 48);
+    if (!NEURAL_CHECK(reader.next(command) && command.type == CommandType::SetConstantBuffer)) {
+        return;
+    }
+    NEURAL_CHECK(command.get<CommandSetConstantBuffer>().address == 0x123456789abcull);
+    if (!NEURAL_CHECK(reader.next(command) && command.type == CommandType::Dispatch)) {
+        return;
+    }
+    NEURAL_CHECK(command.get<CommandDispatch>().z == 6);
+    if (!NEURAL_CHECK(reader.next(command) && command.type == CommandType::Barrier)) {
+        return;
+    }
+    NEURAL_CHECK(command.get<CommandBarrier>().after == RenderGraphState::ShaderResource);
+    NEURAL_CHECK(!reader.next(command));
+}
+
+// Chunks recorded on worker threads come out in chunk order, whichever thread finished first
+NEURAL_TEST(CommandStream, ParallelRecordingAndMerge)
+{
+    constexpr uint32_t drawCount = 20000;
+    TaskScheduler scheduler;
+    scheduler.initialize({ .threadCount = 3 });
+    CommandStream stream;
+    CommandChunk merged;
+    for (const uint32_t chunkCount : { 1u, 4u, 37u }) {
+        stream.reset(chunkCount);
+        recordDraws(scheduler, stream, drawCount);
+        NEURAL_CHECK(stream.getCommandCount() == 3 * drawCount);
+
+        uint32_t expectedDraw = 0;
+        bool inOrder = true;
+        stream.forEach([&expectedDraw, &inOrder](const Command& a_command) {
+            if (a_command.type == CommandType::SetRootConstants) {
+                const std::span<const uint32_t> values = a_command.getTail<CommandSetRootConstants>();
+                inOrder &= a_command.get<CommandSetRootConstants>().count == sizeof(DrawConstants) / sizeof(uint32_t) &&
+                           static_cast<int32_t>(values[0]) == static_cast<int32_t>(expectedDraw);
+            } else if (a_command.type == CommandType::DrawIndexed) {
+                const CommandDrawIndexed draw = a_command.get<CommandDrawIndexed>();
+                inOrder &= draw.firstInstance == expectedDraw && draw.baseVertex == -static_cast<int32_t>(expectedDraw);
+                ++expectedDraw;
+            }
+        });
+        NEURAL_CHECK(inOrder);
+        NEURAL_CHECK(expectedDraw == drawCount);
+
+        // The merged chunk holds the same words, chunk after chunk
+        merged.clear();
+        stream.merge(merged);
+        NEURAL_CHECK(merged.getCommandCount() == stream.getCommandCount());
+        std::vector<uint32_t> words;
+        for (uint32_t i = 0; i < chunkCount; ++i) {
+            words.insert(words.end(), stream.getChunk(i).getWords().begin(), stream.getChunk(i).getWords().end());
+        }
+        NEURAL_CHECK(std::equal(words.begin(), words.end(), merged.getWords().begin(), merged.getWords().end()));
+    }
+}
+
+NEURAL_BENCH(CommandStream, RecordAndMerge)
+{
+    constexpr uint32_t drawCount = 200000;
+    TaskScheduler scheduler;
+    scheduler.initialize({ .threadCount = 0 });
+    CommandStream stream;
+    CommandChunk merged;
+    for (const uint32_t chunkCount : { 1u, std::max(scheduler.getWorkerCount() + 1, 2u) }) {
+        // The first round grows the chunks, the second one reuses their memory as every frame does
+        double recordSeconds = 0.0;
+        double mergeSeconds = 0.0;
+        for (int round = 0; round < 2; ++round) {
+            auto start = std::chrono::steady_clock::now();
+            stream.reset(chunkCount);
+            recordDraws(scheduler, stream, drawCount);
+            recordSeconds = getElapsedSeconds(start);
+            merged.clear();
+            start = std::chrono::steady_clock::now();
+            stream.merge(merged);
+            mergeSeconds = getElapsedSeconds(start);
+        }
+        char name[64];
+        std::snprintf(name, sizeof(name), "record, chunks = %u", chunkCount);
+        reportBenchmark(name, stream.getCommandCount() / recordSeconds * 1e-6, "M commands/s");
+        std::snprintf(name, sizeof(name), "merge %zu KiB, chunks = %u", merged.getWords().size() * 4 / 1024,
+                      chunkCount);
+        reportBenchmark(name, mergeSeconds * 1e3, "ms");
+    }
+}
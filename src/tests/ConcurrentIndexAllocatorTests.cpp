@@ -0,0 +1,207 @@
+#include "Test.h"
+
+#include <utils/ConcurrentIndexAllocator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+
+using namespace neural::tests;
+using namespace neural::utils;
+
+namespace {
+
+constexpr uint32_t k_frameCount = 3;
+
+// Every index in [0, capacity) is allocated once before k_invalidIndex
+bool checkAllAllocatable(ConcurrentIndexAllocator& a_allocator)
+{
+    std::vector<bool> allocated(a_allocator.getCapacity());
+    uint32_t count = 0;
+    for (uint32_t index = a_allocator.allocate(); index != ConcurrentIndexAllocator::k_invalidIndex;
+         index = a_allocator.allocate()) {
+        if (!NEURAL_CHECK(index < allocated.size() && !allocated[index])) {
+            return false;
+        }
+        allocated[index] = true;
+        ++count;
+    }
+    return NEURAL_CHECK(count == a_allocator.getCapacity());
+}
+
+// The baseline: a stack of free indices behind a mutex
+class MutexIndexStack {
+public:
+    void initialize(uint32_t a_capacity) {
+        m_indices.resize(a_capacity);
+        for (uint32_t i = 0; i < a_capacity; ++i) {
+            m_indices[i] = a_capacity - 1 - i;
+        }
+    }
+    uint32_t allocate() {
+        std::lock_guard lock(m_mutex);
+        if (m_indices.empty()) {
+            return ConcurrentIndexAllocator::k_invalidIndex;
+        }
+        const uint32_t index = m_indices.back();
+        m_indices.pop_back();
+        return index;
+    }
+    void free(uint32_t a_index) {
+        std::lock_guard lock(m_mutex);
+        m_indices.push_back(a_index);
+    }
+private:
+    std::mutex m_mutex;
+    std::vector<uint32_t> m_indices;
+};
+
+// Allocations and frees per second of a_threadCount threads, each freeing its last 16 allocations in turn
+template <typename Allocator>
+double measureAllocationRate(Allocator& a_allocator, uint32_t a_threadCount)
+{
+    constexpr int allocationCount = 2000000;
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < a_threadCount; ++i) {
+        threads.emplace_back([&a_allocator] {
+            uint32_t indices[16];
+            for (int allocation = 0; allocation < allocationCount; allocation += 16) {
+                for (uint32_t& index : indices) {
+                    index = a_allocator.allocate();
+                }
+                for (const uint32_t index : indices) {
+                    a_allocator.free(index);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    return a_threadCount * static_cast<double>(allocationCount) / getElapsedSeconds(start);
+}
+}  // namespace
+
+NEURAL_TEST(ConcurrentIndexAllocator, AllocateAll)
+{
+    ConcurrentIndexAllocator allocator;
+    allocator.initialize(1000, k_frameCount);
+    if (!checkAllAllocatable(allocator)) {
+        return;
+    }
+    allocator.free(17);
+    NEURAL_CHECK(allocator.allocate() == 17);
+    NEURAL_CHECK(allocator.allocate() == ConcurrentIndexAllocator::k_invalidIndex);
+}
+
+NEURAL_TEST(ConcurrentIndexAllocator, DeferredFree)
+{
+    ConcurrentIndexAllocator allocator;
+    allocator.initialize(64, k_frameCount);
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < 64; ++i) {
+        indices.push_back(allocator.allocate());
+    }
+    allocator.deferredFree(indices[3], 1);
+    allocator.deferredFree(indices[9], 1);
+    allocator.releaseDeferred(0);
+    allocator.releaseDeferred(2);
+    NEURAL_CHECK(allocator.allocate() == ConcurrentIndexAllocator::k_invalidIndex);
+
+    allocator.releaseDeferred(1);
+    uint32_t first = allocator.allocate();
+    uint32_t second = allocator.allocate();
+    NEURAL_CHECK(std::min(first, second) == std::min(indices[3], indices[9]));
+    NEURAL_CHECK(std::max(first, second) == std::max(indices[3], indices[9]));
+    NEURAL_CHECK(allocator.allocate() == ConcurrentIndexAllocator::k_invalidIndex);
+}
+
+// Threads allocate, free and defer frees at random while the first one releases frames. An index allocated
+// twice at a time, or lost, fails
+NEURAL_TEST(ConcurrentIndexAllocator, MultithreadedStress)
+{
+    constexpr uint32_t threadCount = 8;
+    constexpr int operationCount = 100000;
+    for (const uint32_t capacity : { 64u, 1000u, 100000u }) {
+        ConcurrentIndexAllocator allocator;
+        allocator.initialize(capacity, k_frameCount);
+        const std::unique_ptr<std::atomic<bool>[]> owned = std::make_unique<std::atomic<bool>[]>(capacity);
+        std::atomic<uint32_t> frame = 0;
+        std::atomic<bool> passed = true;
+
+        std::vector<std::thread> threads;
+        for (uint32_t thread = 0; thread < threadCount; ++thread) {
+            threads.emplace_back([&, thread] {
+                std::mt19937 random(thread);
+                std::vector<uint32_t> indices;
+                // Leaves some free indices to every thread, allocate fails when all of them are taken
+                const size_t maxCount = std::max<size_t>(capacity / (4 * threadCount), 1);
+                for (int operation = 0; operation < operationCount; ++operation) {
+                    if (random() % 2 == 0 && indices.size() < maxCount) {
+                        const uint32_t index = allocator.allocate();
+                        if (index == ConcurrentIndexAllocator::k_invalidIndex) {
+                            continue;
+                        }
+                        if (index >= capacity || owned[index].exchange(true)) {
+                            passed = false;
+                        }
+                        indices.push_back(index);
+                    } else if (!indices.empty()) {
+                        const size_t slot = random() % indices.size();
+                        const uint32_t index = indices[slot];
+                        indices[slot] = indices.back();
+                        indices.pop_back();
+                        if (!owned[index].exchange(false)) {
+                            passed = false;
+                        }
+                        if (random() % 4 == 0) {
+                            allocator.deferredFree(index, frame.load() % k_frameCount);
+                        } else {
+                            allocator.free(index);
+                        }
+                    }
+                    if (thread == 0 && operation % 1000 == 0) {
+                        allocator.releaseDeferred((frame.fetch_add(1) + 1) % k_frameCount);
+                    }
+                }
+                for (const uint32_t index : indices) {
+                    owned[index] = false;
+                    allocator.free(index);
+                }
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+        if (!NEURAL_CHECK(passed.load())) {
+            return;
+        }
+        for (uint32_t i = 0; i < k_frameCount; ++i) {
+            allocator.releaseDeferred(i);
+        }
+        checkAllAllocatable(allocator);
+    }
+}
+
+NEURAL_BENCH(ConcurrentIndexAllocator, AllocationsPerSecond)
+{
+    constexpr uint32_t capacity = 1 << 20;
+    const uint32_t threadCount = std::max(std::thread::hardware_concurrency(), 2u);
+    for (const uint32_t threads : { 1u, threadCount }) {
+        ConcurrentIndexAllocator allocator;
+        allocator.initialize(capacity, k_frameCount);
+        MutexIndexStack mutexStack;
+        mutexStack.initialize(capacity);
+        const double rate = measureAllocationRate(allocator, threads);
+        const double mutexRate = measureAllocationRate(mutexStack, threads);
+        char name[64];
+        std::snprintf(name, sizeof(name), "allocate + free, threads = %u", threads);
+        reportBenchmark(name, rate * 1e-6, "M/s");
+        std::snprintf(name, sizeof(name), "allocate + free, threads = %u, mutex stack", threads);
+        reportBenchmark(name, mutexRate * 1e-6, "M/s");
+    }
+}
@@ -0,0 +1,139 @@
+#include "Test.h"
+
+#include <ml/cpu/ConvolutionKernels.h>
+#include <utils/CpuFeatures.h>
+#include <utils/TaskScheduler.h>
+
+#include <cmath>
+#include <random>
+
+using namespace neural::ml;
+using namespace neural::ml::cpu;
+using namespace neural::tests;
+
+namespace {
+
+struct ConvolutionCase {
+    uint32_t inputChannels;
+    uint32_t outputChannels;
+    uint32_t kernelSize;
+    ActivationType activation;
+    bool bias;
+    bool residual;
+};
+
+// Channel counts that fill whole blocks, leave a tail in one block size or in both
+constexpr ConvolutionCase k_cases[] = {
+    { 3, 5, 3, ActivationType::Relu, true, false },
+    { 8, 16, 3, ActivationType::None, false, false },
+    { 13, 20, 3, ActivationType::PRelu, true, true },
+    { 16, 17, 1, ActivationType::Silu, true, false },
+    { 24, 9, 5, ActivationType::Tanh, false, true },
+    { 7, 33, 3, ActivationType::Sigmoid, true, true }
+};
+
+constexpr uint32_t k_batch = 2;
+constexpr uint32_t k_height = 5;
+constexpr uint32_t k_width = 7;
+
+std::vector<float> randomValues(std::mt19937& a_random, size_t a_count)
+{
+    std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+    std::vector<float> values(a_count);
+    for (float& value : values) {
+        value = distribution(a_random);
+    }
+    return values;
+}
+
+// Runs a_case in a_layout on the current ISA tier and compares the channels of the case with the NCHW
+// output. The padded channels of a blocked output must be activation(0), i.e. zero unless it is Sigmoid
+bool matchesReference(const ConvolutionCase& a_case, TensorLayout a_layout)
+{
+    std::mt19937 random(a_case.inputChannels * 100 + a_case.outputChannels);
+    const uint32_t I = a_case.inputChannels;
+    const uint32_t O = a_case.outputChannels;
+    const uint32_t K = a_case.kernelSize;
+    const std::array<uint32_t, 4> inputSizes = { k_batch, I, k_height, k_width };
+    const std::array<uint32_t, 4> outputSizes = { k_batch, O, k_height, k_width };
+    const std::array<uint32_t, 4> filterSizes = { O, I, K, K };
+
+    const std::vector<float> input = randomValues(random, static_cast<size_t>(k_batch) * I * k_height * k_width);
+    const std::vector<float> weights = randomValues(random, static_cast<size_t>(O) * I * K * K);
+    const std::vector<float> residual = randomValues(random, static_cast<size_t>(k_batch) * O * k_height * k_width);
+    std::vector<float> bias = randomValues(random, O);
+    ActivationDesc activation = { .type = a_case.activation, .slopes = randomValues(random, O) };
+
+    ConvolutionParams params = {
+        .batch = k_batch,
+        .inputChannels = I,
+        .outputChannels = O,
+        .height = k_height,
+        .width = k_width,
+        .kernelHeight = K,
+        .kernelWidth = K,
+        .padTop = K / 2,
+        .padLeft = K / 2,
+        .activation = activation
+    };
+    std::vector<float> expected(getActivationElementCount(outputSizes, TensorLayout::NCHW));
+    convolution(input.data(), weights.data(), a_case.bias ? bias.data() : nullptr,
+                a_case.residual ? residual.data() : nullptr, expected.data(), params, TensorLayout::NCHW);
+
+    // The blocked tensors pad the channels with zeros, bias and slopes are padded by hand
+    std::vector<float> blockedInput(getActivationElementCount(inputSizes, a_layout));
+    std::vector<float> blockedResidual(getActivationElementCount(outputSizes, a_layout));
+    reorderActivations(input.data(), TensorLayout::NCHW, blockedInput.data(), a_layout, inputSizes);
+    reorderActivations(residual.data(), TensorLayout::NCHW, blockedResidual.data(), a_layout, outputSizes);
+    const std::vector<float> blockedWeights = reorderWeights(weights.data(), filterSizes, a_layout);
+    const uint32_t paddedOutputChannels = getPaddedChannels(O, a_layout);
+    bias.resize(paddedOutputChannels, 0.0f);
+    params.activation.slopes.resize(paddedOutputChannels, 0.0f);
+    params.inputChannels = getPaddedChannels(I, a_layout);
+    params.outputChannels = paddedOutputChannels;
+
+    std::vector<float> blockedOutput(getActivationElementCount(outputSizes, a_layout), NAN);
+    convolution(blockedInput.data(), blockedWeights.data(), a_case.bias ? bias.data() : nullptr,
+                a_case.residual ? blockedResidual.data() : nullptr, blockedOutput.data(), params, a_layout);
+
+    const std::array<uint32_t, 4> paddedSizes = { k_batch, paddedOutputChannels, k_height, k_width };
+    const float paddedValue = a_case.activation == ActivationType::Sigmoid ? 0.5f : 0.0f;
+    for (uint32_t n = 0; n < k_batch; ++n)
+        for (uint32_t c = 0; c < paddedOutputChannels; ++c)
+            for (uint32_t h = 0; h < k_height; ++h)
+                for (uint32_t w = 0; w < k_width; ++w)
+                {
+                    const float value = blockedOutput[getActivationOffset(paddedSizes, a_layout, n, c, h, w)];
+                    if (c >= O) {
+                        if (value != paddedValue) {
+                            return false;
+                        }
+                        continue;
+                    }
+                    // The blocked kernels add up the products in another order
+                    const float reference = expected[getActivationOffset(outputSizes, TensorLayout::NCHW, n, c, h, w)];
+                    if (!(std::abs(value - reference) <= 1e-4f * (1.0f + std::abs(reference)))) {
+                        return false;
+                    }
+                }
+    return true;
+}
+}  // anonymous namespace
+
+NEURAL_TEST(ConvolutionKernels, BlockedMatchesNchw)
+{
+    neural::utils::getTaskScheduler().initialize({ .threadCount = 3 });
+    const neural::utils::IsaTier initialTier = neural::utils::getIsaTier();
+    for (const neural::utils::IsaTier tier : { neural::utils::IsaTier::Baseline, neural::utils::IsaTier::Avx2,
+                                               neural::utils::IsaTier::Avx512, neural::utils::IsaTier::Avx512Fp16 }) {
+        if (!neural::utils::setIsaTier(tier)) {
+            continue;
+        }
+        for (const ConvolutionCase& convolutionCase : k_cases) {
+            NEURAL_CHECK(matchesReference(convolutionCase, TensorLayout::NCHWc8));
+            NEURAL_CHECK(matchesReference(convolutionCase, TensorLayout::NCHWc16));
+        }
+    }
+    neural::utils::setIsaTier(initialTier);
+    neural::utils::getTaskScheduler().shutdown();
+}
@@ -0,0 +1,186 @@
+#include "Test.h"
+
+#include <utils/DatasetShards.h>
+
+#include <cmath>
+#include <filesystem>
+
+using namespace neural::tests;
+using namespace neural::utils;
+
+namespace {
+
+constexpr uint32_t k_width = 13;
+constexpr uint32_t k_height = 7;
+constexpr uint32_t k_pixelCount = k_width * k_height;
+
+std::filesystem::path createTestDirectory(const char* a_name)
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / a_name;
+    std::filesystem::remove_all(directory);
+    return directory;
+}
+
+// Three planes, each of a value kind that its precision stores without loss
+std::vector<DatasetPlane> getPlanes()
+{
+    return {
+        { .name = "depth", .precision = PlanePrecision::Float32, .compression = PlaneCompression::None },
+        { .name = "normal", .precision = PlanePrecision::Float16, .compression = PlaneCompression::Lossless },
+        { .name = "mask", .precision = PlanePrecision::Unorm8, .compression = PlaneCompression::Lossless }
+    };
+}
+
+// Sample values: depth any float, normal multiples of 1/64 in [-1, 1], mask bytes
+struct Sample {
+    std::vector<float> depthAndNormal;  // interleaved, as a two channel image
+    std::vector<uint8_t> mask;
+};
+
+Sample makeSample(uint32_t a_sampleId)
+{
+    Sample sample;
+    sample.depthAndNormal.resize(2 * k_pixelCount);
+    sample.mask.resize(k_pixelCount);
+    for (uint32_t i = 0; i < k_pixelCount; ++i) {
+        sample.depthAndNormal[2 * i] = std::sin(static_cast<float>(i + a_sampleId)) * 100.0f;
+        const int32_t normal = static_cast<int32_t>((i * 7 + a_sampleId) % 129) - 64;
+        sample.depthAndNormal[2 * i + 1] = static_cast<float>(normal) / 64.0f;
+        sample.mask[i] = static_cast<uint8_t>(i * 3 + a_sampleId);
+    }
+    return sample;
+}
+
+bool append(DatasetWriter& a_writer, uint32_t a_sampleId)
+{
+    const Sample sample = makeSample(a_sampleId);
+    const PlaneSource sources[] = {
+        { .data = sample.depthAndNormal.data(), .pixelStride = 2, .rowStride = 2 * k_width },
+        { .data = sample.depthAndNormal.data() + 1, .pixelStride = 2, .rowStride = 2 * k_width },
+        { .data = sample.mask.data(), .pixelStride = 1, .rowStride = k_width, .element = ImageElement::Uint8 }
+    };
+    return a_writer.append(a_sampleId, sources);
+}
+
+bool matchesSample(DatasetReader& a_reader, uint32_t a_sample, uint32_t a_expectedId)
+{
+    std::vector<float> planes[3];
+    float* destinations[3];
+    for (uint32_t p = 0; p < 3; ++p) {
+        planes[p].resize(k_pixelCount);
+        destinations[p] = planes[p].data();
+    }
+    uint32_t sampleId = UINT32_MAX;
+    if (!a_reader.readSample(a_sample, destinations, &sampleId) || sampleId != a_expectedId) {
+        return false;
+    }
+    const Sample expected = makeSample(a_expectedId);
+    for (uint32_t i = 0; i < k_pixelCount; ++i) {
+        if (planes[0][i] != expected.depthAndNormal[2 * i] || planes[1][i] != expected.depthAndNormal[2 * i + 1] ||
+            std::abs(planes[2][i] - expected.mask[i] / 255.0f) > 1e-6f) {
+            return false;
+        }
+    }
+    return true;
+}
+}  // anonymous namespace
+
+NEURAL_TEST(DatasetShards, RoundTrip)
+{
+    const std::filesystem::path directory = createTestDirectory("neural_tests_dataset_round_trip");
+    DatasetWriter writer;
+    if (!NEURAL_CHECK(writer.initialize({ .directory = directory.string(), .width = k_width, .height = k_height,
+                                          .planes = getPlanes(), .samplesPerShard = 4 }))) {
+        return;
+    }
+    // 10 samples over three shards, the last one partly filled
+    for (uint32_t i = 0; i < 10; ++i) {
+        NEURAL_CHECK(append(writer, 100 + i));
+    }
+    NEURAL_CHECK(writer.getSampleCount() == 10);
+    writer.shutdown();
+    NEURAL_CHECK(std::filesystem::exists(directory / "shard_00002.data"));
+    NEURAL_CHECK(!std::filesystem::exists(directory / "shard_00003.data"));
+
+    DatasetReader reader;
+    if (!NEURAL_CHECK(reader.initialize(directory.string()))) {
+        return;
+    }
+    NEURAL_CHECK(reader.getSampleCount() == 10);
+    NEURAL_CHECK(reader.getWidth() == k_width && reader.getHeight() == k_height);
+    NEURAL_CHECK(reader.getPlanes().size() == 3 && reader.getPlanes()[1].name == "normal");
+    NEURAL_CHECK(reader.getPlaneIndex("mask") == 2);
+    NEURAL_CHECK(reader.getPlaneIndex("albedo") == UINT32_MAX);
+    // Backwards, so shards are opened out of order
+    for (uint32_t i = 10; i-- > 0;) {
+        NEURAL_CHECK(matchesSample(reader, i, 100 + i));
+    }
+
+    std::vector<float> normal(k_pixelCount);
+    NEURAL_CHECK(reader.readPlane(5, 1, normal.data()));
+    const Sample expected = makeSample(105);
+    bool normalMatches = true;
+    for (uint32_t i = 0; i < k_pixelCount; ++i) {
+        normalMatches = normalMatches && normal[i] == expected.depthAndNormal[2 * i + 1];
+    }
+    NEURAL_CHECK(normalMatches);
+    reader.shutdown();
+    std::filesystem::remove_all(directory);
+}
+
+NEURAL_TEST(DatasetShards, TornTailRecovery)
+{
+    const std::filesystem::path directory = createTestDirectory("neural_tests_dataset_torn_tail");
+    const DatasetWriterCreateInfo createInfo = {
+        .directory = directory.string(),
+        .width = k_width,
+        .height = k_height,
+        .planes = getPlanes(),
+        .samplesPerShard = 8
+    };
+    DatasetWriter writer;
+    if (!NEURAL_CHECK(writer.initialize(createInfo))) {
+        return;
+    }
+    for (uint32_t i = 0; i < 5; ++i) {
+        NEURAL_CHECK(append(writer, i));
+    }
+    writer.shutdown();
+
+    // A crash in the middle of the fifth record: its index entry made it to disk, half of its data did not
+    const std::filesystem::path dataPath = directory / "shard_00000.data";
+    const uintmax_t dataSize = std::filesystem::file_size(dataPath);
+    std::filesystem::resize_file(dataPath, dataSize - 40);
+
+    if (!NEURAL_CHECK(writer.initialize(createInfo))) {
+        return;
+    }
+    NEURAL_CHECK(writer.getSampleCount() == 4);
+    NEURAL_CHECK(append(writer, 50));
+    writer.shutdown();
+
+    // Garbage past the last record, as a crash before the index entry was written leaves it
+    if (std::FILE* data = std::fopen(dataPath.string().c_str(), "ab")) {
+        const char garbage[] = "torn record";
+        std::fwrite(garbage, sizeof(garbage), 1, data);
+        std::fclose(data);
+    }
+    if (!NEURAL_CHECK(writer.initialize(createInfo))) {
+        return;
+    }
+    NEURAL_CHECK(writer.getSampleCount() == 5);
+    NEURAL_CHECK(append(writer, 60));
+    writer.shutdown();
+
+    DatasetReader reader;
+    if (!NEURAL_CHECK(reader.initialize(directory.string()))) {
+        return;
+    }
+    NEURAL_CHECK(reader.getSampleCount() == 6);
+    const uint32_t expectedIds[] = { 0, 1, 2, 3, 50, 60 };
+    for (uint32_t i = 0; i < 6; ++i) {
+        NEURAL_CHECK(matchesSample(reader, i, expectedIds[i]));
+    }
+    reader.shutdown();
+    std::filesystem::remove_all(directory);
+}
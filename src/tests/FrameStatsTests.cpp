@@ -0,0 +1,150 @@
+#include "Test.h"
+
+#include <utils/FrameStats.h>
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+
+using namespace neural::tests;
+using namespace neural::utils;
+
+namespace {
+
+std::string readFile(const std::filesystem::path& a_path)
+{
+    std::ifstream file(a_path);
+    std::stringstream content;
+    content << file.rdbuf();
+    return content.str();
+}
+
+double parseBudget(std::vector<std::string> a_arguments)
+{
+    a_arguments.insert(a_arguments.begin(), "neural");
+    std::vector<char*> argv;
+    for (std::string& argument : a_arguments) {
+        argv.push_back(argument.data());
+    }
+    return parseFrameStatsArguments(static_cast<int>(argv.size()), argv.data()).budgetSeconds;
+}
+}  // anonymous namespace
+
+NEURAL_TEST(FrameStats, BucketRanges)
+{
+    using Histogram = LatencyHistogram;
+    const uint32_t lastBucket = Histogram::getBucket(~0ull);
+    NEURAL_CHECK(Histogram::getBucketLow(0) == 0);
+    bool contiguous = true;
+    bool consistent = true;
+    bool boundedError = true;
+    for (uint32_t bucket = 0; bucket <= lastBucket; ++bucket) {
+        const uint64_t low = Histogram::getBucketLow(bucket);
+        const uint64_t high = Histogram::getBucketHigh(bucket);
+        if (bucket < lastBucket) {
+            contiguous = contiguous && Histogram::getBucketLow(bucket + 1) == high + 1;
+        }
+        consistent = consistent && low <= high && Histogram::getBucket(low) == bucket &&
+                     Histogram::getBucket(high) == bucket;
+        boundedError = boundedError && high - low <= low / Histogram::k_subBucketCount;
+    }
+    NEURAL_CHECK(contiguous);
+    NEURAL_CHECK(consistent);
+    NEURAL_CHECK(boundedError);
+    // Exact below 2 * k_subBucketCount, everything too large ends in the last bucket
+    const uint64_t exactCount = 2 * Histogram::k_subBucketCount;
+    NEURAL_CHECK(Histogram::getBucket(exactCount - 1) == exactCount - 1);
+    NEURAL_CHECK(Histogram::getBucketHigh(exactCount - 1) == exactCount - 1);
+    NEURAL_CHECK(Histogram::getBucketHigh(lastBucket) == (exactCount << Histogram::k_maxExponent) - 1);
+}
+
+NEURAL_TEST(FrameStats, PercentilesMatchSortedValues)
+{
+    LatencyHistogram histogram;
+    NEURAL_CHECK(histogram.getPercentile(50.0) == 0);
+
+    // Frame times around 16 ms with a long tail
+    std::mt19937 random(7);
+    std::lognormal_distribution<double> distribution(std::log(16000.0), 0.5);
+    std::vector<uint64_t> values(20000);
+    for (uint64_t& value : values) {
+        value = static_cast<uint64_t>(distribution(random));
+        histogram.record(value);
+    }
+    values.push_back(3);
+    histogram.record(3);
+    std::sort(values.begin(), values.end());
+
+    NEURAL_CHECK(histogram.getCount() == values.size());
+    NEURAL_CHECK(histogram.getMax() == values.back());
+    for (const double percentile : { 0.0, 1.0, 25.0, 50.0, 90.0, 99.0, 99.9, 100.0 }) {
+        const double fraction = percentile / 100.0;
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * values.size())));
+        const uint64_t expected = values[rank - 1];
+        const uint64_t value = histogram.getPercentile(percentile);
+        NEURAL_CHECK(value >= expected && value <= expected + expected / LatencyHistogram::k_subBucketCount);
+    }
+    NEURAL_CHECK(histogram.getPercentile(0.0) == 3);
+    NEURAL_CHECK(histogram.getPercentile(100.0) == values.back());
+
+    histogram.reset();
+    NEURAL_CHECK(histogram.getCount() == 0 && histogram.getMax() == 0 && histogram.getPercentile(99.0) == 0);
+}
+
+NEURAL_TEST(FrameStats, CsvAndJson)
+{
+    FrameStats stats;
+    stats.initialize({ .historySize = 4, .budgetSeconds = 0.010 });
+    for (const double seconds : { 0.005, 0.012, 0.008, 0.020, 0.009, 0.011 }) {
+        stats.addFrame(seconds);
+    }
+    NEURAL_CHECK(stats.isHitch());
+    const FrameStatsSummary summary = stats.getSummary();
+    NEURAL_CHECK(summary.frameCount == 6 && summary.hitchCount == 3);
+    NEURAL_CHECK(summary.maxMs == 20.0);
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "neural_tests_frame_stats";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    // Only the last four frames are kept
+    if (NEURAL_CHECK(stats.writeCsv((directory / "times.csv").string()))) {
+        NEURAL_CHECK(readFile(directory / "times.csv") == "frame,ms,hitch\n"
+                                                          "2,8.000,0\n"
+                                                          "3,20.000,1\n"
+                                                          "4,9.000,0\n"
+                                                          "5,11.000,1\n");
+    }
+    if (NEURAL_CHECK(stats.writeJson((directory / "times.json").string()))) {
+        const std::string json = readFile(directory / "times.json");
+        NEURAL_CHECK(json.find("\"frames\": 6,") != std::string::npos);
+        NEURAL_CHECK(json.find("\"hitches\": 3,") != std::string::npos);
+        NEURAL_CHECK(json.find("\"budget_ms\": 10.000,") != std::string::npos);
+        NEURAL_CHECK(json.find("\"max_ms\": 20.000,") != std::string::npos);
+        NEURAL_CHECK(json.find("\"recent_hitches\": [\n"
+                               "    { \"frame\": 3, \"ms\": 20.000 },\n"
+                               "    { \"frame\": 5, \"ms\": 11.000 }\n"
+                               "  ]\n}\n") != std::string::npos);
+    }
+
+    stats.reset();
+    stats.addFrame(0.001);
+    NEURAL_CHECK(!stats.isHitch());
+    if (NEURAL_CHECK(stats.writeJson((directory / "empty.json").string()))) {
+        NEURAL_CHECK(readFile(directory / "empty.json").find("\"recent_hitches\": []\n}\n") != std::string::npos);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+NEURAL_TEST(FrameStats, BudgetArgument)
+{
+    const double defaultBudget = FrameStatsCreateInfo().budgetSeconds;
+    NEURAL_CHECK(parseBudget({ "--cpu", "--budget-ms", "8.5" }) == 0.0085);
+    NEURAL_CHECK(parseBudget({ "--budget-ms" }) == defaultBudget);
+    for (const char* invalid : { "abc", "", "12ms", "-4", "0", "inf", "nan" }) {
+        NEURAL_CHECK(parseBudget({ "--budget-ms", invalid }) == defaultBudget);
+    }
+}
@@ -0,0 +1,124 @@
+#include "Test.h"
+
+#include <ml/GraphPasses.h>
+#include <ml/cpu/CPUNetwork.h>
+#include <utils/TaskScheduler.h>
+
+#include <cmath>
+#include <random>
+
+using namespace neural::ml;
+using namespace neural::tests;
+
+namespace {
+
+constexpr std::array<uint32_t, 4> k_inputSizes = { 2, 5, 6, 7 };
+
+std::vector<float> randomValues(std::mt19937& a_random, size_t a_count, float a_min = -1.0f, float a_max = 1.0f)
+{
+    std::uniform_real_distribution<float> distribution(a_min, a_max);
+    std::vector<float> values(a_count);
+    for (float& value : values) {
+        value = distribution(a_random);
+    }
+    return values;
+}
+
+ConvolutionDesc randomConvolution(std::mt19937& a_random, uint32_t a_outputs, uint32_t a_inputs, uint32_t a_kernel,
+                                  bool a_loadWeights = true)
+{
+    const size_t weightCount = static_cast<size_t>(a_outputs) * a_inputs * a_kernel * a_kernel;
+    return {
+        .filterSizes = { a_outputs, a_inputs, a_kernel, a_kernel },
+        .filterWeights = a_loadWeights ? randomValues(a_random, weightCount) : std::vector<float>(),
+        .biasWeights = randomValues(a_random, a_outputs)
+    };
+}
+
+// Every pass has something to do: a dead branch and an identity, a batch normalization and a 1x1
+// convolution after a 3x3 one, an add of a residual computed earlier and an activation
+NetworkGraph createGraph(std::mt19937& a_random)
+{
+    NetworkGraph graph;
+    const uint32_t input = graph.addInput(k_inputSizes);
+    const uint32_t residual = graph.addConvolution(input, randomConvolution(a_random, 4, 5, 1));
+    const uint32_t features = graph.addConvolution(input, randomConvolution(a_random, 12, 5, 3));
+    const uint32_t normalized = graph.addBatchNormalization(features, {
+        .mean = randomValues(a_random, 12),
+        .variance = randomValues(a_random, 12, 0.5f, 2.0f),
+        .scale = randomValues(a_random, 12),
+        .bias = randomValues(a_random, 12)
+    });
+    const uint32_t projected = graph.addConvolution(normalized, randomConvolution(a_random, 4, 12, 1));
+    const uint32_t sum = graph.addAdd(projected, residual);
+    const uint32_t activated = graph.addActivation(sum, { .type = ActivationType::Silu });
+    graph.addScaleShift(activated, { .scale = randomValues(a_random, 4), .shift = randomValues(a_random, 4) });
+    graph.setOutput(graph.addIdentity(activated));
+    return graph;
+}
+
+// The first convolution has no weights loaded yet, so the 1x1 convolution after it must not be merged
+NetworkGraph createPartlyLoadedGraph(std::mt19937& a_random)
+{
+    NetworkGraph graph;
+    const uint32_t input = graph.addInput(k_inputSizes);
+    const uint32_t features = graph.addConvolution(input, randomConvolution(a_random, 12, 5, 3, false));
+    graph.setOutput(graph.addConvolution(features, randomConvolution(a_random, 4, 12, 1)));
+    return graph;
+}
+
+// Largest difference between the outputs of a_graph with and without the passes
+float getMaxPassError(const NetworkGraph& a_graph, TensorLayout a_internalLayout, std::vector<PassReport>* a_reports)
+{
+    neural::ml::cpu::CPUNetwork reference;
+    neural::ml::cpu::CPUNetwork optimized;
+    reference.initialize(a_graph, a_internalLayout, false);
+    optimized.initialize(a_graph, a_internalLayout);
+    if (a_reports) {
+        *a_reports = optimized.getPassReports();
+    }
+
+    std::mt19937 random(11);
+    const std::vector<float> input = randomValues(random, reference.getInputElementCount());
+    std::vector<float> expected(reference.getOutputElementCount());
+    std::vector<float> output(optimized.getOutputElementCount(), NAN);
+    reference.execute(input.data(), expected.data());
+    optimized.execute(input.data(), output.data());
+
+    float maxError = 0.0f;
+    for (size_t i = 0; i < expected.size(); ++i) {
+        const float error = std::abs(output[i] - expected[i]) / (1.0f + std::abs(expected[i]));
+        maxError = std::isnan(error) ? INFINITY : std::max(maxError, error);
+    }
+    return maxError;
+}
+}  // anonymous namespace
+
+NEURAL_TEST(GraphPasses, OptimizedGraphMatchesOriginal)
+{
+    neural::utils::getTaskScheduler().initialize({ .threadCount = 3 });
+    std::mt19937 random(5);
+    const NetworkGraph graph = createGraph(random);
+    for (const TensorLayout layout : { TensorLayout::NCHW, TensorLayout::NCHWc8, TensorLayout::NCHWc16 }) {
+        std::vector<PassReport> reports;
+        NEURAL_CHECK(getMaxPassError(graph, layout, &reports) < 1e-4f);
+        // Every pass removed a layer, so the comparison covered all of them
+        bool allPassesRan = true;
+        for (const PassReport& report : reports) {
+            allPassesRan = allPassesRan && report.layersRemoved > 0;
+        }
+        NEURAL_CHECK(reports.size() == 5 && allPassesRan);
+    }
+    neural::utils::getTaskScheduler().shutdown();
+}
+
+NEURAL_TEST(GraphPasses, PartlyLoadedConvolutionsAreNotMerged)
+{
+    neural::utils::getTaskScheduler().initialize({ .threadCount = 3 });
+    std::mt19937 random(6);
+    NetworkGraph graph = createPartlyLoadedGraph(random);
+    NEURAL_CHECK(getMaxPassError(graph, TensorLayout::NCHWc8, nullptr) < 1e-4f);
+    NEURAL_CHECK(mergePointwiseConvolutions(graph).layersRemoved == 0);
+    NEURAL_CHECK(graph.getLayers().size() == 2);
+    neural::utils::getTaskScheduler().shutdown();
+}
@@ -0,0 +1,222 @@
+#include "Test.h"
+
+#include <utils/CpuFeatures.h>
+#include <utils/Float16Conversion.h>
+#include <utils/ImageCodec.h>
+
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+using namespace neural::tests;
+using namespace neural::utils;
+
+namespace {
+
+constexpr ImageElement k_elements[] = { ImageElement::Uint8, ImageElement::Uint16, ImageElement::Float16,
+                                        ImageElement::Float32 };
+
+// Sizes around the block of 256 values and rows that end inside a block
+constexpr uint32_t k_sizes[][2] = { { 1, 1 }, { 3, 5 }, { 17, 13 }, { 256, 1 }, { 257, 3 }, { 1, 300 }, { 301, 299 } };
+
+// A smooth field with a little noise, like a normal map, in the values of a_element
+std::vector<uint8_t> createPlane(uint32_t a_width, uint32_t a_height, ImageElement a_element, uint32_t a_seed)
+{
+    std::mt19937 random(a_seed);
+    std::uniform_real_distribution<float> noise(-0.01f, 0.01f);
+    std::vector<float> values(static_cast<size_t>(a_width) * a_height);
+    for (uint32_t y = 0; y < a_height; ++y) {
+        for (uint32_t x = 0; x < a_width; ++x) {
+            values[static_cast<size_t>(y) * a_width + x] = std::sin(x * 0.05f) * std::cos(y * 0.03f) + noise(random);
+        }
+    }
+
+    std::vector<uint8_t> plane(values.size() * getImageElementSize(a_element));
+    for (size_t i = 0; i < values.size(); ++i) {
+        const float unorm = values[i] * 0.5f + 0.5f;
+        switch (a_element)
+        {
+        case ImageElement::Uint8:
+            plane[i] = static_cast<uint8_t>(unorm * 255.0f + 0.5f);
+            break;
+        case ImageElement::Uint16:
+        {
+            const uint16_t value = static_cast<uint16_t>(unorm * 65535.0f + 0.5f);
+            std::memcpy(plane.data() + 2 * i, &value, 2);
+        }
+        break;
+        case ImageElement::Float16:
+            compressFloat16Baseline(&values[i], reinterpret_cast<uint16_t*>(plane.data()) + i, 1);
+            break;
+        default:
+            std::memcpy(plane.data() + 4 * i, &values[i], 4);
+            break;
+        }
+    }
+    return plane;
+}
+
+bool roundTrips(const std::vector<uint8_t>& a_plane, uint32_t a_width, uint32_t a_height, ImageElement a_element)
+{
+    std::vector<uint8_t> compressed(getMaxCompressedImageSize(a_width, a_height, a_element));
+    const size_t size = compressImage(a_plane.data(), a_width, a_height, a_element, compressed.data());
+    std::vector<uint8_t> decompressed(a_plane.size(), 0xcd);
+    return size <= compressed.size() &&
+           decompressImage(compressed.data(), size, a_width, a_height, a_element, decompressed.data()) &&
+           decompressed == a_plane;
+}
+
+// Runs a_body on every tier the codec has a variant for and the CPU supports
+template<typename Body>
+void forEachTier(Body a_body)
+{
+    const IsaTier initialTier = getIsaTier();
+    for (const IsaTier tier : { IsaTier::Baseline, IsaTier::Avx2 }) {
+        if (setIsaTier(tier)) {
+            a_body();
+        }
+    }
+    setIsaTier(initialTier);
+}
+}  // anonymous namespace
+
+NEURAL_TEST(ImageCodec, RoundTripEveryElement)
+{
+    forEachTier([] {
+        for (const ImageElement element : k_elements) {
+            for (const auto& size : k_sizes) {
+                const std::vector<uint8_t> plane = createPlane(size[0], size[1], element, size[0] + size[1]);
+                NEURAL_CHECK(roundTrips(plane, size[0], size[1], element));
+            }
+        }
+    });
+}
+
+NEURAL_TEST(ImageCodec, RoundTripNoise)
+{
+    // White noise needs every bit, every block is stored at full width
+    std::mt19937 random(9);
+    forEachTier([&] {
+        for (const ImageElement element : k_elements) {
+            std::vector<uint8_t> plane(67 * 41 * getImageElementSize(element));
+            for (uint8_t& byte : plane) {
+                byte = static_cast<uint8_t>(random());
+            }
+            NEURAL_CHECK(roundTrips(plane, 67, 41, element));
+        }
+    });
+}
+
+NEURAL_TEST(ImageCodec, SpecialFloats)
+{
+    const float specials[] = {
+        0.0f, -0.0f, std::numeric_limits<float>::infinity(), -std::numeric_limits<float>::infinity(),
+        std::numeric_limits<float>::quiet_NaN(), -std::numeric_limits<float>::quiet_NaN(),
+        std::bit_cast<float>(0x7fa00001u), std::bit_cast<float>(0xffc12345u),  // NaNs with payloads
+        std::numeric_limits<float>::denorm_min(), -std::numeric_limits<float>::denorm_min(),
+        std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest(), 1.0f, -1.0f
+    };
+    const uint16_t halfSpecials[] = {
+        0x0000, 0x8000, 0x7c00, 0xfc00, 0x7e00, 0xfe00, 0x7c01, 0xfd55, 0x0001, 0x8001, 0x7bff, 0xfbff, 0x3c00, 0xbc00
+    };
+    constexpr uint32_t width = 9;
+    constexpr uint32_t height = 7;
+    std::vector<uint8_t> plane32(width * height * 4);
+    std::vector<uint8_t> plane16(width * height * 2);
+    for (uint32_t i = 0; i < width * height; ++i) {
+        std::memcpy(plane32.data() + 4 * i, &specials[(i * 5) % std::size(specials)], 4);
+        std::memcpy(plane16.data() + 2 * i, &halfSpecials[(i * 5) % std::size(halfSpecials)], 2);
+    }
+    forEachTier([&] {
+        NEURAL_CHECK(roundTrips(plane32, width, height, ImageElement::Float32));
+        NEURAL_CHECK(roundTrips(plane16, width, height, ImageElement::Float16));
+    });
+}
+
+NEURAL_TEST(ImageCodec, RejectsDamagedInput)
+{
+    constexpr uint32_t width = 37;
+    constexpr uint32_t height = 29;
+    const std::vector<uint8_t> plane = createPlane(width, height, ImageElement::Float32, 1);
+    std::vector<uint8_t> compressed(getMaxCompressedImageSize(width, height, ImageElement::Float32));
+    const size_t size = compressImage(plane.data(), width, height, ImageElement::Float32, compressed.data());
+    std::vector<float> decompressed(width * height);
+    forEachTier([&] {
+        for (const size_t truncated : { size_t(0), size_t(3), size / 2, size - 1 }) {
+            NEURAL_CHECK(!decompressImage(compressed.data(), truncated, width, height, ImageElement::Float32,
+                                          decompressed.data()));
+        }
+        NEURAL_CHECK(!decompressImage(compressed.data(), size + 4, width, height, ImageElement::Float32,
+                                      decompressed.data()));
+        // A block width over the element size
+        std::vector<uint8_t> damaged = compressed;
+        damaged[0] = 33;
+        NEURAL_CHECK(!decompressImage(damaged.data(), size, width, height, ImageElement::Float32, decompressed.data()));
+        // The same bytes as a plane of more blocks
+        std::vector<float> larger(width * height * 2);
+        NEURAL_CHECK(!decompressImage(compressed.data(), size, width, height * 2, ImageElement::Float32,
+                                      larger.data()));
+        NEURAL_CHECK(decompressImage(compressed.data(), size, width, height, ImageElement::Float32,
+                                     decompressed.data()));
+    });
+}
+
+#if NEURAL_ARCH_X64
+NEURAL_TEST(ImageCodec, TiersProduceTheSameStream)
+{
+    if (!isIsaTierSupported(IsaTier::Avx2)) {
+        return;
+    }
+    for (const ImageElement element : k_elements) {
+        for (const auto& size : k_sizes) {
+            const std::vector<uint8_t> plane = createPlane(size[0], size[1], element, 2);
+            const size_t maxSize = getMaxCompressedImageSize(size[0], size[1], element);
+            std::vector<uint8_t> baseline(maxSize);
+            std::vector<uint8_t> avx2(maxSize);
+            const size_t baselineSize = compressImageBaseline(plane.data(), size[0], size[1], element,
+                                                              baseline.data());
+            const size_t avx2Size = compressImageAvx2(plane.data(), size[0], size[1], element, avx2.data());
+            NEURAL_CHECK(baselineSize == avx2Size && std::memcmp(baseline.data(), avx2.data(), avx2Size) == 0);
+
+            // Encoded on AVX2, decoded on the baseline and the other way around
+            std::vector<uint8_t> decompressed(plane.size());
+            NEURAL_CHECK(decompressImageBaseline(avx2.data(), avx2Size, size[0], size[1], element,
+                                                 decompressed.data()) &&
+                         decompressed == plane);
+            std::fill(decompressed.begin(), decompressed.end(), uint8_t(0));
+            NEURAL_CHECK(decompressImageAvx2(baseline.data(), baselineSize, size[0], size[1], element,
+                                             decompressed.data()) &&
+                         decompressed == plane);
+        }
+    }
+}
+#endif
+
+NEURAL_BENCH(ImageCodec, DecodeThroughput)
+{
+    constexpr uint32_t width = 1920;
+    constexpr uint32_t height = 1080;
+    forEachTier([] {
+        for (const ImageElement element : { ImageElement::Float16, ImageElement::Float32 }) {
+            const std::vector<uint8_t> plane = createPlane(width, height, element, 4);
+            std::vector<uint8_t> compressed(getMaxCompressedImageSize(width, height, element));
+            const size_t size = compressImage(plane.data(), width, height, element, compressed.data());
+            std::vector<uint8_t> decompressed(plane.size());
+
+            constexpr int rounds = 20;
+            decompressImage(compressed.data(), size, width, height, element, decompressed.data());
+            const auto start = std::chrono::steady_clock::now();
+            for (int round = 0; round < rounds; ++round) {
+                decompressImage(compressed.data(), size, width, height, element, decompressed.data());
+            }
+            const double seconds = getElapsedSeconds(start);
+            char name[64];
+            std::snprintf(name, sizeof(name), "decode %s, %s, %.2f B/px", getIsaTierName(getIsaTier()),
+                          element == ImageElement::Float16 ? "fp16" : "fp32",
+                          static_cast<double>(size) / (width * height));
+            reportBenchmark(name, plane.size() * rounds / seconds * 1e-9, "GB/s");
+        }
+    });
+}
@@ -0,0 +1,93 @@
+#include "Test.h"
+
+#include <utils/LinearRingAllocator.h>
+
+#include <algorithm>
+#include <random>
+
+using namespace neural::tests;
+using namespace neural::utils;
+
+NEURAL_TEST(LinearRingAllocator, FenceRetirement)
+{
+    constexpr uint64_t invalid = LinearRingAllocator::k_invalidOffset;
+    LinearRingAllocator ring;
+    ring.initialize(1024);
+    NEURAL_CHECK(ring.allocate(400, 1) == 0);
+    ring.finishFrame(1);
+    NEURAL_CHECK(ring.allocate(400, 1) == 400);
+    // Neither the end of the ring nor its start has room while frame 1 is in flight
+    NEURAL_CHECK(ring.allocate(400, 1) == invalid);
+    ring.finishFrame(2);
+
+    ring.retire(0);
+    NEURAL_CHECK(ring.allocate(300, 1) == invalid);
+    ring.retire(1);
+    NEURAL_CHECK(ring.getUsedSize() == 400);
+    // Starts again at 0, the 224 bytes skipped at the end go with this frame
+    NEURAL_CHECK(ring.allocate(300, 1) == 0);
+    NEURAL_CHECK(ring.getUsedSize() == 400 + 224 + 300);
+    ring.finishFrame(3);
+    // Aligned to 512, past the start of frame 2
+    NEURAL_CHECK(ring.allocate(64, 256) == invalid);
+
+    ring.retire(3);
+    NEURAL_CHECK(ring.getUsedSize() == 0);
+    NEURAL_CHECK(ring.allocate(10, 256) == 0);
+    NEURAL_CHECK(ring.allocate(10, 256) == 256);
+    NEURAL_CHECK(ring.getUsedSize() == 266);
+}
+
+// A GPU that completes frames up to four behind the CPU: live allocations never overlap, every one is
+// aligned and inside the ring, and everything is retired once the last fence is reached
+NEURAL_TEST(LinearRingAllocator, SimulatedFence)
+{
+    struct Live {
+        uint64_t offset;
+        uint64_t size;
+        uint64_t fenceValue;
+    };
+    std::mt19937_64 random(1);
+    for (const uint64_t capacity : { 4096ull, 1ull << 20 }) {
+        LinearRingAllocator ring;
+        ring.initialize(capacity);
+        std::vector<Live> live;
+        uint64_t completedFenceValue = 0;
+        uint64_t allocationCount = 0;
+        for (uint64_t fenceValue = 1; fenceValue < 20000; ++fenceValue) {
+            const uint64_t lag = random() % 4;
+            if (fenceValue > lag + 1) {
+                completedFenceValue = std::max(completedFenceValue, fenceValue - lag - 1);
+            }
+            ring.retire(completedFenceValue);
+            std::erase_if(live, [completedFenceValue](const Live& a_live) {
+                return a_live.fenceValue <= completedFenceValue;
+            });
+
+            const int count = static_cast<int>(random() % 8);
+            for (int i = 0; i < count; ++i) {
+                const uint64_t size = random() % (capacity / 16) + 1;
+                const uint64_t alignment = 1ull << (random() % 9);
+                const uint64_t offset = ring.allocate(size, alignment);
+                if (offset == LinearRingAllocator::k_invalidOffset) {
+                    continue;
+                }
+                bool passed = NEURAL_CHECK(offset % alignment == 0 && offset + size <= capacity);
+                for (const Live& other : live) {
+                    passed &= NEURAL_CHECK(offset + size <= other.offset || other.offset + other.size <= offset);
+                }
+                if (!passed) {
+                    return;
+                }
+                live.push_back({ offset, size, fenceValue });
+                ++allocationCount;
+            }
+            NEURAL_CHECK(ring.getUsedSize() <= capacity);
+            ring.finishFrame(fenceValue);
+        }
+        // Most frames find room
+        NEURAL_CHECK(allocationCount > 20000);
+        ring.retire(20000);
+        NEURAL_CHECK(ring.getUsedSize() == 0);
+    }
+}
@@ -0,0 +1,129 @@
+#include "Test.h"
+
+#include <graphics/MeshOptimizer.h>
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+using namespace neural::graphics;
+using namespace neural::tests;
+
+namespace {
+
+using Triangle = std::array<uint32_t, 3>;
+
+// A regular grid of a_size * a_size vertices, the texture coordinate u of a vertex is its index, so
+// vertices can be told apart after they are renumbered. The triangles are shuffled, as exporters that
+// don't optimize for the cache leave them
+struct Grid {
+    std::vector<MeshStorage::Vertex> vertices;
+    std::vector<uint32_t> indices;
+};
+
+Grid createShuffledGrid(uint32_t a_size)
+{
+    Grid grid;
+    for (uint32_t y = 0; y < a_size; ++y) {
+        for (uint32_t x = 0; x < a_size; ++x) {
+            grid.vertices.push_back({
+                .position = { static_cast<float>(x), static_cast<float>(y), 0.0f },
+                .normal = { 0.0f, 0.0f, 1.0f },
+                .textureCoordinates = { static_cast<float>(grid.vertices.size()), 0.0f }
+            });
+        }
+    }
+    std::vector<Triangle> triangles;
+    for (uint32_t y = 0; y + 1 < a_size; ++y) {
+        for (uint32_t x = 0; x + 1 < a_size; ++x) {
+            const uint32_t v = y * a_size + x;
+            triangles.push_back({ v, v + 1, v + a_size });
+            triangles.push_back({ v + 1, v + a_size + 1, v + a_size });
+        }
+    }
+    std::mt19937 random(3);
+    std::shuffle(triangles.begin(), triangles.end(), random);
+    for (const Triangle& triangle : triangles) {
+        grid.indices.insert(grid.indices.end(), triangle.begin(), triangle.end());
+    }
+    return grid;
+}
+
+// The triangles as original vertex indices, rotated so the smallest comes first, which keeps the winding
+std::vector<Triangle> getTriangleSet(const std::vector<MeshStorage::Vertex>& a_vertices,
+                                     const std::vector<uint32_t>& a_indices)
+{
+    std::vector<Triangle> triangles;
+    for (size_t i = 0; i + 2 < a_indices.size(); i += 3) {
+        Triangle triangle;
+        for (uint32_t corner = 0; corner < 3; ++corner) {
+            triangle[corner] = static_cast<uint32_t>(a_vertices[a_indices[i + corner]].textureCoordinates.x);
+        }
+        std::rotate(triangle.begin(), std::min_element(triangle.begin(), triangle.end()), triangle.end());
+        triangles.push_back(triangle);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+}  // anonymous namespace
+
+NEURAL_TEST(MeshOptimizer, AnalyzeVertexCache)
+{
+    const std::vector<uint32_t> triangle = { 0, 1, 2 };
+    const VertexCacheStatistics single = analyzeVertexCache(triangle, 3);
+    NEURAL_CHECK(single.acmr == 3.0f && single.atvr == 1.0f);
+
+    // The repeats hit the cache
+    const std::vector<uint32_t> repeated = { 0, 1, 2, 2, 1, 0, 0, 2, 1 };
+    NEURAL_CHECK(analyzeVertexCache(repeated, 3).acmr == 1.0f);
+
+    // A FIFO of 3: vertex 3 evicts 0, which evicts 1 when it comes back and so on, 7 misses
+    const std::vector<uint32_t> evicting = { 0, 1, 2, 1, 2, 3, 0, 1, 2 };
+    NEURAL_CHECK(analyzeVertexCache(evicting, 4, 3).acmr == 7.0f / 3.0f);
+    NEURAL_CHECK(analyzeVertexCache(evicting, 4, 4).acmr == 4.0f / 3.0f);
+}
+
+NEURAL_TEST(MeshOptimizer, VertexCacheLowersAcmr)
+{
+    Grid grid = createShuffledGrid(48);
+    const VertexCacheStatistics before = analyzeVertexCache(grid.indices, grid.vertices.size());
+    optimizeVertexCache(grid.indices, grid.vertices.size());
+    const VertexCacheStatistics after = analyzeVertexCache(grid.indices, grid.vertices.size());
+    // A shuffled grid misses on nearly every corner, after Tipsify most triangles reuse two cached vertices
+    NEURAL_CHECK(before.acmr > 2.0f);
+    NEURAL_CHECK(after.acmr < 1.0f && after.atvr < before.atvr);
+}
+
+NEURAL_TEST(MeshOptimizer, OptimizeMeshKeepsTriangles)
+{
+    Grid grid = createShuffledGrid(40);
+    // An unused vertex, vertex fetch optimization drops it
+    grid.vertices.push_back({ .position = { -1.0f, -1.0f, 0.0f }, .textureCoordinates = { -1.0f, 0.0f } });
+    const std::vector<Triangle> expected = getTriangleSet(grid.vertices, grid.indices);
+    const float shuffledAcmr = analyzeVertexCache(grid.indices, grid.vertices.size()).acmr;
+
+    optimizeMesh(grid.vertices, grid.indices);
+    NEURAL_CHECK(grid.vertices.size() == 40 * 40);
+    NEURAL_CHECK(getTriangleSet(grid.vertices, grid.indices) == expected);
+    // Overdraw ordering moves whole clusters, so the cache stays close to the optimized order
+    NEURAL_CHECK(analyzeVertexCache(grid.indices, grid.vertices.size()).acmr < shuffledAcmr / 2.0f);
+}
+
+NEURAL_TEST(MeshOptimizer, VertexFetchRenumbersByFirstUse)
+{
+    std::vector<MeshStorage::Vertex> vertices(6);
+    for (uint32_t i = 0; i < vertices.size(); ++i) {
+        vertices[i].textureCoordinates = { static_cast<float>(i), 0.0f };
+    }
+    // Vertex 1 is never used
+    std::vector<uint32_t> indices = { 4, 2, 5, 5, 2, 0, 3, 0, 4 };
+    optimizeVertexFetch(vertices, indices);
+
+    NEURAL_CHECK(indices == std::vector<uint32_t>({ 0, 1, 2, 2, 1, 3, 4, 3, 0 }));
+    if (NEURAL_CHECK(vertices.size() == 5)) {
+        const float expectedOrder[] = { 4.0f, 2.0f, 5.0f, 0.0f, 3.0f };
+        for (uint32_t i = 0; i < 5; ++i) {
+            NEURAL_CHECK(vertices[i].textureCoordinates.x == expectedOrder[i]);
+        }
+    }
+}
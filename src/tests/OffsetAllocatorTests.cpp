@@ -0,0 +1,216 @@
+#include "Test.h"
+
+#include <utils/OffsetAllocator.h>
+
+#include <algorithm>
+#include <map>
+#include <random>
+
+using namespace neural::tests;
+using namespace neural::utils;
+
+namespace {
+
+// Checks the allocation against the live ones in a_ranges (offset -> size) and adds it
+bool addRange(std::map<uint64_t, uint64_t>& a_ranges, const OffsetAllocator& a_allocator,
+              const OffsetAllocator::Allocation& a_allocation, uint64_t a_size, uint64_t a_alignment)
+{
+    const uint64_t size = a_allocator.getAllocationSize(a_allocation);
+    bool passed = NEURAL_CHECK(a_allocation.offset % a_alignment == 0);
+    passed &= NEURAL_CHECK(size >= a_size);
+    passed &= NEURAL_CHECK(a_allocation.offset + size <= a_allocator.getCapacity());
+    const auto next = a_ranges.lower_bound(a_allocation.offset);
+    passed &= NEURAL_CHECK(next == a_ranges.end() || next->first >= a_allocation.offset + size);
+    passed &= NEURAL_CHECK(next == a_ranges.begin() ||
+                           std::prev(next)->first + std::prev(next)->second <= a_allocation.offset);
+    a_ranges[a_allocation.offset] = size;
+    return passed;
+}
+}  // namespace
+
+NEURAL_TEST(OffsetAllocator, RandomOperations)
+{
+    constexpr uint64_t granularity = 4096;
+    OffsetAllocator allocator;
+    allocator.initialize(256ull << 20, granularity);
+    std::mt19937_64 random(1);
+    std::vector<OffsetAllocator::Allocation> allocations;
+    std::map<uint64_t, uint64_t> ranges;
+    for (int i = 0; i < 50000; ++i) {
+        if (allocations.empty() || random() % 100 < 55) {
+            const uint64_t size = random() % 3 == 0 ? random() % (4 << 20) + 1 : random() % (256 << 10) + 1;
+            const uint64_t alignment = random() % 4 == 0 ? 4 << 20 : (random() % 2 ? 65536 : granularity);
+            const OffsetAllocator::Allocation allocation = allocator.allocate(size, alignment);
+            if (allocation.isValid()) {
+                if (!addRange(ranges, allocator, allocation, size, alignment)) {
+                    return;
+                }
+                allocations.push_back(allocation);
+            }
+        } else {
+            const size_t index = random() % allocations.size();
+            allocator.free(allocations[index]);
+            ranges.erase(allocations[index].offset);
+            allocations[index] = allocations.back();
+            allocations.pop_back();
+        }
+    }
+
+    for (const OffsetAllocator::Allocation& allocation : allocations) {
+        allocator.free(allocation);
+    }
+    const OffsetAllocatorStats stats = allocator.getStats();
+    NEURAL_CHECK(allocator.isEmpty());
+    NEURAL_CHECK(stats.freeBlockCount == 1);
+    NEURAL_CHECK(stats.largestFreeBlock == allocator.getCapacity());
+}
+
+// The whole range is one free block again after everything is freed, of the class the request rounds up from
+NEURAL_TEST(OffsetAllocator, WholeRangeAfterFullFree)
+{
+    constexpr uint64_t capacity = 64000;
+    constexpr uint64_t granularity = 64;
+    OffsetAllocator allocator;
+    allocator.initialize(capacity, granularity);
+    std::mt19937 random(7);
+    for (int round = 0; round < 20; ++round) {
+        std::vector<OffsetAllocator::Allocation> allocations;
+        for (;;) {
+            const OffsetAllocator::Allocation allocation = allocator.allocate(random() % 2048 + 1, granularity);
+            if (!allocation.isValid()) {
+                break;
+            }
+            allocations.push_back(allocation);
+        }
+        std::shuffle(allocations.begin(), allocations.end(), random);
+        for (const OffsetAllocator::Allocation& allocation : allocations) {
+            allocator.free(allocation);
+        }
+
+        const OffsetAllocator::Allocation whole = allocator.allocate(capacity, granularity);
+        if (!NEURAL_CHECK(whole.isValid())) {
+            return;
+        }
+        NEURAL_CHECK(whole.offset == 0);
+        NEURAL_CHECK(allocator.getStats().freeBlockCount == 0);
+        allocator.free(whole);
+    }
+}
+
+// DescriptorHeap's range section: descriptor counts at granularity 1, binding tables of a few to tens of
+// descriptors. The DX12 renderer keeps 256, the other capacities aren't size classes of their own
+NEURAL_TEST(OffsetAllocator, DescriptorRangeSection)
+{
+    std::mt19937 random(11);
+    for (const uint64_t capacity : { 256, 250, 1000, 4097 }) {
+        OffsetAllocator allocator;
+        allocator.initialize(capacity, 1);
+        for (int round = 0; round < 10; ++round) {
+            std::vector<OffsetAllocator::Allocation> ranges;
+            for (;;) {
+                const OffsetAllocator::Allocation range = allocator.allocate(random() % 40 + 1, 1);
+                if (!range.isValid()) {
+                    break;
+                }
+                ranges.push_back(range);
+            }
+            std::shuffle(ranges.begin(), ranges.end(), random);
+            for (const OffsetAllocator::Allocation& range : ranges) {
+                allocator.free(range);
+            }
+
+            const OffsetAllocator::Allocation section = allocator.allocate(capacity, 1);
+            if (!NEURAL_CHECK(section.isValid() && section.offset == 0)) {
+                return;
+            }
+            allocator.free(section);
+        }
+    }
+}
+
+// A hole of exactly the requested size, with nothing free in the classes above
+NEURAL_TEST(OffsetAllocator, ExactFitInOwnClass)
+{
+    constexpr uint64_t granularity = 64;
+    OffsetAllocator allocator;
+    allocator.initialize(100 * granularity, granularity);
+    const OffsetAllocator::Allocation first = allocator.allocate(30 * granularity, granularity);
+    const OffsetAllocator::Allocation middle = allocator.allocate(35 * granularity, granularity);
+    const OffsetAllocator::Allocation last = allocator.allocate(35 * granularity, granularity);
+    if (!NEURAL_CHECK(first.isValid() && middle.isValid() && last.isValid())) {
+        return;
+    }
+    allocator.free(middle);
+
+    // A block of 35 units fits 34 of them with any alignment up to 2 units
+    NEURAL_CHECK(!allocator.allocate(35 * granularity, 4 * granularity).isValid());
+    const OffsetAllocator::Allocation aligned = allocator.allocate(34 * granularity, 2 * granularity);
+    if (!NEURAL_CHECK(aligned.isValid())) {
+        return;
+    }
+    NEURAL_CHECK(aligned.offset == 30 * granularity);
+    allocator.free(aligned);
+
+    const OffsetAllocator::Allocation refill = allocator.allocate(35 * granularity, granularity);
+    NEURAL_CHECK(refill.isValid() && refill.offset == middle.offset);
+}
+
+NEURAL_TEST(OffsetAllocator, Alignment)
+{
+    constexpr uint64_t granularity = 256;
+    OffsetAllocator allocator;
+    allocator.initialize(1 << 20, granularity);
+    const OffsetAllocator::Allocation small = allocator.allocate(100, granularity);
+    const OffsetAllocator::Allocation aligned = allocator.allocate(1000, 65536);
+    if (!NEURAL_CHECK(small.isValid() && aligned.isValid())) {
+        return;
+    }
+    NEURAL_CHECK(allocator.getAllocationSize(small) == granularity);
+    NEURAL_CHECK(aligned.offset == 65536);
+    // The padding before the aligned allocation went back to the free lists
+    const OffsetAllocatorStats stats = allocator.getStats();
+    NEURAL_CHECK(stats.usedSize == granularity + 1024);
+    NEURAL_CHECK(stats.freeBlockCount == 2);
+}
+
+// Latency of allocate and free, with GPU heap sizes and alignments
+NEURAL_BENCH(OffsetAllocator, Latency)
+{
+    constexpr int count = 100000;
+    std::mt19937 random(2);
+    std::vector<uint64_t> sizes(1 << 16);
+    for (uint64_t& size : sizes) {
+        size = random() % (1 << 20) + 1;
+    }
+    OffsetAllocator allocator;
+    allocator.initialize(1ull << 40, 4096);
+    std::vector<OffsetAllocator::Allocation> allocations(count);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < count; ++i) {
+        allocations[i] = allocator.allocate(sizes[i & 0xffff], 65536);
+    }
+    reportBenchmark("allocate", getElapsedSeconds(start) * 1e9 / count, "ns");
+    std::shuffle(allocations.begin(), allocations.end(), random);
+    start = std::chrono::steady_clock::now();
+    for (const OffsetAllocator::Allocation& allocation : allocations) {
+        allocator.free(allocation);
+    }
+    reportBenchmark("free in random order", getElapsedSeconds(start) * 1e9 / count, "ns");
+
+    // Steady state: 10K live allocations, each step frees one and allocates another
+    constexpr int liveCount = 10000;
+    constexpr int stepCount = 2000000;
+    allocations.resize(liveCount);
+    for (int i = 0; i < liveCount; ++i) {
+        allocations[i] = allocator.allocate(sizes[i], 65536);
+    }
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < stepCount; ++i) {
+        OffsetAllocator::Allocation& allocation = allocations[static_cast<size_t>(i) * 7919 % liveCount];
+        allocator.free(allocation);
+        allocation = allocator.allocate(sizes[i & 0xffff], (i & 3) ? 65536 : 4096);
+    }
+    reportBenchmark("free + allocate with 10K live", getElapsedSeconds(start) * 1e9 / stepCount, "ns");
+    reportBenchmark("fragmentation", allocator.getStats().getFragmentation() * 100.0, "%");
+}
@@ -0,0 +1,160 @@
+#include "Test.h"
+
+#include <graphics/PipelineCache.h>
+#include <utils/TaskScheduler.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+
+using namespace neural::graphics;
+using namespace neural::tests;
+
+namespace {
+
+struct StubCompiler {
+    std::atomic<uint32_t> compileCount = 0;
+    std::atomic<uint32_t> cachedBlobCount = 0;  // compilations given a blob of an earlier run
+
+    // Pipelines are the shader count, blobs "BLOB" and the shader count. With a_rejectBlobs the cached blob
+    // is treated as stale, as after a driver update
+    PipelineCache::CompileFunction get(bool a_rejectBlobs = false) {
+        return [this, a_rejectBlobs](std::span<const std::vector<char>> a_shaders, std::span<const char> a_cachedBlob) {
+            ++compileCount;
+            PipelineCache::CompileResult result;
+            result.pipeline = std::make_shared<size_t>(a_shaders.size());
+            if (!a_cachedBlob.empty()) {
+                ++cachedBlobCount;
+            }
+            if (a_cachedBlob.empty() || a_rejectBlobs) {
+                result.blob = { 'B', 'L', 'O', 'B', static_cast<char>('0' + a_shaders.size()) };
+            }
+            return result;
+        };
+    }
+};
+
+std::filesystem::path createTestDirectory()
+{
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "neural_tests_pipeline_cache";
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    return directory;
+}
+
+void writeFile(const std::filesystem::path& a_path, std::string_view a_content)
+{
+    std::ofstream(a_path, std::ios::binary).write(a_content.data(), static_cast<std::streamsize>(a_content.size()));
+}
+
+std::vector<char> toBytes(std::string_view a_content)
+{
+    return { a_content.begin(), a_content.end() };
+}
+}  // namespace
+
+NEURAL_TEST(PipelineCache, Keys)
+{
+    const std::vector<std::vector<char>> shaders = { toBytes("vertexA"), toBytes("pixelA") };
+    const std::vector<std::vector<char>> changedShader = { toBytes("vertexA"), toBytes("pixelB") };
+    const std::vector<std::vector<char>> swappedShaders = { toBytes("pixelA"), toBytes("vertexA") };
+    const std::string key = PipelineCache::getKey(shaders, "state");
+    NEURAL_CHECK(key == PipelineCache::getKey(shaders, "state"));
+    NEURAL_CHECK(key != PipelineCache::getKey(shaders, "state2"));
+    NEURAL_CHECK(key != PipelineCache::getKey(changedShader, "state"));
+    NEURAL_CHECK(key != PipelineCache::getKey(swappedShaders, "state"));
+
+    std::string state;
+    appendPipelineState(state, uint32_t{ 7 });
+    appendPipelineState(state, 1.5f);
+    NEURAL_CHECK(state.size() == 8);
+}
+
+NEURAL_TEST(PipelineCache, Blobs)
+{
+    const std::filesystem::path directory = createTestDirectory();
+    PipelineCache cache;
+    cache.initialize((directory / "cache").string());
+    const std::string key = PipelineCache::getKey(std::vector<std::vector<char>>{ toBytes("shader") }, "state");
+    std::vector<char> blob;
+    NEURAL_CHECK(!cache.readBlob(key, blob));
+    NEURAL_CHECK(cache.writeBlob(key, toBytes("compiled")));
+    NEURAL_CHECK(cache.readBlob(key, blob) && blob == toBytes("compiled"));
+    // Keys are files of their own
+    const std::string otherKey = PipelineCache::getKey(std::vector<std::vector<char>>{ toBytes("shader") }, "other");
+    NEURAL_CHECK(!cache.readBlob(otherKey, blob));
+    std::filesystem::remove_all(directory);
+}
+
+// Two runs over the same cache directory, with the stub compiler on the scheduler's workers
+NEURAL_TEST(PipelineCache, HitsAndMisses)
+{
+    neural::utils::getTaskScheduler().initialize({ .threadCount = 3 });
+    const std::filesystem::path directory = createTestDirectory();
+    const std::string vertex = (directory / "a.vs").string();
+    const std::string pixelA = (directory / "a.ps").string();
+    const std::string pixelB = (directory / "b.ps").string();
+    writeFile(vertex, "vertexA");
+    writeFile(pixelA, "pixelA");
+    writeFile(pixelB, "pixelB");
+
+    {
+        StubCompiler compiler;
+        PipelineCache cache;
+        cache.initialize((directory / "cache").string());
+        const PipelineCache::Handle first = cache.request({ vertex, pixelA }, "state1", compiler.get());
+        const PipelineCache::Handle otherShader = cache.request({ vertex, pixelB }, "state1", compiler.get());
+        const PipelineCache::Handle otherState = cache.request({ vertex, pixelA }, "state2", compiler.get());
+        const PipelineCache::Handle missing = cache.request({ vertex, (directory / "missing.ps").string() }, "state1",
+                                                            compiler.get());
+        const PipelineCache::Pipeline firstPipeline = cache.wait(first);
+        NEURAL_CHECK(firstPipeline != nullptr);
+        NEURAL_CHECK(cache.wait(otherShader) != nullptr && cache.wait(otherShader) != firstPipeline);
+        NEURAL_CHECK(cache.wait(otherState) != nullptr && cache.wait(otherState) != firstPipeline);
+        NEURAL_CHECK(cache.wait(missing) == nullptr);
+        NEURAL_CHECK(cache.isReady(first));
+
+        const PipelineCache::Handle again = cache.request({ vertex, pixelA }, "state1", compiler.get());
+        NEURAL_CHECK(cache.wait(again) == firstPipeline);
+
+        const PipelineCacheStats stats = cache.getStats();
+        NEURAL_CHECK(stats.requests == 5);
+        NEURAL_CHECK(stats.memoryHits == 1);
+        NEURAL_CHECK(stats.diskHits == 0);
+        NEURAL_CHECK(stats.misses == 3);
+        NEURAL_CHECK(stats.failures == 1);
+        NEURAL_CHECK(compiler.compileCount == 3 && compiler.cachedBlobCount == 0);
+    }
+
+    {
+        StubCompiler compiler;
+        PipelineCache cache;
+        cache.initialize((directory / "cache").string());
+        const PipelineCache::Handle cached = cache.request({ vertex, pixelA }, "state1", compiler.get());
+        cache.wait(cached);
+        // A rebuilt shader has a key of its own
+        writeFile(pixelB, "pixelB2");
+        const PipelineCache::Handle rebuilt = cache.request({ vertex, pixelB }, "state1", compiler.get());
+        const PipelineCache::Handle stale = cache.request({ vertex, pixelA }, "state2", compiler.get(true));
+        NEURAL_CHECK(cache.wait(rebuilt) != nullptr);
+        NEURAL_CHECK(cache.wait(stale) != nullptr);
+
+        const PipelineCacheStats stats = cache.getStats();
+        NEURAL_CHECK(stats.requests == 3);
+        NEURAL_CHECK(stats.memoryHits == 0);
+        NEURAL_CHECK(stats.diskHits == 1);
+        NEURAL_CHECK(stats.misses == 2);
+        NEURAL_CHECK(stats.failures == 0);
+        NEURAL_CHECK(compiler.compileCount == 3 && compiler.cachedBlobCount == 2);
+
+        // One file per key, no temporary file left behind
+        uint32_t fileCount = 0;
+        for (const auto& entry : std::filesystem::directory_iterator(directory / "cache")) {
+            NEURAL_CHECK(entry.path().extension() == ".pso");
+            ++fileCount;
+        }
+        NEURAL_CHECK(fileCount == 4);
+    }
+    std::filesystem::remove_all(directory);
+    neural::utils::getTaskScheduler().shutdown();
+}
@@ -0,0 +1,165 @@
+#include "Test.h"
+
+#include <graphics/NullRenderGraphBackend.h>
+#include <graphics/RenderGraph.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace neural::graphics;
+using namespace neural::tests;
+
+namespace {
+
+using State = RenderGraphState;
+
+constexpr RenderGraphResourceDesc k_targetDesc = { .width = 1280, .height = 720 };
+
+bool isBarrier(const NullRenderGraphBackend::RecordedBarrier& a_recorded, RenderGraphBarrierType a_type,
+               std::string_view a_resource, State a_before = State::Common, State a_after = State::Common)
+{
+    return a_recorded.barrier.type == a_type && a_recorded.resourceName == a_resource &&
+           (a_type != RenderGraphBarrierType::Transition ||
+            (a_recorded.barrier.before == a_before && a_recorded.barrier.after == a_after));
+}
+
+const RenderGraphPlacement* findPlacement(const RenderGraph& a_graph, const NullRenderGraphBackend& a_backend,
+                                          std::string_view a_name)
+{
+    for (const RenderGraphPlacement& placement : a_backend.getPlacements()) {
+        if (a_graph.getResourceName(placement.resource) == a_name) {
+            return &placement;
+        }
+    }
+    return nullptr;
+}
+}  // namespace
+
+NEURAL_TEST(RenderGraph, PassCulling)
+{
+    int backBuffer = 0;
+    RenderGraph graph;
+    NullRenderGraphBackend backend;
+    const RenderGraphResource screen = graph.importResource("screen", &backBuffer, State::Present, State::Present);
+    const RenderGraphResource color = graph.createResource("color", k_targetDesc);
+    const RenderGraphResource unusedInput = graph.createResource("unusedInput", k_targetDesc);
+    const RenderGraphResource unusedOutput = graph.createResource("unusedOutput", k_targetDesc);
+    const RenderGraphResource statistics = graph.createResource("statistics", k_targetDesc);
+
+    std::vector<std::string> executed;
+    const auto record = [&executed](const char* a_pass) {
+        return [&executed, a_pass] { executed.push_back(a_pass); };
+    };
+    graph.addPass("scene", { { color, State::RenderTarget } }, record("scene"));
+    // Only read by a culled pass, culled in turn
+    graph.addPass("unusedProducer", { { unusedInput, State::RenderTarget } }, record("unusedProducer"));
+    graph.addPass("unusedConsumer", { { unusedInput, State::ShaderResource }, { unusedOutput, State::RenderTarget } },
+                  record("unusedConsumer"));
+    graph.addPass("statistics", { { color, State::ShaderResource }, { statistics, State::UnorderedAccess } },
+                  record("statistics"), true);
+    graph.addPass("present", { { color, State::ShaderResource }, { screen, State::RenderTarget } }, record("present"));
+    graph.compile(backend);
+    graph.execute(backend);
+
+    NEURAL_CHECK(!graph.isPassCulled("scene"));
+    NEURAL_CHECK(graph.isPassCulled("unusedProducer"));
+    NEURAL_CHECK(graph.isPassCulled("unusedConsumer"));
+    NEURAL_CHECK(!graph.isPassCulled("statistics"));
+    NEURAL_CHECK(!graph.isPassCulled("present"));
+    NEURAL_CHECK((executed == std::vector<std::string>{ "scene", "statistics", "present" }));
+    // The culled passes' resources are not placed
+    NEURAL_CHECK(backend.getPlacements().size() == 2);
+    NEURAL_CHECK(findPlacement(graph, backend, "unusedInput") == nullptr);
+}
+
+NEURAL_TEST(RenderGraph, BarrierPlacement)
+{
+    int backBuffer = 0;
+    RenderGraph graph;
+    NullRenderGraphBackend backend;
+    const RenderGraphResource screen = graph.importResource("screen", &backBuffer, State::Present, State::Present);
+    const RenderGraphResource gbuffer = graph.createResource("gbuffer", k_targetDesc);
+    const RenderGraphResource blurred = graph.createResource("blurred", k_targetDesc);
+    graph.addPass("scene", { { screen, State::RenderTarget }, { gbuffer, State::RenderTarget } }, [] {});
+    graph.addPass("blur", { { gbuffer, State::ShaderResource }, { blurred, State::RenderTarget } }, [] {});
+    graph.addPass("compose", { { gbuffer, State::CopySource }, { blurred, State::ShaderResource },
+                               { screen, State::RenderTarget } }, [] {});
+    graph.addPass("simulate", { { blurred, State::UnorderedAccess } }, [] {}, true);
+    graph.addPass("resolve", { { blurred, State::UnorderedAccess } }, [] {}, true);
+    graph.compile(backend);
+    graph.execute(backend);
+
+    using Type = RenderGraphBarrierType;
+    const std::vector<NullRenderGraphBackend::RecordedBarrier>& barriers = backend.getBarriers();
+    if (!NEURAL_CHECK(barriers.size() == 8)) {
+        return;
+    }
+    // screen stays a render target from scene to compose. The two reads of gbuffer are merged
+    NEURAL_CHECK(isBarrier(barriers[0], Type::Transition, "screen", State::Present, State::RenderTarget));
+    NEURAL_CHECK(isBarrier(barriers[1], Type::Transition, "gbuffer", State::RenderTarget,
+                           State::ShaderResource | State::CopySource));
+    NEURAL_CHECK(isBarrier(barriers[2], Type::Transition, "blurred", State::RenderTarget, State::ShaderResource));
+    NEURAL_CHECK(isBarrier(barriers[3], Type::Transition, "blurred", State::ShaderResource,
+                           State::UnorderedAccess));
+    NEURAL_CHECK(isBarrier(barriers[4], Type::UnorderedAccess, "blurred"));
+    // Back to the final state of the imported resource and the initial states of the transient ones
+    NEURAL_CHECK(isBarrier(barriers[5], Type::Transition, "screen", State::RenderTarget, State::Present));
+    NEURAL_CHECK(std::any_of(barriers.begin() + 5, barriers.end(), [](const auto& a_barrier) {
+        return isBarrier(a_barrier, Type::Transition, "gbuffer", State::ShaderResource | State::CopySource,
+                         State::RenderTarget);
+    }));
+    NEURAL_CHECK(std::any_of(barriers.begin() + 5, barriers.end(), [](const auto& a_barrier) {
+        return isBarrier(a_barrier, Type::Transition, "blurred", State::UnorderedAccess, State::RenderTarget);
+    }));
+    NEURAL_CHECK(graph.getBarrierCount() == barriers.size());
+
+    // The compiled graph replays the same barriers the next frame
+    backend.clear();
+    graph.execute(backend);
+    NEURAL_CHECK(backend.getBarriers().size() == barriers.size());
+}
+
+// a -> b -> c -> screen: a and c never live at the same time and share memory, b overlaps both
+NEURAL_TEST(RenderGraph, TransientAliasing)
+{
+    int backBuffer = 0;
+    RenderGraph graph;
+    NullRenderGraphBackend backend;
+    const RenderGraphResource screen = graph.importResource("screen", &backBuffer, State::Present, State::Present);
+    const RenderGraphResource a = graph.createResource("a", k_targetDesc);
+    const RenderGraphResource b = graph.createResource("b", k_targetDesc);
+    const RenderGraphResource c = graph.createResource("c", k_targetDesc);
+    graph.addPass("writeA", { { a, State::RenderTarget } }, [] {});
+    graph.addPass("aToB", { { a, State::ShaderResource }, { b, State::RenderTarget } }, [] {});
+    graph.addPass("bToC", { { b, State::ShaderResource }, { c, State::RenderTarget } }, [] {});
+    graph.addPass("cToScreen", { { c, State::ShaderResource }, { screen, State::RenderTarget } }, [] {});
+    graph.compile(backend);
+    graph.execute(backend);
+
+    const RenderGraphPlacement* placementA = findPlacement(graph, backend, "a");
+    const RenderGraphPlacement* placementB = findPlacement(graph, backend, "b");
+    const RenderGraphPlacement* placementC = findPlacement(graph, backend, "c");
+    if (!NEURAL_CHECK(placementA && placementB && placementC)) {
+        return;
+    }
+    const uint64_t size = placementA->size;
+    NEURAL_CHECK(placementA->offset == placementC->offset);
+    NEURAL_CHECK(placementB->offset + size <= placementA->offset || placementA->offset + size <= placementB->offset);
+    NEURAL_CHECK(placementA->offset % NullRenderGraphBackend::k_alignment == 0);
+    NEURAL_CHECK(placementB->offset % NullRenderGraphBackend::k_alignment == 0);
+    NEURAL_CHECK(graph.getUnaliasedMemorySize() == 3 * size);
+    NEURAL_CHECK(graph.getTransientMemorySize() == 2 * size);
+    NEURAL_CHECK(backend.getMemorySize() == 2 * size);
+
+    // a and c take over the shared memory on their first use, b has memory of its own
+    const auto hasAliasingBarrier = [&backend](std::string_view a_resource) {
+        const std::vector<NullRenderGraphBackend::RecordedBarrier>& barriers = backend.getBarriers();
+        return std::any_of(barriers.begin(), barriers.end(), [a_resource](const auto& a_barrier) {
+            return isBarrier(a_barrier, RenderGraphBarrierType::Aliasing, a_resource);
+        });
+    };
+    NEURAL_CHECK(hasAliasingBarrier("a"));
+    NEURAL_CHECK(!hasAliasingBarrier("b"));
+    NEURAL_CHECK(hasAliasingBarrier("c"));
+}
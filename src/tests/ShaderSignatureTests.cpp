@@ -0,0 +1,171 @@
+#include "Test.h"
+
+#include <graphics/ShaderSignature.h>
+
+#include <algorithm>
+#include <cstring>
+
+using namespace neural::graphics;
+using namespace neural::tests;
+
+namespace {
+
+struct Input {
+    const char* name;
+    uint32_t index;
+    uint32_t systemValue;
+    uint8_t readMask;
+};
+
+// The inputs of the scene vertex shaders, SV_VertexID as a system value to skip
+constexpr Input k_sceneInputs[] = {
+    { "POSITION", 0, 0, 0x7 }, { "NORMAL", 0, 0, 0x7 }, { "WORLD", 0, 0, 0xf }, { "WORLD", 1, 0, 0xf },
+    { "WORLD", 2, 0, 0xf }, { "SV_VertexID", 0, 6, 0x1 }
+};
+
+constexpr InputLayoutElement k_sceneLayout[] = {
+    { "POSITION", 0, false }, { "NORMAL", 0, false }, { "WORLD", 0, true }, { "WORLD", 1, true },
+    { "WORLD", 2, true }
+};
+
+void writeUint32(std::vector<char>& a_data, size_t a_offset, uint32_t a_value)
+{
+    std::memcpy(a_data.data() + a_offset, &a_value, 4);
+}
+
+// A signature chunk as fxc (ISGN) or dxc (ISG1) writes it: the elements, then the names
+std::vector<char> createSignatureChunk(std::span<const Input> a_inputs, bool a_isg1)
+{
+    const uint32_t elementSize = a_isg1 ? 32 : 24;
+    std::vector<char> data(8 + a_inputs.size() * elementSize, 0);
+    writeUint32(data, 0, static_cast<uint32_t>(a_inputs.size()));
+    writeUint32(data, 4, 8);
+    for (size_t i = 0; i < a_inputs.size(); ++i) {
+        const size_t element = 8 + i * elementSize + (a_isg1 ? 4 : 0);
+        writeUint32(data, element, static_cast<uint32_t>(data.size()));
+        writeUint32(data, element + 4, a_inputs[i].index);
+        writeUint32(data, element + 8, a_inputs[i].systemValue);
+        writeUint32(data, element + 12, 3);  // float
+        writeUint32(data, element + 16, static_cast<uint32_t>(i));
+        data[element + 20] = 0xf;
+        data[element + 21] = static_cast<char>(a_inputs[i].readMask);
+        data.insert(data.end(), a_inputs[i].name, a_inputs[i].name + std::strlen(a_inputs[i].name) + 1);
+    }
+    return data;
+}
+
+// A container of a_chunks after a chunk the reader has to skip, like the RDEF chunk of real shaders
+std::vector<char> createContainer(const std::vector<std::pair<const char*, std::vector<char>>>& a_chunks)
+{
+    std::vector<std::pair<const char*, std::vector<char>>> chunks = { { "RDEF", std::vector<char>(20, 0) } };
+    chunks.insert(chunks.end(), a_chunks.begin(), a_chunks.end());
+    // The checksum stays zero
+    std::vector<char> container(32 + chunks.size() * 4, 0);
+    std::memcpy(container.data(), "DXBC", 4);
+    writeUint32(container, 20, 1);
+    writeUint32(container, 28, static_cast<uint32_t>(chunks.size()));
+    for (size_t i = 0; i < chunks.size(); ++i) {
+        const size_t offset = container.size();
+        writeUint32(container, 32 + i * 4, static_cast<uint32_t>(offset));
+        container.resize(offset + 8 + chunks[i].second.size());
+        std::memcpy(container.data() + offset, chunks[i].first, 4);
+        writeUint32(container, offset + 4, static_cast<uint32_t>(chunks[i].second.size()));
+        std::copy(chunks[i].second.begin(), chunks[i].second.end(), container.begin() + offset + 8);
+    }
+    writeUint32(container, 24, static_cast<uint32_t>(container.size()));
+    return container;
+}
+
+std::string checkSceneLayout(std::span<const Input> a_inputs)
+{
+    std::vector<ShaderSignatureElement> signature;
+    if (!readInputSignature(createContainer({ { "ISGN", createSignatureChunk(a_inputs, false) } }), signature)) {
+        return "unreadable";
+    }
+    return checkInputLayout(signature, k_sceneLayout);
+}
+}  // anonymous namespace
+
+NEURAL_TEST(ShaderSignature, ReadsIsgnAndIsg1)
+{
+    for (const bool isg1 : { false, true }) {
+        const std::vector<char> container = createContainer({
+            { isg1 ? "ISG1" : "ISGN", createSignatureChunk(k_sceneInputs, isg1) }
+        });
+        std::vector<ShaderSignatureElement> signature;
+        if (!NEURAL_CHECK(readInputSignature(container, signature) && signature.size() == std::size(k_sceneInputs))) {
+            continue;
+        }
+        for (size_t i = 0; i < signature.size(); ++i) {
+            NEURAL_CHECK(signature[i].semanticName == k_sceneInputs[i].name &&
+                         signature[i].semanticIndex == k_sceneInputs[i].index &&
+                         signature[i].systemValue == k_sceneInputs[i].systemValue &&
+                         signature[i].registerIndex == i && signature[i].mask == 0xf &&
+                         signature[i].readMask == k_sceneInputs[i].readMask);
+        }
+    }
+}
+
+NEURAL_TEST(ShaderSignature, RejectsDamagedContainers)
+{
+    const std::vector<char> container = createContainer({ { "ISGN", createSignatureChunk(k_sceneInputs, false) } });
+    std::vector<ShaderSignatureElement> signature;
+    NEURAL_CHECK(readInputSignature(container, signature));
+
+    // Truncated, then a wrong magic
+    for (const size_t size : { size_t(0), size_t(16), size_t(40), container.size() - 1 }) {
+        NEURAL_CHECK(!readInputSignature(std::span(container.data(), size), signature));
+    }
+    std::vector<char> damaged = container;
+    damaged[0] = 'X';
+    NEURAL_CHECK(!readInputSignature(damaged, signature));
+
+    // The signature chunk is after the header, the two chunk offsets and the RDEF chunk
+    const size_t chunk = 32 + 2 * 4 + 8 + 20;
+    // A chunk offset and a chunk size past the end
+    damaged = container;
+    writeUint32(damaged, 36, static_cast<uint32_t>(damaged.size() - 4));
+    NEURAL_CHECK(!readInputSignature(damaged, signature));
+    damaged = container;
+    writeUint32(damaged, chunk + 4, static_cast<uint32_t>(damaged.size()));
+    NEURAL_CHECK(!readInputSignature(damaged, signature));
+
+    // More elements than fit and a name without its terminator
+    damaged = container;
+    writeUint32(damaged, chunk + 8, 1000);
+    NEURAL_CHECK(!readInputSignature(damaged, signature));
+    damaged = container;
+    damaged.back() = 'D';
+    NEURAL_CHECK(!readInputSignature(damaged, signature));
+
+    // No input signature at all
+    NEURAL_CHECK(!readInputSignature(createContainer({ { "OSGN", createSignatureChunk(k_sceneInputs, false) } }),
+                                     signature));
+}
+
+NEURAL_TEST(ShaderSignature, ChecksInputLayout)
+{
+    NEURAL_CHECK(checkSceneLayout(k_sceneInputs).empty());
+
+    // Semantic names don't depend on the case
+    Input inputs[std::size(k_sceneInputs)];
+    std::copy(std::begin(k_sceneInputs), std::end(k_sceneInputs), inputs);
+    inputs[1].name = "Normal";
+    NEURAL_CHECK(checkSceneLayout(inputs).empty());
+
+    // An input the layout doesn't have
+    inputs[1].name = "TEXCOORD";
+    NEURAL_CHECK(checkSceneLayout(inputs) == "the shader takes TEXCOORD0, the input layout has no such element\n");
+
+    // A shader that declares the instance transform but ignores a column of it, and one without the column
+    std::copy(std::begin(k_sceneInputs), std::end(k_sceneInputs), inputs);
+    inputs[3].readMask = 0;
+    NEURAL_CHECK(checkSceneLayout(inputs) == "the per-instance element WORLD1 isn't read by the shader\n");
+    NEURAL_CHECK(checkSceneLayout(std::span(k_sceneInputs).first(4)) ==
+                 "the per-instance element WORLD2 isn't read by the shader\n");
+
+    // Unread per-vertex elements are fine, the layout is shared by shaders that read less
+    std::copy(std::begin(k_sceneInputs), std::end(k_sceneInputs), inputs);
+    inputs[1].readMask = 0;
+    NEURAL_CHECK(checkSceneLayout(inputs).empty());
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+// The checks and benchmarks of neural_tests. A test or benchmark is a function registered under a suite with
+// NEURAL_TEST / NEURAL_BENCH, ctest runs every suite's tests and the benchmarks are run by hand with --bench
+namespace neural::tests {
+
+struct TestCase {
+    const char* suite;
+    const char* name;
+    void (*function)();
+    bool isBenchmark;
+};
+
+std::vector<TestCase>& getTestCases();
+
+struct TestRegistration {
+    TestRegistration(const char* a_suite, const char* a_name, void (*a_function)(), bool a_isBenchmark) {
+        getTestCases().push_back({ a_suite, a_name, a_function, a_isBenchmark });
+    }
+};
+
+// Records a failure and carries on, returns a_passed so the caller can stop when the rest depends on it
+bool check(bool a_passed, const char* a_expression, const char* a_file, int a_line);
+
+// Seconds since a_start
+inline double getElapsedSeconds(std::chrono::steady_clock::time_point a_start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - a_start).count();
+}
+
+inline void reportBenchmark(const char* a_name, double a_value, const char* a_unit)
+{
+    std::printf("  %-48s %12.1f %s\n", a_name, a_value, a_unit);
+}
+}  // namespace neural::tests
+
+#define NEURAL_TEST_FUNCTION(suite, name) test_##suite##_##name
+#define NEURAL_REGISTER(suite, name, isBenchmark)                                                                 \
+    static void NEURAL_TEST_FUNCTION(suite, name)();                                                              \
+    static const neural::tests::TestRegistration g_registration_##suite##_##name(#suite, #name,                    \
+                                                                                 NEURAL_TEST_FUNCTION(suite, name), \
+                                                                                 isBenchmark);                     \
+    static void NEURAL_TEST_FUNCTION(suite, name)()
+#define NEURAL_TEST(suite, name) NEURAL_REGISTER(suite, name, false)
+#define NEURAL_BENCH(suite, name) NEURAL_REGISTER(suite, name, true)
+#define NEURAL_CHECK(expression) neural::tests::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
@@ -0,0 +1,57 @@
+#include "Test.h"
+
+#include <cstring>
+#include <string_view>
+
+namespace neural::tests {
+
+static int g_failureCount = 0;
+
+std::vector<TestCase>& getTestCases()
+{
+    static std::vector<TestCase> testCases;
+    return testCases;
+}
+
+bool check(bool a_passed, const char* a_expression, const char* a_file, int a_line)
+{
+    if (!a_passed) {
+        std::printf("  %s:%d: failed %s\n", a_file, a_line, a_expression);
+        ++g_failureCount;
+    }
+    return a_passed;
+}
+}  // namespace neural::tests
+
+// neural_tests [--bench] [suite]: runs the tests, or the benchmarks with --bench, of every suite or of one.
+// Fails if a check failed
+int main(int argc, char** argv)
+{
+    using namespace neural::tests;
+    bool benchmarks = false;
+    std::string_view suite;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bench") == 0) {
+            benchmarks = true;
+        } else {
+            suite = argv[i];
+        }
+    }
+
+    int runCount = 0;
+    for (const TestCase& testCase : getTestCases()) {
+        if (testCase.isBenchmark != benchmarks || (!suite.empty() && suite != testCase.suite)) {
+            continue;
+        }
+        const int failureCount = g_failureCount;
+        std::printf("%s.%s\n", testCase.suite, testCase.name);
+        std::fflush(stdout);
+        testCase.function();
+        if (g_failureCount > failureCount) {
+            std::printf("  FAILED\n");
+        }
+        ++runCount;
+    }
+    std::printf("%d run, %d checks failed\n", runCount, g_failureCount);
+    return runCount > 0 && g_failureCount == 0 ? 0 : 1;
+}
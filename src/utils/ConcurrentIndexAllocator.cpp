@@ -0,0 +1,177 @@
+#include "ConcurrentIndexAllocator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <thread>
+#include <vector>
+
+namespace neural::utils {
+
+namespace {
+uint32_t getThreadIndex()
+{
+    static std::atomic<uint32_t> s_threadCount = 0;
+    thread_local const uint32_t t_threadIndex = s_threadCount.fetch_add(1, std::memory_order_relaxed);
+    return t_threadIndex;
+}
+}  // anonymous namespace
+
+void ConcurrentIndexAllocator::initialize(uint32_t a_capacity, uint32_t a_frameCount)
+{
+    assert(a_capacity > 0 && a_capacity != k_invalidIndex);
+    m_capacity = a_capacity;
+    // The caches hold a quarter of the indices at most
+    m_magazineSize = std::clamp(a_capacity / (8 * k_cacheCount), 1u, k_maxMagazineSize);
+    m_next = std::make_unique<uint32_t[]>(a_capacity);
+    m_nextMagazine = std::make_unique<std::atomic<uint32_t>[]>(a_capacity);
+    m_head.store(k_invalidIndex, std::memory_order_relaxed);
+    m_caches = std::make_unique<Cache[]>(k_cacheCount);
+
+    // Pushed from the end, so the low indices are allocated first
+    std::vector<uint32_t> indices(a_capacity);
+    for (uint32_t i = 0; i < a_capacity; ++i) {
+        indices[i] = i;
+    }
+    for (uint32_t end = a_capacity; end > 0;) {
+        const uint32_t begin = end - std::min(end, m_magazineSize);
+        pushMagazine(&indices[begin], end - begin);
+        end = begin;
+    }
+
+    m_frameCount = a_frameCount;
+    m_deferred = std::make_unique<std::atomic<uint32_t>[]>(a_frameCount);
+    for (uint32_t i = 0; i < a_frameCount; ++i) {
+        m_deferred[i].store(k_invalidIndex, std::memory_order_relaxed);
+    }
+}
+
+uint32_t ConcurrentIndexAllocator::allocate()
+{
+    if (Cache* cache = tryLockCache()) {
+        if (cache->count == 0) {
+            for (uint32_t index = popMagazine(); index != k_invalidIndex; index = m_next[index]) {
+                cache->indices[cache->count++] = index;
+            }
+        }
+        if (cache->count > 0) {
+            const uint32_t index = cache->indices[--cache->count];
+            cache->busy.store(false, std::memory_order_release);
+            return index;
+        }
+        cache->busy.store(false, std::memory_order_release);
+    }
+    uint32_t index = popMagazine();
+    if (index == k_invalidIndex) {
+        gatherCaches();
+        index = popMagazine();
+        if (index == k_invalidIndex) {
+            return k_invalidIndex;
+        }
+    }
+    if (m_next[index] != k_invalidIndex) {
+        pushMagazine(m_next[index]);
+    }
+    return index;
+}
+
+void ConcurrentIndexAllocator::free(uint32_t a_index)
+{
+    assert(a_index < m_capacity);
+    Cache* cache = tryLockCache();
+    if (cache == nullptr) {
+        m_next[a_index] = k_invalidIndex;
+        pushMagazine(a_index);
+        return;
+    }
+    if (cache->count == 2 * m_magazineSize) {
+        cache->count -= m_magazineSize;
+        pushMagazine(&cache->indices[cache->count], m_magazineSize);
+    }
+    cache->indices[cache->count++] = a_index;
+    cache->busy.store(false, std::memory_order_release);
+}
+
+void ConcurrentIndexAllocator::deferredFree(uint32_t a_index, uint32_t a_frame)
+{
+    assert(a_index < m_capacity);
+    assert(a_frame < m_frameCount);
+    uint32_t head = m_deferred[a_frame].load(std::memory_order_relaxed);
+    do {
+        m_next[a_index] = head;
+    } while (!m_deferred[a_frame].compare_exchange_weak(head, a_index, std::memory_order_release,
+                                                        std::memory_order_relaxed));
+}
+
+void ConcurrentIndexAllocator::releaseDeferred(uint32_t a_frame)
+{
+    assert(a_frame < m_frameCount);
+    uint32_t index = m_deferred[a_frame].exchange(k_invalidIndex, std::memory_order_acquire);
+    while (index != k_invalidIndex) {
+        const uint32_t next = m_next[index];
+        free(index);
+        index = next;
+    }
+}
+
+void ConcurrentIndexAllocator::pushMagazine(const uint32_t* a_indices, uint32_t a_count)
+{
+    assert(a_count > 0 && a_count <= m_magazineSize);
+    for (uint32_t i = 0; i + 1 < a_count; ++i) {
+        m_next[a_indices[i]] = a_indices[i + 1];
+    }
+    m_next[a_indices[a_count - 1]] = k_invalidIndex;
+    pushMagazine(a_indices[0]);
+}
+
+void ConcurrentIndexAllocator::pushMagazine(uint32_t a_first)
+{
+    uint64_t head = m_head.load(std::memory_order_relaxed);
+    uint64_t newHead;
+    do {
+        m_nextMagazine[a_first].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+        newHead = ((head >> 32) + 1) << 32 | a_first;
+    } while (!m_head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+}
+
+uint32_t ConcurrentIndexAllocator::popMagazine()
+{
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    while (true) {
+        const uint32_t first = static_cast<uint32_t>(head);
+        if (first == k_invalidIndex) {
+            return k_invalidIndex;
+        }
+        // May be stale if another thread pops first, the tag of the head makes the exchange fail then
+        const uint32_t next = m_nextMagazine[first].load(std::memory_order_relaxed);
+        const uint64_t newHead = ((head >> 32) + 1) << 32 | next;
+        if (m_head.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire)) {
+            return first;
+        }
+    }
+}
+
+void ConcurrentIndexAllocator::gatherCaches()
+{
+    for (uint32_t i = 0; i < k_cacheCount; ++i) {
+        Cache& cache = m_caches[i];
+        // Owners hold their cache for a few instructions only
+        while (cache.busy.exchange(true, std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+        for (uint32_t begin = 0; begin < cache.count; begin += m_magazineSize) {
+            pushMagazine(&cache.indices[begin], std::min(m_magazineSize, cache.count - begin));
+        }
+        cache.count = 0;
+        cache.busy.store(false, std::memory_order_release);
+    }
+}
+
+ConcurrentIndexAllocator::Cache* ConcurrentIndexAllocator::tryLockCache()
+{
+    Cache& cache = m_caches[getThreadIndex() % k_cacheCount];
+    if (cache.busy.load(std::memory_order_relaxed) || cache.busy.exchange(true, std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &cache;
+}
+}  // namespace neural::utils
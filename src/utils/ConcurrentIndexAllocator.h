@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+namespace neural::utils {
+
+// Thread-safe allocator of indices in [0, capacity), for descriptor slots and other fixed tables. Free indices
+// live in a global lock-free stack of magazines, chains of up to getMagazineSize() indices taken or given back
+// with one CAS. Every thread works on a cache of its own in front of it: allocate and free only touch the
+// cache until it runs empty or holds two magazines. Threads are mapped to k_cacheCount caches, a thread that
+// finds its cache taken by another one goes to the global stack. Indices cached by other threads are gathered
+// back before allocate gives up.
+// Deferred frees are kept per frame and go back to the free indices when that frame index is released
+class ConcurrentIndexAllocator {
+public:
+    static constexpr uint32_t k_invalidIndex = ~0u;
+    static constexpr uint32_t k_cacheCount = 64;
+    static constexpr uint32_t k_maxMagazineSize = 32;
+
+    ConcurrentIndexAllocator() = default;
+    ConcurrentIndexAllocator(const ConcurrentIndexAllocator&) = delete;
+    ConcurrentIndexAllocator& operator=(const ConcurrentIndexAllocator&) = delete;
+
+    // Not thread-safe, neither is destruction
+    void initialize(uint32_t a_capacity, uint32_t a_frameCount);
+
+    // k_invalidIndex if every index is allocated
+    uint32_t allocate();
+    void free(uint32_t a_index);
+    // a_index is freed by the next releaseDeferred(a_frame)
+    void deferredFree(uint32_t a_index, uint32_t a_frame);
+    // Frees the indices deferred on a_frame, once nothing uses them any more
+    void releaseDeferred(uint32_t a_frame);
+
+    uint32_t getCapacity() const {
+        return m_capacity;
+    }
+    uint32_t getMagazineSize() const {
+        return m_magazineSize;
+    }
+private:
+    struct alignas(64) Cache {
+        std::atomic<bool> busy = false;
+        uint32_t count = 0;
+        std::array<uint32_t, 2 * k_maxMagazineSize> indices;
+    };
+    // Links a_count indices of a_indices into a magazine and pushes it
+    void pushMagazine(const uint32_t* a_indices, uint32_t a_count);
+    // Pushes the magazine already linked from a_first
+    void pushMagazine(uint32_t a_first);
+    // The first index of the magazine, k_invalidIndex if the stack is empty
+    uint32_t popMagazine();
+    // Moves the indices cached by every thread to the global stack
+    void gatherCaches();
+    Cache* tryLockCache();
+
+    uint32_t m_capacity = 0;
+    uint32_t m_magazineSize = 1;
+    std::unique_ptr<uint32_t[]> m_next;                       // next index of the magazine or deferred list
+    std::unique_ptr<std::atomic<uint32_t>[]> m_nextMagazine;  // of the first index of a magazine
+    alignas(64) std::atomic<uint64_t> m_head = 0;             // tag << 32 | first index, the tag avoids ABA
+    std::unique_ptr<Cache[]> m_caches;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_deferred;     // per frame, linked by m_next
+    uint32_t m_frameCount = 0;
+};
+}  // namespace neural::utils
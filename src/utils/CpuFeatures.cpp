@@ -0,0 +1,168 @@
+#include "CpuFeatures.h"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+#if NEURAL_ARCH_X64
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace neural::utils {
+
+namespace {
+#if NEURAL_ARCH_X64
+std::array<uint32_t, 4> cpuid(uint32_t a_leaf, uint32_t a_subleaf)
+{
+    std::array<uint32_t, 4> registers = {};  // eax, ebx, ecx, edx
+#ifdef _MSC_VER
+    int values[4];
+    __cpuidex(values, static_cast<int>(a_leaf), static_cast<int>(a_subleaf));
+    std::memcpy(registers.data(), values, sizeof(values));
+#else
+    __cpuid_count(a_leaf, a_subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+    return registers;
+}
+
+uint64_t xgetbv()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+CpuFeatures detectCpuFeatures()
+{
+    CpuFeatures features;
+#if NEURAL_ARCH_X64
+    const uint32_t maxLeaf = cpuid(0, 0)[0];
+    const auto leaf1 = cpuid(1, 0);
+    const bool osxsave = (leaf1[2] >> 27) & 1;
+    if (!osxsave || maxLeaf < 7) {
+        return features;
+    }
+    // XCR0 tells whether the OS saves the YMM (bits 1-2) and the ZMM/opmask (bits 5-7) state
+    const uint64_t xcr0 = xgetbv();
+    const bool avxState = (xcr0 & 0x6) == 0x6;
+    const bool avx512State = avxState && (xcr0 & 0xE0) == 0xE0;
+
+    const auto leaf7 = cpuid(7, 0);
+    if (avxState) {
+        features.fma  = (leaf1[2] >> 12) & 1;
+        features.f16c = (leaf1[2] >> 29) & 1;
+        features.avx2 = (leaf7[1] >> 5) & 1;
+    }
+    if (avx512State) {
+        features.avx512f    = (leaf7[1] >> 16) & 1;
+        features.avx512dq   = (leaf7[1] >> 17) & 1;
+        features.avx512bw   = (leaf7[1] >> 30) & 1;
+        features.avx512vl   = (leaf7[1] >> 31) & 1;
+        features.avx512vnni = (leaf7[2] >> 11) & 1;
+        features.avx512fp16 = (leaf7[3] >> 23) & 1;
+    }
+#elif NEURAL_ARCH_ARM64
+    features.neon = true;  // mandatory on ARMv8-A
+#endif
+    return features;
+}
+
+IsaTier getOverrideOrBest()
+{
+    const IsaTier best = getBestIsaTier();
+    const char* name = std::getenv("NEURAL_ISA");
+    if (name == nullptr) {
+        return best;
+    }
+    for (IsaTier tier : { IsaTier::Baseline, IsaTier::Avx2, IsaTier::Avx512, IsaTier::Avx512Fp16 }) {
+        if (std::strcmp(name, getIsaTierName(tier)) == 0 ||
+            (tier == IsaTier::Baseline && std::strcmp(name, "baseline") == 0)) {
+            if (isIsaTierSupported(tier)) {
+                return tier;
+            }
+            break;
+        }
+    }
+    std::cout << "NEURAL_ISA=" << name << " is unknown or not supported, using " << getIsaTierName(best) << "\n";
+    return best;
+}
+
+std::atomic<IsaTier>& getActiveTier()
+{
+    static std::atomic<IsaTier> activeTier = getOverrideOrBest();
+    return activeTier;
+}
+}  // anonymous namespace
+
+const CpuFeatures& getCpuFeatures()
+{
+    static const CpuFeatures features = detectCpuFeatures();
+    return features;
+}
+
+bool isIsaTierSupported(IsaTier a_tier)
+{
+    const CpuFeatures& f = getCpuFeatures();
+    switch (a_tier)
+    {
+    case IsaTier::Avx2:
+        return f.avx2 && f.fma && f.f16c;
+    case IsaTier::Avx512:
+        return isIsaTierSupported(IsaTier::Avx2) && f.avx512f && f.avx512bw && f.avx512vl && f.avx512dq;
+    case IsaTier::Avx512Fp16:
+        return isIsaTierSupported(IsaTier::Avx512) && f.avx512vnni && f.avx512fp16;
+    default:
+        return true;
+    }
+}
+
+IsaTier getBestIsaTier()
+{
+    for (IsaTier tier : { IsaTier::Avx512Fp16, IsaTier::Avx512, IsaTier::Avx2 }) {
+        if (isIsaTierSupported(tier)) {
+            return tier;
+        }
+    }
+    return IsaTier::Baseline;
+}
+
+IsaTier getIsaTier()
+{
+    return getActiveTier().load(std::memory_order_relaxed);
+}
+
+bool setIsaTier(IsaTier a_tier)
+{
+    if (!isIsaTierSupported(a_tier)) {
+        return false;
+    }
+    getActiveTier().store(a_tier, std::memory_order_relaxed);
+    return true;
+}
+
+const char* getIsaTierName(IsaTier a_tier)
+{
+    switch (a_tier)
+    {
+    case IsaTier::Avx2:
+        return "avx2";
+    case IsaTier::Avx512:
+        return "avx512";
+    case IsaTier::Avx512Fp16:
+        return "avx512fp16";
+    default:
+        return NEURAL_ARCH_ARM64 ? "neon" : "baseline";
+    }
+}
+}  // namespace neural::utils
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <math.h>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define NEURAL_ARCH_X64 1
+#else
+#define NEURAL_ARCH_X64 0
+#endif
+
+#if defined(_M_ARM64) || defined(__aarch64__)
+#define NEURAL_ARCH_ARM64 1
+#else
+#define NEURAL_ARCH_ARM64 0
+#endif
+
+// Translation units of a tier get NEURAL_ISA_NAMESPACE from src/CMakeLists.txt. Inline kernel code is
+// put into this inline namespace, so copies compiled with different target flags never merge at link time.
+// That only holds for code inside it: an inline function or template from elsewhere that a tier TU doesn't
+// inline, std::max or std::vector::data in a -O0 build for example, is emitted as a weak copy with the flags
+// of that tier, and the linker may keep it for baseline callers too, which then fault on CPUs without the
+// tier. Tier code therefore uses the helpers below, plain pointers instead of std::vector and std::array,
+// and C library functions. The IsaSymbols test lists weak symbols of the tier objects outside their
+// namespace; the residual risk is code that is only compiled by a toolchain the test doesn't run on (MSVC)
+#ifndef NEURAL_ISA_NAMESPACE
+#define NEURAL_ISA_NAMESPACE baseline
+#endif
+
+namespace neural::utils {
+inline namespace NEURAL_ISA_NAMESPACE {
+
+// Same results as std::min and std::max, NaNs included
+template<typename T>
+inline T isaMin(T a_a, T a_b)
+{
+    return a_b < a_a ? a_b : a_a;
+}
+
+template<typename T>
+inline T isaMax(T a_a, T a_b)
+{
+    return a_a < a_b ? a_b : a_a;
+}
+
+// The float overloads of std::abs, std::floor and std::sqrt are inline functions, the C ones aren't
+inline float isaAbs(float a_x)
+{
+    return fabsf(a_x);
+}
+
+inline float isaFloor(float a_x)
+{
+    return floorf(a_x);
+}
+
+inline float isaSqrt(float a_x)
+{
+    return sqrtf(a_x);
+}
+
+template<typename To, typename From>
+inline To isaBitCast(From a_from)
+{
+    static_assert(sizeof(To) == sizeof(From));
+    To to;
+    std::memcpy(&to, &a_from, sizeof(To));
+    return to;
+}
+}  // namespace NEURAL_ISA_NAMESPACE
+
+struct CpuFeatures {
+    bool avx2 = false;
+    bool fma = false;
+    bool f16c = false;
+    bool avx512f = false;
+    bool avx512bw = false;
+    bool avx512vl = false;
+    bool avx512dq = false;
+    bool avx512vnni = false;
+    bool avx512fp16 = false;
+    bool neon = false;
+};
+
+// Kernel families are compiled once per tier in their own translation units (see src/CMakeLists.txt)
+// and pick the variant of the active tier on every call. Baseline uses the default flags of the build,
+// which is SSE2 on x64 and NEON on ARM64. Avx512Fp16 also requires VNNI; kernels that have no
+// variant for a tier use the closest lower one
+enum class IsaTier
+{
+    Baseline,
+    Avx2,
+    Avx512,
+    Avx512Fp16
+};
+
+// Detected once, including the OS support for the AVX/AVX-512 register state
+const CpuFeatures& getCpuFeatures();
+bool isIsaTierSupported(IsaTier a_tier);
+IsaTier getBestIsaTier();
+
+// The best supported tier, unless NEURAL_ISA (baseline, avx2, avx512, avx512fp16) is set in the
+// environment or setIsaTier is called. Forcing a tier is meant for benchmarks and for comparing
+// the variants with each other, unsupported tiers are rejected
+IsaTier getIsaTier();
+bool setIsaTier(IsaTier a_tier);
+const char* getIsaTierName(IsaTier a_tier);
+}  // namespace neural::utils
@@ -0,0 +1,652 @@
+#include "DatasetShards.h"
+#include "Float16Compressor.h"
+#include "Float16Conversion.h"
+#include "ImageCodec.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace neural::utils {
+
+namespace {
+constexpr uint32_t k_shardMagic = 0x4853444E;  // "NDSH"
+constexpr uint32_t k_shardVersion = 2;
+constexpr uint32_t k_planeNameSize = 16;
+constexpr uint32_t k_maxOpenShards = 64;
+constexpr uint32_t k_compressedPlane = 1u << 31;  // in the plane sizes of a record
+
+struct ShardHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint32_t planeCount;
+    uint32_t samplesPerShard;
+};
+
+struct PlaneHeader {
+    char name[k_planeNameSize];
+    PlanePrecision precision;
+    PlaneCompression compression;
+    float minValue;
+    float maxValue;
+};
+
+struct IndexEntry {
+    uint64_t offset;
+    uint32_t size;
+    uint32_t crc;
+};
+static_assert(sizeof(IndexEntry) == 16);
+
+// Slicing-by-8, table k is the CRC of a byte followed by k zero bytes, so every step folds in 8 bytes
+constexpr std::array<std::array<uint32_t, 256>, 8> k_crcTables = [] {
+    std::array<std::array<uint32_t, 256>, 8> tables = {};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t crc = i;
+        for (uint32_t bit = 0; bit < 8; ++bit) {
+            crc = crc & 1 ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t k = 1; k < 8; ++k) {
+        for (uint32_t i = 0; i < 256; ++i) {
+            tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}();
+
+uint32_t crc32(const uint8_t* a_data, size_t a_size)
+{
+    const auto& t = k_crcTables;
+    uint32_t crc = 0xFFFFFFFFu;
+    size_t i = 0;
+    for (; i + 8 <= a_size; i += 8) {
+        uint32_t low, high;
+        std::memcpy(&low, a_data + i, sizeof(low));
+        std::memcpy(&high, a_data + i + 4, sizeof(high));
+        low ^= crc;
+        crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+              t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+    for (; i < a_size; ++i) {
+        crc = t[0][(crc ^ a_data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+uint32_t getPrecisionSize(PlanePrecision a_precision)
+{
+    switch (a_precision)
+    {
+    case PlanePrecision::Float32:
+        return 4;
+    case PlanePrecision::Float16:
+    case PlanePrecision::Unorm16:
+        return 2;
+    default:
+        return 1;
+    }
+}
+
+uint64_t getHeaderSize(size_t a_planeCount)
+{
+    return sizeof(ShardHeader) + a_planeCount * sizeof(PlaneHeader);
+}
+
+std::string getShardPath(const std::string& a_directory, uint32_t a_shard, const char* a_extension)
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "/shard_%05u%s", a_shard, a_extension);
+    return a_directory + name;
+}
+
+uint64_t getFileSize(const std::string& a_path)
+{
+    std::error_code error;
+    const uint64_t size = std::filesystem::file_size(a_path, error);
+    return error ? 0 : size;
+}
+
+bool seek(std::FILE* a_file, uint64_t a_offset)
+{
+#ifdef _WIN32
+    return _fseeki64(a_file, static_cast<int64_t>(a_offset), SEEK_SET) == 0;
+#else
+    return fseeko(a_file, static_cast<off_t>(a_offset), SEEK_SET) == 0;
+#endif
+}
+
+// fflush only hands the data to the OS, which is enough to survive a crash of the process
+void flush(std::FILE* a_file, bool a_durable)
+{
+    std::fflush(a_file);
+    if (a_durable) {
+#ifdef _WIN32
+        _commit(_fileno(a_file));
+#else
+        fsync(fileno(a_file));
+#endif
+    }
+}
+
+ImageElement getImageElement(PlanePrecision a_precision)
+{
+    switch (a_precision)
+    {
+    case PlanePrecision::Float32:
+        return ImageElement::Float32;
+    case PlanePrecision::Float16:
+        return ImageElement::Float16;
+    case PlanePrecision::Unorm16:
+        return ImageElement::Uint16;
+    default:
+        return ImageElement::Uint8;
+    }
+}
+
+template<typename T, typename Convert>
+void gatherPlane(const PlaneSource& a_source, uint32_t a_width, uint32_t a_height, float* a_dst, Convert a_convert)
+{
+    for (uint32_t y = 0; y < a_height; ++y) {
+        const T* row = static_cast<const T*>(a_source.data) + static_cast<size_t>(y) * a_source.rowStride;
+        float* dst = a_dst + static_cast<size_t>(y) * a_width;
+        for (uint32_t x = 0; x < a_width; ++x) {
+            dst[x] = a_convert(row[static_cast<size_t>(x) * a_source.pixelStride]);
+        }
+    }
+}
+
+// Strided source elements to floats, unorm sources end up in [0, 1]
+void gatherPlane(const PlaneSource& a_source, uint32_t a_width, uint32_t a_height, float* a_dst)
+{
+    switch (a_source.element)
+    {
+    case ImageElement::Uint8:
+        gatherPlane<uint8_t>(a_source, a_width, a_height, a_dst, [](uint8_t a_value) {
+            return static_cast<float>(a_value) * (1.0f / 255.0f);
+        });
+        break;
+    case ImageElement::Uint16:
+        gatherPlane<uint16_t>(a_source, a_width, a_height, a_dst, [](uint16_t a_value) {
+            return static_cast<float>(a_value) * (1.0f / 65535.0f);
+        });
+        break;
+    case ImageElement::Float16:
+        gatherPlane<uint16_t>(a_source, a_width, a_height, a_dst, [](uint16_t a_value) {
+            return Float16Compressor::decompress(a_value);
+        });
+        break;
+    case ImageElement::Float32:
+        gatherPlane<float>(a_source, a_width, a_height, a_dst, [](float a_value) { return a_value; });
+        break;
+    }
+}
+
+// Appends the plane to a_record and returns its entry in the plane sizes
+uint32_t encodePlane(const PlaneSource& a_source, const DatasetPlane& a_plane, uint32_t a_width, uint32_t a_height,
+                     std::vector<uint8_t>& a_record)
+{
+    const size_t count = static_cast<size_t>(a_width) * a_height;
+    std::vector<float> values(count);
+    gatherPlane(a_source, a_width, a_height, values.data());
+
+    std::vector<uint8_t> raw(count * getPrecisionSize(a_plane.precision));
+    const float scale = 1.0f / (a_plane.maxValue - a_plane.minValue);
+    switch (a_plane.precision)
+    {
+    case PlanePrecision::Float32:
+        std::memcpy(raw.data(), values.data(), count * sizeof(float));
+        break;
+    case PlanePrecision::Float16:
+        compressFloat16(values.data(), reinterpret_cast<uint16_t*>(raw.data()), count);
+        break;
+    case PlanePrecision::Unorm8:
+        for (size_t i = 0; i < count; ++i) {
+            const float normalized = std::clamp((values[i] - a_plane.minValue) * scale, 0.0f, 1.0f);
+            raw[i] = static_cast<uint8_t>(normalized * 255.0f + 0.5f);
+        }
+        break;
+    case PlanePrecision::Unorm16:
+        for (size_t i = 0; i < count; ++i) {
+            const float normalized = std::clamp((values[i] - a_plane.minValue) * scale, 0.0f, 1.0f);
+            reinterpret_cast<uint16_t*>(raw.data())[i] = static_cast<uint16_t>(normalized * 65535.0f + 0.5f);
+        }
+        break;
+    }
+
+    const size_t offset = a_record.size();
+    if (a_plane.compression == PlaneCompression::Lossless) {
+        const ImageElement element = getImageElement(a_plane.precision);
+        a_record.resize(offset + getMaxCompressedImageSize(a_width, a_height, element));
+        const size_t size = compressImage(raw.data(), a_width, a_height, element, a_record.data() + offset);
+        if (size < raw.size()) {
+            a_record.resize(offset + size);
+            return static_cast<uint32_t>(size) | k_compressedPlane;
+        }
+        a_record.resize(offset);
+    }
+    a_record.insert(a_record.end(), raw.begin(), raw.end());
+    return static_cast<uint32_t>(raw.size());
+}
+
+bool decodePlane(const uint8_t* a_src, uint32_t a_sizeEntry, const DatasetPlane& a_plane, uint32_t a_width,
+                 uint32_t a_height, float* a_dst)
+{
+    const size_t count = static_cast<size_t>(a_width) * a_height;
+    const size_t rawSize = count * getPrecisionSize(a_plane.precision);
+    std::vector<uint8_t> raw(rawSize);
+    if (a_sizeEntry & k_compressedPlane) {
+        if (!decompressImage(a_src, a_sizeEntry & ~k_compressedPlane, a_width, a_height,
+                             getImageElement(a_plane.precision), raw.data())) {
+            return false;
+        }
+    } else if (a_sizeEntry == rawSize) {
+        std::memcpy(raw.data(), a_src, rawSize);
+    } else {
+        return false;
+    }
+
+    const float range = a_plane.maxValue - a_plane.minValue;
+    switch (a_plane.precision)
+    {
+    case PlanePrecision::Float32:
+        std::memcpy(a_dst, raw.data(), count * sizeof(float));
+        break;
+    case PlanePrecision::Float16:
+        decompressFloat16(reinterpret_cast<const uint16_t*>(raw.data()), a_dst, count);
+        break;
+    case PlanePrecision::Unorm8:
+        for (size_t i = 0; i < count; ++i) {
+            a_dst[i] = a_plane.minValue + range * (raw[i] / 255.0f);
+        }
+        break;
+    case PlanePrecision::Unorm16:
+        for (size_t i = 0; i < count; ++i) {
+            a_dst[i] = a_plane.minValue + range * (reinterpret_cast<const uint16_t*>(raw.data())[i] / 65535.0f);
+        }
+        break;
+    }
+    return true;
+}
+
+bool readHeader(std::FILE* a_file, ShardHeader& a_header, std::vector<DatasetPlane>& a_planes)
+{
+    if (!seek(a_file, 0) || std::fread(&a_header, sizeof(a_header), 1, a_file) != 1 ||
+        a_header.magic != k_shardMagic || a_header.version != k_shardVersion) {
+        return false;
+    }
+    a_planes.resize(a_header.planeCount);
+    for (DatasetPlane& plane : a_planes) {
+        PlaneHeader planeHeader;
+        if (std::fread(&planeHeader, sizeof(planeHeader), 1, a_file) != 1) {
+            return false;
+        }
+        plane = {
+            .name = std::string(planeHeader.name, strnlen(planeHeader.name, k_planeNameSize)),
+            .precision = planeHeader.precision,
+            .compression = planeHeader.compression,
+            .minValue = planeHeader.minValue,
+            .maxValue = planeHeader.maxValue
+        };
+    }
+    return true;
+}
+}  // anonymous namespace
+
+bool DatasetWriter::initialize(const DatasetWriterCreateInfo& a_createInfo)
+{
+    assert(!a_createInfo.planes.empty() && a_createInfo.samplesPerShard > 0);
+    shutdown();
+    m_info = a_createInfo;
+    for (const DatasetPlane& plane : m_info.planes) {
+        assert(plane.name.size() < k_planeNameSize);
+    }
+
+    std::error_code error;
+    std::filesystem::create_directories(m_info.directory, error);
+    uint32_t lastShard = 0;
+    while (std::filesystem::exists(getShardPath(m_info.directory, lastShard + 1, ".data"))) {
+        ++lastShard;
+    }
+    std::lock_guard lock(m_mutex);
+    return openShard(lastShard);
+}
+
+// Creates the shard or recovers it: index entries without a complete, matching record and data past
+// the last indexed record are cut off
+bool DatasetWriter::openShard(uint32_t a_shard)
+{
+    const std::string dataPath = getShardPath(m_info.directory, a_shard, ".data");
+    const std::string indexPath = getShardPath(m_info.directory, a_shard, ".index");
+    const uint64_t headerSize = getHeaderSize(m_info.planes.size());
+    uint64_t dataSize = getFileSize(dataPath);
+
+    if (dataSize < headerSize) {
+        std::FILE* data = std::fopen(dataPath.c_str(), "wb");
+        std::FILE* index = std::fopen(indexPath.c_str(), "wb");
+        if (!data || !index) {
+            if (data) std::fclose(data);
+            if (index) std::fclose(index);
+            return false;
+        }
+        const ShardHeader header = {
+            .magic = k_shardMagic,
+            .version = k_shardVersion,
+            .width = m_info.width,
+            .height = m_info.height,
+            .planeCount = static_cast<uint32_t>(m_info.planes.size()),
+            .samplesPerShard = m_info.samplesPerShard
+        };
+        std::fwrite(&header, sizeof(header), 1, data);
+        for (const DatasetPlane& plane : m_info.planes) {
+            PlaneHeader planeHeader = {
+                .name = {},
+                .precision = plane.precision,
+                .compression = plane.compression,
+                .minValue = plane.minValue,
+                .maxValue = plane.maxValue
+            };
+            std::memcpy(planeHeader.name, plane.name.data(), plane.name.size());
+            std::fwrite(&planeHeader, sizeof(planeHeader), 1, data);
+        }
+        flush(data, m_info.durable);
+        std::fclose(data);
+        std::fclose(index);
+        dataSize = headerSize;
+    } else {
+        std::FILE* data = std::fopen(dataPath.c_str(), "rb");
+        if (!data) {
+            return false;
+        }
+        ShardHeader header;
+        std::vector<DatasetPlane> planes;
+        bool matches = readHeader(data, header, planes) && header.width == m_info.width &&
+                       header.height == m_info.height && header.samplesPerShard == m_info.samplesPerShard &&
+                       planes.size() == m_info.planes.size();
+        for (size_t i = 0; matches && i < planes.size(); ++i) {
+            const DatasetPlane& plane = m_info.planes[i];
+            matches = planes[i].name == plane.name && planes[i].precision == plane.precision &&
+                      planes[i].compression == plane.compression && planes[i].minValue == plane.minValue &&
+                      planes[i].maxValue == plane.maxValue;
+        }
+
+        std::vector<IndexEntry> entries(getFileSize(indexPath) / sizeof(IndexEntry));
+        if (std::FILE* index = std::fopen(indexPath.c_str(), "rb")) {
+            entries.resize(std::fread(entries.data(), sizeof(IndexEntry), entries.size(), index));
+            std::fclose(index);
+        } else {
+            entries.clear();
+        }
+        // Records follow each other without gaps, only the last one may be torn
+        uint32_t valid = 0;
+        uint64_t recordsEnd = headerSize;
+        for (const IndexEntry& entry : entries) {
+            if (entry.offset != recordsEnd || entry.offset + entry.size > dataSize) {
+                break;
+            }
+            recordsEnd += entry.size;
+            ++valid;
+        }
+        std::vector<uint8_t> record;
+        while (matches && valid > 0) {
+            const IndexEntry& entry = entries[valid - 1];
+            record.resize(entry.size);
+            if (seek(data, entry.offset) && std::fread(record.data(), record.size(), 1, data) == 1 &&
+                crc32(record.data(), record.size()) == entry.crc) {
+                break;
+            }
+            recordsEnd = entry.offset;
+            --valid;
+        }
+        std::fclose(data);
+        if (!matches) {
+            return false;
+        }
+
+        m_shardSamples = valid;
+        dataSize = recordsEnd;
+        std::error_code error;
+        std::filesystem::resize_file(dataPath, dataSize, error);
+        std::filesystem::resize_file(indexPath, static_cast<uint64_t>(valid) * sizeof(IndexEntry), error);
+    }
+    if (dataSize == headerSize) {
+        m_shardSamples = 0;
+    }
+
+    m_data = std::fopen(dataPath.c_str(), "ab");
+    m_index = std::fopen(indexPath.c_str(), "ab");
+    m_shard = a_shard;
+    m_dataSize = dataSize;
+    if (!m_data || !m_index) {
+        closeShard();
+        return false;
+    }
+    return true;
+}
+
+void DatasetWriter::closeShard()
+{
+    if (m_data) {
+        flush(m_data, m_info.durable);
+        std::fclose(m_data);
+        m_data = nullptr;
+    }
+    if (m_index) {
+        flush(m_index, m_info.durable);
+        std::fclose(m_index);
+        m_index = nullptr;
+    }
+}
+
+void DatasetWriter::shutdown()
+{
+    std::lock_guard lock(m_mutex);
+    closeShard();
+}
+
+DatasetWriter::~DatasetWriter()
+{
+    shutdown();
+}
+
+uint32_t DatasetWriter::getSampleCount()
+{
+    std::lock_guard lock(m_mutex);
+    return m_shard * m_info.samplesPerShard + m_shardSamples;
+}
+
+bool DatasetWriter::append(uint32_t a_sampleId, std::span<const PlaneSource> a_planes)
+{
+    assert(a_planes.size() == m_info.planes.size());
+    std::vector<uint32_t> planeSizes(a_planes.size());
+    std::vector<uint8_t> record(sizeof(a_sampleId) + planeSizes.size() * sizeof(uint32_t));
+    for (size_t i = 0; i < a_planes.size(); ++i) {
+        planeSizes[i] = encodePlane(a_planes[i], m_info.planes[i], m_info.width, m_info.height, record);
+    }
+    std::memcpy(record.data(), &a_sampleId, sizeof(a_sampleId));
+    std::memcpy(record.data() + sizeof(a_sampleId), planeSizes.data(), planeSizes.size() * sizeof(uint32_t));
+    const uint32_t crc = crc32(record.data(), record.size());
+
+    std::lock_guard lock(m_mutex);
+    if (m_data && m_shardSamples == m_info.samplesPerShard) {
+        closeShard();
+        openShard(m_shard + 1);
+    }
+    if (!m_data) {
+        return false;
+    }
+    // The record reaches the file before its index entry
+    const IndexEntry entry = { .offset = m_dataSize, .size = static_cast<uint32_t>(record.size()), .crc = crc };
+    if (std::fwrite(record.data(), record.size(), 1, m_data) != 1) {
+        return false;
+    }
+    flush(m_data, m_info.durable);
+    if (std::fwrite(&entry, sizeof(entry), 1, m_index) != 1) {
+        return false;
+    }
+    flush(m_index, m_info.durable);
+    m_dataSize += record.size();
+    ++m_shardSamples;
+    return true;
+}
+
+bool DatasetReader::initialize(const std::string& a_directory)
+{
+    shutdown();
+    m_directory = a_directory;
+    for (uint32_t shard = 0; ; ++shard) {
+        const std::string dataPath = getShardPath(a_directory, shard, ".data");
+        std::FILE* data = std::fopen(dataPath.c_str(), "rb");
+        if (!data) {
+            break;
+        }
+        ShardHeader header;
+        std::vector<DatasetPlane> planes;
+        const bool validHeader = readHeader(data, header, planes);
+        std::fclose(data);
+        if (!validHeader) {
+            break;
+        }
+        if (shard == 0) {
+            m_width = header.width;
+            m_height = header.height;
+            m_samplesPerShard = header.samplesPerShard;
+            m_planes = planes;
+        }
+
+        // Entries past the data are the tail of an interrupted write
+        const std::string indexPath = getShardPath(a_directory, shard, ".index");
+        std::vector<IndexEntry> entries(getFileSize(indexPath) / sizeof(IndexEntry));
+        if (std::FILE* index = std::fopen(indexPath.c_str(), "rb")) {
+            entries.resize(std::fread(entries.data(), sizeof(IndexEntry), entries.size(), index));
+            std::fclose(index);
+        } else {
+            entries.clear();
+        }
+        const uint64_t dataSize = getFileSize(dataPath);
+        while (!entries.empty() && entries.back().offset + entries.back().size > dataSize) {
+            entries.pop_back();
+        }
+        for (const IndexEntry& entry : entries) {
+            m_entries.push_back({ entry.offset, entry.size, entry.crc });
+        }
+        m_data.push_back(nullptr);
+        // Only the last shard may be partial
+        if (entries.size() < m_samplesPerShard) {
+            break;
+        }
+    }
+    m_sampleCount = static_cast<uint32_t>(m_entries.size());
+    return !m_data.empty();
+}
+
+void DatasetReader::shutdown()
+{
+    for (std::FILE*& data : m_data) {
+        if (data) {
+            std::fclose(data);
+            data = nullptr;
+        }
+    }
+    m_data.clear();
+    m_entries.clear();
+    m_openShards = 0;
+    m_sampleCount = 0;
+}
+
+DatasetReader::~DatasetReader()
+{
+    shutdown();
+}
+
+uint32_t DatasetReader::getPlaneIndex(std::string_view a_name) const
+{
+    for (uint32_t i = 0; i < m_planes.size(); ++i) {
+        if (m_planes[i].name == a_name) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+std::FILE* DatasetReader::getShardData(uint32_t a_shard)
+{
+    if (!m_data[a_shard]) {
+        // Keeps the number of open files bounded for datasets with many shards
+        if (m_openShards == k_maxOpenShards) {
+            for (std::FILE*& data : m_data) {
+                if (data) {
+                    std::fclose(data);
+                    data = nullptr;
+                }
+            }
+            m_openShards = 0;
+        }
+        m_data[a_shard] = std::fopen(getShardPath(m_directory, a_shard, ".data").c_str(), "rb");
+        m_openShards += m_data[a_shard] != nullptr;
+    }
+    return m_data[a_shard];
+}
+
+bool DatasetReader::readPlane(uint32_t a_sample, uint32_t a_plane, float* a_dst)
+{
+    assert(a_sample < m_sampleCount && a_plane < m_planes.size());
+    const IndexEntry& entry = m_entries[a_sample];
+    std::FILE* data = getShardData(a_sample / m_samplesPerShard);
+    std::vector<uint32_t> planeSizes(m_planes.size());
+    if (!data || !seek(data, entry.offset + sizeof(uint32_t)) ||
+        std::fread(planeSizes.data(), sizeof(uint32_t), planeSizes.size(), data) != planeSizes.size()) {
+        return false;
+    }
+    uint64_t offset = sizeof(uint32_t) * (1 + planeSizes.size());
+    for (uint32_t i = 0; i < a_plane; ++i) {
+        offset += planeSizes[i] & ~k_compressedPlane;
+    }
+    m_record.resize(planeSizes[a_plane] & ~k_compressedPlane);
+    if (offset + m_record.size() > entry.size || !seek(data, entry.offset + offset) ||
+        std::fread(m_record.data(), m_record.size(), 1, data) != 1) {
+        return false;
+    }
+    return decodePlane(m_record.data(), planeSizes[a_plane], m_planes[a_plane], m_width, m_height, a_dst);
+}
+
+bool DatasetReader::readSample(uint32_t a_sample, std::span<float* const> a_dst, uint32_t* a_sampleId)
+{
+    assert(a_sample < m_sampleCount && a_dst.size() == m_planes.size());
+    const IndexEntry& entry = m_entries[a_sample];
+    std::FILE* data = getShardData(a_sample / m_samplesPerShard);
+    const uint64_t planesOffset = sizeof(uint32_t) * (1 + m_planes.size());
+    m_record.resize(entry.size);
+    if (!data || entry.size < planesOffset || !seek(data, entry.offset) ||
+        std::fread(m_record.data(), m_record.size(), 1, data) != 1 ||
+        crc32(m_record.data(), m_record.size()) != entry.crc) {
+        return false;
+    }
+    if (a_sampleId) {
+        std::memcpy(a_sampleId, m_record.data(), sizeof(uint32_t));
+    }
+    std::vector<uint32_t> planeSizes(m_planes.size());
+    std::memcpy(planeSizes.data(), m_record.data() + sizeof(uint32_t), planeSizes.size() * sizeof(uint32_t));
+    uint64_t offset = planesOffset;
+    for (size_t i = 0; i < m_planes.size(); ++i) {
+        const uint32_t size = planeSizes[i] & ~k_compressedPlane;
+        if (offset + size > entry.size ||
+            !decodePlane(m_record.data() + offset, planeSizes[i], m_planes[i], m_width, m_height, a_dst[i])) {
+            return false;
+        }
+        offset += size;
+    }
+    return true;
+}
+}  // namespace neural::utils
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "ImageCodec.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace neural::utils {
+
+// A dataset is a directory of shards, shard_<k>.data holds up to samplesPerShard records and
+// shard_<k>.index one 16-byte entry per record, so sample i is found with two reads:
+//     data:  header, plane descriptions, records
+//     index: { uint64 offset; uint32 size; uint32 crc32 } per record
+//     record: uint32 sample id, uint32 size of every plane, then the planes
+// A plane is width * height values of its precision, compressed with utils/ImageCodec.h if the plane asks
+// for it and that is smaller, the top bit of its size tells which. Records are appended and flushed before
+// their index entry, so after a crash the index always describes a prefix of complete records, the writer
+// drops anything past it when it reopens the shard
+
+enum class PlanePrecision : uint32_t
+{
+    Float32,
+    Float16,
+    Unorm8,   // [minValue, maxValue] mapped onto 0..255
+    Unorm16
+};
+
+enum class PlaneCompression : uint32_t
+{
+    None,
+    Lossless  // utils/ImageCodec.h on the values of the precision
+};
+
+struct DatasetPlane {
+    std::string name;   // at most 15 characters
+    PlanePrecision precision = PlanePrecision::Float16;
+    PlaneCompression compression = PlaneCompression::None;
+    float minValue = 0.0f;
+    float maxValue = 1.0f;
+};
+
+// One channel of an image in memory, e.g. the green channel of RGBA32F is { data + 1, 4, 4 * width }.
+// Uint8 and Uint16 elements are unorm values in [0, 1], a source of the element of the plane precision
+// is stored without loss
+struct PlaneSource {
+    const void* data;
+    uint32_t pixelStride;  // in elements
+    uint32_t rowStride;    // in elements
+    ImageElement element = ImageElement::Float32;
+};
+
+struct DatasetWriterCreateInfo {
+    std::string directory;
+    uint32_t width;
+    uint32_t height;
+    std::vector<DatasetPlane> planes;
+    uint32_t samplesPerShard = 1024;
+    bool durable = false;  // sync every record to disk, survives power loss and not only process crashes
+};
+
+class DatasetWriter {
+public:
+    // Continues an existing dataset, whose layout must match a_createInfo
+    bool initialize(const DatasetWriterCreateInfo& a_createInfo);
+    void shutdown();
+    ~DatasetWriter();
+
+    uint32_t getSampleCount();
+    // Thread-safe. Planes are encoded on the calling thread, only the file writes are serialized,
+    // records are stored in the order of the calls
+    bool append(uint32_t a_sampleId, std::span<const PlaneSource> a_planes);
+private:
+    bool openShard(uint32_t a_shard);
+    void closeShard();
+
+    DatasetWriterCreateInfo m_info;
+
+    std::mutex m_mutex;
+    uint32_t m_shard = 0;
+    uint32_t m_shardSamples = 0;
+    uint64_t m_dataSize = 0;
+    std::FILE* m_data = nullptr;
+    std::FILE* m_index = nullptr;
+};
+
+// Keeps the index of the whole dataset in memory, 16 bytes per sample, and opens shard data files on
+// first use. Not thread-safe, every thread opens its own reader
+class DatasetReader {
+public:
+    bool initialize(const std::string& a_directory);
+    void shutdown();
+    ~DatasetReader();
+
+    uint32_t getSampleCount() const {
+        return m_sampleCount;
+    }
+    uint32_t getWidth() const {
+        return m_width;
+    }
+    uint32_t getHeight() const {
+        return m_height;
+    }
+    const std::vector<DatasetPlane>& getPlanes() const {
+        return m_planes;
+    }
+    // UINT32_MAX if there is no such plane
+    uint32_t getPlaneIndex(std::string_view a_name) const;
+
+    // Decodes one plane into width * height floats, reads only the plane sizes and that plane
+    bool readPlane(uint32_t a_sample, uint32_t a_plane, float* a_dst);
+    // Decodes all planes, plane p goes to a_dst[p], and checks the record checksum
+    bool readSample(uint32_t a_sample, std::span<float* const> a_dst, uint32_t* a_sampleId = nullptr);
+private:
+    struct IndexEntry {
+        uint64_t offset;
+        uint32_t size;
+        uint32_t crc;
+    };
+    std::FILE* getShardData(uint32_t a_shard);
+
+    std::string m_directory;
+    uint32_t m_width = 0;
+    uint32_t m_height = 0;
+    uint32_t m_samplesPerShard = 0;
+    uint32_t m_sampleCount = 0;
+    std::vector<DatasetPlane> m_planes;
+    std::vector<IndexEntry> m_entries;
+    std::vector<std::FILE*> m_data;
+    uint32_t m_openShards = 0;
+    std::vector<uint8_t> m_record;
+};
+}  // namespace neural::utils
@@ -0,0 +1,91 @@
+#include "DdsFile.h"
+
+#include <fstream>
+
+namespace neural::utils {
+
+namespace {
+constexpr uint32_t k_ddsMagic = 0x20534444;  // "DDS "
+
+struct DdsPixelFormat {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t fourCC;
+    uint32_t rgbBitCount;
+    uint32_t rBitMask;
+    uint32_t gBitMask;
+    uint32_t bBitMask;
+    uint32_t aBitMask;
+};
+
+struct DdsHeader {
+    uint32_t size;
+    uint32_t flags;
+    uint32_t height;
+    uint32_t width;
+    uint32_t pitchOrLinearSize;
+    uint32_t depth;
+    uint32_t mipMapCount;
+    uint32_t reserved1[11];
+    DdsPixelFormat pixelFormat;
+    uint32_t caps;
+    uint32_t caps2;
+    uint32_t caps3;
+    uint32_t caps4;
+    uint32_t reserved2;
+};
+static_assert(sizeof(DdsHeader) == 124);
+
+constexpr uint32_t k_flagsTexture = 0x00001007;  // caps, height, width, pixel format
+constexpr uint32_t k_flagsMipmap = 0x00020000;
+constexpr uint32_t k_flagsPitch = 0x00000008;
+constexpr uint32_t k_surfaceTexture = 0x00001000;
+constexpr uint32_t k_pixelFormatFourCC = 0x00000004;
+constexpr uint32_t k_pixelFormatRgba = 0x00000041;
+constexpr uint32_t k_fourCCA32B32G32R32F = 116;  // D3DFMT_A32B32G32R32F
+
+uint32_t getPixelSize(DdsFormat a_format) {
+    return a_format == DdsFormat::R32G32B32A32Float ? 16 : 4;
+}
+}  // anonymous namespace
+
+bool saveDdsFile(const std::string& a_path, DdsFormat a_format, uint32_t a_width, uint32_t a_height,
+                 uint32_t a_pitch, const void* a_data)
+{
+    const uint32_t rowSize = a_width * getPixelSize(a_format);
+    DdsHeader header = {
+        .size = sizeof(DdsHeader),
+        .flags = k_flagsTexture | k_flagsMipmap | k_flagsPitch,
+        .height = a_height,
+        .width = a_width,
+        .pitchOrLinearSize = rowSize,
+        .mipMapCount = 1,
+        .caps = k_surfaceTexture
+    };
+    header.pixelFormat.size = sizeof(DdsPixelFormat);
+    if (a_format == DdsFormat::R32G32B32A32Float) {
+        header.pixelFormat.flags = k_pixelFormatFourCC;
+        header.pixelFormat.fourCC = k_fourCCA32B32G32R32F;
+    } else {
+        header.pixelFormat.flags = k_pixelFormatRgba;
+        header.pixelFormat.rgbBitCount = 32;
+        header.pixelFormat.rBitMask = 0x000000ff;
+        header.pixelFormat.gBitMask = 0x0000ff00;
+        header.pixelFormat.bBitMask = 0x00ff0000;
+        header.pixelFormat.aBitMask = 0xff000000;
+    }
+
+    std::ofstream file(a_path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(&k_ddsMagic), sizeof(k_ddsMagic));
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const char* data = static_cast<const char*>(a_data);
+    const size_t pitch = static_cast<size_t>(a_pitch) * getPixelSize(a_format);
+    for (uint32_t y = 0; y < a_height; ++y) {
+        file.write(data + y * pitch, rowSize);
+    }
+    return static_cast<bool>(file);
+}
+}  // namespace neural::utils
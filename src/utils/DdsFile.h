@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace neural::utils {
+
+enum class DdsFormat
+{
+    R8G8B8A8Unorm,
+    R32G32B32A32Float
+};
+
+// Writes a single 2D texture without mips, with the same legacy header DirectXTK's SaveDDSTextureToFile
+// writes for these formats, so captures of the CPU and D3D12 backends load the same way.
+// a_pitch is the distance between rows in pixels
+bool saveDdsFile(const std::string& a_path, DdsFormat a_format, uint32_t a_width, uint32_t a_height,
+                 uint32_t a_pitch, const void* a_data);
+}  // namespace neural::utils
@@ -0,0 +1,66 @@
+#include "Float16Conversion.h"
+#include "Float16Compressor.h"
+#include "CpuFeatures.h"
+
+#if NEURAL_ARCH_ARM64
+#include <arm_neon.h>
+#endif
+
+namespace neural::utils {
+
+void compressFloat16(const float* a_src, uint16_t* a_dst, size_t a_count)
+{
+#if NEURAL_ARCH_X64
+    if (getIsaTier() != IsaTier::Baseline) {
+        compressFloat16Avx2(a_src, a_dst, a_count);
+        return;
+    }
+#endif
+    compressFloat16Baseline(a_src, a_dst, a_count);
+}
+
+void decompressFloat16(const uint16_t* a_src, float* a_dst, size_t a_count)
+{
+#if NEURAL_ARCH_X64
+    if (getIsaTier() != IsaTier::Baseline) {
+        decompressFloat16Avx2(a_src, a_dst, a_count);
+        return;
+    }
+#endif
+    decompressFloat16Baseline(a_src, a_dst, a_count);
+}
+
+void compressFloat16Baseline(const float* a_src, uint16_t* a_dst, size_t a_count)
+{
+#if NEURAL_ARCH_ARM64
+    size_t i = 0;
+    for (; i + 4 <= a_count; i += 4) {
+        vst1_u16(a_dst + i, vreinterpret_u16_f16(vcvt_f16_f32(vld1q_f32(a_src + i))));
+    }
+    for (; i < a_count; ++i) {
+        a_dst[i] = vget_lane_u16(vreinterpret_u16_f16(vcvt_f16_f32(vdupq_n_f32(a_src[i]))), 0);
+    }
+#else
+    for (size_t i = 0; i < a_count; ++i) {
+        a_dst[i] = Float16Compressor::compress(a_src[i]);
+    }
+#endif
+}
+
+void decompressFloat16Baseline(const uint16_t* a_src, float* a_dst, size_t a_count)
+{
+#if NEURAL_ARCH_ARM64
+    size_t i = 0;
+    for (; i + 4 <= a_count; i += 4) {
+        vst1q_f32(a_dst + i, vcvt_f32_f16(vreinterpret_f16_u16(vld1_u16(a_src + i))));
+    }
+    for (; i < a_count; ++i) {
+        a_dst[i] = vgetq_lane_f32(vcvt_f32_f16(vreinterpret_f16_u16(vdup_n_u16(a_src[i]))), 0);
+    }
+#else
+    for (size_t i = 0; i < a_count; ++i) {
+        a_dst[i] = Float16Compressor::decompress(a_src[i]);
+    }
+#endif
+}
+}  // namespace neural::utils
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace neural::utils {
+
+// Bulk float32 <-> float16 conversion on the active IsaTier. The x64 baseline uses Float16Compressor,
+// which truncates the mantissa, while F16C and NEON round to nearest even, so the tiers may differ by one ulp
+void compressFloat16(const float* a_src, uint16_t* a_dst, size_t a_count);
+void decompressFloat16(const uint16_t* a_src, float* a_dst, size_t a_count);
+
+// Variants, each in its own translation unit
+void compressFloat16Baseline(const float* a_src, uint16_t* a_dst, size_t a_count);
+void decompressFloat16Baseline(const uint16_t* a_src, float* a_dst, size_t a_count);
+void compressFloat16Avx2(const float* a_src, uint16_t* a_dst, size_t a_count);
+void decompressFloat16Avx2(const uint16_t* a_src, float* a_dst, size_t a_count);
+}  // namespace neural::utils
@@ -0,0 +1,35 @@
+// Compiled with AVX2, FMA and F16C, see src/CMakeLists.txt
+#include "Float16Conversion.h"
+#include "CpuFeatures.h"
+
+#if NEURAL_ARCH_X64
+#include <immintrin.h>
+#endif
+
+namespace neural::utils {
+#if NEURAL_ARCH_X64
+void compressFloat16Avx2(const float* a_src, uint16_t* a_dst, size_t a_count)
+{
+    size_t i = 0;
+    for (; i + 8 <= a_count; i += 8) {
+        const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps(a_src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(a_dst + i), half);
+    }
+    for (; i < a_count; ++i) {
+        a_dst[i] = static_cast<uint16_t>(_mm_extract_epi16(_mm_cvtps_ph(_mm_set_ss(a_src[i]), _MM_FROUND_TO_NEAREST_INT), 0));
+    }
+}
+
+void decompressFloat16Avx2(const uint16_t* a_src, float* a_dst, size_t a_count)
+{
+    size_t i = 0;
+    for (; i + 8 <= a_count; i += 8) {
+        const __m128i half = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_src + i));
+        _mm256_storeu_ps(a_dst + i, _mm256_cvtph_ps(half));
+    }
+    for (; i < a_count; ++i) {
+        a_dst[i] = _mm_cvtss_f32(_mm_cvtph_ps(_mm_cvtsi32_si128(a_src[i])));
+    }
+}
+#endif
+}  // namespace neural::utils
@@ -0,0 +1,216 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string_view>
+
+namespace neural::utils {
+
+LatencyHistogram::LatencyHistogram()
+    : m_buckets(getBucket(~0ull) + 1)
+{
+}
+
+uint32_t LatencyHistogram::getBucket(uint64_t a_value)
+{
+    a_value = std::min<uint64_t>(a_value, (2ull * k_subBucketCount << k_maxExponent) - 1);
+    if (a_value < 2 * k_subBucketCount) {
+        return static_cast<uint32_t>(a_value);
+    }
+    // a_value >> exponent is in [k_subBucketCount, 2 * k_subBucketCount)
+    const uint32_t exponent = static_cast<uint32_t>(std::bit_width(a_value)) - (k_subBucketBits + 1);
+    return (exponent << k_subBucketBits) + static_cast<uint32_t>(a_value >> exponent);
+}
+
+uint64_t LatencyHistogram::getBucketLow(uint32_t a_bucket)
+{
+    if (a_bucket < 2 * k_subBucketCount) {
+        return a_bucket;
+    }
+    const uint32_t exponent = (a_bucket >> k_subBucketBits) - 1;
+    return static_cast<uint64_t>(a_bucket - (exponent << k_subBucketBits)) << exponent;
+}
+
+uint64_t LatencyHistogram::getBucketHigh(uint32_t a_bucket)
+{
+    if (a_bucket < 2 * k_subBucketCount) {
+        return a_bucket;
+    }
+    const uint32_t exponent = (a_bucket >> k_subBucketBits) - 1;
+    return getBucketLow(a_bucket) + (1ull << exponent) - 1;
+}
+
+void LatencyHistogram::record(uint64_t a_microseconds)
+{
+    ++m_buckets[getBucket(a_microseconds)];
+    ++m_count;
+    m_sum += a_microseconds;
+    m_max = std::max(m_max, a_microseconds);
+}
+
+void LatencyHistogram::reset()
+{
+    std::fill(m_buckets.begin(), m_buckets.end(), 0);
+    m_count = 0;
+    m_sum = 0;
+    m_max = 0;
+}
+
+uint64_t LatencyHistogram::getPercentile(double a_percentile) const
+{
+    if (m_count == 0) {
+        return 0;
+    }
+    const double fraction = std::clamp(a_percentile, 0.0, 100.0) / 100.0;
+    const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(fraction * m_count)));
+    uint64_t seen = 0;
+    for (uint32_t bucket = 0; bucket < m_buckets.size(); ++bucket) {
+        seen += m_buckets[bucket];
+        if (seen >= rank) {
+            // The bucket of the max is only filled up to it
+            return std::min(getBucketHigh(bucket), m_max);
+        }
+    }
+    return m_max;
+}
+
+void FrameStats::initialize(const FrameStatsCreateInfo& a_createInfo)
+{
+    assert(a_createInfo.historySize > 0);
+    m_history.assign(a_createInfo.historySize, {});
+    m_budgetSeconds = a_createInfo.budgetSeconds;
+    reset();
+}
+
+void FrameStats::addFrame(double a_seconds)
+{
+    assert(!m_history.empty() && "not initialized");
+    const uint64_t index = m_histogram.getCount();
+    const bool hitch = a_seconds > m_budgetSeconds;
+    m_hitchCount += hitch;
+    m_history[index % m_history.size()] = {
+        .index = index,
+        .milliseconds = static_cast<float>(a_seconds * 1000.0),
+        .hitch = hitch
+    };
+    m_histogram.record(static_cast<uint64_t>(std::max(a_seconds, 0.0) * 1e6 + 0.5));
+}
+
+void FrameStats::reset()
+{
+    m_histogram.reset();
+    m_hitchCount = 0;
+}
+
+bool FrameStats::isHitch() const
+{
+    const uint64_t count = m_histogram.getCount();
+    return count > 0 && m_history[(count - 1) % m_history.size()].hitch;
+}
+
+FrameStatsSummary FrameStats::getSummary() const
+{
+    const auto toMs = [](uint64_t a_microseconds) {
+        return static_cast<double>(a_microseconds) / 1000.0;
+    };
+    return {
+        .frameCount = m_histogram.getCount(),
+        .hitchCount = m_hitchCount,
+        .budgetMs = m_budgetSeconds * 1000.0,
+        .meanMs = m_histogram.getMean() / 1000.0,
+        .p50Ms = toMs(m_histogram.getPercentile(50.0)),
+        .p90Ms = toMs(m_histogram.getPercentile(90.0)),
+        .p99Ms = toMs(m_histogram.getPercentile(99.0)),
+        .p999Ms = toMs(m_histogram.getPercentile(99.9)),
+        .maxMs = toMs(m_histogram.getMax())
+    };
+}
+
+bool FrameStats::writeCsv(const std::string& a_path) const
+{
+    std::FILE* file = std::fopen(a_path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    bool written = std::fprintf(file, "frame,ms,hitch\n") > 0;
+    const uint64_t count = m_histogram.getCount();
+    const uint64_t first = count > m_history.size() ? count - m_history.size() : 0;
+    for (uint64_t i = first; i < count && written; ++i) {
+        const Frame& frame = m_history[i % m_history.size()];
+        written = std::fprintf(file, "%llu,%.3f,%d\n", static_cast<unsigned long long>(frame.index),
+                               frame.milliseconds, frame.hitch ? 1 : 0) > 0;
+    }
+    return std::fclose(file) == 0 && written;
+}
+
+bool FrameStats::writeJson(const std::string& a_path) const
+{
+    std::FILE* file = std::fopen(a_path.c_str(), "w");
+    if (!file) {
+        return false;
+    }
+    const FrameStatsSummary summary = getSummary();
+    bool written = std::fprintf(file,
+        "{\n"
+        "  \"frames\": %llu,\n"
+        "  \"hitches\": %llu,\n"
+        "  \"budget_ms\": %.3f,\n"
+        "  \"mean_ms\": %.3f,\n"
+        "  \"p50_ms\": %.3f,\n"
+        "  \"p90_ms\": %.3f,\n"
+        "  \"p99_ms\": %.3f,\n"
+        "  \"p99_9_ms\": %.3f,\n"
+        "  \"max_ms\": %.3f,\n"
+        "  \"recent_hitches\": [",
+        static_cast<unsigned long long>(summary.frameCount), static_cast<unsigned long long>(summary.hitchCount),
+        summary.budgetMs, summary.meanMs, summary.p50Ms, summary.p90Ms, summary.p99Ms, summary.p999Ms,
+        summary.maxMs) > 0;
+    const uint64_t count = m_histogram.getCount();
+    const uint64_t first = count > m_history.size() ? count - m_history.size() : 0;
+    const char* separator = "";
+    for (uint64_t i = first; i < count && written; ++i) {
+        const Frame& frame = m_history[i % m_history.size()];
+        if (frame.hitch) {
+            written = std::fprintf(file, "%s\n    { \"frame\": %llu, \"ms\": %.3f }", separator,
+                                   static_cast<unsigned long long>(frame.index), frame.milliseconds) > 0;
+            separator = ",";
+        }
+    }
+    written = written && std::fprintf(file, "%s]\n}\n", *separator ? "\n  " : "") > 0;
+    return std::fclose(file) == 0 && written;
+}
+
+FrameStatsCreateInfo parseFrameStatsArguments(int a_argc, char** a_argv)
+{
+    FrameStatsCreateInfo createInfo;
+    for (int i = 1; i + 1 < a_argc; ++i) {
+        if (std::string_view(a_argv[i]) != "--budget-ms") {
+            continue;
+        }
+        char* end = nullptr;
+        const double milliseconds = std::strtod(a_argv[i + 1], &end);
+        if (end == a_argv[i + 1] || *end != '\0' || !std::isfinite(milliseconds) || milliseconds <= 0.0) {
+            std::printf("Ignoring --budget-ms %s, expected a positive number of milliseconds\n", a_argv[i + 1]);
+            continue;
+        }
+        createInfo.budgetSeconds = milliseconds / 1000.0;
+    }
+    return createInfo;
+}
+
+void reportFrameStats(const FrameStats& a_stats, const std::string& a_path)
+{
+    const FrameStatsSummary stats = a_stats.getSummary();
+    std::printf("%llu frames: mean %.2f p50 %.2f p90 %.2f p99 %.2f p99.9 %.2f max %.2f ms, %llu over %.1f ms\n",
+                static_cast<unsigned long long>(stats.frameCount), stats.meanMs, stats.p50Ms, stats.p90Ms,
+                stats.p99Ms, stats.p999Ms, stats.maxMs, static_cast<unsigned long long>(stats.hitchCount),
+                stats.budgetMs);
+    if (!a_stats.writeCsv(a_path + ".csv") || !a_stats.writeJson(a_path + ".json")) {
+        std::printf("Can't write the frame times to %s\n", a_path.c_str());
+    }
+}
+}  // namespace neural::utils
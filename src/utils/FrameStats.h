@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace neural::utils {
+
+// Histogram of microsecond values with a bounded relative error (HDR histogram): values below
+// 2 * k_subBucketCount have a bucket each, above that every power of two is split into k_subBucketCount
+// linear buckets, so a bucket is never wider than 1 / k_subBucketCount of its values. Recording is O(1),
+// memory doesn't depend on the number of values
+class LatencyHistogram {
+public:
+    static constexpr uint32_t k_subBucketBits = 7;
+    static constexpr uint32_t k_subBucketCount = 1 << k_subBucketBits;  // under 0.8% error
+    static constexpr uint32_t k_maxExponent = 32;                       // values up to 2^40 us, 12 days
+
+    LatencyHistogram();
+    void record(uint64_t a_microseconds);
+    void reset();
+
+    // The highest value of the bucket the a_percentile percent lowest values end in, 0 if empty
+    uint64_t getPercentile(double a_percentile) const;
+    uint64_t getCount() const {
+        return m_count;
+    }
+    uint64_t getMax() const {
+        return m_max;
+    }
+    double getMean() const {
+        return m_count > 0 ? static_cast<double>(m_sum) / static_cast<double>(m_count) : 0.0;
+    }
+
+    static uint32_t getBucket(uint64_t a_value);
+    // The values in a_bucket are [getBucketLow, getBucketHigh]
+    static uint64_t getBucketLow(uint32_t a_bucket);
+    static uint64_t getBucketHigh(uint32_t a_bucket);
+private:
+    std::vector<uint64_t> m_buckets;
+    uint64_t m_count = 0;
+    uint64_t m_sum = 0;
+    uint64_t m_max = 0;
+};
+
+struct FrameStatsCreateInfo {
+    uint32_t historySize = 4096;          // the last frames kept one by one for the CSV export
+    double budgetSeconds = 1.0 / 60.0;    // longer frames are hitches
+};
+
+struct FrameStatsSummary {
+    uint64_t frameCount;
+    uint64_t hitchCount;
+    double budgetMs;
+    double meanMs;
+    double p50Ms;
+    double p90Ms;
+    double p99Ms;
+    double p999Ms;
+    double maxMs;
+};
+
+// CPU frame times of a run: every frame goes into a LatencyHistogram for the percentiles of the whole run
+// and into a ring of the last historySize frames. Frames over the budget are counted as hitches, the ring
+// keeps which ones they were
+class FrameStats {
+public:
+    void initialize(const FrameStatsCreateInfo& a_createInfo);
+    void addFrame(double a_seconds);
+    void reset();
+
+    FrameStatsSummary getSummary() const;
+    uint64_t getFrameCount() const {
+        return m_histogram.getCount();
+    }
+    // Of the frame added last
+    bool isHitch() const;
+
+    // One line per frame of the ring: frame, ms, hitch
+    bool writeCsv(const std::string& a_path) const;
+    // The summary and the hitches of the ring
+    bool writeJson(const std::string& a_path) const;
+private:
+    struct Frame {
+        uint64_t index;
+        float milliseconds;
+        bool hitch;
+    };
+
+    LatencyHistogram m_histogram;
+    std::vector<Frame> m_history;  // ring, m_histogram.getCount() % size is the oldest once it is full
+    double m_budgetSeconds = 0.0;
+    uint64_t m_hitchCount = 0;
+};
+
+// --budget-ms <ms> of a command line, the other arguments are skipped. A value that isn't a positive number is
+// reported and the default budget kept
+FrameStatsCreateInfo parseFrameStatsArguments(int a_argc, char** a_argv);
+// Prints the summary and writes a_path.csv and a_path.json
+void reportFrameStats(const FrameStats& a_stats, const std::string& a_path);
+}  // namespace neural::utils
@@ -0,0 +1,25 @@
+#include "GBufferEncoding.h"
+
+namespace neural::utils {
+
+void decodeOctahedral(const uint32_t* a_src, size_t a_count, float* a_x, float* a_y, float* a_z)
+{
+#if NEURAL_ARCH_X64
+    if (getIsaTier() != IsaTier::Baseline) {
+        decodeOctahedralAvx2(a_src, a_count, a_x, a_y, a_z);
+        return;
+    }
+#endif
+    decodeOctahedralBaseline(a_src, a_count, a_x, a_y, a_z);
+}
+
+void decodeOctahedralBaseline(const uint32_t* a_src, size_t a_count, float* a_x, float* a_y, float* a_z)
+{
+    for (size_t i = 0; i < a_count; ++i) {
+        const std::array<float, 3> vector = decodeOctahedral(a_src[i]);
+        a_x[i] = vector[0];
+        a_y[i] = vector[1];
+        a_z[i] = vector[2];
+    }
+}
+}  // namespace neural::utils
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <utils/CpuFeatures.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace neural::utils {
+
+// Compact G-buffer texels, the same encodings as graphics/d3d12/shaders/GBufferEncoding.hlsli:
+//     unit vectors: octahedral in R16G16_UNORM, 4 bytes instead of 16. The vector is projected onto
+//                   |x| + |y| + |z| = 1, the lower half of the octahedron is folded over the diagonals onto
+//                   the upper one and x, y are stored as unorm16 with x in the low half. Max angular error
+//                   after decoding is 0.0037 degrees
+//     color:        R16G16B16A16_FLOAT, 8 bytes instead of 16
+inline namespace NEURAL_ISA_NAMESPACE {
+
+// The scalar functions are branch-free, so inside the lane loops of the per-ISA kernels they vectorize.
+// They use the helpers of utils/CpuFeatures.h, not std::. A zero vector encodes to 0, as NaN does in a
+// UNORM target
+inline uint32_t encodeOctahedral(float a_x, float a_y, float a_z)
+{
+    const float invLength = 1.0f / (isaAbs(a_x) + isaAbs(a_y) + isaAbs(a_z));
+    const float u = a_x * invLength;
+    const float v = a_y * invLength;
+    const float foldedU = (1.0f - isaAbs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+    const float foldedV = (1.0f - isaAbs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+    const float octU = a_z >= 0.0f ? u : foldedU;
+    const float octV = a_z >= 0.0f ? v : foldedV;
+    // Round to nearest, as the output merger converts to UNORM. max(0, NaN) is 0
+    const uint32_t x = static_cast<uint32_t>(isaMin(isaMax(0.0f, octU * 0.5f + 0.5f), 1.0f) * 65535.0f + 0.5f);
+    const uint32_t y = static_cast<uint32_t>(isaMin(isaMax(0.0f, octV * 0.5f + 0.5f), 1.0f) * 65535.0f + 0.5f);
+    return x | y << 16;
+}
+
+// a_u and a_v are the unorm values in [0, 1]
+inline std::array<float, 3> decodeOctahedral(float a_u, float a_v)
+{
+    float x = a_u * 2.0f - 1.0f;
+    float y = a_v * 2.0f - 1.0f;
+    const float z = 1.0f - isaAbs(x) - isaAbs(y);
+    const float fold = isaMax(-z, 0.0f);
+    x += x >= 0.0f ? -fold : fold;
+    y += y >= 0.0f ? -fold : fold;
+    const float invLength = 1.0f / isaSqrt(x * x + y * y + z * z);
+    return { x * invLength, y * invLength, z * invLength };
+}
+
+inline std::array<float, 3> decodeOctahedral(uint32_t a_packed)
+{
+    constexpr float k_scale = 1.0f / 65535.0f;
+    return decodeOctahedral(static_cast<float>(a_packed & 0xFFFFu) * k_scale,
+                            static_cast<float>(a_packed >> 16) * k_scale);
+}
+
+// Round to nearest even, as the output merger converts to FLOAT16. Finite values only, NaN becomes infinity
+inline uint16_t encodeFloat16(float a_value)
+{
+    const uint32_t bits = isaBitCast<uint32_t>(a_value);
+    const uint32_t sign = (bits >> 16) & 0x8000u;
+    const uint32_t magnitude = bits & 0x7FFFFFFFu;
+    // Below the smallest normal half, adding 0.5 lets the float adder round the mantissa into place
+    const uint32_t subnormal = isaBitCast<uint32_t>(isaBitCast<float>(magnitude) + 0.5f) - 0x3F000000u;
+    // Rebias the exponent from 127 to 15, then round the 13 dropped mantissa bits to even
+    const uint32_t normal = (magnitude - 0x38000000u + 0xFFFu + ((magnitude >> 13) & 1u)) >> 13;
+    const uint32_t half = magnitude < 0x38800000u ? subnormal
+                        : magnitude < 0x47800000u ? normal
+                                                  : 0x7C00u;
+    return static_cast<uint16_t>(half | sign);
+}
+
+}  // namespace NEURAL_ISA_NAMESPACE
+
+// Packed octahedral vectors to planes of x, y and z, the NCHW layout of the network inputs.
+// The tiers may differ in the last bit
+void decodeOctahedral(const uint32_t* a_src, size_t a_count, float* a_x, float* a_y, float* a_z);
+
+// Variants, each in its own translation unit
+void decodeOctahedralBaseline(const uint32_t* a_src, size_t a_count, float* a_x, float* a_y, float* a_z);
+void decodeOctahedralAvx2(const uint32_t* a_src, size_t a_count, float* a_x, float* a_y, float* a_z);
+}  // namespace neural::utils
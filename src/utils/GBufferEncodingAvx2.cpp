@@ -0,0 +1,38 @@
+// Compiled with AVX2, FMA and F16C, see src/CMakeLists.txt
+#include "GBufferEncoding.h"
+
+#if NEURAL_ARCH_X64
+#include <immintrin.h>
+#endif
+
+namespace neural::utils {
+#if NEURAL_ARCH_X64
+void decodeOctahedralAvx2(const uint32_t* a_src, size_t a_count, float* a_x, float* a_y, float* a_z)
+{
+    const __m256i lowHalf = _mm256_set1_epi32(0xFFFF);
+    const __m256 scale = _mm256_set1_ps(1.0f / 65535.0f);
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 two = _mm256_set1_ps(2.0f);
+    const __m256 signBit = _mm256_set1_ps(-0.0f);
+    size_t i = 0;
+    for (; i + 8 <= a_count; i += 8) {
+        const __m256i packed = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_src + i));
+        const __m256 u = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_and_si256(packed, lowHalf)), scale);
+        const __m256 v = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(packed, 16)), scale);
+        __m256 x = _mm256_fmsub_ps(u, two, one);
+        __m256 y = _mm256_fmsub_ps(v, two, one);
+        const __m256 z = _mm256_sub_ps(_mm256_sub_ps(one, _mm256_andnot_ps(signBit, x)), _mm256_andnot_ps(signBit, y));
+        // Moves x and y towards zero by the fold, x and y are never -0 here
+        const __m256 fold = _mm256_max_ps(_mm256_xor_ps(z, signBit), _mm256_setzero_ps());
+        x = _mm256_sub_ps(x, _mm256_or_ps(fold, _mm256_and_ps(x, signBit)));
+        y = _mm256_sub_ps(y, _mm256_or_ps(fold, _mm256_and_ps(y, signBit)));
+        const __m256 lengthSquared = _mm256_fmadd_ps(x, x, _mm256_fmadd_ps(y, y, _mm256_mul_ps(z, z)));
+        const __m256 invLength = _mm256_div_ps(one, _mm256_sqrt_ps(lengthSquared));
+        _mm256_storeu_ps(a_x + i, _mm256_mul_ps(x, invLength));
+        _mm256_storeu_ps(a_y + i, _mm256_mul_ps(y, invLength));
+        _mm256_storeu_ps(a_z + i, _mm256_mul_ps(z, invLength));
+    }
+    decodeOctahedralBaseline(a_src + i, a_count - i, a_x + i, a_y + i, a_z + i);
+}
+#endif
+}  // namespace neural::utils
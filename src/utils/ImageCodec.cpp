@@ -0,0 +1,61 @@
+#include "ImageCodecImpl.h"
+
+#include <cassert>
+
+namespace neural::utils {
+
+uint32_t getImageElementSize(ImageElement a_element)
+{
+    switch (a_element)
+    {
+    case ImageElement::Uint8:
+        return 1;
+    case ImageElement::Uint16:
+    case ImageElement::Float16:
+        return 2;
+    default:
+        return 4;
+    }
+}
+
+size_t getMaxCompressedImageSize(uint32_t a_width, uint32_t a_height, ImageElement a_element)
+{
+    const size_t blockCount = getCodecBlockCount(a_width, a_height);
+    return getCodecWidthsSize(blockCount) + blockCount * k_codecBlockSize * getImageElementSize(a_element);
+}
+
+size_t compressImage(const void* a_src, uint32_t a_width, uint32_t a_height, ImageElement a_element, uint8_t* a_dst)
+{
+    assert(a_width > 0 && a_height > 0);
+#if NEURAL_ARCH_X64
+    if (getIsaTier() != IsaTier::Baseline) {
+        return compressImageAvx2(a_src, a_width, a_height, a_element, a_dst);
+    }
+#endif
+    return compressImageBaseline(a_src, a_width, a_height, a_element, a_dst);
+}
+
+bool decompressImage(const uint8_t* a_src, size_t a_size, uint32_t a_width, uint32_t a_height, ImageElement a_element,
+                     void* a_dst)
+{
+    assert(a_width > 0 && a_height > 0);
+#if NEURAL_ARCH_X64
+    if (getIsaTier() != IsaTier::Baseline) {
+        return decompressImageAvx2(a_src, a_size, a_width, a_height, a_element, a_dst);
+    }
+#endif
+    return decompressImageBaseline(a_src, a_size, a_width, a_height, a_element, a_dst);
+}
+
+size_t compressImageBaseline(const void* a_src, uint32_t a_width, uint32_t a_height, ImageElement a_element,
+                             uint8_t* a_dst)
+{
+    return compressImageKernel(a_src, a_width, a_height, a_element, a_dst);
+}
+
+bool decompressImageBaseline(const uint8_t* a_src, size_t a_size, uint32_t a_width, uint32_t a_height,
+                             ImageElement a_element, void* a_dst)
+{
+    return decompressImageKernel(a_src, a_size, a_width, a_height, a_element, a_dst);
+}
+}  // namespace neural::utils
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace neural::utils {
+
+enum class ImageElement : uint32_t
+{
+    Uint8,
+    Uint16,
+    Float16,  // as uint16_t bits
+    Float32
+};
+
+// Lossless codec for image planes of smooth values, like the channels of G-buffer captures.
+// Floats are mapped to integers ordered like the floats, every value is predicted from its left, upper
+// and upper-left neighbours as left + up - upLeft, and the zigzagged residuals are bit-packed in blocks
+// of 256 with the smallest width that fits the block. The bits of a block are interleaved across 8
+// lanes, so packing and unpacking vectorize. Only bits are transformed, NaNs and denormals round-trip
+//     widths: one byte per block, padded to 4 bytes
+//     words:  width * 8 uint32 per block, value j * 8 + l is bits [j * width, (j + 1) * width) of lane l
+uint32_t getImageElementSize(ImageElement a_element);
+size_t getMaxCompressedImageSize(uint32_t a_width, uint32_t a_height, ImageElement a_element);
+// Returns the compressed size, a_dst must hold getMaxCompressedImageSize bytes
+size_t compressImage(const void* a_src, uint32_t a_width, uint32_t a_height, ImageElement a_element, uint8_t* a_dst);
+// False if a_src isn't a complete plane of this size
+bool decompressImage(const uint8_t* a_src, size_t a_size, uint32_t a_width, uint32_t a_height, ImageElement a_element,
+                     void* a_dst);
+
+// Variants, each in its own translation unit
+size_t compressImageBaseline(const void* a_src, uint32_t a_width, uint32_t a_height, ImageElement a_element,
+                             uint8_t* a_dst);
+bool decompressImageBaseline(const uint8_t* a_src, size_t a_size, uint32_t a_width, uint32_t a_height,
+                             ImageElement a_element, void* a_dst);
+size_t compressImageAvx2(const void* a_src, uint32_t a_width, uint32_t a_height, ImageElement a_element,
+                         uint8_t* a_dst);
+bool decompressImageAvx2(const uint8_t* a_src, size_t a_size, uint32_t a_width, uint32_t a_height,
+                         ImageElement a_element, void* a_dst);
+}  // namespace neural::utils
@@ -0,0 +1,18 @@
+// Compiled with AVX2, FMA and F16C, see src/CMakeLists.txt
+#include "ImageCodecImpl.h"
+
+namespace neural::utils {
+#if NEURAL_ARCH_X64
+size_t compressImageAvx2(const void* a_src, uint32_t a_width, uint32_t a_height, ImageElement a_element,
+                         uint8_t* a_dst)
+{
+    return compressImageKernel(a_src, a_width, a_height, a_element, a_dst);
+}
+
+bool decompressImageAvx2(const uint8_t* a_src, size_t a_size, uint32_t a_width, uint32_t a_height,
+                         ImageElement a_element, void* a_dst)
+{
+    return decompressImageKernel(a_src, a_size, a_width, a_height, a_element, a_dst);
+}
+#endif
+}  // namespace neural::utils
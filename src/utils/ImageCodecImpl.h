@@ -0,0 +1,374 @@
+#pragma once
+
+#include "ImageCodec.h"
+#include "CpuFeatures.h"
+
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace neural::utils {
+
+namespace {
+constexpr uint32_t k_codecLanes = 8;
+constexpr uint32_t k_codecBlockSize = 32 * k_codecLanes;
+
+size_t getCodecBlockCount(uint32_t a_width, uint32_t a_height)
+{
+    return (static_cast<size_t>(a_width) * a_height + k_codecBlockSize - 1) / k_codecBlockSize;
+}
+
+size_t getCodecWidthsSize(size_t a_blockCount)
+{
+    return (a_blockCount + 3) & ~size_t(3);
+}
+
+// Negative floats get all bits flipped and positive ones the sign bit, so the integers compare like the
+// floats and values close to each other stay close across zero
+template<typename T, bool Float>
+T toOrdered(T a_bits)
+{
+    if constexpr (Float) {
+        constexpr uint32_t k_signShift = sizeof(T) * 8 - 1;
+        return a_bits ^ static_cast<T>((0 - (a_bits >> k_signShift)) | (1u << k_signShift));
+    } else {
+        return a_bits;
+    }
+}
+
+template<typename T, bool Float>
+T fromOrdered(T a_value)
+{
+    if constexpr (Float) {
+        constexpr uint32_t k_signShift = sizeof(T) * 8 - 1;
+        return a_value ^ static_cast<T>(((a_value >> k_signShift) - 1) | (1u << k_signShift));
+    } else {
+        return a_value;
+    }
+}
+
+template<typename T>
+uint32_t zigzag(T a_residual)
+{
+    constexpr uint32_t k_signShift = sizeof(T) * 8 - 1;
+    return static_cast<T>((a_residual << 1) ^ (0 - (a_residual >> k_signShift)));
+}
+
+template<typename T>
+T unzigzag(uint32_t a_value)
+{
+    return static_cast<T>((a_value >> 1) ^ (0 - (a_value & 1)));
+}
+
+// Every step j is the same shift for all lanes
+#if defined(__AVX2__)
+void packBlock(const uint32_t* a_values, uint32_t a_width, uint32_t* a_words)
+{
+    std::memset(a_words, 0, a_width * k_codecLanes * sizeof(uint32_t));
+    for (uint32_t j = 0; j < 32; ++j) {
+        const uint32_t position = j * a_width;
+        const uint32_t shift = position & 31;
+        __m256i* low = reinterpret_cast<__m256i*>(a_words + (position >> 5) * k_codecLanes);
+        const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a_values + j * k_codecLanes));
+        _mm256_storeu_si256(low, _mm256_or_si256(_mm256_loadu_si256(low),
+                                                 _mm256_sll_epi32(values, _mm_cvtsi32_si128(shift))));
+        if (shift + a_width > 32) {
+            _mm256_storeu_si256(low + 1, _mm256_srl_epi32(values, _mm_cvtsi32_si128(32 - shift)));
+        }
+    }
+}
+
+// Unpacks a block and writes the running sum of its unzigzagged residuals, continuing from a_sum. Step j
+// unpacks the values [8 * j, 8 * j + 8), so the sum goes along in registers: three shifted adds within the
+// 8 lanes and the last lane of the step before as the carry. The width is a template argument, so the
+// loop unrolls into fixed shifts
+template<uint32_t Width>
+void unpackBlockSums(const uint8_t* a_words, uint32_t& a_sum, uint32_t* a_sums)
+{
+    if constexpr (Width == 0) {
+        for (uint32_t i = 0; i < k_codecBlockSize; ++i) {
+            a_sums[i] = a_sum;
+        }
+    } else {
+        const __m256i mask = _mm256_set1_epi32(static_cast<int32_t>((uint64_t(1) << Width) - 1));
+        const __m256i one = _mm256_set1_epi32(1);
+        const __m256i lastLane = _mm256_set1_epi32(7);
+        __m256i carry = _mm256_set1_epi32(static_cast<int32_t>(a_sum));
+        for (uint32_t j = 0; j < 32; ++j) {
+            const uint32_t position = j * Width;
+            const uint32_t shift = position & 31;
+            const uint8_t* low = a_words + (position >> 5) * k_codecLanes * sizeof(uint32_t);
+            __m256i values = _mm256_srl_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(low)),
+                                              _mm_cvtsi32_si128(shift));
+            if (shift + Width > 32) {
+                const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(low) + 1);
+                values = _mm256_or_si256(values, _mm256_sll_epi32(high, _mm_cvtsi32_si128(32 - shift)));
+            }
+            values = _mm256_and_si256(values, mask);
+            values = _mm256_xor_si256(_mm256_srli_epi32(values, 1),
+                                      _mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(values, one)));
+            values = _mm256_add_epi32(values, _mm256_slli_si256(values, 4));
+            values = _mm256_add_epi32(values, _mm256_slli_si256(values, 8));
+            // The upper 128 bits get the total of the lower ones
+            const __m256i lowTotal = _mm256_shuffle_epi32(_mm256_permute2x128_si256(values, values, 0x08), 0xff);
+            values = _mm256_add_epi32(_mm256_add_epi32(values, lowTotal), carry);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(a_sums + j * k_codecLanes), values);
+            carry = _mm256_permutevar8x32_epi32(values, lastLane);
+        }
+        a_sum = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm256_castsi256_si128(carry)));
+    }
+}
+#else
+// Lanes go through local arrays, so the compiler vectorizes the lane loops without proving that
+// a_values and a_words don't overlap
+void packBlock(const uint32_t* a_values, uint32_t a_width, uint32_t* a_words)
+{
+    std::memset(a_words, 0, a_width * k_codecLanes * sizeof(uint32_t));
+    for (uint32_t j = 0; j < 32; ++j) {
+        const uint32_t position = j * a_width;
+        const uint32_t shift = position & 31;
+        uint32_t* low = a_words + (position >> 5) * k_codecLanes;
+        uint32_t values[k_codecLanes];
+        std::memcpy(values, a_values + j * k_codecLanes, sizeof(values));
+        uint32_t lanes[k_codecLanes];
+        for (uint32_t l = 0; l < k_codecLanes; ++l) {
+            lanes[l] = low[l] | (values[l] << shift);
+        }
+        std::memcpy(low, lanes, sizeof(lanes));
+        if (shift + a_width > 32) {
+            for (uint32_t l = 0; l < k_codecLanes; ++l) {
+                lanes[l] = values[l] >> (32 - shift);
+            }
+            std::memcpy(low + k_codecLanes, lanes, sizeof(lanes));
+        }
+    }
+}
+
+template<uint32_t Width>
+void unpackBlockSums(const uint8_t* a_words, uint32_t& a_sum, uint32_t* a_sums)
+{
+    if constexpr (Width == 0) {
+        for (uint32_t i = 0; i < k_codecBlockSize; ++i) {
+            a_sums[i] = a_sum;
+        }
+    } else {
+        const uint32_t mask = static_cast<uint32_t>((uint64_t(1) << Width) - 1);
+        uint32_t sum = a_sum;
+        for (uint32_t j = 0; j < 32; ++j) {
+            const uint32_t position = j * Width;
+            const uint32_t shift = position & 31;
+            const uint8_t* words = a_words + (position >> 5) * k_codecLanes * sizeof(uint32_t);
+            uint32_t low[k_codecLanes];
+            std::memcpy(low, words, sizeof(low));
+            uint32_t values[k_codecLanes];
+            if (shift + Width > 32) {
+                uint32_t high[k_codecLanes];
+                std::memcpy(high, words + sizeof(low), sizeof(high));
+                for (uint32_t l = 0; l < k_codecLanes; ++l) {
+                    values[l] = ((low[l] >> shift) | (high[l] << (32 - shift))) & mask;
+                }
+            } else {
+                for (uint32_t l = 0; l < k_codecLanes; ++l) {
+                    values[l] = (low[l] >> shift) & mask;
+                }
+            }
+            for (uint32_t l = 0; l < k_codecLanes; ++l) {
+                sum += unzigzag<uint32_t>(values[l]);
+                a_sums[j * k_codecLanes + l] = sum;
+            }
+        }
+        a_sum = sum;
+    }
+}
+#endif
+
+using UnpackBlockSumsFunction = void (*)(const uint8_t* a_words, uint32_t& a_sum, uint32_t* a_sums);
+
+template<uint32_t... Widths>
+struct UnpackBlockSumsTable {
+    static constexpr UnpackBlockSumsFunction functions[] = { unpackBlockSums<Widths>... };
+};
+
+// Only named in decltype, the widths 0 to 32 as a parameter pack
+template<uint32_t... Widths>
+UnpackBlockSumsTable<Widths...> getUnpackBlockSumsTable(std::integer_sequence<uint32_t, Widths...>);
+
+// Reads width * 8 words
+void unpackBlockSums(const uint8_t* a_words, uint32_t a_width, uint32_t& a_sum, uint32_t* a_sums)
+{
+    using Table = decltype(getUnpackBlockSumsTable(std::make_integer_sequence<uint32_t, 33>()));
+    Table::functions[a_width](a_words, a_sum, a_sums);
+}
+
+// Residuals are produced row by row and packed whenever a block is full, blocks continue across rows
+template<typename T, bool Float>
+size_t compressImageT(const T* a_src, uint32_t a_width, uint32_t a_height, uint8_t* a_dst)
+{
+    const size_t blockCount = getCodecBlockCount(a_width, a_height);
+    uint8_t* widths = a_dst;
+    const size_t widthsSize = getCodecWidthsSize(blockCount);
+    std::memset(widths + blockCount, 0, widthsSize - blockCount);
+    uint8_t* words = a_dst + widthsSize;
+
+    uint32_t block[k_codecBlockSize];
+    uint32_t packed[k_codecBlockSize];
+    uint32_t blockSize = 0;
+    auto packResiduals = [&]() {
+        std::memset(block + blockSize, 0, (k_codecBlockSize - blockSize) * sizeof(uint32_t));
+        uint32_t bits = 0;
+        for (uint32_t i = 0; i < k_codecBlockSize; ++i) {
+            bits |= block[i];
+        }
+        uint32_t width = 0;
+        while (width < 32 && bits >> width != 0) {
+            ++width;
+        }
+        *widths++ = static_cast<uint8_t>(width);
+        packBlock(block, width, packed);
+        std::memcpy(words, packed, width * k_codecLanes * sizeof(uint32_t));
+        words += width * k_codecLanes * sizeof(uint32_t);
+        blockSize = 0;
+    };
+
+    // current - left - up + upLeft is the step to the left minus the one above it. Neighbours outside the
+    // image are 0, so the first value of a row is predicted from above only
+    for (uint32_t y = 0; y < a_height; ++y) {
+        const T* row = a_src + static_cast<size_t>(y) * a_width;
+        const T* above = row - a_width;
+        for (uint32_t x = 0; x < a_width; ) {
+            const uint32_t count = isaMin(k_codecBlockSize - blockSize, a_width - x);
+            if (x == 0) {
+                const T up = y > 0 ? toOrdered<T, Float>(above[0]) : T(0);
+                block[blockSize] = zigzag<T>(static_cast<T>(toOrdered<T, Float>(row[0]) - up));
+            }
+            // From here on every value has a left neighbour
+            const uint32_t first = x == 0 ? 1 : 0;
+            const T* values = row + x + first;
+            const T* left = values - 1;
+            uint32_t* residuals = block + blockSize + first;
+            if (y == 0) {
+                for (uint32_t i = 0; i < count - first; ++i) {
+                    const T step = static_cast<T>(toOrdered<T, Float>(values[i]) - toOrdered<T, Float>(left[i]));
+                    residuals[i] = zigzag<T>(step);
+                }
+            } else {
+                const T* valuesAbove = values - a_width;
+                const T* leftAbove = left - a_width;
+                for (uint32_t i = 0; i < count - first; ++i) {
+                    const T step = static_cast<T>(toOrdered<T, Float>(values[i]) - toOrdered<T, Float>(left[i]));
+                    const T stepAbove = static_cast<T>(toOrdered<T, Float>(valuesAbove[i]) -
+                                                       toOrdered<T, Float>(leftAbove[i]));
+                    residuals[i] = zigzag<T>(static_cast<T>(step - stepAbove));
+                }
+            }
+            blockSize += count;
+            x += count;
+            if (blockSize == k_codecBlockSize) {
+                packResiduals();
+            }
+        }
+    }
+    if (blockSize > 0) {
+        packResiduals();
+    }
+    return words - a_dst;
+}
+
+template<typename T, bool Float>
+bool decompressImageT(const uint8_t* a_src, size_t a_size, uint32_t a_width, uint32_t a_height, T* a_dst)
+{
+    const size_t blockCount = getCodecBlockCount(a_width, a_height);
+    const size_t widthsSize = getCodecWidthsSize(blockCount);
+    if (a_size < widthsSize) {
+        return false;
+    }
+    size_t wordsSize = 0;
+    for (size_t b = 0; b < blockCount; ++b) {
+        if (a_src[b] > sizeof(T) * 8) {
+            return false;
+        }
+        wordsSize += a_src[b] * k_codecLanes * sizeof(uint32_t);
+    }
+    if (a_size != widthsSize + wordsSize) {
+        return false;
+    }
+
+    const uint8_t* widths = a_src;
+    const uint8_t* words = a_src + widthsSize;
+    uint32_t sums[k_codecBlockSize];
+    uint32_t blockUsed = k_codecBlockSize;
+
+    // The residuals of a row add up to the difference to the row above, left + up - upLeft telescopes.
+    // So a row is the row above plus the running sum of its residuals, the first row has zeros above.
+    // The sum runs over the whole stream and the row subtracts the sum before it, both wrap around
+    uint32_t sum = 0;
+    uint32_t rowBase = 0;
+    for (uint32_t y = 0; y < a_height; ++y) {
+        T* row = a_dst + static_cast<size_t>(y) * a_width;
+        const T* above = row - a_width;
+        for (uint32_t x = 0; x < a_width; ) {
+            if (blockUsed == k_codecBlockSize) {
+                const uint32_t width = *widths++;
+                unpackBlockSums(words, width, sum, sums);
+                words += width * k_codecLanes * sizeof(uint32_t);
+                blockUsed = 0;
+            }
+            const uint32_t count = isaMin(k_codecBlockSize - blockUsed, a_width - x);
+            // Pointers rather than x + i, which may wrap and keeps the loops from vectorizing
+            const uint32_t* rowSums = sums + blockUsed;
+            T* values = row + x;
+            if (y == 0) {
+                for (uint32_t i = 0; i < count; ++i) {
+                    values[i] = fromOrdered<T, Float>(static_cast<T>(rowSums[i] - rowBase));
+                }
+            } else {
+                const T* valuesAbove = above + x;
+                for (uint32_t i = 0; i < count; ++i) {
+                    const T ordered = toOrdered<T, Float>(valuesAbove[i]);
+                    values[i] = fromOrdered<T, Float>(static_cast<T>(ordered + (rowSums[i] - rowBase)));
+                }
+            }
+            blockUsed += count;
+            x += count;
+        }
+        rowBase = sums[blockUsed - 1];
+    }
+    return true;
+}
+
+size_t compressImageKernel(const void* a_src, uint32_t a_width, uint32_t a_height, ImageElement a_element,
+                           uint8_t* a_dst)
+{
+    switch (a_element)
+    {
+    case ImageElement::Uint8:
+        return compressImageT<uint8_t, false>(static_cast<const uint8_t*>(a_src), a_width, a_height, a_dst);
+    case ImageElement::Uint16:
+        return compressImageT<uint16_t, false>(static_cast<const uint16_t*>(a_src), a_width, a_height, a_dst);
+    case ImageElement::Float16:
+        return compressImageT<uint16_t, true>(static_cast<const uint16_t*>(a_src), a_width, a_height, a_dst);
+    default:
+        return compressImageT<uint32_t, true>(static_cast<const uint32_t*>(a_src), a_width, a_height, a_dst);
+    }
+}
+
+bool decompressImageKernel(const uint8_t* a_src, size_t a_size, uint32_t a_width, uint32_t a_height,
+                           ImageElement a_element, void* a_dst)
+{
+    switch (a_element)
+    {
+    case ImageElement::Uint8:
+        return decompressImageT<uint8_t, false>(a_src, a_size, a_width, a_height, static_cast<uint8_t*>(a_dst));
+    case ImageElement::Uint16:
+        return decompressImageT<uint16_t, false>(a_src, a_size, a_width, a_height, static_cast<uint16_t*>(a_dst));
+    case ImageElement::Float16:
+        return decompressImageT<uint16_t, true>(a_src, a_size, a_width, a_height, static_cast<uint16_t*>(a_dst));
+    default:
+        return decompressImageT<uint32_t, true>(a_src, a_size, a_width, a_height, static_cast<uint32_t*>(a_dst));
+    }
+}
+}  // anonymous namespace
+}  // namespace neural::utils
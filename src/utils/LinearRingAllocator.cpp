@@ -0,0 +1,73 @@
+#include "LinearRingAllocator.h"
+
+#include <bit>
+#include <cassert>
+
+namespace neural::utils {
+
+void LinearRingAllocator::initialize(uint64_t a_capacity)
+{
+    assert(a_capacity > 0);
+    m_capacity = a_capacity;
+    m_head = 0;
+    m_tail = 0;
+    m_usedSize = 0;
+    m_openFrameSize = 0;
+    m_frames.clear();
+}
+
+uint64_t LinearRingAllocator::allocate(uint64_t a_size, uint64_t a_alignment)
+{
+    assert(a_size > 0);
+    assert(std::has_single_bit(a_alignment));
+    if (m_usedSize == 0) {
+        m_head = 0;
+        m_tail = 0;
+    } else if (m_usedSize == m_capacity) {
+        return k_invalidOffset;
+    }
+
+    uint64_t offset = (m_head + a_alignment - 1) & ~(a_alignment - 1);
+    uint64_t size;  // with the padding in front
+    if (m_head >= m_tail) {
+        // The live bytes are [tail, head), both [head, capacity) and [0, tail) are free
+        if (offset + a_size <= m_capacity) {
+            size = offset + a_size - m_head;
+        } else if (a_size <= m_tail) {
+            offset = 0;
+            size = m_capacity - m_head + a_size;
+        } else {
+            return k_invalidOffset;
+        }
+    } else {
+        // Wrapped, only [head, tail) is free
+        if (offset + a_size > m_tail) {
+            return k_invalidOffset;
+        }
+        size = offset + a_size - m_head;
+    }
+    m_head = offset + a_size == m_capacity ? 0 : offset + a_size;
+    m_usedSize += size;
+    m_openFrameSize += size;
+    return offset;
+}
+
+void LinearRingAllocator::finishFrame(uint64_t a_fenceValue)
+{
+    assert(m_frames.empty() || m_frames.back().fenceValue <= a_fenceValue);
+    if (m_openFrameSize == 0) {
+        return;
+    }
+    m_frames.push_back({ .fenceValue = a_fenceValue, .end = m_head, .size = m_openFrameSize });
+    m_openFrameSize = 0;
+}
+
+void LinearRingAllocator::retire(uint64_t a_completedFenceValue)
+{
+    while (!m_frames.empty() && m_frames.front().fenceValue <= a_completedFenceValue) {
+        m_tail = m_frames.front().end;
+        m_usedSize -= m_frames.front().size;
+        m_frames.pop_front();
+    }
+}
+}  // namespace neural::utils
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+namespace neural::utils {
+
+// Offsets in a ring for per-frame data written by the CPU and read by the GPU. Allocations are bumped
+// from the head and belong to the open frame, finishFrame closes it with the fence value the GPU signals
+// after it. retire gives back the space of every frame whose fence value has been reached, oldest first.
+// An allocation that doesn't fit before the end of the ring starts again at 0, the skipped bytes are
+// retired with its frame
+class LinearRingAllocator {
+public:
+    static constexpr uint64_t k_invalidOffset = ~0ull;
+
+    void initialize(uint64_t a_capacity);
+    // a_alignment is a power of two. k_invalidOffset if the frames in flight leave no room
+    uint64_t allocate(uint64_t a_size, uint64_t a_alignment);
+    void finishFrame(uint64_t a_fenceValue);
+    void retire(uint64_t a_completedFenceValue);
+
+    uint64_t getCapacity() const {
+        return m_capacity;
+    }
+    // With the alignment padding and the skipped ends
+    uint64_t getUsedSize() const {
+        return m_usedSize;
+    }
+private:
+    struct Frame {
+        uint64_t fenceValue;
+        uint64_t end;   // the head when the frame was finished
+        uint64_t size;
+    };
+
+    uint64_t m_capacity = 0;
+    uint64_t m_head = 0;
+    uint64_t m_tail = 0;        // start of the oldest frame in flight
+    uint64_t m_usedSize = 0;
+    uint64_t m_openFrameSize = 0;
+    std::deque<Frame> m_frames;
+};
+}  // namespace neural::utils
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace neural::utils {
+
+// Read-only mapping of a whole file, the pages are read on first touch
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile();
+
+    // False if the file is missing or empty
+    bool open(const std::string& a_path);
+    void close();
+
+    const uint8_t* getData() const {
+        return m_data;
+    }
+    size_t getSize() const {
+        return m_size;
+    }
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    void* m_file = nullptr;
+    void* m_mapping = nullptr;
+#endif
+};
+}  // namespace neural::utils
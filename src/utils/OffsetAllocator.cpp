@@ -0,0 +1,250 @@
+#include "OffsetAllocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+
+namespace neural::utils {
+
+void OffsetAllocator::initialize(uint64_t a_capacity, uint64_t a_granularity)
+{
+    assert(std::has_single_bit(a_granularity));
+    assert(a_capacity > 0 && a_capacity % a_granularity == 0);
+    m_capacity = a_capacity;
+    m_granularityShift = static_cast<uint32_t>(std::countr_zero(a_granularity));
+    m_levelBitmap = 0;
+    m_subclassBitmaps.fill(0);
+    for (auto& lists : m_freeLists) {
+        lists.fill(k_invalidNode);
+    }
+    m_nodes.clear();
+    m_unusedNodes.clear();
+    m_usedSize = 0;
+    m_allocationCount = 0;
+    m_freeBlockCount = 0;
+    insertFreeNode(createNode(0, a_capacity, k_invalidNode, k_invalidNode));
+}
+
+OffsetAllocator::Allocation OffsetAllocator::allocate(uint64_t a_size, uint64_t a_alignment)
+{
+    assert(a_size > 0);
+    assert(std::has_single_bit(a_alignment));
+    const uint64_t granularity = 1ull << m_granularityShift;
+    const uint64_t alignment = std::max(a_alignment, granularity);
+    const uint64_t size = (a_size + granularity - 1) & ~(granularity - 1);
+    if (size > m_capacity) {
+        return {};
+    }
+
+    // The first block of the class usually fits as it is, otherwise one with room for the worst padding
+    uint32_t node = findFreeNode(size);
+    uint64_t offset = 0;
+    if (node != k_invalidNode) {
+        offset = (m_nodes[node].offset + alignment - 1) & ~(alignment - 1);
+    }
+    if (node == k_invalidNode || offset + size > m_nodes[node].offset + m_nodes[node].size) {
+        node = findFreeNode(size + alignment - granularity);
+        if (node == k_invalidNode) {
+            // The rounded-up searches skip the class of the size itself, where an exact fit may be listed
+            node = findFittingNode(size, alignment);
+            if (node == k_invalidNode) {
+                return {};
+            }
+        }
+        offset = (m_nodes[node].offset + alignment - 1) & ~(alignment - 1);
+    }
+    removeFreeNode(node);
+
+    if (offset > m_nodes[node].offset) {
+        const uint32_t aligned = splitNode(node, offset - m_nodes[node].offset);
+        insertFreeNode(node);
+        node = aligned;
+    }
+    if (m_nodes[node].size > size) {
+        insertFreeNode(splitNode(node, size));
+    }
+    m_usedSize += size;
+    ++m_allocationCount;
+    return { .offset = offset, .node = node };
+}
+
+void OffsetAllocator::free(const Allocation& a_allocation)
+{
+    assert(a_allocation.isValid() && a_allocation.node < m_nodes.size());
+    uint32_t node = a_allocation.node;
+    assert(!m_nodes[node].isFree && m_nodes[node].offset == a_allocation.offset);
+    m_usedSize -= m_nodes[node].size;
+    --m_allocationCount;
+
+    const uint32_t prev = m_nodes[node].prevPhysical;
+    if (prev != k_invalidNode && m_nodes[prev].isFree) {
+        removeFreeNode(prev);
+        m_nodes[prev].size += m_nodes[node].size;
+        m_nodes[prev].nextPhysical = m_nodes[node].nextPhysical;
+        if (m_nodes[node].nextPhysical != k_invalidNode) {
+            m_nodes[m_nodes[node].nextPhysical].prevPhysical = prev;
+        }
+        m_unusedNodes.push_back(node);
+        node = prev;
+    }
+    const uint32_t next = m_nodes[node].nextPhysical;
+    if (next != k_invalidNode && m_nodes[next].isFree) {
+        removeFreeNode(next);
+        m_nodes[node].size += m_nodes[next].size;
+        m_nodes[node].nextPhysical = m_nodes[next].nextPhysical;
+        if (m_nodes[next].nextPhysical != k_invalidNode) {
+            m_nodes[m_nodes[next].nextPhysical].prevPhysical = node;
+        }
+        m_unusedNodes.push_back(next);
+    }
+    insertFreeNode(node);
+}
+
+OffsetAllocatorStats OffsetAllocator::getStats() const
+{
+    uint64_t largestFreeBlock = 0;
+    if (m_levelBitmap != 0) {
+        const uint32_t level = 63 - static_cast<uint32_t>(std::countl_zero(m_levelBitmap));
+        const uint32_t subclass = 31 - static_cast<uint32_t>(std::countl_zero(m_subclassBitmaps[level]));
+        for (uint32_t node = m_freeLists[level][subclass]; node != k_invalidNode; node = m_nodes[node].nextFree) {
+            largestFreeBlock = std::max(largestFreeBlock, m_nodes[node].size);
+        }
+    }
+    return {
+        .capacity = m_capacity,
+        .usedSize = m_usedSize,
+        .freeSize = m_capacity - m_usedSize,
+        .largestFreeBlock = largestFreeBlock,
+        .allocationCount = m_allocationCount,
+        .freeBlockCount = m_freeBlockCount
+    };
+}
+
+OffsetAllocator::SizeClass OffsetAllocator::getClass(uint64_t a_size) const
+{
+    const uint64_t units = a_size >> m_granularityShift;
+    assert(units > 0);
+    if (units < k_subclassCount) {
+        return { 0, static_cast<uint32_t>(units) };
+    }
+    const uint32_t log2 = 63 - static_cast<uint32_t>(std::countl_zero(units));
+    return {
+        .level = log2 - k_subclassBits + 1,
+        .subclass = static_cast<uint32_t>(units >> (log2 - k_subclassBits)) & (k_subclassCount - 1)
+    };
+}
+
+uint32_t OffsetAllocator::findFreeNode(uint64_t a_size) const
+{
+    // Rounded up to the next class, every block listed there or above is big enough
+    uint64_t size = a_size;
+    const uint64_t units = size >> m_granularityShift;
+    if (units >= k_subclassCount) {
+        const uint32_t log2 = 63 - static_cast<uint32_t>(std::countl_zero(units));
+        size += ((1ull << (log2 - k_subclassBits)) - 1) << m_granularityShift;
+    }
+    SizeClass sizeClass = getClass(size);
+    uint32_t subclasses = m_subclassBitmaps[sizeClass.level] & (~0u << sizeClass.subclass);
+    if (subclasses == 0) {
+        const uint64_t levels = sizeClass.level + 1 < k_classCount ? m_levelBitmap & (~0ull << (sizeClass.level + 1))
+                                                                    : 0;
+        if (levels == 0) {
+            return k_invalidNode;
+        }
+        sizeClass.level = static_cast<uint32_t>(std::countr_zero(levels));
+        subclasses = m_subclassBitmaps[sizeClass.level];
+    }
+    sizeClass.subclass = static_cast<uint32_t>(std::countr_zero(subclasses));
+    return m_freeLists[sizeClass.level][sizeClass.subclass];
+}
+
+uint32_t OffsetAllocator::findFittingNode(uint64_t a_size, uint64_t a_alignment) const
+{
+    const SizeClass sizeClass = getClass(a_size);
+    for (uint32_t node = m_freeLists[sizeClass.level][sizeClass.subclass]; node != k_invalidNode;
+         node = m_nodes[node].nextFree) {
+        const uint64_t offset = (m_nodes[node].offset + a_alignment - 1) & ~(a_alignment - 1);
+        if (offset + a_size <= m_nodes[node].offset + m_nodes[node].size) {
+            return node;
+        }
+    }
+    return k_invalidNode;
+}
+
+uint32_t OffsetAllocator::createNode(uint64_t a_offset, uint64_t a_size, uint32_t a_prevPhysical,
+                                     uint32_t a_nextPhysical)
+{
+    uint32_t node;
+    if (!m_unusedNodes.empty()) {
+        node = m_unusedNodes.back();
+        m_unusedNodes.pop_back();
+    } else {
+        node = static_cast<uint32_t>(m_nodes.size());
+        m_nodes.emplace_back();
+    }
+    m_nodes[node] = {
+        .offset = a_offset,
+        .size = a_size,
+        .prevPhysical = a_prevPhysical,
+        .nextPhysical = a_nextPhysical,
+        .prevFree = k_invalidNode,
+        .nextFree = k_invalidNode,
+        .isFree = false
+    };
+    return node;
+}
+
+void OffsetAllocator::insertFreeNode(uint32_t a_node)
+{
+    const SizeClass sizeClass = getClass(m_nodes[a_node].size);
+    uint32_t& head = m_freeLists[sizeClass.level][sizeClass.subclass];
+    m_nodes[a_node].isFree = true;
+    m_nodes[a_node].prevFree = k_invalidNode;
+    m_nodes[a_node].nextFree = head;
+    if (head != k_invalidNode) {
+        m_nodes[head].prevFree = a_node;
+    }
+    head = a_node;
+    m_subclassBitmaps[sizeClass.level] |= 1u << sizeClass.subclass;
+    m_levelBitmap |= 1ull << sizeClass.level;
+    ++m_freeBlockCount;
+}
+
+void OffsetAllocator::removeFreeNode(uint32_t a_node)
+{
+    Node& node = m_nodes[a_node];
+    assert(node.isFree);
+    if (node.prevFree != k_invalidNode) {
+        m_nodes[node.prevFree].nextFree = node.nextFree;
+    } else {
+        const SizeClass sizeClass = getClass(node.size);
+        m_freeLists[sizeClass.level][sizeClass.subclass] = node.nextFree;
+        if (node.nextFree == k_invalidNode) {
+            m_subclassBitmaps[sizeClass.level] &= ~(1u << sizeClass.subclass);
+            if (m_subclassBitmaps[sizeClass.level] == 0) {
+                m_levelBitmap &= ~(1ull << sizeClass.level);
+            }
+        }
+    }
+    if (node.nextFree != k_invalidNode) {
+        m_nodes[node.nextFree].prevFree = node.prevFree;
+    }
+    node.isFree = false;
+    --m_freeBlockCount;
+}
+
+uint32_t OffsetAllocator::splitNode(uint32_t a_node, uint64_t a_size)
+{
+    assert(!m_nodes[a_node].isFree && a_size < m_nodes[a_node].size);
+    const uint32_t rest = createNode(m_nodes[a_node].offset + a_size, m_nodes[a_node].size - a_size, a_node,
+                                     m_nodes[a_node].nextPhysical);
+    // createNode may have moved the nodes
+    Node& node = m_nodes[a_node];
+    if (node.nextPhysical != k_invalidNode) {
+        m_nodes[node.nextPhysical].prevPhysical = rest;
+    }
+    node.nextPhysical = rest;
+    node.size = a_size;
+    return rest;
+}
+}  // namespace neural::utils
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace neural::utils {
+
+struct OffsetAllocatorStats {
+    uint64_t capacity;
+    uint64_t usedSize;          // allocated, with the granularity round-up
+    uint64_t freeSize;
+    uint64_t largestFreeBlock;
+    uint32_t allocationCount;
+    uint32_t freeBlockCount;
+    // 0 when all the free space is one block, close to 1 when it is scattered in small blocks
+    float getFragmentation() const {
+        return freeSize > 0 ? 1.0f - static_cast<float>(largestFreeBlock) / static_cast<float>(freeSize) : 0.0f;
+    }
+};
+
+// Two-level segregated fit (TLSF) allocator of offsets in a range, for memory it doesn't touch such as
+// GPU heaps. Free blocks are kept in lists by size class: the first level is the power of two of the size,
+// the second one splits it in k_subclassCount linear classes, bitmaps of both levels find the first non-empty
+// list that only holds big enough blocks in a few bit scans. allocate and free are O(1), freed blocks are
+// merged with their free neighbours. When no class above the request has a block, the list of its own class
+// is walked for one that fits. Sizes are rounded up to the granularity, an alignment above it costs the
+// allocation up to alignment - granularity bytes that go back to the free lists
+class OffsetAllocator {
+public:
+    static constexpr uint32_t k_invalidNode = ~0u;
+    static constexpr uint32_t k_subclassBits = 4;
+    static constexpr uint32_t k_subclassCount = 1 << k_subclassBits;
+
+    struct Allocation {
+        uint64_t offset = 0;
+        uint32_t node = k_invalidNode;
+        bool isValid() const {
+            return node != k_invalidNode;
+        }
+    };
+
+    // a_granularity is a power of two, the smallest alignment class. a_capacity is a multiple of it
+    void initialize(uint64_t a_capacity, uint64_t a_granularity);
+    // a_alignment is a power of two. Invalid if no free block is big enough
+    Allocation allocate(uint64_t a_size, uint64_t a_alignment);
+    void free(const Allocation& a_allocation);
+
+    uint64_t getAllocationSize(const Allocation& a_allocation) const {
+        return m_nodes[a_allocation.node].size;
+    }
+    uint64_t getCapacity() const {
+        return m_capacity;
+    }
+    bool isEmpty() const {
+        return m_allocationCount == 0;
+    }
+    // O(number of free blocks in the largest size class)
+    OffsetAllocatorStats getStats() const;
+private:
+    static constexpr uint32_t k_classCount = 64;
+    struct Node {
+        uint64_t offset;
+        uint64_t size;
+        uint32_t prevPhysical;  // neighbours in the range
+        uint32_t nextPhysical;
+        uint32_t prevFree;      // in the list of the size class
+        uint32_t nextFree;
+        bool isFree;
+    };
+    struct SizeClass {
+        uint32_t level;
+        uint32_t subclass;
+    };
+    // The class a block of a_size is listed in
+    SizeClass getClass(uint64_t a_size) const;
+    uint32_t findFreeNode(uint64_t a_size) const;
+    // Walks the list of the class of a_size for a block that holds it once aligned, O(length of the list)
+    uint32_t findFittingNode(uint64_t a_size, uint64_t a_alignment) const;
+    uint32_t createNode(uint64_t a_offset, uint64_t a_size, uint32_t a_prevPhysical, uint32_t a_nextPhysical);
+    void insertFreeNode(uint32_t a_node);
+    void removeFreeNode(uint32_t a_node);
+    // Shrinks a_node to a_size, returns the node of the rest. Neither is listed as free
+    uint32_t splitNode(uint32_t a_node, uint64_t a_size);
+
+    uint64_t m_capacity = 0;
+    uint32_t m_granularityShift = 0;
+    uint64_t m_levelBitmap = 0;
+    std::array<uint32_t, k_classCount> m_subclassBitmaps = {};
+    std::array<std::array<uint32_t, k_subclassCount>, k_classCount> m_freeLists;
+    std::vector<Node> m_nodes;
+    std::vector<uint32_t> m_unusedNodes;
+    uint64_t m_usedSize = 0;
+    uint32_t m_allocationCount = 0;
+    uint32_t m_freeBlockCount = 0;
+};
+}  // namespace neural::utils
@@ -0,0 +1,278 @@
+#include "TaskScheduler.h"
+
+#include <algorithm>
+#include <cassert>
+
+#ifdef _WIN32
+#include <Windows.h>
+#elif defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace neural::utils {
+
+struct TaskScheduler::Task {
+    std::function<void()> function;
+    std::atomic<uint32_t> pendingDependencies = 0;
+    std::atomic<bool> finished = false;
+    std::mutex mutex;                        // guards finished transitions and continuations
+    std::vector<TaskHandle> continuations;   // tasks that depend on this one
+};
+
+struct TaskScheduler::RangeState {
+    const std::function<void(uint32_t, uint32_t)>* body;
+    uint32_t grain;
+    std::atomic<uint32_t> remaining;  // iterations not processed yet
+};
+
+namespace {
+thread_local TaskScheduler* t_scheduler = nullptr;
+thread_local uint32_t t_workerIndex = UINT32_MAX;
+
+void pinCurrentThread(uint32_t a_processor)
+{
+#ifdef _WIN32
+    if (a_processor < 64) {
+        SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(1) << a_processor);
+    }
+#elif defined(__linux__)
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(a_processor, &set);
+    pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+}
+}  // anonymous namespace
+
+void TaskScheduler::initialize(const TaskSchedulerCreateInfo& a_createInfo)
+{
+    shutdown();
+    const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t threadCount = a_createInfo.threadCount > 0 ? a_createInfo.threadCount : hardwareThreads - 1;
+
+    m_queues.clear();
+    for (uint32_t i = 0; i < threadCount + 1; ++i) {
+        m_queues.push_back(std::make_unique<TaskQueue>());
+    }
+    m_running = true;
+    for (uint32_t i = 0; i < threadCount; ++i) {
+        m_workers.emplace_back([this, i, a_createInfo, hardwareThreads]() {
+            if (a_createInfo.pinThreads) {
+                pinCurrentThread((i + 1) % hardwareThreads);
+            }
+            workerMain(i);
+        });
+    }
+}
+
+void TaskScheduler::shutdown()
+{
+    if (!m_running) {
+        return;
+    }
+    {
+        std::lock_guard lock(m_sleepMutex);
+        m_running = false;
+    }
+    m_wakeUp.notify_all();
+    for (auto& worker : m_workers) {
+        worker.join();
+    }
+    m_workers.clear();
+}
+
+void TaskScheduler::workerMain(uint32_t a_workerIndex)
+{
+    t_scheduler = this;
+    t_workerIndex = a_workerIndex;
+    while (m_running) {
+        if (runOneTask()) {
+            continue;
+        }
+        std::unique_lock lock(m_sleepMutex);
+        ++m_sleepingWorkers;
+        m_wakeUp.wait(lock, [this]() { return !m_running || m_queuedTasks > 0; });
+        --m_sleepingWorkers;
+    }
+}
+
+TaskScheduler::TaskHandle TaskScheduler::submit(std::function<void()> a_function,
+                                                std::span<const TaskHandle> a_dependencies)
+{
+    auto task = std::make_shared<Task>();
+    task->function = std::move(a_function);
+    // the extra count keeps the task from starting until all dependencies are registered
+    task->pendingDependencies = static_cast<uint32_t>(a_dependencies.size()) + 1;
+
+    uint32_t satisfied = 1;
+    for (const TaskHandle& dependency : a_dependencies) {
+        std::lock_guard lock(dependency->mutex);
+        if (dependency->finished) {
+            ++satisfied;
+        }
+        else {
+            dependency->continuations.push_back(task);
+        }
+    }
+    if (task->pendingDependencies.fetch_sub(satisfied) == satisfied) {
+        push(task);
+    }
+    return task;
+}
+
+void TaskScheduler::push(TaskHandle a_task)
+{
+    if (m_queues.empty()) {
+        // not initialized, run in place
+        execute(a_task);
+        return;
+    }
+    const bool isWorker = t_scheduler == this && t_workerIndex < m_workers.size();
+    TaskQueue& queue = *m_queues[isWorker ? t_workerIndex : m_workers.size()];
+    // counted before the task is visible, so a thief can't take the count below zero
+    ++m_queuedTasks;
+    {
+        std::lock_guard lock(queue.mutex);
+        queue.tasks.push_back(std::move(a_task));
+    }
+    if (m_sleepingWorkers > 0) {
+        { std::lock_guard lock(m_sleepMutex); }
+        m_wakeUp.notify_one();
+    }
+}
+
+TaskScheduler::TaskHandle TaskScheduler::findTask()
+{
+    if (m_queuedTasks == 0) {
+        return nullptr;
+    }
+    const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+    const bool isWorker = t_scheduler == this && t_workerIndex < m_workers.size();
+    if (isWorker) {
+        TaskQueue& own = *m_queues[t_workerIndex];
+        std::lock_guard lock(own.mutex);
+        if (own.tasks.size() > own.head) {
+            TaskHandle task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            if (own.tasks.size() == own.head) {
+                own.tasks.clear();
+                own.head = 0;
+            }
+            --m_queuedTasks;
+            return task;
+        }
+    }
+
+    // the shared queue first, then steal the oldest task of the other workers
+    const uint32_t start = isWorker ? t_workerIndex + 1 : 0;
+    for (uint32_t i = 0; i < queueCount; ++i) {
+        const uint32_t victim = (i == 0) ? queueCount - 1 : (start + i - 1) % (queueCount - 1);
+        if (isWorker && victim == t_workerIndex) {
+            continue;
+        }
+        TaskQueue& queue = *m_queues[victim];
+        std::lock_guard lock(queue.mutex);
+        if (queue.tasks.size() > queue.head) {
+            TaskHandle task = std::move(queue.tasks[queue.head++]);
+            if (queue.tasks.size() == queue.head) {
+                queue.tasks.clear();
+                queue.head = 0;
+            }
+            --m_queuedTasks;
+            return task;
+        }
+    }
+    return nullptr;
+}
+
+bool TaskScheduler::runOneTask()
+{
+    TaskHandle task = findTask();
+    if (!task) {
+        return false;
+    }
+    execute(task);
+    return true;
+}
+
+void TaskScheduler::execute(const TaskHandle& a_task)
+{
+    a_task->function();
+    a_task->function = nullptr;
+
+    std::vector<TaskHandle> continuations;
+    {
+        std::lock_guard lock(a_task->mutex);
+        a_task->finished = true;
+        continuations.swap(a_task->continuations);
+    }
+    for (TaskHandle& continuation : continuations) {
+        if (continuation->pendingDependencies.fetch_sub(1) == 1) {
+            push(std::move(continuation));
+        }
+    }
+}
+
+void TaskScheduler::wait(const TaskHandle& a_task)
+{
+    while (!a_task->finished) {
+        if (!runOneTask()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void TaskScheduler::wait(std::span<const TaskHandle> a_tasks)
+{
+    for (const TaskHandle& task : a_tasks) {
+        wait(task);
+    }
+}
+
+bool TaskScheduler::isFinished(const TaskHandle& a_task) const
+{
+    return a_task->finished;
+}
+
+void TaskScheduler::runRange(RangeState& a_state, uint32_t a_begin, uint32_t a_end)
+{
+    while (a_begin < a_end) {
+        // give away the upper half while somebody is idle
+        while (a_end - a_begin > a_state.grain && m_sleepingWorkers > 0) {
+            const uint32_t middle = a_begin + (a_end - a_begin) / 2;
+            submit([this, &a_state, middle, a_end]() { runRange(a_state, middle, a_end); });
+            a_end = middle;
+        }
+        const uint32_t chunkEnd = std::min(a_end, a_begin + a_state.grain);
+        (*a_state.body)(a_begin, chunkEnd);
+        a_state.remaining -= chunkEnd - a_begin;
+        a_begin = chunkEnd;
+    }
+}
+
+void TaskScheduler::parallelFor(uint32_t a_begin, uint32_t a_end, uint32_t a_minGrain,
+                                const std::function<void(uint32_t, uint32_t)>& a_body)
+{
+    if (a_begin >= a_end) {
+        return;
+    }
+    RangeState state = {
+        .body = &a_body,
+        .grain = std::max(1u, a_minGrain),
+        .remaining = a_end - a_begin
+    };
+    runRange(state, a_begin, a_end);
+    while (state.remaining > 0) {
+        if (!runOneTask()) {
+            std::this_thread::yield();
+        }
+    }
+}
+
+TaskScheduler& getTaskScheduler()
+{
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+}  // namespace neural::utils
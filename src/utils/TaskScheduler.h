@@ -0,0 +1,75 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace neural::utils {
+
+struct TaskSchedulerCreateInfo {
+    uint32_t threadCount = 0;  // worker threads, 0 is one per hardware thread minus the calling thread
+    bool pinThreads = false;   // worker i runs only on logical processor i + 1, the caller keeps processor 0
+};
+
+// Engine-wide work-stealing scheduler. Every worker owns a deque: it pushes and pops its own tasks
+// at the back and idle workers steal from the front. Threads that are not workers submit into a shared
+// queue and help executing tasks while they wait, so nested waits never block a thread and the
+// engine never runs more threads than configured
+class TaskScheduler {
+public:
+    struct Task;
+    using TaskHandle = std::shared_ptr<Task>;
+
+    void initialize(const TaskSchedulerCreateInfo& a_createInfo);
+    void shutdown();
+    ~TaskScheduler() {
+        shutdown();
+    }
+
+    // a_function starts after every task of a_dependencies is finished
+    TaskHandle submit(std::function<void()> a_function, std::span<const TaskHandle> a_dependencies = {});
+    void wait(const TaskHandle& a_task);
+    void wait(std::span<const TaskHandle> a_tasks);
+    bool isFinished(const TaskHandle& a_task) const;
+
+    // Calls a_body(begin, end) for subranges of [a_begin, a_end) and returns when all of them are done.
+    // A range is split in halves only while some worker is idle (lazy binary splitting), so the grain
+    // adapts to the load and a_minGrain only bounds it from below
+    void parallelFor(uint32_t a_begin, uint32_t a_end, uint32_t a_minGrain,
+                     const std::function<void(uint32_t, uint32_t)>& a_body);
+
+    uint32_t getWorkerCount() const {
+        return static_cast<uint32_t>(m_workers.size());
+    }
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::vector<TaskHandle> tasks;
+        size_t head = 0;  // stolen tasks are taken from here, the owner pops from the back
+    };
+    struct RangeState;
+
+    void workerMain(uint32_t a_workerIndex);
+    void push(TaskHandle a_task);
+    TaskHandle findTask();
+    bool runOneTask();
+    void execute(const TaskHandle& a_task);
+    void runRange(RangeState& a_state, uint32_t a_begin, uint32_t a_end);
+
+    std::vector<std::thread> m_workers;
+    std::vector<std::unique_ptr<TaskQueue>> m_queues;  // one per worker and the last one for other threads
+    std::atomic<bool> m_running = false;
+    std::atomic<uint32_t> m_queuedTasks = 0;
+    std::atomic<uint32_t> m_sleepingWorkers = 0;
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeUp;
+};
+
+TaskScheduler& getTaskScheduler();
+}  // namespace neural::utils
@@ -0,0 +1,313 @@
+#pragma once
+
+// DirectXMath where it is available: the Windows SDK, or installed next to sal.h elsewhere. Without it the part
+// of DirectXMath the CPU code uses is defined here in scalar code, with the same names and conventions: matrices
+// are row-major and multiply row vectors, views and projections are left-handed
+#if __has_include(<DirectXMath.h>)
+#include <DirectXMath.h>
+#else
+#include <cmath>
+#include <cstddef>
+
+namespace DirectX {
+
+constexpr float XM_PI = 3.141592654f;
+constexpr float XM_2PI = 6.283185307f;
+constexpr float XM_1DIVPI = 0.318309886f;
+constexpr float XM_1DIV2PI = 0.159154943f;
+constexpr float XM_PIDIV2 = 1.570796327f;
+
+struct XMFLOAT2 {
+    float x;
+    float y;
+
+    XMFLOAT2() = default;
+    constexpr XMFLOAT2(float a_x, float a_y) : x(a_x), y(a_y) {}
+};
+
+struct XMFLOAT3 {
+    float x;
+    float y;
+    float z;
+
+    XMFLOAT3() = default;
+    constexpr XMFLOAT3(float a_x, float a_y, float a_z) : x(a_x), y(a_y), z(a_z) {}
+};
+
+struct XMFLOAT4 {
+    float x;
+    float y;
+    float z;
+    float w;
+
+    XMFLOAT4() = default;
+    constexpr XMFLOAT4(float a_x, float a_y, float a_z, float a_w) : x(a_x), y(a_y), z(a_z), w(a_w) {}
+};
+
+struct XMFLOAT4X4 {
+    union {
+        struct {
+            float _11, _12, _13, _14;
+            float _21, _22, _23, _24;
+            float _31, _32, _33, _34;
+            float _41, _42, _43, _44;
+        };
+        float m[4][4];
+    };
+
+    float operator()(size_t a_row, size_t a_column) const {
+        return m[a_row][a_column];
+    }
+    float& operator()(size_t a_row, size_t a_column) {
+        return m[a_row][a_column];
+    }
+};
+
+struct XMVECTOR {
+    float v[4];
+};
+
+struct XMMATRIX {
+    XMVECTOR r[4];
+};
+
+using FXMVECTOR = const XMVECTOR;
+using FXMMATRIX = const XMMATRIX&;
+using CXMMATRIX = const XMMATRIX&;
+
+constexpr float XMConvertToRadians(float a_degrees)
+{
+    return a_degrees * (XM_PI / 180.0f);
+}
+
+constexpr float XMConvertToDegrees(float a_radians)
+{
+    return a_radians * (180.0f / XM_PI);
+}
+
+inline XMVECTOR XMLoadFloat3(const XMFLOAT3* a_source)
+{
+    return { a_source->x, a_source->y, a_source->z, 0.0f };
+}
+
+inline void XMStoreFloat3(XMFLOAT3* a_destination, FXMVECTOR a_vector)
+{
+    *a_destination = { a_vector.v[0], a_vector.v[1], a_vector.v[2] };
+}
+
+inline XMMATRIX XMLoadFloat4x4(const XMFLOAT4X4* a_source)
+{
+    XMMATRIX matrix;
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            matrix.r[row].v[column] = a_source->m[row][column];
+        }
+    }
+    return matrix;
+}
+
+inline void XMStoreFloat4x4(XMFLOAT4X4* a_destination, FXMMATRIX a_matrix)
+{
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            a_destination->m[row][column] = a_matrix.r[row].v[column];
+        }
+    }
+}
+
+inline XMVECTOR XMVectorReplicate(float a_value)
+{
+    return { a_value, a_value, a_value, a_value };
+}
+
+inline float XMVectorGetX(FXMVECTOR a_vector)
+{
+    return a_vector.v[0];
+}
+
+// a_v1 * a_v2 + a_v3
+inline XMVECTOR XMVectorMultiplyAdd(FXMVECTOR a_v1, FXMVECTOR a_v2, FXMVECTOR a_v3)
+{
+    XMVECTOR result;
+    for (int i = 0; i < 4; ++i) {
+        result.v[i] = a_v1.v[i] * a_v2.v[i] + a_v3.v[i];
+    }
+    return result;
+}
+
+// The dot product in every component
+inline XMVECTOR XMVector3Dot(FXMVECTOR a_v1, FXMVECTOR a_v2)
+{
+    return XMVectorReplicate(a_v1.v[0] * a_v2.v[0] + a_v1.v[1] * a_v2.v[1] + a_v1.v[2] * a_v2.v[2]);
+}
+
+inline XMVECTOR XMVector3Cross(FXMVECTOR a_v1, FXMVECTOR a_v2)
+{
+    return {
+        a_v1.v[1] * a_v2.v[2] - a_v1.v[2] * a_v2.v[1],
+        a_v1.v[2] * a_v2.v[0] - a_v1.v[0] * a_v2.v[2],
+        a_v1.v[0] * a_v2.v[1] - a_v1.v[1] * a_v2.v[0],
+        0.0f
+    };
+}
+
+// Zero stays zero
+inline XMVECTOR XMVector3Normalize(FXMVECTOR a_vector)
+{
+    const float length = std::sqrt(XMVectorGetX(XMVector3Dot(a_vector, a_vector)));
+    const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+    return { a_vector.v[0] * scale, a_vector.v[1] * scale, a_vector.v[2] * scale, a_vector.v[3] * scale };
+}
+
+// (x, y, z, 1) * a_matrix
+inline XMVECTOR XMVector3Transform(FXMVECTOR a_vector, FXMMATRIX a_matrix)
+{
+    XMVECTOR result;
+    for (int i = 0; i < 4; ++i) {
+        result.v[i] = a_vector.v[0] * a_matrix.r[0].v[i] + a_vector.v[1] * a_matrix.r[1].v[i] +
+                      a_vector.v[2] * a_matrix.r[2].v[i] + a_matrix.r[3].v[i];
+    }
+    return result;
+}
+
+// (x, y, z, 0) * a_matrix
+inline XMVECTOR XMVector3TransformNormal(FXMVECTOR a_vector, FXMMATRIX a_matrix)
+{
+    XMVECTOR result;
+    for (int i = 0; i < 4; ++i) {
+        result.v[i] = a_vector.v[0] * a_matrix.r[0].v[i] + a_vector.v[1] * a_matrix.r[1].v[i] +
+                      a_vector.v[2] * a_matrix.r[2].v[i];
+    }
+    return result;
+}
+
+inline XMMATRIX XMMatrixIdentity()
+{
+    return { { { 1.0f, 0.0f, 0.0f, 0.0f },
+               { 0.0f, 1.0f, 0.0f, 0.0f },
+               { 0.0f, 0.0f, 1.0f, 0.0f },
+               { 0.0f, 0.0f, 0.0f, 1.0f } } };
+}
+
+// a_m1 is applied first
+inline XMMATRIX XMMatrixMultiply(FXMMATRIX a_m1, CXMMATRIX a_m2)
+{
+    XMMATRIX result;
+    for (int row = 0; row < 4; ++row) {
+        for (int column = 0; column < 4; ++column) {
+            float sum = 0.0f;
+            for (int k = 0; k < 4; ++k) {
+                sum += a_m1.r[row].v[k] * a_m2.r[k].v[column];
+            }
+            result.r[row].v[column] = sum;
+        }
+    }
+    return result;
+}
+
+inline XMMATRIX XMMatrixTranslation(float a_x, float a_y, float a_z)
+{
+    XMMATRIX matrix = XMMatrixIdentity();
+    matrix.r[3] = { a_x, a_y, a_z, 1.0f };
+    return matrix;
+}
+
+inline XMMATRIX XMMatrixScaling(float a_x, float a_y, float a_z)
+{
+    XMMATRIX matrix = XMMatrixIdentity();
+    matrix.r[0].v[0] = a_x;
+    matrix.r[1].v[1] = a_y;
+    matrix.r[2].v[2] = a_z;
+    return matrix;
+}
+
+inline XMMATRIX XMMatrixRotationX(float a_angle)
+{
+    const float sin = std::sin(a_angle);
+    const float cos = std::cos(a_angle);
+    XMMATRIX matrix = XMMatrixIdentity();
+    matrix.r[1] = { 0.0f, cos, sin, 0.0f };
+    matrix.r[2] = { 0.0f, -sin, cos, 0.0f };
+    return matrix;
+}
+
+inline XMMATRIX XMMatrixRotationY(float a_angle)
+{
+    const float sin = std::sin(a_angle);
+    const float cos = std::cos(a_angle);
+    XMMATRIX matrix = XMMatrixIdentity();
+    matrix.r[0] = { cos, 0.0f, -sin, 0.0f };
+    matrix.r[2] = { sin, 0.0f, cos, 0.0f };
+    return matrix;
+}
+
+inline XMMATRIX XMMatrixRotationZ(float a_angle)
+{
+    const float sin = std::sin(a_angle);
+    const float cos = std::cos(a_angle);
+    XMMATRIX matrix = XMMatrixIdentity();
+    matrix.r[0] = { cos, sin, 0.0f, 0.0f };
+    matrix.r[1] = { -sin, cos, 0.0f, 0.0f };
+    return matrix;
+}
+
+// Roll about Z first, then pitch about X, then yaw about Y
+inline XMMATRIX XMMatrixRotationRollPitchYaw(float a_pitch, float a_yaw, float a_roll)
+{
+    return XMMatrixMultiply(XMMatrixMultiply(XMMatrixRotationZ(a_roll), XMMatrixRotationX(a_pitch)),
+                            XMMatrixRotationY(a_yaw));
+}
+
+inline XMMATRIX XMMatrixRotationAxis(FXMVECTOR a_axis, float a_angle)
+{
+    const XMVECTOR n = XMVector3Normalize(a_axis);
+    const float x = n.v[0], y = n.v[1], z = n.v[2];
+    const float sin = std::sin(a_angle);
+    const float cos = std::cos(a_angle);
+    const float t = 1.0f - cos;
+    return { { { t * x * x + cos, t * x * y + sin * z, t * x * z - sin * y, 0.0f },
+               { t * x * y - sin * z, t * y * y + cos, t * y * z + sin * x, 0.0f },
+               { t * x * z + sin * y, t * y * z - sin * x, t * z * z + cos, 0.0f },
+               { 0.0f, 0.0f, 0.0f, 1.0f } } };
+}
+
+inline XMMATRIX XMMatrixLookToLH(FXMVECTOR a_eyePosition, FXMVECTOR a_eyeDirection, FXMVECTOR a_upDirection)
+{
+    const XMVECTOR forward = XMVector3Normalize(a_eyeDirection);
+    const XMVECTOR right = XMVector3Normalize(XMVector3Cross(a_upDirection, forward));
+    const XMVECTOR up = XMVector3Cross(forward, right);
+    const XMVECTOR axes[3] = { right, up, forward };
+    XMMATRIX matrix = XMMatrixIdentity();
+    for (int axis = 0; axis < 3; ++axis) {
+        for (int i = 0; i < 3; ++i) {
+            matrix.r[i].v[axis] = axes[axis].v[i];
+        }
+        matrix.r[3].v[axis] = -XMVectorGetX(XMVector3Dot(axes[axis], a_eyePosition));
+    }
+    return matrix;
+}
+
+inline XMMATRIX XMMatrixLookAtLH(FXMVECTOR a_eyePosition, FXMVECTOR a_focusPosition, FXMVECTOR a_upDirection)
+{
+    const XMVECTOR direction = {
+        a_focusPosition.v[0] - a_eyePosition.v[0],
+        a_focusPosition.v[1] - a_eyePosition.v[1],
+        a_focusPosition.v[2] - a_eyePosition.v[2],
+        0.0f
+    };
+    return XMMatrixLookToLH(a_eyePosition, direction, a_upDirection);
+}
+
+// Maps view depth [a_nearZ, a_farZ] to [0, 1]
+inline XMMATRIX XMMatrixPerspectiveFovLH(float a_fovAngleY, float a_aspectRatio, float a_nearZ, float a_farZ)
+{
+    const float height = std::cos(0.5f * a_fovAngleY) / std::sin(0.5f * a_fovAngleY);
+    const float width = height / a_aspectRatio;
+    const float range = a_farZ / (a_farZ - a_nearZ);
+    return { { { width, 0.0f, 0.0f, 0.0f },
+               { 0.0f, height, 0.0f, 0.0f },
+               { 0.0f, 0.0f, range, 1.0f },
+               { 0.0f, 0.0f, -range * a_nearZ, 0.0f } } };
+}
+}  // namespace DirectX
+#endif